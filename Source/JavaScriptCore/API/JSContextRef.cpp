@@ -107,6 +107,68 @@ void JSContextGroupClearExecutionTimeLimit(JSContextGroupRef group)
     watchdog.setTimeLimit(vm, std::numeric_limits<double>::infinity());
 }
 
+void JSContextGroupSetExecutionBudget(JSContextGroupRef group, double budget, JSShouldTerminateCallback callback, void* callbackData)
+{
+    VM& vm = *toJS(group);
+    APIEntryShim entryShim(&vm);
+    Watchdog& watchdog = vm.watchdog;
+    if (callback) {
+        void* callbackPtr = reinterpret_cast<void*>(callback);
+        watchdog.setBudget(vm, budget, internalScriptTimeoutCallback, callbackPtr, callbackData);
+    } else
+        watchdog.setBudget(vm, budget);
+}
+
+double JSContextGroupGetExecutionBudget(JSContextGroupRef group)
+{
+    VM& vm = *toJS(group);
+    APIEntryShim entryShim(&vm);
+    return vm.watchdog.remainingBudget();
+}
+
+void JSContextGroupClearExecutionBudget(JSContextGroupRef group)
+{
+    VM& vm = *toJS(group);
+    APIEntryShim entryShim(&vm);
+    Watchdog& watchdog = vm.watchdog;
+    watchdog.setBudget(vm, std::numeric_limits<double>::infinity());
+}
+
+static void internalScriptYieldCallback(ExecState* exec, void* callbackPtr, void* callbackData)
+{
+    JSYieldCallback callback = reinterpret_cast<JSYieldCallback>(callbackPtr);
+    JSContextRef contextRef = toRef(exec);
+    ASSERT(callback);
+    callback(contextRef, callbackData);
+}
+
+void JSContextGroupSetExecutionYieldInterval(JSContextGroupRef group, double interval, JSYieldCallback callback, void* callbackData)
+{
+    VM& vm = *toJS(group);
+    APIEntryShim entryShim(&vm);
+    Watchdog& watchdog = vm.watchdog;
+    if (callback) {
+        void* callbackPtr = reinterpret_cast<void*>(callback);
+        watchdog.setYieldInterval(vm, interval, internalScriptYieldCallback, callbackPtr, callbackData);
+    } else
+        watchdog.setYieldInterval(vm, std::numeric_limits<double>::infinity());
+}
+
+void JSContextGroupClearExecutionYieldInterval(JSContextGroupRef group)
+{
+    VM& vm = *toJS(group);
+    APIEntryShim entryShim(&vm);
+    Watchdog& watchdog = vm.watchdog;
+    watchdog.setYieldInterval(vm, std::numeric_limits<double>::infinity());
+}
+
+double JSContextGroupGetExecutionTime(JSContextGroupRef group)
+{
+    VM& vm = *toJS(group);
+    APIEntryShim entryShim(&vm);
+    return vm.watchdog.cpuTime();
+}
+
 // From the API's perspective, a global context remains alive iff it has been JSGlobalContextRetained.
 
 JSGlobalContextRef JSGlobalContextCreate(JSClassRef globalObjectClass)
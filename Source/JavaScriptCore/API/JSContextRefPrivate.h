@@ -103,6 +103,84 @@ JS_EXPORT void JSContextGroupSetExecutionTimeLimit(JSContextGroupRef, double lim
 */
 JS_EXPORT void JSContextGroupClearExecutionTimeLimit(JSContextGroupRef) AVAILABLE_IN_WEBKIT_VERSION_4_0;
 
+/*!
+@function
+@abstract Sets the CPU time budget shared by all script executions in a context group.
+@param group The JavaScript context group that this budget applies to.
+@param budget The total script execution time allowed in seconds.
+@param callback The callback function that will be invoked when the budget has
+ been used up. If you return false from it, the script continues; call
+ JSContextGroupSetExecutionBudget from the callback to grant more time, otherwise
+ the budget is cleared. If you pass a NULL callback, the script will be
+ terminated unconditionally when the budget runs out.
+@param context User data that you can provide to be passed back to you
+ in your callback.
+@discussion Unlike the execution time limit, which applies to each script
+ execution separately, time used against the budget accumulates across all
+ executions until a new budget is set.
+*/
+JS_EXPORT void JSContextGroupSetExecutionBudget(JSContextGroupRef, double budget, JSShouldTerminateCallback, void* context) AVAILABLE_IN_WEBKIT_VERSION_4_0;
+
+/*!
+@function
+@abstract Returns the remaining CPU time budget of a context group in seconds.
+@param group The JavaScript context group to query.
+@result The remaining budget, or infinity if no budget has been set.
+*/
+JS_EXPORT double JSContextGroupGetExecutionBudget(JSContextGroupRef) AVAILABLE_IN_WEBKIT_VERSION_4_0;
+
+/*!
+@function
+@abstract Clears the CPU time budget of a context group.
+@param group The JavaScript context group that the budget is cleared on.
+*/
+JS_EXPORT void JSContextGroupClearExecutionBudget(JSContextGroupRef) AVAILABLE_IN_WEBKIT_VERSION_4_0;
+
+/*!
+@typedef JSYieldCallback
+@abstract The callback invoked periodically while script runs, as requested via
+ JSContextGroupSetExecutionYieldInterval.
+@param ctx The execution context to use.
+@param context User specified context data previously passed to
+ JSContextGroupSetExecutionYieldInterval.
+@discussion If you named your function Callback, you would declare it like this:
+
+ void Callback(JSContextRef ctx, void* context);
+
+ The script is suspended while the callback runs and resumes when it returns.
+ The callback may process pending events of the embedder, but should not run
+ script in the same context group.
+*/
+typedef void
+(*JSYieldCallback) (JSContextRef ctx, void* context);
+
+/*!
+@function
+@abstract Requests that long running scripts periodically yield to the embedder.
+@param group The JavaScript context group that this interval applies to.
+@param interval The amount of script execution time in seconds between calls.
+@param callback The callback function to invoke after every interval.
+@param context User data that you can provide to be passed back to you
+ in your callback.
+*/
+JS_EXPORT void JSContextGroupSetExecutionYieldInterval(JSContextGroupRef, double interval, JSYieldCallback, void* context) AVAILABLE_IN_WEBKIT_VERSION_4_0;
+
+/*!
+@function
+@abstract Stops the periodic yield callback of a context group.
+@param group The JavaScript context group that the yield interval is cleared on.
+*/
+JS_EXPORT void JSContextGroupClearExecutionYieldInterval(JSContextGroupRef) AVAILABLE_IN_WEBKIT_VERSION_4_0;
+
+/*!
+@function
+@abstract Returns the CPU time spent executing script in a context group.
+@discussion Time is only accounted while the group has an execution time limit, budget or yield interval set.
+@param group The JavaScript context group to query.
+@result The accumulated script execution time in seconds.
+*/
+JS_EXPORT double JSContextGroupGetExecutionTime(JSContextGroupRef) AVAILABLE_IN_WEBKIT_VERSION_4_0;
+
 #ifdef __cplusplus
 }
 #endif
@@ -1110,6 +1110,23 @@ static bool extendTerminateCallback(JSContextRef ctx, void* context)
     }
     return true;
 }
+
+int yieldCallbackCalled = 0;
+static void yieldCallback(JSContextRef ctx, void* context)
+{
+    UNUSED_PARAM(ctx);
+    UNUSED_PARAM(context);
+    yieldCallbackCalled++;
+}
+
+bool budgetCallbackWasCalled = false;
+static bool budgetCallback(JSContextRef ctx, void* context)
+{
+    UNUSED_PARAM(ctx);
+    UNUSED_PARAM(context);
+    budgetCallbackWasCalled = true;
+    return true;
+}
 #endif /* PLATFORM(MAC) || PLATFORM(IOS) */
 
 
@@ -1932,6 +1949,60 @@ int main(int argc, char* argv[])
             failed = true;
         }
     }
+    JSContextGroupClearExecutionTimeLimit(contextGroup);
+
+    /* Test script yield interval: */
+    JSContextGroupSetExecutionYieldInterval(contextGroup, 0.050f, yieldCallback, 0);
+    {
+        const char* loopForeverScript = "var startTime = currentCPUTime(); while (true) { if (currentCPUTime() - startTime > .300) break; } ";
+        JSStringRef script = JSStringCreateWithUTF8CString(loopForeverScript);
+        exception = NULL;
+        v = JSEvaluateScript(context, script, NULL, NULL, 1, &exception);
+
+        if ((yieldCallbackCalled >= 3) && !exception)
+            printf("PASS: script yielded periodically as expected.\n");
+        else {
+            if (yieldCallbackCalled < 3)
+                printf("FAIL: script yield callback was called %d times.\n", yieldCallbackCalled);
+            if (exception)
+                printf("FAIL: Unexpected TerminatedExecutionException thrown during yield test.\n");
+            failed = true;
+        }
+    }
+    JSContextGroupClearExecutionYieldInterval(contextGroup);
+
+    /* Test script execution budget, which is shared between evaluations: */
+    JSContextGroupSetExecutionBudget(contextGroup, 0.200f, budgetCallback, 0);
+    {
+        const char* loopScript = "var startTime = currentCPUTime(); while (true) { if (currentCPUTime() - startTime > .150) break; } ";
+        JSStringRef script = JSStringCreateWithUTF8CString(loopScript);
+        double executionTimeBefore = JSContextGroupGetExecutionTime(contextGroup);
+        JSValueRef firstException = NULL;
+        JSValueRef secondException = NULL;
+        JSEvaluateScript(context, script, NULL, NULL, 1, &firstException);
+        JSEvaluateScript(context, script, NULL, NULL, 1, &secondException);
+        double executionTime = JSContextGroupGetExecutionTime(contextGroup) - executionTimeBefore;
+
+        if (!firstException && secondException && budgetCallbackWasCalled)
+            printf("PASS: script execution budget was enforced across evaluations as expected.\n");
+        else {
+            if (firstException)
+                printf("FAIL: script was terminated before using up the execution budget.\n");
+            if (!secondException)
+                printf("FAIL: script was not terminated after using up the execution budget.\n");
+            if (!budgetCallbackWasCalled)
+                printf("FAIL: script budget callback was not called.\n");
+            failed = true;
+        }
+
+        if (executionTime >= .200f && executionTime < .300f)
+            printf("PASS: script execution time was accounted as expected.\n");
+        else {
+            printf("FAIL: script execution time was %f seconds.\n", executionTime);
+            failed = true;
+        }
+    }
+    JSContextGroupClearExecutionBudget(contextGroup);
 #endif /* PLATFORM(MAC) || PLATFORM(IOS) */
 
     // Clear out local variables pointing at JSObjectRefs to allow their values to be collected
@@ -92,6 +92,7 @@ SOURCES += \
     heap/GCThreadSharedData.cpp \
     heap/GCThread.cpp \
     heap/Heap.cpp \
+    heap/HeapSnapshot.cpp \
     heap/HeapStatistics.cpp \
     heap/HeapTimer.cpp \
     heap/IncrementalSweeper.cpp \
@@ -218,6 +219,7 @@ SOURCES += \
     profiler/ProfilerOSRExit.cpp \
     profiler/ProfilerOSRExitSite.cpp \
     profiler/ProfilerProfiledBytecodes.cpp \
+    profiler/ProfilerTieringCounters.cpp \
     profiler/Profile.cpp \
     profiler/ProfileGenerator.cpp \
     profiler/ProfileNode.cpp \
@@ -321,7 +323,7 @@ SOURCES += \
     runtime/StructureRareData.cpp \
     runtime/SymbolTable.cpp \
     runtime/Watchdog.cpp \
-    runtime/WatchdogNone.cpp \
+    runtime/WatchdogGeneric.cpp \
     tools/CodeProfile.cpp \
     tools/CodeProfiling.cpp \
     yarr/YarrJIT.cpp \
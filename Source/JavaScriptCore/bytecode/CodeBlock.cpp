@@ -2887,6 +2887,7 @@ void CodeBlock::jettison()
     ASSERT(this == replacement());
     alternative()->optimizeAfterWarmUp();
     tallyFrequentExitSites();
+    baselineVersion()->tieringCounters().didJettison(this);
     if (DFG::shouldShowDisassembly())
         dataLog("Jettisoning ", *this, ".\n");
     jettisonImpl();
@@ -62,6 +62,7 @@
 #include "LazyOperandValueProfile.h"
 #include "LineInfo.h"
 #include "ProfilerCompilation.h"
+#include "ProfilerTieringCounters.h"
 #include "RegExpObject.h"
 #include "ResolveOperation.h"
 #include "StructureStubInfo.h"
@@ -436,6 +437,10 @@ public:
             m_vm->heap.m_dfgCodeBlocks.m_set.add(this);
         }
 #endif
+        CodeBlock* baselineCodeBlock = this;
+        while (baselineCodeBlock->alternative())
+            baselineCodeBlock = baselineCodeBlock->alternative();
+        baselineCodeBlock->m_tieringCounters.didInstallCode(m_jitCode.jitType());
     }
     JITCode& getJITCode() { return m_jitCode; }
     MacroAssemblerCodePtr getJITCodeWithArityCheck() { return m_jitCodeWithArityCheck; }
@@ -1024,6 +1029,9 @@ public:
     uint32_t osrExitCounter() const { return m_osrExitCounter; }
         
     void countOSRExit() { m_osrExitCounter++; }
+
+    // Only meaningful for the baseline CodeBlock; see baselineVersion().
+    Profiler::TieringCounters& tieringCounters() { return m_tieringCounters; }
         
     uint32_t* addressOfOSRExitCounter() { return &m_osrExitCounter; }
         
@@ -1273,6 +1281,8 @@ private:
     uint16_t m_optimizationDelayCounter;
     uint16_t m_reoptimizationRetryCounter;
 
+    Profiler::TieringCounters m_tieringCounters;
+
     Vector<ResolveOperations> m_resolveOperations;
     Vector<PutToBaseOperation, 1> m_putToBaseOperations;
 
@@ -50,6 +50,8 @@ enum ExitKind {
     WatchdogTimerFired // We exited because we need to service the watchdog timer.
 };
 
+const unsigned numberOfExitKinds = WatchdogTimerFired + 1;
+
 const char* exitKindToString(ExitKind);
 bool exitKindIsCountable(ExitKind);
 
@@ -50,7 +50,13 @@ public:
     void initialize(VM& vm, JSCell* owner, JSObject* prototype, unsigned inferredInlineCapacity)
     {
         ASSERT(!m_allocator);
-        ASSERT(!m_structure);
+
+        // If objects allocated from the previous structure spilled into out-of-line
+        // storage, make room for all of their properties inline this time around.
+        if (m_structure) {
+            inferredInlineCapacity = std::max(inferredInlineCapacity, m_structure->largestDerivedPropertyCount());
+            m_structure.clear();
+        }
 
         unsigned inlineCapacity = 0;
         if (inferredInlineCapacity < JSFinalObject::defaultInlineCapacity()) {
@@ -104,6 +110,15 @@ public:
         ASSERT(isNull());
     }
 
+    // Forces the next allocation through the slow path, which re-initializes the
+    // profile. The structure is kept so that initialize() can see how large the
+    // objects allocated from it have grown.
+    void clearAllocator()
+    {
+        m_allocator = 0;
+        ASSERT(isNull());
+    }
+
     void visitAggregate(SlotVisitor& visitor)
     {
         visitor.append(&m_structure);
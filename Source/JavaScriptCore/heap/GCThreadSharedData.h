@@ -39,6 +39,7 @@
 namespace JSC {
 
 class GCThread;
+class HeapSnapshot;
 class VM;
 class CopiedSpace;
 class CopyVisitor;
@@ -70,6 +71,7 @@ public:
     
 private:
     friend class GCThread;
+    friend class HeapSnapshot;
     friend class SlotVisitor;
     friend class CopyVisitor;
 
@@ -82,6 +84,8 @@ private:
     
     bool m_shouldHashCons;
 
+    HeapSnapshot* m_heapSnapshot;
+
     Vector<GCThread*> m_gcThreads;
 
     Mutex m_markingLock;
@@ -65,6 +65,10 @@ namespace JSC {
     class WeakGCHandlePool;
     class SlotVisitor;
 
+    namespace Profiler {
+    class Database;
+    }
+
     typedef std::pair<JSValue, WTF::String> ValueStringPair;
     typedef HashCountedSet<JSCell*> ProtectCountSet;
     typedef HashCountedSet<const char*> TypeCountSet;
@@ -192,8 +196,10 @@ namespace JSC {
         friend class SlotVisitor;
         friend class SuperRegion;
         friend class IncrementalSweeper;
+        friend class HeapSnapshot;
         friend class HeapStatistics;
         friend class WeakSet;
+        friend class Profiler::Database;
         template<typename T> friend void* allocateCell(Heap&);
         template<typename T> friend void* allocateCell(Heap&, size_t);
 
@@ -0,0 +1,325 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HeapSnapshot.h"
+
+#include "Heap.h"
+#include "JSCell.h"
+#include "JSLock.h"
+#include "MarkedBlock.h"
+#include "Operations.h"
+#include "VM.h"
+#include <wtf/BitVector.h>
+#include <wtf/CommaPrinter.h>
+#include <wtf/FilePrintStream.h>
+
+namespace JSC {
+
+static const unsigned notComputed = UINT_MAX;
+
+const unsigned HeapSnapshot::rootNodeIndex;
+
+HeapSnapshot::HeapSnapshot()
+{
+    m_nodes.append(Node(0, 0, 0));
+}
+
+HeapSnapshot::~HeapSnapshot()
+{
+}
+
+PassRefPtr<HeapSnapshot> HeapSnapshot::take(VM& vm)
+{
+    JSLockHolder lock(vm);
+
+    RefPtr<HeapSnapshot> snapshot = adoptRef(new HeapSnapshot);
+    Heap& heap = vm.heap;
+    if (!heap.isSafeToCollect())
+        return snapshot.release();
+
+    ASSERT(!heap.m_sharedData.m_heapSnapshot);
+    heap.m_sharedData.m_heapSnapshot = snapshot.get();
+    heap.collectAllGarbage();
+    heap.m_sharedData.m_heapSnapshot = 0;
+
+    snapshot->finishCollecting();
+    return snapshot.release();
+}
+
+bool HeapSnapshot::takeAndWriteToFile(VM& vm, const char* filename)
+{
+    OwnPtr<FilePrintStream> file = FilePrintStream::open(filename, "w");
+    if (!file)
+        return false;
+
+    RefPtr<HeapSnapshot> snapshot = take(vm);
+    snapshot->writeJSON(*file);
+    return true;
+}
+
+void HeapSnapshot::appendNode(JSCell* cell)
+{
+    size_t cellSize = MarkedBlock::blockFor(cell)->cellSize();
+    const ClassInfo* classInfo = cell->classInfo();
+
+    MutexLocker locker(m_lock);
+    HashMap<JSCell*, unsigned>::AddResult result = m_nodeIndices.add(cell, m_nodes.size());
+    if (result.isNewEntry)
+        m_nodes.append(Node(cell, classInfo, cellSize));
+}
+
+void HeapSnapshot::appendEdge(JSCell* from, JSCell* to)
+{
+    MutexLocker locker(m_lock);
+    m_pendingEdges.append(Edge(from, to));
+}
+
+void HeapSnapshot::appendStorage(JSCell* owner, size_t bytes)
+{
+    MutexLocker locker(m_lock);
+    HashMap<JSCell*, unsigned>::iterator it = m_nodeIndices.find(owner);
+    if (it != m_nodeIndices.end())
+        m_nodes[it->value].selfSize += bytes;
+}
+
+const char* HeapSnapshot::className(unsigned nodeIndex) const
+{
+    const ClassInfo* classInfo = m_nodes[nodeIndex].classInfo;
+    return classInfo ? classInfo->className : "<root>";
+}
+
+void HeapSnapshot::finishCollecting()
+{
+    // Resolve the edges recorded during marking to node indices, dropping any
+    // that point at cells that were not traced (e.g. cells without a structure).
+    size_t nodeCount = m_nodes.size();
+    Vector<unsigned> fromIndices;
+    Vector<unsigned> toIndices;
+    fromIndices.reserveInitialCapacity(m_pendingEdges.size());
+    toIndices.reserveInitialCapacity(m_pendingEdges.size());
+    m_successorOffsets.fill(0, nodeCount + 1);
+    for (size_t i = 0; i < m_pendingEdges.size(); ++i) {
+        const Edge& edge = m_pendingEdges[i];
+        unsigned from = rootNodeIndex;
+        if (edge.from) {
+            HashMap<JSCell*, unsigned>::iterator it = m_nodeIndices.find(edge.from);
+            if (it == m_nodeIndices.end())
+                continue;
+            from = it->value;
+        }
+        HashMap<JSCell*, unsigned>::iterator it = m_nodeIndices.find(edge.to);
+        if (it == m_nodeIndices.end())
+            continue;
+        fromIndices.uncheckedAppend(from);
+        toIndices.uncheckedAppend(it->value);
+        m_successorOffsets[from + 1]++;
+    }
+    m_pendingEdges.clear();
+    m_nodeIndices.clear();
+
+    for (size_t i = 0; i < nodeCount; ++i)
+        m_successorOffsets[i + 1] += m_successorOffsets[i];
+
+    m_successors.resize(fromIndices.size());
+    Vector<unsigned> cursors(m_successorOffsets);
+    for (size_t i = 0; i < fromIndices.size(); ++i)
+        m_successors[cursors[fromIndices[i]]++] = toIndices[i];
+
+    Vector<unsigned> postorderIndex;
+    Vector<unsigned> postorder;
+    computeDepthFirstOrder(postorderIndex, postorder);
+    computeDominators(postorderIndex, postorder);
+    computeRetainedSizes(postorderIndex, postorder);
+}
+
+void HeapSnapshot::computeDepthFirstOrder(Vector<unsigned>& postorderIndex, Vector<unsigned>& postorder)
+{
+    size_t nodeCount = m_nodes.size();
+    postorderIndex.fill(notComputed, nodeCount);
+    postorder.reserveInitialCapacity(nodeCount);
+
+    BitVector visited;
+    visited.ensureSize(nodeCount);
+    Vector<std::pair<unsigned, unsigned> > stack;
+    visited.set(rootNodeIndex);
+    stack.append(std::make_pair(rootNodeIndex, m_successorOffsets[rootNodeIndex]));
+    while (!stack.isEmpty()) {
+        unsigned node = stack.last().first;
+        unsigned next = stack.last().second;
+        if (next < m_successorOffsets[node + 1]) {
+            stack.last().second++;
+            unsigned successor = m_successors[next];
+            if (!visited.quickGet(successor)) {
+                visited.quickSet(successor);
+                stack.append(std::make_pair(successor, m_successorOffsets[successor]));
+            }
+            continue;
+        }
+        postorderIndex[node] = postorder.size();
+        postorder.append(node);
+        stack.removeLast();
+    }
+}
+
+// This is the iterative algorithm from Cooper, Harvey and Kennedy, "A Simple,
+// Fast Dominance Algorithm". It converges in a handful of passes over the
+// reverse postorder on heap-shaped graphs.
+void HeapSnapshot::computeDominators(const Vector<unsigned>& postorderIndex, const Vector<unsigned>& postorder)
+{
+    size_t nodeCount = m_nodes.size();
+
+    Vector<unsigned> predecessorOffsets;
+    predecessorOffsets.fill(0, nodeCount + 1);
+    for (size_t i = 0; i < m_successors.size(); ++i)
+        predecessorOffsets[m_successors[i] + 1]++;
+    for (size_t i = 0; i < nodeCount; ++i)
+        predecessorOffsets[i + 1] += predecessorOffsets[i];
+    Vector<unsigned> predecessors(m_successors.size());
+    Vector<unsigned> cursors(predecessorOffsets);
+    for (unsigned from = 0; from < nodeCount; ++from) {
+        for (unsigned i = m_successorOffsets[from]; i < m_successorOffsets[from + 1]; ++i)
+            predecessors[cursors[m_successors[i]]++] = from;
+    }
+
+    ASSERT(postorder.last() == rootNodeIndex);
+
+    Vector<unsigned> dominators;
+    dominators.fill(notComputed, nodeCount);
+    dominators[rootNodeIndex] = rootNodeIndex;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        // Walk in reverse postorder, skipping the root which comes last in postorder.
+        for (size_t i = postorder.size() - 1; i--;) {
+            unsigned node = postorder[i];
+            unsigned newDominator = notComputed;
+            for (unsigned j = predecessorOffsets[node]; j < predecessorOffsets[node + 1]; ++j) {
+                unsigned predecessor = predecessors[j];
+                if (dominators[predecessor] == notComputed)
+                    continue;
+                if (newDominator == notComputed) {
+                    newDominator = predecessor;
+                    continue;
+                }
+                unsigned finger1 = predecessor;
+                unsigned finger2 = newDominator;
+                while (finger1 != finger2) {
+                    while (postorderIndex[finger1] < postorderIndex[finger2])
+                        finger1 = dominators[finger1];
+                    while (postorderIndex[finger2] < postorderIndex[finger1])
+                        finger2 = dominators[finger2];
+                }
+                newDominator = finger1;
+            }
+            if (dominators[node] != newDominator) {
+                dominators[node] = newDominator;
+                changed = true;
+            }
+        }
+    }
+
+    // Nodes that the traversal did not reach are attributed to the root.
+    for (size_t i = 0; i < nodeCount; ++i)
+        m_nodes[i].dominator = dominators[i] == notComputed ? rootNodeIndex : dominators[i];
+}
+
+void HeapSnapshot::computeRetainedSizes(const Vector<unsigned>& postorderIndex, const Vector<unsigned>& postorder)
+{
+    // Retained sizes are accumulated in postorder, where every node comes
+    // before its immediate dominator.
+    size_t nodeCount = m_nodes.size();
+    for (size_t i = 0; i < nodeCount; ++i)
+        m_nodes[i].retainedSize = m_nodes[i].selfSize;
+    for (size_t i = 0; i < postorder.size(); ++i) {
+        unsigned node = postorder[i];
+        if (node != rootNodeIndex)
+            m_nodes[m_nodes[node].dominator].retainedSize += m_nodes[node].retainedSize;
+    }
+    for (size_t i = 0; i < nodeCount; ++i) {
+        if (postorderIndex[i] == notComputed)
+            m_nodes[rootNodeIndex].retainedSize += m_nodes[i].retainedSize;
+    }
+}
+
+// The layout below is the one the Web Inspector's heap profiler loads
+// (see inspector/front-end/HeapSnapshotLoader.js): a "snapshot" header whose
+// meta describes the flat "nodes" and "edges" arrays, followed by the "strings"
+// table that node names index into. The front end computes dominators and
+// retained sizes on its own, so only the graph itself is written out.
+static const unsigned nodeFieldCount = 5;
+static const unsigned nodeTypeObject = 3;
+static const unsigned nodeTypeSynthetic = 9;
+static const unsigned edgeTypeElement = 1;
+
+void HeapSnapshot::writeJSON(PrintStream& out) const
+{
+    HashMap<const ClassInfo*, unsigned> classIndices;
+    Vector<const char*> strings;
+    strings.append(className(rootNodeIndex));
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        const ClassInfo* classInfo = m_nodes[i].classInfo;
+        if (classInfo && classIndices.add(classInfo, strings.size()).isNewEntry)
+            strings.append(classInfo->className);
+    }
+
+    out.print("{\"snapshot\":{\"meta\":{");
+    out.print("\"node_fields\":[\"type\",\"name\",\"id\",\"self_size\",\"edge_count\"],");
+    out.print("\"node_types\":[[\"hidden\",\"array\",\"string\",\"object\",\"code\",\"closure\",\"regexp\",\"number\",\"native\",\"synthetic\"],\"string\",\"number\",\"number\",\"number\"],");
+    out.print("\"edge_fields\":[\"type\",\"name_or_index\",\"to_node\"],");
+    out.print("\"edge_types\":[[\"context\",\"element\",\"property\",\"internal\",\"hidden\",\"shortcut\",\"weak\"],\"string_or_number\",\"node\"]},");
+    out.print("\"node_count\":", m_nodes.size(), ",\"edge_count\":", m_successors.size(), "},\n");
+
+    out.print("\"nodes\":[");
+    CommaPrinter nodeComma(",");
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        const Node& node = m_nodes[i];
+        unsigned type = i == rootNodeIndex ? nodeTypeSynthetic : nodeTypeObject;
+        unsigned name = node.classInfo ? classIndices.get(node.classInfo) : 0;
+        unsigned edgeCount = m_successorOffsets[i + 1] - m_successorOffsets[i];
+        out.print(nodeComma, type, ",", name, ",", i + 1, ",", node.selfSize, ",", edgeCount);
+    }
+
+    // Edges are listed by source node, in node order; each node's edge_count
+    // says how many of them belong to it. Cells do not name their references,
+    // so every edge is an element edge indexed by its position in the node,
+    // and to_node is the offset of the target in the nodes array.
+    out.print("],\n\"edges\":[");
+    CommaPrinter edgeComma(",");
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        for (unsigned j = m_successorOffsets[i]; j < m_successorOffsets[i + 1]; ++j)
+            out.print(edgeComma, edgeTypeElement, ",", j - m_successorOffsets[i], ",", m_successors[j] * nodeFieldCount);
+    }
+
+    out.print("],\n\"strings\":[");
+    CommaPrinter stringComma(",");
+    for (size_t i = 0; i < strings.size(); ++i)
+        out.print(stringComma, "\"", strings[i], "\"");
+    out.print("]}\n");
+    out.flush();
+}
+
+} // namespace JSC
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HeapSnapshot_h
+#define HeapSnapshot_h
+
+#include "JSExportMacros.h"
+#include <wtf/HashMap.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/PrintStream.h>
+#include <wtf/RefCounted.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+class JSCell;
+class VM;
+struct ClassInfo;
+
+// A HeapSnapshot records the object graph seen by a full collection: one node
+// per live cell and one edge per reference traced by visitChildren. Once the
+// collection is over, the graph is resolved to node indices and the dominator
+// tree is computed so that each node knows the number of bytes that would be
+// freed if it became unreachable (its retained size).
+class HeapSnapshot : public RefCounted<HeapSnapshot> {
+public:
+    // Index of the synthetic node that owns every GC root.
+    static const unsigned rootNodeIndex = 0;
+
+    // Triggers a full collection. The returned snapshot is empty if it is not
+    // safe to collect right now.
+    JS_EXPORT_PRIVATE static PassRefPtr<HeapSnapshot> take(VM&);
+    JS_EXPORT_PRIVATE static bool takeAndWriteToFile(VM&, const char* filename);
+
+    JS_EXPORT_PRIVATE ~HeapSnapshot();
+
+    // Called by SlotVisitor while marking. These may be called concurrently from
+    // the parallel marking threads.
+    void appendNode(JSCell*);
+    void appendEdge(JSCell* from, JSCell* to);
+    void appendStorage(JSCell* owner, size_t bytes);
+
+    size_t nodeCount() const { return m_nodes.size(); }
+    size_t edgeCount() const { return m_successors.size(); }
+    const char* className(unsigned nodeIndex) const;
+    size_t selfSize(unsigned nodeIndex) const { return m_nodes[nodeIndex].selfSize; }
+    size_t retainedSize(unsigned nodeIndex) const { return m_nodes[nodeIndex].retainedSize; }
+    unsigned dominator(unsigned nodeIndex) const { return m_nodes[nodeIndex].dominator; }
+
+    // Writes the snapshot in the Web Inspector's heap snapshot JSON format, one
+    // node or edge at a time, so that the output never has to be materialized
+    // as a single string.
+    JS_EXPORT_PRIVATE void writeJSON(PrintStream&) const;
+
+private:
+    HeapSnapshot();
+
+    void finishCollecting();
+    void computeDepthFirstOrder(Vector<unsigned>& postorderIndex, Vector<unsigned>& postorder);
+    void computeDominators(const Vector<unsigned>& postorderIndex, const Vector<unsigned>& postorder);
+    void computeRetainedSizes(const Vector<unsigned>& postorderIndex, const Vector<unsigned>& postorder);
+
+    struct Node {
+        Node() { }
+        Node(JSCell* cell, const ClassInfo* classInfo, size_t selfSize)
+            : cell(cell)
+            , classInfo(classInfo)
+            , selfSize(selfSize)
+            , retainedSize(0)
+            , dominator(rootNodeIndex)
+        {
+        }
+
+        JSCell* cell;
+        const ClassInfo* classInfo;
+        size_t selfSize;
+        size_t retainedSize;
+        unsigned dominator;
+    };
+
+    struct Edge {
+        Edge() { }
+        Edge(JSCell* from, JSCell* to)
+            : from(from)
+            , to(to)
+        {
+        }
+
+        JSCell* from;
+        JSCell* to;
+    };
+
+    Mutex m_lock;
+    Vector<Node> m_nodes;
+    HashMap<JSCell*, unsigned> m_nodeIndices;
+    Vector<Edge> m_pendingEdges;
+
+    // Edges in compressed form: the successors of node i are
+    // m_successors[m_successorOffsets[i] .. m_successorOffsets[i + 1]).
+    Vector<unsigned> m_successorOffsets;
+    Vector<unsigned> m_successors;
+};
+
+} // namespace JSC
+
+#endif // HeapSnapshot_h
@@ -6,6 +6,7 @@
 #include "CopiedSpace.h"
 #include "CopiedSpaceInlines.h"
 #include "GCThread.h"
+#include "HeapSnapshot.h"
 #include "JSArray.h"
 #include "JSDestructibleObject.h"
 #include "VM.h"
@@ -22,6 +23,8 @@ SlotVisitor::SlotVisitor(GCThreadSharedData& shared)
     , m_isInParallelMode(false)
     , m_shared(shared)
     , m_shouldHashCons(false)
+    , m_heapSnapshot(0)
+    , m_currentCell(0)
 #if !ASSERT_DISABLED
     , m_isCheckingForDefaultMarkViolation(false)
     , m_isDraining(false)
@@ -38,9 +41,12 @@ void SlotVisitor::setup()
 {
     m_shared.m_shouldHashCons = m_shared.m_vm->haveEnoughNewStringsToHashCons();
     m_shouldHashCons = m_shared.m_shouldHashCons;
+    m_heapSnapshot = m_shared.m_heapSnapshot;
 #if ENABLE(PARALLEL_GC)
-    for (unsigned i = 0; i < m_shared.m_gcThreads.size(); ++i)
+    for (unsigned i = 0; i < m_shared.m_gcThreads.size(); ++i) {
         m_shared.m_gcThreads[i]->slotVisitor()->m_shouldHashCons = m_shared.m_shouldHashCons;
+        m_shared.m_gcThreads[i]->slotVisitor()->m_heapSnapshot = m_shared.m_heapSnapshot;
+    }
 #endif
 }
 
@@ -57,6 +63,8 @@ void SlotVisitor::reset()
         m_uniqueStrings.clear();
         m_shouldHashCons = false;
     }
+    m_heapSnapshot = 0;
+    m_currentCell = 0;
 }
 
 void SlotVisitor::append(ConservativeRoots& conservativeRoots)
@@ -76,6 +84,11 @@ ALWAYS_INLINE static void visitChildren(SlotVisitor& visitor, const JSCell* cell
 #endif
 
     ASSERT(Heap::isMarked(cell));
+
+    if (UNLIKELY(visitor.isTakingHeapSnapshot())) {
+        visitor.visitChildrenForHeapSnapshot(const_cast<JSCell*>(cell));
+        return;
+    }
     
     if (isJSString(cell)) {
         JSString::visitChildren(const_cast<JSCell*>(cell), visitor);
@@ -95,6 +108,16 @@ ALWAYS_INLINE static void visitChildren(SlotVisitor& visitor, const JSCell* cell
     cell->methodTable()->visitChildren(const_cast<JSCell*>(cell), visitor);
 }
 
+void SlotVisitor::visitChildrenForHeapSnapshot(JSCell* cell)
+{
+    // Edges appended while visiting this cell are attributed to it; anything
+    // appended outside of a visitChildren call is attributed to the root set.
+    m_heapSnapshot->appendNode(cell);
+    m_currentCell = cell;
+    cell->methodTable()->visitChildren(cell, *this);
+    m_currentCell = 0;
+}
+
 void SlotVisitor::donateKnownParallel()
 {
     StackStats::probe();
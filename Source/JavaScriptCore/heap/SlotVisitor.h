@@ -36,6 +36,7 @@ namespace JSC {
 class ConservativeRoots;
 class GCThreadSharedData;
 class Heap;
+class HeapSnapshot;
 template<typename T> class Weak;
 template<typename T> class WriteBarrierBase;
 template<typename T> class JITWriteBarrier;
@@ -84,6 +85,9 @@ public:
     void finalizeUnconditionalFinalizers();
 
     void copyLater(JSCell*, void*, size_t);
+
+    bool isTakingHeapSnapshot() const { return m_heapSnapshot; }
+    void visitChildrenForHeapSnapshot(JSCell*);
     
 #if ENABLE(SIMPLE_HEAP_PROFILING)
     VTableSpectrum m_visitedTypeCounts;
@@ -129,6 +133,9 @@ private:
     typedef HashMap<StringImpl*, JSValue> UniqueStringMap;
     UniqueStringMap m_uniqueStrings;
 
+    HeapSnapshot* m_heapSnapshot; // Local per-thread copy of the shared snapshot, non-null only while taking one.
+    JSCell* m_currentCell;
+
 #if ENABLE(OBJECT_MARK_LOGGING)
     unsigned m_logChildCount;
 #endif
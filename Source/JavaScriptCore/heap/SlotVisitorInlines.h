@@ -28,6 +28,7 @@
 
 #include "CopiedBlockInlines.h"
 #include "CopiedSpaceInlines.h"
+#include "HeapSnapshot.h"
 #include "Options.h"
 #include "SlotVisitor.h"
 #include "Weak.h"
@@ -175,6 +176,9 @@ inline void SlotVisitor::donateAndDrain()
 inline void SlotVisitor::copyLater(JSCell* owner, void* ptr, size_t bytes)
 {
     ASSERT(bytes);
+    if (UNLIKELY(isTakingHeapSnapshot()))
+        m_heapSnapshot->appendStorage(owner, bytes);
+
     CopiedBlock* block = CopiedSpace::blockFor(ptr);
     if (block->isOversize()) {
         m_shared.m_copiedSpace->pin(block);
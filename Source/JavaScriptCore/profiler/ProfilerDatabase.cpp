@@ -105,6 +105,34 @@ JSValue Database::toJS(ExecState* exec) const
         compilations->putDirectIndex(exec, i, m_compilations[i]->toJS(exec));
     result->putDirect(exec->vm(), exec->propertyNames().compilations, compilations);
     
+    result->putDirect(exec->vm(), exec->propertyNames().tiering, tieringCountersToJS(exec));
+    
+    return result;
+}
+
+static void appendTieringCounters(ExecState* exec, JSArray* array, CodeBlock* codeBlock)
+{
+    // The executable holds its newest code block, which is the DFG one once the function has
+    // been optimized, but the counters are kept on the baseline code block.
+    codeBlock = codeBlock->baselineVersion();
+    JSObject* entry = asObject(codeBlock->tieringCounters().toJS(exec, codeBlock));
+    entry->putDirect(exec->vm(), exec->propertyNames().inferredName, jsString(exec, codeBlock->inferredName()));
+    entry->putDirect(exec->vm(), exec->propertyNames().hash, jsString(exec, String::fromUTF8(toCString(codeBlock->hash()))));
+    array->push(exec, entry);
+}
+
+JSValue Database::tieringCountersToJS(ExecState* exec) const
+{
+    JSArray* result = constructEmptyArray(exec, 0);
+    for (ExecutableBase* current = m_vm.heap.m_compiledCode.head(); current; current = current->next()) {
+        if (!current->isFunctionExecutable())
+            continue;
+        FunctionExecutable* executable = static_cast<FunctionExecutable*>(current);
+        if (executable->isGeneratedForCall())
+            appendTieringCounters(exec, result, &executable->generatedBytecodeForCall());
+        if (executable->isGeneratedForConstruct())
+            appendTieringCounters(exec, result, &executable->generatedBytecodeForConstruct());
+    }
     return result;
 }
 
@@ -58,6 +58,11 @@ public:
     // object that is "clean" - i.e. array and object prototypes haven't had strange things
     // done to them. And yes, it should be appropriate to just use a globalExec here.
     JS_EXPORT_PRIVATE JSValue toJS(ExecState*) const;
+
+    // Returns the tiering counters of every live function as a JavaScript array. These are
+    // always collected, so a Database may be created just to call this or toJSON(), without
+    // having enabled the profiler.
+    JS_EXPORT_PRIVATE JSValue tieringCountersToJS(ExecState*) const;
     
     // Converts the database to a JavaScript object using a private temporary global object,
     // and then returns the JSON representation of that object.
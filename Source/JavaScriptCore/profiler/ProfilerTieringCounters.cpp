@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "ProfilerTieringCounters.h"
+
+#include "CodeBlock.h"
+#include "JSGlobalObject.h"
+#include "ObjectConstructor.h"
+#include "Operations.h"
+#include <wtf/CurrentTime.h>
+
+namespace JSC { namespace Profiler {
+
+static const char* const tierNames[] = { "LLInt", "Baseline", "DFG" };
+
+TieringCounters::TieringCounters()
+    : m_currentTier(NoTier)
+    , m_currentTierStartTime(0)
+    , m_numberOfJettisons(0)
+{
+    for (unsigned i = 0; i < NumberOfTiers; ++i) {
+        m_timeInTier[i] = 0;
+        m_numberOfCompilations[i] = 0;
+    }
+}
+
+TieringCounters::Tier TieringCounters::tierForJITType(JITCode::JITType jitType)
+{
+    switch (jitType) {
+    case JITCode::InterpreterThunk:
+        return LLIntTier;
+    case JITCode::BaselineJIT:
+        return BaselineTier;
+    case JITCode::DFGJIT:
+        return DFGTier;
+    default:
+        return NoTier;
+    }
+}
+
+void TieringCounters::didInstallCode(JITCode::JITType jitType)
+{
+    Tier tier = tierForJITType(jitType);
+    if (tier == NoTier)
+        return;
+
+    double now = monotonicallyIncreasingTime();
+    if (m_currentTier != NoTier)
+        m_timeInTier[m_currentTier] += now - m_currentTierStartTime;
+    m_currentTier = tier;
+    m_currentTierStartTime = now;
+    m_numberOfCompilations[tier]++;
+}
+
+void TieringCounters::didJettison(CodeBlock* optimizedCodeBlock)
+{
+    double now = monotonicallyIncreasingTime();
+    m_timeInTier[DFGTier] += now - m_currentTierStartTime;
+    m_currentTier = BaselineTier;
+    m_currentTierStartTime = now;
+    m_numberOfJettisons++;
+
+    addExitCounts(optimizedCodeBlock, m_exitCounts);
+}
+
+void TieringCounters::addExitCounts(CodeBlock* optimizedCodeBlock, Vector<uint64_t>& exitCounts)
+{
+#if ENABLE(DFG_JIT)
+    if (!optimizedCodeBlock->numberOfOSRExits())
+        return;
+    if (exitCounts.isEmpty())
+        exitCounts.fill(0, numberOfExitKinds);
+    for (unsigned i = 0; i < optimizedCodeBlock->numberOfOSRExits(); ++i) {
+        DFG::OSRExit& exit = optimizedCodeBlock->osrExit(i);
+        exitCounts[exit.m_kind] += exit.m_count;
+    }
+#else
+    UNUSED_PARAM(optimizedCodeBlock);
+    UNUSED_PARAM(exitCounts);
+#endif
+}
+
+JSValue TieringCounters::toJS(ExecState* exec, CodeBlock* baselineCodeBlock) const
+{
+    JSObject* result = constructEmptyObject(exec);
+
+    double timeInTier[NumberOfTiers];
+    for (unsigned i = 0; i < NumberOfTiers; ++i)
+        timeInTier[i] = m_timeInTier[i];
+    if (m_currentTier != NoTier)
+        timeInTier[m_currentTier] += monotonicallyIncreasingTime() - m_currentTierStartTime;
+
+    JSArray* tiers = constructEmptyArray(exec, 0);
+    for (unsigned i = 0; i < NumberOfTiers; ++i) {
+        JSObject* tier = constructEmptyObject(exec);
+        tier->putDirect(exec->vm(), exec->propertyNames().tier, jsString(exec, String(tierNames[i])));
+        tier->putDirect(exec->vm(), exec->propertyNames().installedTime, jsNumber(timeInTier[i]));
+        tier->putDirect(exec->vm(), exec->propertyNames().compilations, jsNumber(m_numberOfCompilations[i]));
+        tiers->putDirectIndex(exec, i, tier);
+    }
+    result->putDirect(exec->vm(), exec->propertyNames().tiers, tiers);
+    result->putDirect(exec->vm(), exec->propertyNames().jettisons, jsNumber(m_numberOfJettisons));
+
+    Vector<uint64_t> exitCounts = m_exitCounts;
+    CodeBlock* replacement = baselineCodeBlock->replacement();
+    if (replacement && replacement != baselineCodeBlock && JITCode::isOptimizingJIT(replacement->getJITType()))
+        addExitCounts(replacement, exitCounts);
+
+    JSArray* exits = constructEmptyArray(exec, 0);
+    for (unsigned kind = 0; kind < exitCounts.size(); ++kind) {
+        if (!exitCounts[kind])
+            continue;
+        JSObject* exit = constructEmptyObject(exec);
+        exit->putDirect(exec->vm(), exec->propertyNames().exitKind, jsString(exec, String(exitKindToString(static_cast<ExitKind>(kind)))));
+        exit->putDirect(exec->vm(), exec->propertyNames().count, jsNumber(exitCounts[kind]));
+        exits->push(exec, exit);
+    }
+    result->putDirect(exec->vm(), exec->propertyNames().osrExits, exits);
+
+    return result;
+}
+
+} } // namespace JSC::Profiler
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef ProfilerTieringCounters_h
+#define ProfilerTieringCounters_h
+
+#include "ExitKind.h"
+#include "JITCode.h"
+#include "JSCJSValue.h"
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+class CodeBlock;
+
+namespace Profiler {
+
+// Always-on record of how a function moved between execution tiers: how long each
+// tier's code was installed, how many times each tier compiled it, how often its
+// optimized code was jettisoned and how many OSR exits of each kind it took. One
+// of these lives in every baseline CodeBlock; the optimized CodeBlocks report to
+// the baseline one.
+class TieringCounters {
+public:
+    TieringCounters();
+
+    void didInstallCode(JITCode::JITType);
+    void didJettison(CodeBlock* optimizedCodeBlock);
+
+    unsigned numberOfJettisons() const { return m_numberOfJettisons; }
+
+    // Takes the baseline CodeBlock that owns these counters, so that the exits of
+    // its current optimized replacement can be included.
+    JSValue toJS(ExecState*, CodeBlock* baselineCodeBlock) const;
+
+private:
+    enum Tier { LLIntTier, BaselineTier, DFGTier, NumberOfTiers, NoTier = NumberOfTiers };
+
+    static Tier tierForJITType(JITCode::JITType);
+    static void addExitCounts(CodeBlock* optimizedCodeBlock, Vector<uint64_t>& exitCounts);
+
+    Tier m_currentTier;
+    double m_currentTierStartTime;
+    double m_timeInTier[NumberOfTiers];
+    unsigned m_numberOfCompilations[NumberOfTiers];
+    unsigned m_numberOfJettisons;
+
+    // Indexed by ExitKind. Empty until optimized code has been jettisoned.
+    Vector<uint64_t> m_exitCounts;
+};
+
+} } // namespace JSC::Profiler
+
+#endif // ProfilerTieringCounters_h
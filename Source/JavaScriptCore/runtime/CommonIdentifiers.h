@@ -89,10 +89,12 @@
     macro(index) \
     macro(inferredName) \
     macro(input) \
+    macro(installedTime) \
     macro(instructionCount) \
     macro(isArray) \
     macro(isPrototypeOf) \
     macro(isWatchpoint) \
+    macro(jettisons) \
     macro(join) \
     macro(lastIndex) \
     macro(length) \
@@ -116,6 +118,9 @@
     macro(sourceCode) \
     macro(stack) \
     macro(test) \
+    macro(tier) \
+    macro(tiering) \
+    macro(tiers) \
     macro(toExponential) \
     macro(toFixed) \
     macro(toISOString) \
@@ -47,11 +47,17 @@ static inline void appendNumber(StringBuilder& builder, int value)
         value = -value;
         --fillingZerosCount;
     }
-    String valueString = String::number(value);
-    fillingZerosCount -= valueString.length();
+    LChar digits[10];
+    int digitCount = 0;
+    do {
+        digits[digitCount++] = '0' + value % 10;
+        value /= 10;
+    } while (value);
+    fillingZerosCount -= digitCount;
     for (int i = 0; i < fillingZerosCount; ++i)
         builder.append('0');
-    builder.append(valueString);
+    while (digitCount)
+        builder.append(digits[--digitCount]);
 }
 
 template<>
@@ -76,7 +76,7 @@ namespace JSC {
         }
 
     private:
-        static const size_t cacheSize = 16;
+        static const size_t cacheSize = 256;
 
         struct CacheEntry {
             double key;
@@ -538,6 +538,17 @@ EncodedJSValue JSC_HOST_CALL dateProtoFuncToUTCString(ExecState* exec)
     return formateDateInstance(exec, DateTimeFormatDateAndTime, asUTCVariant);
 }
 
+// Writes a non-negative value as exactly the given number of digits, zero padded on the left.
+static inline LChar* appendDigits(LChar* buffer, int value, unsigned digits)
+{
+    ASSERT(value >= 0);
+    for (unsigned i = digits; i; --i) {
+        buffer[i - 1] = '0' + value % 10;
+        value /= 10;
+    }
+    return buffer + digits;
+}
+
 EncodedJSValue JSC_HOST_CALL dateProtoFuncToISOString(ExecState* exec)
 {
     JSValue thisValue = exec->hostThisValue();
@@ -551,25 +562,38 @@ EncodedJSValue JSC_HOST_CALL dateProtoFuncToISOString(ExecState* exec)
     const GregorianDateTime* gregorianDateTime = thisDateObj->gregorianDateTimeUTC(exec);
     if (!gregorianDateTime)
         return JSValue::encode(jsNontrivialString(exec, String(ASCIILiteral("Invalid Date"))));
-    // Maximum amount of space we need in buffer: 7 (max. digits in year) + 2 * 5 (2 characters each for month, day, hour, minute, second) + 4 (. + 3 digits for milliseconds)
-    // 6 for formatting and one for null termination = 28. We add one extra character to allow us to force null termination.
-    char buffer[28];
     // If the year is outside the bounds of 0 and 9999 inclusive we want to use the extended year format (ES 15.9.1.15.1).
     int ms = static_cast<int>(fmod(thisDateObj->internalNumber(), msPerSecond));
     if (ms < 0)
         ms += msPerSecond;
 
-    int charactersWritten;
-    if (gregorianDateTime->year() > 9999 || gregorianDateTime->year() < 0)
-        charactersWritten = snprintf(buffer, sizeof(buffer), "%+07d-%02d-%02dT%02d:%02d:%02d.%03dZ", gregorianDateTime->year(), gregorianDateTime->month() + 1, gregorianDateTime->monthDay(), gregorianDateTime->hour(), gregorianDateTime->minute(), gregorianDateTime->second(), ms);
-    else
-        charactersWritten = snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ", gregorianDateTime->year(), gregorianDateTime->month() + 1, gregorianDateTime->monthDay(), gregorianDateTime->hour(), gregorianDateTime->minute(), gregorianDateTime->second(), ms);
-
-    ASSERT(charactersWritten > 0 && static_cast<unsigned>(charactersWritten) < sizeof(buffer));
-    if (static_cast<unsigned>(charactersWritten) >= sizeof(buffer))
-        return JSValue::encode(jsEmptyString(exec));
-
-    return JSValue::encode(jsNontrivialString(exec, String(buffer, charactersWritten)));
+    // Maximum amount of space we need in buffer: 7 (sign and 6 digits of an extended year)
+    // + 2 * 5 (2 characters each for month, day, hour, minute, second) + 4 (. + 3 digits for
+    // milliseconds) + 6 for formatting = 27.
+    LChar buffer[27];
+    LChar* position = buffer;
+    int year = gregorianDateTime->year();
+    if (year > 9999 || year < 0) {
+        *position++ = year < 0 ? '-' : '+';
+        position = appendDigits(position, abs(year), 6);
+    } else
+        position = appendDigits(position, year, 4);
+    *position++ = '-';
+    position = appendDigits(position, gregorianDateTime->month() + 1, 2);
+    *position++ = '-';
+    position = appendDigits(position, gregorianDateTime->monthDay(), 2);
+    *position++ = 'T';
+    position = appendDigits(position, gregorianDateTime->hour(), 2);
+    *position++ = ':';
+    position = appendDigits(position, gregorianDateTime->minute(), 2);
+    *position++ = ':';
+    position = appendDigits(position, gregorianDateTime->second(), 2);
+    *position++ = '.';
+    position = appendDigits(position, ms, 3);
+    *position++ = 'Z';
+    ASSERT(position <= buffer + WTF_ARRAY_LENGTH(buffer));
+
+    return JSValue::encode(jsNontrivialString(exec, String(buffer, position - buffer)));
 }
 
 EncodedJSValue JSC_HOST_CALL dateProtoFuncToDateString(ExecState* exec)
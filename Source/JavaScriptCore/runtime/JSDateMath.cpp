@@ -127,6 +127,80 @@ static inline int msToWeekDay(double ms)
     return wd;
 }
 
+LocalTimeOffsetTable::LocalTimeOffsetTable()
+{
+    reset();
+}
+
+void LocalTimeOffsetTable::reset()
+{
+    for (int i = 0; i <= lastYear - firstYear; ++i)
+        m_years[i].state = YearEntry::NotComputed;
+}
+
+// NOTE: Like localTimeOffset() below, this relies on the fact that no time zones
+// have more than one daylight savings offset change per month.
+void LocalTimeOffsetTable::computeYear(int year, YearEntry& entry)
+{
+    entry.state = YearEntry::Computed;
+    entry.transitionCount = 0;
+
+    double monthStart = dateToDaysFrom1970(year, 0, 1) * msPerDay;
+    LocalTimeOffset monthStartOffset = calculateLocalTimeOffset(monthStart);
+    entry.offsets[0] = monthStartOffset;
+
+    for (int month = 1; month <= 12; ++month) {
+        double nextMonthStart = dateToDaysFrom1970(year + month / 12, month % 12, 1) * msPerDay;
+        LocalTimeOffset nextMonthStartOffset = calculateLocalTimeOffset(nextMonthStart);
+
+        if (monthStartOffset != nextMonthStartOffset) {
+            if (entry.transitionCount == maximumTransitionsPerYear) {
+                entry.state = YearEntry::Uncacheable;
+                return;
+            }
+
+            // The system computes offsets with one second granularity, so search for
+            // the first second that has the new offset.
+            double before = monthStart;
+            double after = nextMonthStart;
+            while (after - before > msPerSecond) {
+                double middle = before + floor((after - before) / (2 * msPerSecond)) * msPerSecond;
+                if (calculateLocalTimeOffset(middle) == monthStartOffset)
+                    before = middle;
+                else
+                    after = middle;
+            }
+
+            entry.transitionTimes[entry.transitionCount] = after;
+            entry.offsets[++entry.transitionCount] = nextMonthStartOffset;
+        }
+
+        monthStart = nextMonthStart;
+        monthStartOffset = nextMonthStartOffset;
+    }
+}
+
+bool LocalTimeOffsetTable::lookup(double ms, LocalTimeOffset& offset)
+{
+    static const double tableStart = dateToDaysFrom1970(firstYear, 0, 1) * msPerDay;
+    static const double tableEnd = dateToDaysFrom1970(lastYear + 1, 0, 1) * msPerDay;
+    if (!(ms >= tableStart && ms < tableEnd))
+        return false;
+
+    int year = msToYear(ms);
+    YearEntry& entry = m_years[year - firstYear];
+    if (entry.state == YearEntry::NotComputed)
+        computeYear(year, entry);
+    if (entry.state == YearEntry::Uncacheable)
+        return false;
+
+    unsigned index = 0;
+    while (index < entry.transitionCount && ms >= entry.transitionTimes[index])
+        ++index;
+    offset = entry.offsets[index];
+    return true;
+}
+
 // Get the combined UTC + DST offset for the time passed in.
 //
 // NOTE: The implementation relies on the fact that no time zones have
@@ -134,6 +208,10 @@ static inline int msToWeekDay(double ms)
 // If this function is called with NaN it returns NaN.
 static LocalTimeOffset localTimeOffset(ExecState* exec, double ms)
 {
+    LocalTimeOffset tableOffset;
+    if (exec->vm().localTimeOffsetTable.lookup(ms, tableOffset))
+        return tableOffset;
+
     LocalTimeOffsetCache& cache = exec->vm().localTimeOffsetCache;
     double start = cache.start;
     double end = cache.end;
@@ -238,13 +316,97 @@ double parseDateFromNullTerminatedCharacters(ExecState* exec, const char* dateSt
     return ms - (offset * WTF::msPerMinute);
 }
 
+template<typename CharType>
+static inline bool readDigits(const CharType* characters, unsigned count, int& result)
+{
+    result = 0;
+    for (unsigned i = 0; i < count; ++i) {
+        if (!isASCIIDigit(characters[i]))
+            return false;
+        result = result * 10 + characters[i] - '0';
+    }
+    return true;
+}
+
+// Parses the forms of the ES5 date time string format that toISOString() and JSON
+// serializers produce, YYYY-MM-DD[THH:mm[:ss[.sss]][Z]], directly from the string's
+// characters. Returns false if the string has to go through the general parsers, in
+// which case they will also handle any errors. The result is computed exactly the way
+// parseES5DateFromNullTerminatedCharacters() would compute it.
+template<typename CharType>
+static bool parseSimpleISODate(const CharType* characters, unsigned length, double& result)
+{
+    static const int daysPerMonth[12] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+    int year;
+    int month;
+    int day;
+    if (length < 10 || characters[4] != '-' || characters[7] != '-')
+        return false;
+    if (!readDigits(characters, 4, year) || !readDigits(characters + 5, 2, month) || !readDigits(characters + 8, 2, day))
+        return false;
+    if (month < 1 || month > 12 || day < 1 || day > daysPerMonth[month - 1])
+        return false;
+    if (month == 2 && day > 28 && !isLeapYear(year))
+        return false;
+
+    int hours = 0;
+    int minutes = 0;
+    double seconds = 0;
+    unsigned position = 10;
+    if (position < length) {
+        if (length < 16 || characters[10] != 'T' || characters[13] != ':')
+            return false;
+        if (!readDigits(characters + 11, 2, hours) || !readDigits(characters + 14, 2, minutes))
+            return false;
+        position = 16;
+
+        if (position < length && characters[position] == ':') {
+            int intSeconds;
+            if (length < position + 3 || !readDigits(characters + position + 1, 2, intSeconds))
+                return false;
+            seconds = intSeconds;
+            position += 3;
+
+            if (position < length && characters[position] == '.') {
+                int milliseconds;
+                if (length < position + 4 || !readDigits(characters + position + 1, 3, milliseconds))
+                    return false;
+                seconds += milliseconds * pow(10.0, -3.0);
+                position += 4;
+            }
+        }
+
+        if (position < length && characters[position] == 'Z')
+            ++position;
+        if (position != length)
+            return false;
+
+        // Leave 24:00 and leap seconds to the general parser.
+        if (hours > 23 || minutes > 59 || seconds >= 60)
+            return false;
+    }
+
+    double days = dateToDaysFrom1970(year, month - 1, day);
+    result = (((days * hoursPerDay + hours) * minutesPerHour + minutes) * secondsPerMinute + seconds) * msPerSecond;
+    return true;
+}
+
 double parseDate(ExecState* exec, const String& date)
 {
     if (date == exec->vm().cachedDateString)
         return exec->vm().cachedDateStringValue;
-    double value = parseES5DateFromNullTerminatedCharacters(date.utf8().data());
-    if (std::isnan(value))
-        value = parseDateFromNullTerminatedCharacters(exec, date.utf8().data());
+
+    double value;
+    bool parsed = date.is8Bit()
+        ? parseSimpleISODate(date.characters8(), date.length(), value)
+        : parseSimpleISODate(date.characters16(), date.length(), value);
+    if (!parsed) {
+        CString dateUTF8 = date.utf8();
+        value = parseES5DateFromNullTerminatedCharacters(dateUTF8.data());
+        if (std::isnan(value))
+            value = parseDateFromNullTerminatedCharacters(exec, dateUTF8.data());
+    }
     exec->vm().cachedDateString = date;
     exec->vm().cachedDateStringValue = value;
     return value;
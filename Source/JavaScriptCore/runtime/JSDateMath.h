@@ -50,6 +50,40 @@ namespace JSC {
 
 class ExecState;
 
+// Caches the local time offset, including daylight saving time, for each year that
+// the system time zone database covers directly. A year's DST transitions are located
+// the first time a date in that year is converted, after which looking up an offset is
+// a comparison against at most a handful of transition times.
+class LocalTimeOffsetTable {
+public:
+    LocalTimeOffsetTable();
+
+    void reset();
+
+    // Returns false if the time is outside the years covered by the table, or if its
+    // year has too many offset changes to be cached.
+    bool lookup(double ms, LocalTimeOffset&);
+
+private:
+    static const int firstYear = 1970;
+    static const int lastYear = 2037;
+    static const unsigned maximumTransitionsPerYear = 4;
+
+    struct YearEntry {
+        enum State { NotComputed, Computed, Uncacheable };
+
+        State state;
+        unsigned transitionCount;
+        // offsets[i + 1] applies from transitionTimes[i] (inclusive) onwards.
+        double transitionTimes[maximumTransitionsPerYear];
+        LocalTimeOffset offsets[maximumTransitionsPerYear + 1];
+    };
+
+    void computeYear(int year, YearEntry&);
+
+    YearEntry m_years[lastYear - firstYear + 1];
+};
+
 void msToGregorianDateTime(ExecState*, double, bool outputIsUTC, GregorianDateTime&);
 double gregorianDateTimeToMS(ExecState*, const GregorianDateTime&, double, bool inputIsUTC);
 double getUTCOffset(ExecState*);
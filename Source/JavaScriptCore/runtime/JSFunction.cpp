@@ -117,6 +117,49 @@ ObjectAllocationProfile* JSFunction::createAllocationProfile(ExecState* exec, si
     return &m_allocationProfile;
 }
 
+bool JSFunction::didSpillFromAllocationProfile(Structure* structure)
+{
+    if (m_allocationProfile.isNull())
+        return false;
+
+    Structure* allocationStructure = m_allocationProfile.structure();
+    if (allocationStructure->inlineCapacity() != structure->inlineCapacity())
+        return false;
+    if (allocationStructure->inlineCapacity() >= JSFinalObject::maxInlineCapacity())
+        return false;
+
+    for (Structure* current = structure; current != allocationStructure; current = current->previousID()) {
+        if (!current)
+            return false;
+    }
+
+    // Keep the structure so that the next createAllocationProfile() can see how many
+    // properties the objects allocated from it end up with.
+    m_allocationProfile.clearAllocator();
+    m_allocationProfileWatchpoint.notifyWrite();
+    return true;
+}
+
+void JSFunction::didSpillOutOfLine(VM& vm, Structure* structure)
+{
+    // The object that made the transition is most likely still being built up by its
+    // constructor, either directly or through helpers it calls, so the constructor is
+    // usually only a few frames up. Inlined frames are searched too, since the
+    // constructor may have been inlined into its caller.
+    static const unsigned maximumFramesToSearch = 64;
+
+    CallFrame* callFrame = vm.topCallFrame->removeHostCallFrameFlag();
+    if (!callFrame)
+        return;
+    callFrame = callFrame->trueCallFrameFromVMCode();
+    for (unsigned i = 0; callFrame && i < maximumFramesToSearch; ++i) {
+        JSObject* callee = callFrame->callee();
+        if (callee && callee->inherits(&s_info) && jsCast<JSFunction*>(callee)->didSpillFromAllocationProfile(structure))
+            return;
+        callFrame = callFrame->trueCallerFrame();
+    }
+}
+
 String JSFunction::name(ExecState* exec)
 {
     return get(exec, exec->vm().propertyNames->name).toWTFString(exec);
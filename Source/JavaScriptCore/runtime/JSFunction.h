@@ -154,6 +154,16 @@ namespace JSC {
             m_allocationProfileWatchpoint.add(watchpoint);
         }
 
+        // Called when an object whose structure derives from this function's allocation
+        // profile has spilled into out-of-line storage. Returns true if the profile was
+        // reset so that the next allocation can size its inline storage to fit.
+        bool didSpillFromAllocationProfile(Structure*);
+
+        // Called when a structure transition first moves objects into out-of-line storage.
+        // Tells the function on the stack, if any, whose allocation profile vended the root
+        // of the transition chain.
+        static void didSpillOutOfLine(VM&, Structure*);
+
     protected:
         const static unsigned StructureFlags = OverridesGetOwnPropertySlot | ImplementsHasInstance | OverridesVisitChildren | OverridesGetPropertyNames | JSObject::StructureFlags;
 
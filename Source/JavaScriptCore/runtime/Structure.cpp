@@ -27,6 +27,7 @@
 #include "Structure.h"
 
 #include "CodeBlock.h"
+#include "JSFunction.h"
 #include "JSObject.h"
 #include "JSPropertyNameIterator.h"
 #include "Lookup.h"
@@ -161,6 +162,7 @@ Structure::Structure(VM& vm, JSGlobalObject* globalObject, JSValue prototype, co
     , m_typeInfo(typeInfo)
     , m_indexingType(indexingType)
     , m_inlineCapacity(inlineCapacity)
+    , m_largestDerivedPropertyCount(0)
     , m_dictionaryKind(NoneDictionaryKind)
     , m_isPinnedPropertyTable(false)
     , m_hasGetterSetterProperties(false)
@@ -188,6 +190,7 @@ Structure::Structure(VM& vm)
     , m_typeInfo(CompoundType, OverridesVisitChildren)
     , m_indexingType(0)
     , m_inlineCapacity(0)
+    , m_largestDerivedPropertyCount(0)
     , m_dictionaryKind(NoneDictionaryKind)
     , m_isPinnedPropertyTable(false)
     , m_hasGetterSetterProperties(false)
@@ -210,6 +213,7 @@ Structure::Structure(VM& vm, const Structure* previous)
     , m_typeInfo(previous->typeInfo().type(), previous->typeInfo().flags() & ~StructureHasRareData)
     , m_indexingType(previous->indexingTypeIncludingHistory())
     , m_inlineCapacity(previous->m_inlineCapacity)
+    , m_largestDerivedPropertyCount(0)
     , m_dictionaryKind(previous->m_dictionaryKind)
     , m_isPinnedPropertyTable(false)
     , m_hasGetterSetterProperties(previous->m_hasGetterSetterProperties)
@@ -386,9 +390,33 @@ Structure* Structure::addPropertyTransition(VM& vm, Structure* structure, Proper
     structure->m_transitionTable.add(vm, transition);
     transition->checkOffsetConsistency();
     structure->checkOffsetConsistency();
+
+    if (isOutOfLineOffset(transition->m_offset)) {
+        transition->didSpillOutOfLine();
+
+        // Every path that adds a property, including the JIT's transition stubs, has to
+        // create the transition before it can use it, so this is where the first object to
+        // spill into out-of-line storage is seen.
+        if (!structure->outOfLineCapacity())
+            JSFunction::didSpillOutOfLine(vm, transition);
+    }
     return transition;
 }
 
+void Structure::didSpillOutOfLine()
+{
+    // Record on the first structure of the transition chain how many properties the
+    // objects built from it have grown to, so that an allocation profile vending that
+    // structure can give the next objects enough inline storage for all of them.
+    Structure* root = this;
+    while (Structure* previous = root->previousID())
+        root = previous;
+
+    unsigned propertyCount = std::min<unsigned>(totalStorageSize(), std::numeric_limits<uint8_t>::max());
+    if (propertyCount > root->m_largestDerivedPropertyCount)
+        root->m_largestDerivedPropertyCount = propertyCount;
+}
+
 Structure* Structure::removePropertyTransition(VM& vm, Structure* structure, PropertyName propertyName, PropertyOffset& offset)
 {
     ASSERT(!structure->isUncacheableDictionary());
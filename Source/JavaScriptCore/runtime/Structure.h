@@ -207,6 +207,12 @@ public:
     {
         return numberOfSlotsForLastOffset(m_offset, m_inlineCapacity);
     }
+    // The largest number of properties reached by a structure in the transition tree
+    // rooted at this one, once that tree has spilled into out-of-line storage.
+    unsigned largestDerivedPropertyCount() const
+    {
+        return m_largestDerivedPropertyCount;
+    }
     unsigned totalStorageCapacity() const
     {
         ASSERT(structure()->classInfo() == &s_info);
@@ -369,6 +375,8 @@ private:
     bool despecifyFunction(VM&, PropertyName);
     void despecifyAllFunctions(VM&);
 
+    void didSpillOutOfLine();
+
     WriteBarrier<PropertyTable>& propertyTable();
     PropertyTable* takePropertyTableOrCloneIfPinned(VM&, Structure* owner);
     PropertyTable* copyPropertyTable(VM&, Structure* owner);
@@ -464,6 +472,7 @@ private:
     IndexingType m_indexingType;
 
     uint8_t m_inlineCapacity;
+    uint8_t m_largestDerivedPropertyCount;
     unsigned m_dictionaryKind : 2;
     bool m_isPinnedPropertyTable : 1;
     bool m_hasGetterSetterProperties : 1;
@@ -26,6 +26,7 @@
 #ifndef StructureInlines_h
 #define StructureInlines_h
 
+#include "HeapSnapshot.h"
 #include "JSGlobalObject.h"
 #include "PropertyMapHashTable.h"
 #include "Structure.h"
@@ -92,6 +93,8 @@ ALWAYS_INLINE void SlotVisitor::internalAppend(JSCell* cell)
 #if ENABLE(GC_VALIDATION)
     validate(cell);
 #endif
+    if (UNLIKELY(isTakingHeapSnapshot()))
+        m_heapSnapshot->appendEdge(m_currentCell, cell);
     if (Heap::testAndSetMarked(cell) || !cell->structure())
         return;
 
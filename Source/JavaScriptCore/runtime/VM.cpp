@@ -425,6 +425,7 @@ VM::ClientData::~ClientData()
 void VM::resetDateCache()
 {
     localTimeOffsetCache.reset();
+    localTimeOffsetTable.reset();
     cachedDateString = String();
     cachedDateStringValue = QNaN;
     dateInstanceCache.reset();
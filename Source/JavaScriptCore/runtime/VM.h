@@ -374,6 +374,7 @@ namespace JSC {
         HashSet<JSObject*> stringRecursionCheckVisitedObjects;
 
         LocalTimeOffsetCache localTimeOffsetCache;
+        LocalTimeOffsetTable localTimeOffsetTable;
         
         String cachedDateString;
         double cachedDateStringValue;
@@ -38,13 +38,24 @@ Watchdog::Watchdog()
     : m_timerDidFire(false)
     , m_didFire(false)
     , m_limit(NO_LIMIT)
-    , m_startTime(0)
-    , m_elapsedTime(0)
+    , m_limitStartTime(0)
+    , m_budget(NO_LIMIT)
+    , m_yieldInterval(NO_LIMIT)
+    , m_lastYieldTime(0)
+    , m_cpuTime(0)
+    , m_accountingStartTime(0)
     , m_reentryCount(0)
     , m_isStopped(true)
+    , m_isAccounting(false)
     , m_callback(0)
     , m_callbackData1(0)
     , m_callbackData2(0)
+    , m_budgetCallback(0)
+    , m_budgetCallbackData1(0)
+    , m_budgetCallbackData2(0)
+    , m_yieldCallback(0)
+    , m_yieldCallbackData1(0)
+    , m_yieldCallbackData2(0)
 {
     initTimer();
 }
@@ -71,22 +82,115 @@ void Watchdog::setTimeLimit(VM& vm, double limit,
     m_callbackData1 = data1;
     m_callbackData2 = data2;
 
-    // If this is the first time that timeout is being enabled, then any
+    // A new limit applies to the script that is currently running from now on.
+    if (isArmed())
+        m_limitStartTime = currentCPUTime();
+
+    didChangeConfiguration(vm, wasEnabled);
+}
+
+void Watchdog::setBudget(VM& vm, double budget,
+    ShouldTerminateCallback callback, void* data1, void* data2)
+{
+    bool wasEnabled = isEnabled();
+
+    if (!m_isStopped)
+        stopCountdown();
+
+    // Charge the time used so far to the old budget before replacing it.
+    if (m_isAccounting)
+        updateAccounting(currentCPUTime());
+
+    m_didFire = false;
+
+    m_budget = budget;
+    m_budgetCallback = callback;
+    m_budgetCallbackData1 = data1;
+    m_budgetCallbackData2 = data2;
+
+    didChangeConfiguration(vm, wasEnabled);
+}
+
+double Watchdog::remainingBudget()
+{
+    if (m_isAccounting)
+        updateAccounting(currentCPUTime());
+    return m_budget;
+}
+
+void Watchdog::setYieldInterval(VM& vm, double interval,
+    YieldCallback callback, void* data1, void* data2)
+{
+    bool wasEnabled = isEnabled();
+
+    if (!m_isStopped)
+        stopCountdown();
+
+    m_yieldInterval = callback ? interval : NO_LIMIT;
+    m_yieldCallback = callback;
+    m_yieldCallbackData1 = data1;
+    m_yieldCallbackData2 = data2;
+
+    if (isArmed())
+        m_lastYieldTime = currentCPUTime();
+
+    didChangeConfiguration(vm, wasEnabled);
+}
+
+double Watchdog::cpuTime()
+{
+    if (m_isAccounting)
+        updateAccounting(currentCPUTime());
+    return m_cpuTime;
+}
+
+void Watchdog::didChangeConfiguration(VM& vm, bool wasEnabled)
+{
+    // If this is the first time that the watchdog is being enabled, then any
     // previously JIT compiled code will not have the needed polling checks.
     // Hence, we need to flush all the pre-existing compiled code.
     //
-    // However, if the timeout is already enabled, and we're just changing the
+    // However, if the watchdog is already enabled, and we're just changing the
     // timeout value, then any existing JITted code will have the appropriate
     // polling checks. Hence, there is no need to re-do this flushing.
-    if (!wasEnabled) {
+    if (!wasEnabled && isEnabled()) {
         // And if we've previously compiled any functions, we need to revert
         // them because they don't have the needed polling checks yet.
         vm.releaseExecutableMemory();
     }
 
+    // Script that is already running starts being accounted for now.
+    if (isArmed() && !m_isAccounting && isEnabled())
+        startAccounting(currentCPUTime());
+
     startCountdownIfNeeded();
 }
 
+void Watchdog::startAccounting(double currentTime)
+{
+    m_isAccounting = true;
+    m_accountingStartTime = currentTime;
+    m_limitStartTime = currentTime;
+    m_lastYieldTime = currentTime;
+}
+
+void Watchdog::updateAccounting(double currentTime)
+{
+    double deltaTime = currentTime - m_accountingStartTime;
+    m_cpuTime += deltaTime;
+    if (m_budget != NO_LIMIT)
+        m_budget -= deltaTime;
+    m_accountingStartTime = currentTime;
+}
+
+double Watchdog::nextDeadline()
+{
+    double deadline = m_limitStartTime + m_limit;
+    deadline = std::min(deadline, m_lastYieldTime + m_yieldInterval);
+    deadline = std::min(deadline, m_accountingStartTime + m_budget);
+    return deadline;
+}
+
 bool Watchdog::didFire(ExecState* exec)
 {
     if (m_didFire)
@@ -98,10 +202,10 @@ bool Watchdog::didFire(ExecState* exec)
     stopCountdown();
 
     double currentTime = currentCPUTime();
-    double deltaTime = currentTime - m_startTime;
-    double totalElapsedTime = m_elapsedTime + deltaTime;
-    if (totalElapsedTime > m_limit) {
-        // Case 1: the allowed CPU time has elapsed.
+    updateAccounting(currentTime);
+
+    if (currentTime - m_limitStartTime > m_limit) {
+        // Case 1: the allowed CPU time for this script execution has elapsed.
 
         // If m_callback is not set, then we terminate by default.
         // Else, we let m_callback decide if we should terminate or not.
@@ -112,27 +216,43 @@ bool Watchdog::didFire(ExecState* exec)
             return true;
         }
 
-        // The m_callback may have set a new limit. So, we may need to restart
-        // the countdown.
-        startCountdownIfNeeded();
+        // The script gets another period of the (possibly new) limit.
+        m_limitStartTime = currentCPUTime();
+    }
+
+    if (m_budget <= 0) {
+        // Case 2: the CPU time budget of this VM has run out.
+        bool needsTermination = !m_budgetCallback
+            || m_budgetCallback(exec, m_budgetCallbackData1, m_budgetCallbackData2);
+        if (needsTermination) {
+            m_didFire = true;
+            return true;
+        }
 
-    } else {
-        // Case 2: the allowed CPU time has NOT elapsed.
+        // The callback may have granted more time. If it did not, stop
+        // enforcing the budget rather than calling back again immediately.
+        updateAccounting(currentCPUTime());
+        if (m_budget <= 0)
+            m_budget = NO_LIMIT;
+    }
 
-        // Tell the timer to alarm us again when it thinks we've reached the
-        // end of the allowed time.
-        double remainingTime = m_limit - totalElapsedTime;
-        m_elapsedTime = totalElapsedTime;
-        m_startTime = currentTime;
-        startCountdown(remainingTime);
+    if (currentTime - m_lastYieldTime >= m_yieldInterval) {
+        // Case 3: it is time to let the embedder run.
+        m_yieldCallback(exec, m_yieldCallbackData1, m_yieldCallbackData2);
+        m_lastYieldTime = currentCPUTime();
     }
 
+    // Tell the timer to alarm us again at the next deadline. The callbacks may
+    // have reconfigured the watchdog and restarted the countdown already, so
+    // start over from the final state.
+    stopCountdown();
+    startCountdownIfNeeded();
     return false;
 }
 
 bool Watchdog::isEnabled()
 {
-    return (m_limit != NO_LIMIT);
+    return m_limit != NO_LIMIT || m_budget != NO_LIMIT || m_yieldInterval != NO_LIMIT;
 }
 
 void Watchdog::fire()
@@ -143,15 +263,22 @@ void Watchdog::fire()
 void Watchdog::arm()
 {
     m_reentryCount++;
-    if (m_reentryCount == 1)
+    if (m_reentryCount == 1 && isEnabled()) {
+        startAccounting(currentCPUTime());
         startCountdownIfNeeded();
+    }
 }
 
 void Watchdog::disarm()
 {
     ASSERT(m_reentryCount > 0);
-    if (m_reentryCount == 1)
+    if (m_reentryCount == 1) {
         stopCountdown();
+        if (m_isAccounting) {
+            updateAccounting(currentCPUTime());
+            m_isAccounting = false;
+        }
+    }
     m_reentryCount--;
 }
 
@@ -163,11 +290,8 @@ void Watchdog::startCountdownIfNeeded()
     if (!isArmed())
         return; // Not executing JS script. No need to start.
 
-    if (isEnabled()) {
-        m_elapsedTime = 0;
-        m_startTime = currentCPUTime();
-        startCountdown(m_limit);
-    }
+    if (isEnabled())
+        startCountdown(std::max(nextDeadline() - currentCPUTime(), 0.0));
 }
 
 void Watchdog::startCountdown(double limit)
@@ -28,6 +28,8 @@
 
 #if PLATFORM(MAC) || PLATFORM(IOS)
 #include <dispatch/dispatch.h>    
+#else
+#include <wtf/Threading.h>
 #endif
 
 namespace JSC {
@@ -45,6 +47,23 @@ public:
     typedef bool (*ShouldTerminateCallback)(ExecState*, void* data1, void* data2);
     void setTimeLimit(VM&, double seconds, ShouldTerminateCallback = 0, void* data1 = 0, void* data2 = 0);
 
+    // Unlike the time limit, which restarts with every outermost script
+    // execution, the budget is shared by all script executions in the VM and
+    // only goes down. When it runs out, the callback decides whether to
+    // terminate. The callback may grant more time by calling setBudget();
+    // if it does not, the budget is cleared.
+    void setBudget(VM&, double seconds, ShouldTerminateCallback = 0, void* data1 = 0, void* data2 = 0);
+    double remainingBudget();
+
+    // Interrupts running script after every interval seconds of CPU time and
+    // calls the callback, e.g. to service the embedder's event loop. The script
+    // then resumes where it left off.
+    typedef void (*YieldCallback)(ExecState*, void* data1, void* data2);
+    void setYieldInterval(VM&, double seconds, YieldCallback = 0, void* data1 = 0, void* data2 = 0);
+
+    // Total CPU time spent executing script in this VM.
+    double cpuTime();
+
     // This version of didFire() will check the elapsed CPU time and call the
     // callback (if needed) to determine if the watchdog should fire.
     bool didFire(ExecState*);
@@ -62,6 +81,10 @@ public:
 private:
     void arm();
     void disarm();
+    void didChangeConfiguration(VM&, bool wasEnabled);
+    void startAccounting(double currentTime);
+    void updateAccounting(double currentTime);
+    double nextDeadline();
     void startCountdownIfNeeded();
     void startCountdown(double limit);
     void stopCountdown();
@@ -81,21 +104,46 @@ private:
     bool m_timerDidFire;
     bool m_didFire;
 
-    // All time units are in seconds.
+    // All time units are in seconds of CPU time.
     double m_limit;
-    double m_startTime;
-    double m_elapsedTime;
+    double m_limitStartTime;
+    double m_budget;
+    double m_yieldInterval;
+    double m_lastYieldTime;
+    double m_cpuTime;
+    double m_accountingStartTime;
 
     int m_reentryCount;
     bool m_isStopped;
 
+    // CPU time is only measured while armed and enabled, so that entering
+    // script does not pay for a clock read when nothing is being enforced.
+    bool m_isAccounting;
+
     ShouldTerminateCallback m_callback;
     void* m_callbackData1;
     void* m_callbackData2;
 
+    ShouldTerminateCallback m_budgetCallback;
+    void* m_budgetCallbackData1;
+    void* m_budgetCallbackData2;
+
+    YieldCallback m_yieldCallback;
+    void* m_yieldCallbackData1;
+    void* m_yieldCallbackData2;
+
 #if PLATFORM(MAC) || PLATFORM(IOS)
     dispatch_queue_t m_queue;
     dispatch_source_t m_timer;
+#else
+    static void timerThreadStartFunc(void*);
+    void runTimerThread();
+
+    ThreadIdentifier m_timerThread;
+    Mutex m_timerLock;
+    ThreadCondition m_timerCondition;
+    double m_timerDeadline; // In wall clock time; 0 when the timer is stopped.
+    bool m_timerThreadShouldExit;
 #endif
 
     friend class Watchdog::Scope;
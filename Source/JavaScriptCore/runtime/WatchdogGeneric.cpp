@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "Watchdog.h"
+
+#include <wtf/CurrentTime.h>
+
+namespace JSC {
+
+// This implementation runs the timer on a helper thread, created the first
+// time the watchdog is armed with a limit, which sleeps until the deadline.
+
+void Watchdog::initTimer()
+{
+    m_timerThread = 0;
+    m_timerDeadline = 0;
+    m_timerThreadShouldExit = false;
+}
+
+void Watchdog::destroyTimer()
+{
+    if (!m_timerThread)
+        return;
+
+    {
+        MutexLocker locker(m_timerLock);
+        m_timerThreadShouldExit = true;
+        m_timerCondition.signal();
+    }
+    waitForThreadCompletion(m_timerThread);
+}
+
+void Watchdog::startTimer(double limit)
+{
+    MutexLocker locker(m_timerLock);
+    m_timerDeadline = currentTime() + limit;
+    if (!m_timerThread)
+        m_timerThread = createThread(timerThreadStartFunc, this, "JavaScriptCore::Watchdog");
+    m_timerCondition.signal();
+}
+
+void Watchdog::stopTimer()
+{
+    // Once this returns, the timer thread can no longer set m_timerDidFire for
+    // the deadline being cancelled, since it only does so while holding the lock.
+    MutexLocker locker(m_timerLock);
+    m_timerDeadline = 0;
+}
+
+void Watchdog::timerThreadStartFunc(void* watchdog)
+{
+    static_cast<Watchdog*>(watchdog)->runTimerThread();
+}
+
+void Watchdog::runTimerThread()
+{
+    MutexLocker locker(m_timerLock);
+    while (!m_timerThreadShouldExit) {
+        if (!m_timerDeadline) {
+            m_timerCondition.wait(m_timerLock);
+            continue;
+        }
+
+        if (currentTime() >= m_timerDeadline) {
+            m_timerDidFire = true;
+            m_timerDeadline = 0;
+            continue;
+        }
+
+        m_timerCondition.timedWait(m_timerLock, m_timerDeadline);
+    }
+}
+
+} // namespace JSC
@@ -32,6 +32,7 @@ HEADERS += \
     BitVector.h \
     BloomFilter.h \
     BoundsCheckedPointer.h \
+    BumpArena.h \
     BumpPointerAllocator.h \
     ByteOrder.h \
     CheckedArithmetic.h \
@@ -71,6 +72,7 @@ HEADERS += \
     Functional.h \
     GetPtr.h \
     GregorianDateTime.h \
+    GroupProbingHashTable.h \
     HashCountedSet.h \
     HashFunctions.h \
     HashIterators.h \
@@ -88,6 +90,7 @@ HEADERS += \
     MathExtras.h \
     MD5.h \
     MediaTime.h \
+    MemoryUsageRegistry.h \
     MessageQueue.h \
     MetaAllocator.h \
     MetaAllocatorHandle.h \
@@ -155,11 +158,13 @@ HEADERS += \
     text/StringHash.h \
     text/StringImpl.h \
     text/StringOperators.h \
+    text/StringSIMD.h \
     text/TextPosition.h \
     text/WTFString.h \
     threads/BinarySemaphore.h \
     Threading.h \
     ThreadingPrimitives.h \
+    ThreadPool.h \
     ThreadRestrictionVerifier.h \
     ThreadSafeRefCounted.h \
     ThreadSpecific.h \
@@ -189,6 +194,7 @@ SOURCES += \
     ArrayBufferView.cpp \
     Assertions.cpp \
     BitVector.cpp \
+    BumpArena.cpp \
     CryptographicallyRandomNumber.cpp \
     CurrentTime.cpp \
     DateMath.cpp \
@@ -213,6 +219,7 @@ SOURCES += \
     MD5.cpp \
     MainThread.cpp \
     MediaTime.cpp \
+    MemoryUsageRegistry.cpp \
     MetaAllocator.cpp \
     NullPtr.cpp \
     NumberOfCores.cpp \
@@ -231,6 +238,7 @@ SOURCES += \
     StringPrintStream.cpp \
     SysLog.cpp \
     TCSystemAlloc.cpp \
+    ThreadPool.cpp \
     Threading.cpp \
     TypeTraits.cpp \
     WTFThreadData.cpp \
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "BumpArena.h"
+
+#include <algorithm>
+
+namespace WTF {
+
+BumpArena::~BumpArena()
+{
+    while (m_chunks) {
+        Chunk* next = m_chunks->next;
+        fastFree(m_chunks);
+        m_chunks = next;
+    }
+}
+
+BumpArena::Chunk* BumpArena::allocateChunk(size_t dataSize)
+{
+    Chunk* chunk = static_cast<Chunk*>(fastMalloc(roundUpToAlignment(sizeof(Chunk)) + dataSize));
+    chunk->size = dataSize;
+    return chunk;
+}
+
+void* BumpArena::allocateSlowCase(size_t size)
+{
+    ASSERT(size == roundUpToAlignment(size));
+
+    // Large allocations get a chunk of their own, placed behind the current one so that it can
+    // keep serving small allocations.
+    if (size > m_chunkSize / 4) {
+        Chunk* chunk = allocateChunk(size);
+        if (m_chunks) {
+            chunk->next = m_chunks->next;
+            m_chunks->next = chunk;
+        } else {
+            chunk->next = 0;
+            m_chunks = chunk;
+            m_current = m_end = chunkData(chunk) + size;
+        }
+        m_lastAllocation = 0;
+        return chunkData(chunk);
+    }
+
+    Chunk* chunk = allocateChunk(m_chunkSize);
+    chunk->next = m_chunks;
+    m_chunks = chunk;
+    m_current = chunkData(chunk);
+    m_end = m_current + m_chunkSize;
+    return allocate(size);
+}
+
+void* BumpArena::reallocate(void* p, size_t oldSize, size_t newSize)
+{
+    if (!p)
+        return allocate(newSize);
+
+    if (p == m_lastAllocation) {
+        size_t roundedSize = roundUpToAlignment(newSize);
+        if (roundedSize <= static_cast<size_t>(m_end - m_lastAllocation)) {
+            m_current = m_lastAllocation + roundedSize;
+            return p;
+        }
+    }
+
+    void* result = allocate(newSize);
+    memcpy(result, p, std::min(oldSize, newSize));
+    return result;
+}
+
+void BumpArena::reset()
+{
+    Chunk* keptChunk = 0;
+    while (m_chunks) {
+        Chunk* next = m_chunks->next;
+        if (!keptChunk && m_chunks->size == m_chunkSize)
+            keptChunk = m_chunks;
+        else
+            fastFree(m_chunks);
+        m_chunks = next;
+    }
+
+    m_lastAllocation = 0;
+    if (!keptChunk) {
+        m_current = m_end = 0;
+        return;
+    }
+    keptChunk->next = 0;
+    m_chunks = keptChunk;
+    m_current = chunkData(keptChunk);
+    m_end = m_current + m_chunkSize;
+}
+
+} // namespace WTF
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BumpArena_h
+#define BumpArena_h
+
+#include <string.h>
+#include <wtf/FastAllocBase.h>
+#include <wtf/Noncopyable.h>
+
+namespace WTF {
+
+// A region for short-lived scratch data. Allocation bumps a pointer through chunks obtained
+// from fastMalloc, individual deallocations are no-ops unless they undo the latest allocation,
+// and everything is released at once by reset() or by destroying the arena. Objects placed in
+// the arena do not have their destructors run.
+class BumpArena {
+    WTF_MAKE_NONCOPYABLE(BumpArena); WTF_MAKE_FAST_ALLOCATED;
+public:
+    static const size_t defaultChunkSize = 16 * 1024;
+    static const size_t alignment = 2 * sizeof(void*);
+
+    explicit BumpArena(size_t chunkSize = defaultChunkSize);
+    WTF_EXPORT_PRIVATE ~BumpArena();
+
+    void* allocate(size_t size)
+    {
+        size = roundUpToAlignment(size);
+        if (UNLIKELY(size > static_cast<size_t>(m_end - m_current)))
+            return allocateSlowCase(size);
+        m_lastAllocation = m_current;
+        m_current += size;
+        return m_lastAllocation;
+    }
+
+    // Grows or shrinks the latest allocation in place when possible.
+    WTF_EXPORT_PRIVATE void* reallocate(void*, size_t oldSize, size_t newSize);
+
+    void deallocate(void* p)
+    {
+        if (p && p == m_lastAllocation) {
+            m_current = m_lastAllocation;
+            m_lastAllocation = 0;
+        }
+    }
+
+    // Releases every allocation. One chunk is kept for the next use of the arena.
+    WTF_EXPORT_PRIVATE void reset();
+
+    size_t chunkSize() const { return m_chunkSize; }
+
+    static size_t roundUpToAlignment(size_t size) { return (size + alignment - 1) & ~(alignment - 1); }
+
+private:
+    struct Chunk {
+        Chunk* next;
+        size_t size;
+    };
+
+    static char* chunkData(Chunk* chunk) { return reinterpret_cast<char*>(chunk) + roundUpToAlignment(sizeof(Chunk)); }
+
+    WTF_EXPORT_PRIVATE void* allocateSlowCase(size_t);
+    Chunk* allocateChunk(size_t dataSize);
+
+    char* m_current;
+    char* m_end;
+    char* m_lastAllocation;
+    Chunk* m_chunks;
+    size_t m_chunkSize;
+};
+
+inline BumpArena::BumpArena(size_t chunkSize)
+    : m_current(0)
+    , m_end(0)
+    , m_lastAllocation(0)
+    , m_chunks(0)
+    , m_chunkSize(roundUpToAlignment(chunkSize))
+{
+}
+
+// Lets Vector, HashMap and HashSet put their buffers in a BumpArena, which must outlive them.
+// A default-constructed allocator, such as the one a container is left with after being moved
+// from, uses fastMalloc.
+class BumpArenaAllocator {
+public:
+    // Buffers are not fastMalloc'ed, so Vector::releaseBuffer() copies them.
+    static const bool usesFastMalloc = false;
+
+    BumpArenaAllocator()
+        : m_arena(0)
+    {
+    }
+
+    explicit BumpArenaAllocator(BumpArena& arena)
+        : m_arena(&arena)
+    {
+    }
+
+    BumpArena* arena() const { return m_arena; }
+
+    void* allocate(size_t size) { return m_arena ? m_arena->allocate(size) : fastMalloc(size); }
+
+    void* allocateZeroed(size_t size)
+    {
+        if (!m_arena)
+            return fastZeroedMalloc(size);
+        void* result = m_arena->allocate(size);
+        memset(result, 0, size);
+        return result;
+    }
+
+    TryMallocReturnValue tryAllocate(size_t size) { return m_arena ? m_arena->allocate(size) : tryFastMalloc(size); }
+
+    void* reallocate(void* p, size_t oldSize, size_t newSize) { return m_arena ? m_arena->reallocate(p, oldSize, newSize) : fastRealloc(p, newSize); }
+
+    void deallocate(void* p)
+    {
+        if (m_arena)
+            m_arena->deallocate(p);
+        else
+            fastFree(p);
+    }
+
+    size_t goodSize(size_t size) const { return m_arena ? BumpArena::roundUpToAlignment(size) : fastMallocGoodSize(size); }
+
+private:
+    BumpArena* m_arena;
+};
+
+} // namespace WTF
+
+using WTF::BumpArena;
+using WTF::BumpArenaAllocator;
+
+#endif // BumpArena_h
@@ -63,6 +63,10 @@
 #include <QElapsedTimer>
 #endif
 
+#if OS(LINUX)
+#include <time.h>
+#endif
+
 namespace WTF {
 
 #if OS(WINDOWS)
@@ -353,7 +357,7 @@ double currentCPUTime()
     GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime.fileTime, &userTime.fileTime);
     
     return userTime.fileTimeAsLong / 10000000. + kernelTime.fileTimeAsLong / 10000000.;
-#elif OS(QNX)
+#elif OS(QNX) || OS(LINUX)
     struct timespec time;
     if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time))
         CRASH();
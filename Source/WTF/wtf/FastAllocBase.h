@@ -420,8 +420,24 @@ namespace WTF {
     }
 
 
+    // The allocator for the buffers of Vector, HashMap and HashSet. Containers keep an instance of
+    // their allocator, so an allocator can refer to state such as an arena; this one is empty and
+    // adds nothing to their size. See BumpArenaAllocator for the other implementation.
+    struct FastMallocAllocator {
+        // Buffers may be given away with Vector::releaseBuffer() and freed with fastFree().
+        static const bool usesFastMalloc = true;
+
+        static void* allocate(size_t size) { return fastMalloc(size); }
+        static void* allocateZeroed(size_t size) { return fastZeroedMalloc(size); }
+        static TryMallocReturnValue tryAllocate(size_t size) { return tryFastMalloc(size); }
+        static void* reallocate(void* p, size_t, size_t newSize) { return fastRealloc(p, newSize); }
+        static void deallocate(void* p) { fastFree(p); }
+        static size_t goodSize(size_t size) { return fastMallocGoodSize(size); }
+    };
+
 } // namespace WTF
 
+using WTF::FastMallocAllocator;
 using WTF::fastDeleteSkippingDestructor;
 
 #endif // FastAllocBase_h
@@ -400,6 +400,11 @@ FastMallocStatistics fastMallocStatistics()
     return statistics;
 }
 
+size_t fastMallocSizeClassStatistics(FastMallocSizeClassStatistics*, size_t)
+{
+    return 0;
+}
+
 size_t fastMallocSize(const void* p)
 {
 #if ENABLE(WTF_MALLOC_VALIDATION)
@@ -1340,6 +1345,17 @@ class TCMalloc_Central_FreeList {
     return used_slots_ * num_objects_to_move[size_class_];
   }
 
+  // Returns the objects held in the transfer cache to their spans, so that spans
+  // with no objects in use go back to the page heap.
+  void ReleaseTransferCache();
+
+  // Returns the number of objects, free or in use, in the spans owned by this
+  // size class.
+  size_t object_count() {
+    SpinLockHolder h(&lock_);
+    return object_count_;
+  }
+
 #ifdef WTF_CHANGES
   template <class Finder, class Reader>
   void enumerateFreeObjects(Finder& finder, const Reader& reader, TCMalloc_Central_FreeList* remoteCentralFreeList)
@@ -1430,6 +1446,7 @@ class TCMalloc_Central_FreeList {
   Span     empty_;          // Dummy header for list of empty spans
   Span     nonempty_;       // Dummy header for list of non-empty spans
   size_t   counter_;        // Number of free objects in cache entry
+  size_t   object_count_;   // Number of objects carved out of spans we own
 
   // Here we reserve space for TCEntry cache slots.  Since one size class can
   // end up getting all the TCEntries quota in the system we just preallocate
@@ -2687,6 +2704,12 @@ class TCMalloc_ThreadCache {
 
   uintptr_t     entropy_;               // Entropy value used for hardening
 
+  unsigned      release_epoch_;         // Last thread_cache_release_epoch acted upon
+
+  // Returns all free objects to the central cache if releaseFastMallocFreeMemory()
+  // was called on any thread since we last checked.
+  ALWAYS_INLINE bool ReleaseIfRequested();
+
   // Allocate a new heap. REQUIRES: pageheap_lock is held.
   static inline TCMalloc_ThreadCache* NewHeap(ThreadIdentifier tid, uintptr_t entropy);
 
@@ -2898,6 +2921,11 @@ static size_t overall_thread_cache_size = kDefaultOverallThreadCacheSize;
 // invariants between this variable and other pieces of state.
 static volatile size_t per_thread_cache_size = kMaxThreadCacheSize;
 
+// Incremented by releaseFastMallocFreeMemory(). A thread cache can only be emptied
+// by its own thread, so each one compares this with the value it last saw whenever
+// it goes to the central cache. Writes are protected by pageheap_lock.
+static volatile unsigned thread_cache_release_epoch = 0;
+
 //-------------------------------------------------------------------
 // Central cache implementation
 //-------------------------------------------------------------------
@@ -2912,6 +2940,7 @@ void TCMalloc_Central_FreeList::Init(size_t cl, uintptr_t entropy) {
   DLL_Init(&empty_, entropy_);
   DLL_Init(&nonempty_, entropy_);
   counter_ = 0;
+  object_count_ = 0;
 
   cache_size_ = 1;
   used_slots_ = 0;
@@ -2956,6 +2985,7 @@ ALWAYS_INLINE void TCMalloc_Central_FreeList::ReleaseToSpans(HardenedSLL object)
   if (span->refcount == 0) {
     Event(span, '#', 0);
     counter_ -= (span->length<<kPageShift) / ByteSizeForClass(span->sizeclass);
+    object_count_ -= (span->length<<kPageShift) / ByteSizeForClass(span->sizeclass);
     DLL_Remove(span, entropy_);
 
     // Release central list lock while operating on pageheap
@@ -3041,6 +3071,20 @@ bool TCMalloc_Central_FreeList::ShrinkCache(int locked_size_class, bool force) {
   return true;
 }
 
+void TCMalloc_Central_FreeList::ReleaseTransferCache() {
+  SpinLockHolder h(&lock_);
+  // ReleaseListToSpans releases the lock, so take the slot before calling it.
+  while (used_slots_ > 0) {
+    int slot = --used_slots_;
+    ReleaseListToSpans(tc_slots_[slot].head);
+  }
+}
+
+static void ReleaseCentralTransferCaches() {
+  for (size_t cl = 0; cl < kNumClasses; ++cl)
+    central_cache[cl].ReleaseTransferCache();
+}
+
 void TCMalloc_Central_FreeList::InsertRange(HardenedSLL start, HardenedSLL end, int N) {
   SpinLockHolder h(&lock_);
   if (N == num_objects_to_move[size_class_] &&
@@ -3193,6 +3237,7 @@ ALWAYS_INLINE void TCMalloc_Central_FreeList::Populate() {
   lock_.Lock();
   DLL_Prepend(&nonempty_, span, entropy_);
   counter_ += num;
+  object_count_ += num;
 }
 
 //-------------------------------------------------------------------
@@ -3216,6 +3261,7 @@ void TCMalloc_ThreadCache::Init(ThreadIdentifier tid, uintptr_t entropy) {
   tid_  = tid;
   in_setspecific_ = false;
   entropy_ = entropy;
+  release_epoch_ = thread_cache_release_epoch;
 #if ENABLE(TCMALLOC_HARDENING)
   ASSERT(entropy_);
 #endif
@@ -3246,6 +3292,7 @@ ALWAYS_INLINE void* TCMalloc_ThreadCache::Allocate(size_t size) {
   FreeList* list = &list_[cl];
   size_t allocationSize = ByteSizeForClass(cl);
   if (list->empty()) {
+    ReleaseIfRequested();
     FetchFromCentralCache(cl, allocationSize);
     if (list->empty()) return NULL;
   }
@@ -3304,8 +3351,22 @@ inline void TCMalloc_ThreadCache::ReleaseToCentralCache(size_t cl, int N) {
   central_cache[cl].InsertRange(head, tail, N);
 }
 
+ALWAYS_INLINE bool TCMalloc_ThreadCache::ReleaseIfRequested() {
+  unsigned epoch = thread_cache_release_epoch;
+  if (LIKELY(release_epoch_ == epoch))
+    return false;
+  release_epoch_ = epoch;
+  Cleanup();
+  // Cleanup() parks full batches in the transfer caches, where they would keep their spans alive.
+  ReleaseCentralTransferCaches();
+  return true;
+}
+
 // Release idle memory to the central cache
 inline void TCMalloc_ThreadCache::Scavenge() {
+  if (ReleaseIfRequested())
+    return;
+
   // If the low-water mark for the free list is L, it means we would
   // not have had to allocate anything from the central cache even if
   // we had reduced the free list size by L.  We aim to get closer to
@@ -4636,8 +4697,10 @@ void releaseFastMallocFreeMemory()
     // Flush free pages in the current thread cache back to the page heap.
     if (TCMalloc_ThreadCache* threadCache = TCMalloc_ThreadCache::GetCacheIfPresent())
         threadCache->Cleanup();
+    ReleaseCentralTransferCaches();
 
     SpinLockHolder h(&pageheap_lock);
+    ++thread_cache_release_epoch;
     pageheap->ReleaseFreePages();
 }
 
@@ -4662,6 +4725,33 @@ FastMallocStatistics fastMallocStatistics()
     return statistics;
 }
 
+size_t fastMallocSizeClassStatistics(FastMallocSizeClassStatistics* statistics, size_t maxCount)
+{
+    // Size class 0 is unused.
+    const size_t sizeClassCount = kNumClasses - 1;
+    if (!statistics)
+        return sizeClassCount;
+
+    SpinLockHolder lockHolder(&pageheap_lock);
+    for (size_t i = 0; i < sizeClassCount && i < maxCount; ++i) {
+        const size_t cl = i + 1;
+        const size_t objectSize = ByteSizeForClass(cl);
+
+        // Thread cache lengths are read without their owners' cooperation, so the
+        // totals are approximate while other threads are allocating.
+        size_t freeObjects = central_cache[cl].length() + central_cache[cl].tc_length();
+        for (TCMalloc_ThreadCache* threadCache = thread_heaps; threadCache ; threadCache = threadCache->next_)
+            freeObjects += threadCache->freelist_length(cl);
+
+        const size_t objectCount = central_cache[cl].object_count();
+        statistics[i].objectSize = objectSize;
+        statistics[i].freeBytes = freeObjects * objectSize;
+        statistics[i].liveBytes = objectCount > freeObjects ? (objectCount - freeObjects) * objectSize : 0;
+    }
+
+    return sizeClassCount;
+}
+
 size_t fastMallocSize(const void* ptr)
 {
 #if ENABLE(WTF_MALLOC_VALIDATION)
@@ -81,6 +81,9 @@ namespace WTF {
     WTF_EXPORT_PRIVATE void fastMallocAllow();
 #endif
 
+    // Returns the current thread's cached free objects and all free pages to the system,
+    // and asks every other thread cache to give back its free objects the next time it
+    // has to go to the central cache.
     WTF_EXPORT_PRIVATE void releaseFastMallocFreeMemory();
     
     struct FastMallocStatistics {
@@ -90,6 +93,18 @@ namespace WTF {
     };
     WTF_EXPORT_PRIVATE FastMallocStatistics fastMallocStatistics();
 
+    // Statistics for one small-object size class. Allocations larger than the
+    // largest size class come straight from the page heap and are not counted.
+    struct FastMallocSizeClassStatistics {
+        size_t objectSize;
+        size_t liveBytes;
+        size_t freeBytes; // Free objects held by the central cache and all thread caches.
+    };
+    // Fills in at most maxCount entries, smallest size class first, and returns the
+    // number of size classes. Pass a null array to only get the count. Returns 0 when
+    // FastMalloc is not in use.
+    WTF_EXPORT_PRIVATE size_t fastMallocSizeClassStatistics(FastMallocSizeClassStatistics*, size_t maxCount);
+
     // This defines a type which holds an unsigned integer and is the same
     // size as the minimally aligned memory allocation.
     typedef unsigned long long AllocAlignmentInteger;
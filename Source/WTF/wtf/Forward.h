@@ -32,7 +32,7 @@ namespace WTF {
     template<typename T> class PassOwnPtr;
     template<typename T> class PassRefPtr;
     template<typename T> class RefPtr;
-    template<typename T, size_t inlineCapacity, typename OverflowHandler> class Vector;
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator> class Vector;
     
     class ArrayBuffer;
     class ArrayBufferView;
@@ -0,0 +1,774 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WTF_GroupProbingHashTable_h
+#define WTF_GroupProbingHashTable_h
+
+#include <string.h>
+#include <wtf/HashTable.h>
+
+#if CPU(X86_64) || (CPU(X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#include <emmintrin.h>
+#define WTF_GROUP_PROBING_USE_SSE2 1
+#elif HAVE(ARM_NEON_INTRINSICS)
+#include <arm_neon.h>
+#define WTF_GROUP_PROBING_USE_NEON 1
+#endif
+
+#if COMPILER(MSVC)
+#include <intrin.h>
+#endif
+
+namespace WTF {
+
+    // GroupProbingHashTable is an open addressing hash table that keeps one control byte per
+    // bucket in a separate array. A full bucket's control byte holds 7 bits of its hash, so a
+    // lookup compares the control bytes of 16 buckets at once and only compares keys for the
+    // few buckets whose byte matches. Deleted buckets are tracked in the control bytes, which
+    // means that deletedValue() is never stored in a bucket.
+    //
+    // It has the same interface as HashTable and is selected by setting useGroupProbing in the
+    // key traits of a HashMap or HashSet. CHECK_HASHTABLE_ITERATORS is not supported.
+
+    class GroupProbingControlGroup {
+    public:
+        static const int size = 16;
+        static const int8_t empty = -128;
+        static const int8_t deleted = -2;
+
+        explicit GroupProbingControlGroup(const int8_t* control)
+#if defined(WTF_GROUP_PROBING_USE_SSE2)
+            : m_control(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control)))
+#elif defined(WTF_GROUP_PROBING_USE_NEON)
+            : m_control(vld1q_s8(control))
+#else
+            : m_control(control)
+#endif
+        {
+        }
+
+        // Each of these returns a mask where bit i is set if the control byte of bucket i matches.
+        unsigned match(int8_t tag) const
+        {
+#if defined(WTF_GROUP_PROBING_USE_SSE2)
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(m_control, _mm_set1_epi8(tag)));
+#elif defined(WTF_GROUP_PROBING_USE_NEON)
+            return toMask(vceqq_s8(m_control, vdupq_n_s8(tag)));
+#else
+            unsigned mask = 0;
+            for (int i = 0; i < size; ++i) {
+                if (m_control[i] == tag)
+                    mask |= 1 << i;
+            }
+            return mask;
+#endif
+        }
+
+        unsigned matchEmpty() const { return match(empty); }
+
+        unsigned matchEmptyOrDeleted() const
+        {
+            // Only empty and deleted buckets have the high bit set.
+#if defined(WTF_GROUP_PROBING_USE_SSE2)
+            return _mm_movemask_epi8(m_control);
+#elif defined(WTF_GROUP_PROBING_USE_NEON)
+            return toMask(vcltq_s8(m_control, vdupq_n_s8(0)));
+#else
+            unsigned mask = 0;
+            for (int i = 0; i < size; ++i) {
+                if (m_control[i] < 0)
+                    mask |= 1 << i;
+            }
+            return mask;
+#endif
+        }
+
+        // The mask must be non-zero.
+        static unsigned firstIndex(unsigned mask)
+        {
+            ASSERT(mask);
+#if COMPILER(GCC)
+            return __builtin_ctz(mask);
+#elif COMPILER(MSVC)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return index;
+#else
+            unsigned index = 0;
+            while (!(mask & 1)) {
+                mask >>= 1;
+                ++index;
+            }
+            return index;
+#endif
+        }
+
+    private:
+#if defined(WTF_GROUP_PROBING_USE_NEON)
+        static unsigned toMask(uint8x16_t matches)
+        {
+            static const uint8_t bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+            uint8x16_t masked = vandq_u8(matches, vld1q_u8(bits));
+            uint8x8_t sum = vpadd_u8(vget_low_u8(masked), vget_high_u8(masked));
+            sum = vpadd_u8(sum, sum);
+            sum = vpadd_u8(sum, sum);
+            return vget_lane_u16(vreinterpret_u16_u8(sum), 0);
+        }
+#endif
+
+#if defined(WTF_GROUP_PROBING_USE_SSE2)
+        __m128i m_control;
+#elif defined(WTF_GROUP_PROBING_USE_NEON)
+        int8x16_t m_control;
+#else
+        const int8_t* m_control;
+#endif
+    };
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    class GroupProbingHashTable;
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    class GroupProbingHashTableIterator;
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    class GroupProbingHashTableConstIterator {
+    private:
+        typedef GroupProbingHashTableIterator<Key, Value, Extractor, HashFunctions, Traits, KeyTraits> iterator;
+        typedef GroupProbingHashTableConstIterator<Key, Value, Extractor, HashFunctions, Traits, KeyTraits> const_iterator;
+        typedef Value ValueType;
+        typedef const ValueType& ReferenceType;
+        typedef const ValueType* PointerType;
+
+        friend class GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>;
+        friend class GroupProbingHashTableIterator<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>;
+
+        void skipEmptyBuckets()
+        {
+            while (m_position != m_endPosition && *m_control < 0) {
+                ++m_position;
+                ++m_control;
+            }
+        }
+
+        GroupProbingHashTableConstIterator(PointerType position, PointerType endPosition, const int8_t* control)
+            : m_position(position), m_endPosition(endPosition), m_control(control)
+        {
+            skipEmptyBuckets();
+        }
+
+        GroupProbingHashTableConstIterator(PointerType position, PointerType endPosition, const int8_t* control, HashItemKnownGoodTag)
+            : m_position(position), m_endPosition(endPosition), m_control(control)
+        {
+        }
+
+    public:
+        GroupProbingHashTableConstIterator()
+            : m_position(0), m_endPosition(0), m_control(0)
+        {
+        }
+
+        PointerType get() const { return m_position; }
+        ReferenceType operator*() const { return *get(); }
+        PointerType operator->() const { return get(); }
+
+        const_iterator& operator++()
+        {
+            ASSERT(m_position != m_endPosition);
+            ++m_position;
+            ++m_control;
+            skipEmptyBuckets();
+            return *this;
+        }
+
+        // postfix ++ intentionally omitted
+
+        // Comparison.
+        bool operator==(const const_iterator& other) const { return m_position == other.m_position; }
+        bool operator!=(const const_iterator& other) const { return m_position != other.m_position; }
+        bool operator==(const iterator& other) const { return *this == static_cast<const_iterator>(other); }
+        bool operator!=(const iterator& other) const { return *this != static_cast<const_iterator>(other); }
+
+    private:
+        PointerType m_position;
+        PointerType m_endPosition;
+        const int8_t* m_control;
+    };
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    class GroupProbingHashTableIterator {
+    private:
+        typedef GroupProbingHashTableIterator<Key, Value, Extractor, HashFunctions, Traits, KeyTraits> iterator;
+        typedef GroupProbingHashTableConstIterator<Key, Value, Extractor, HashFunctions, Traits, KeyTraits> const_iterator;
+        typedef Value ValueType;
+        typedef ValueType& ReferenceType;
+        typedef ValueType* PointerType;
+
+        friend class GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>;
+
+        GroupProbingHashTableIterator(PointerType position, PointerType end, const int8_t* control) : m_iterator(position, end, control) { }
+        GroupProbingHashTableIterator(PointerType position, PointerType end, const int8_t* control, HashItemKnownGoodTag tag) : m_iterator(position, end, control, tag) { }
+
+    public:
+        GroupProbingHashTableIterator() { }
+
+        // default copy, assignment and destructor are OK
+
+        PointerType get() const { return const_cast<PointerType>(m_iterator.get()); }
+        ReferenceType operator*() const { return *get(); }
+        PointerType operator->() const { return get(); }
+
+        iterator& operator++() { ++m_iterator; return *this; }
+
+        // postfix ++ intentionally omitted
+
+        // Comparison.
+        bool operator==(const iterator& other) const { return m_iterator == other.m_iterator; }
+        bool operator!=(const iterator& other) const { return m_iterator != other.m_iterator; }
+        bool operator==(const const_iterator& other) const { return m_iterator == other; }
+        bool operator!=(const const_iterator& other) const { return m_iterator != other; }
+
+        operator const_iterator() const { return m_iterator; }
+
+    private:
+        const_iterator m_iterator;
+    };
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    class GroupProbingHashTable : private Traits::Allocator {
+    public:
+        typedef GroupProbingHashTableIterator<Key, Value, Extractor, HashFunctions, Traits, KeyTraits> iterator;
+        typedef GroupProbingHashTableConstIterator<Key, Value, Extractor, HashFunctions, Traits, KeyTraits> const_iterator;
+        typedef Traits ValueTraits;
+        typedef Key KeyType;
+        typedef Value ValueType;
+        typedef IdentityHashTranslator<HashFunctions> IdentityTranslatorType;
+        typedef HashTableAddResult<iterator> AddResult;
+        typedef typename Traits::Allocator Allocator;
+
+        GroupProbingHashTable();
+        explicit GroupProbingHashTable(const Allocator&);
+        ~GroupProbingHashTable()
+        {
+            if (m_table)
+                deallocateTable(m_table, m_tableSize);
+        }
+
+        GroupProbingHashTable(const GroupProbingHashTable&);
+        void swap(GroupProbingHashTable&);
+        GroupProbingHashTable& operator=(const GroupProbingHashTable&);
+
+        const Allocator& allocator() const { return *this; }
+
+        iterator begin() { return isEmpty() ? end() : makeIterator(m_table); }
+        iterator end() { return makeKnownGoodIterator(m_table + m_tableSize); }
+        const_iterator begin() const { return isEmpty() ? end() : makeConstIterator(m_table); }
+        const_iterator end() const { return makeKnownGoodConstIterator(m_table + m_tableSize); }
+
+        int size() const { return m_keyCount; }
+        int capacity() const { return m_tableSize; }
+        bool isEmpty() const { return !m_keyCount; }
+
+        AddResult add(const ValueType& value) { return add<IdentityTranslatorType>(Extractor::extract(value), value); }
+
+        template<typename HashTranslator, typename T, typename Extra> AddResult add(const T& key, const Extra&);
+        template<typename HashTranslator, typename T, typename Extra> AddResult addPassingHashCode(const T& key, const Extra&);
+
+        iterator find(const KeyType& key) { return find<IdentityTranslatorType>(key); }
+        const_iterator find(const KeyType& key) const { return find<IdentityTranslatorType>(key); }
+        bool contains(const KeyType& key) const { return contains<IdentityTranslatorType>(key); }
+
+        template<typename HashTranslator, typename T> iterator find(const T&);
+        template<typename HashTranslator, typename T> const_iterator find(const T&) const;
+        template<typename HashTranslator, typename T> bool contains(const T&) const;
+
+        void remove(const KeyType&);
+        void remove(iterator);
+        void removeWithoutEntryConsistencyCheck(iterator);
+        void removeWithoutEntryConsistencyCheck(const_iterator);
+        void clear();
+
+        ValueType* lookup(const Key& key) { return lookup<IdentityTranslatorType>(key); }
+        template<typename HashTranslator, typename T> ValueType* lookup(const T&);
+
+#if !ASSERT_DISABLED
+        void checkTableConsistency() const;
+#else
+        static void checkTableConsistency() { }
+#endif
+#if CHECK_HASHTABLE_CONSISTENCY
+        void internalCheckTableConsistency() const { checkTableConsistency(); }
+#else
+        static void internalCheckTableConsistency() { }
+#endif
+
+    private:
+        static const int groupSize = GroupProbingControlGroup::size;
+        static const int minimumTableSize = KeyTraits::minimumTableSize > groupSize ? KeyTraits::minimumTableSize : groupSize;
+
+        // The tag is taken from a remix of the hash, since the low bits of the hash pick the group.
+        static int8_t tagForHash(unsigned hash) { return doubleHash(hash) & 0x7F; }
+
+        ValueType* allocateTable(int size, int8_t*& control);
+        void deallocateTable(ValueType* table, int size);
+        static void initializeBucket(ValueType& bucket) { HashTableBucketInitializer<Traits::emptyValueIsZero>::template initialize<Traits>(bucket); }
+
+        // Returns the matching bucket, or 0. If insertionEntry is non-null, it is set to the
+        // first empty or deleted bucket on the probe sequence.
+        template<typename HashTranslator, typename T> ValueType* lookupInGroups(const T&, unsigned hash, ValueType** insertionEntry);
+        ValueType* findEmptyBucket(unsigned hash);
+        AddResult didAdd(ValueType* entry, unsigned hash);
+
+        void remove(ValueType*);
+
+        bool shouldExpand() const { return (m_keyCount + m_deletedCount) * 8 >= m_tableSize * 7; }
+        bool mustRehashInPlace() const { return m_keyCount * 6 < m_tableSize * 2; }
+        bool shouldShrink() const { return m_keyCount * 6 < m_tableSize && m_tableSize > minimumTableSize; }
+        void expand();
+        void shrink() { rehash(m_tableSize / 2); }
+
+        void rehash(int newTableSize);
+        void reinsert(ValueType&);
+
+        iterator makeIterator(ValueType* pos) { return iterator(pos, m_table + m_tableSize, m_control + (pos - m_table)); }
+        const_iterator makeConstIterator(ValueType* pos) const { return const_iterator(pos, m_table + m_tableSize, m_control + (pos - m_table)); }
+        iterator makeKnownGoodIterator(ValueType* pos) { return iterator(pos, m_table + m_tableSize, m_control + (pos - m_table), HashItemKnownGood); }
+        const_iterator makeKnownGoodConstIterator(ValueType* pos) const { return const_iterator(pos, m_table + m_tableSize, m_control + (pos - m_table), HashItemKnownGood); }
+
+        // Every bucket holds a constructed value; buckets that are not full hold the empty value.
+        ValueType* m_table;
+        int8_t* m_control;
+        int m_tableSize;
+        int m_tableSizeMask;
+        int m_keyCount;
+        int m_deletedCount;
+    };
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    inline GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::GroupProbingHashTable()
+        : m_table(0)
+        , m_control(0)
+        , m_tableSize(0)
+        , m_tableSizeMask(0)
+        , m_keyCount(0)
+        , m_deletedCount(0)
+    {
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    inline GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::GroupProbingHashTable(const Allocator& allocator)
+        : Allocator(allocator)
+        , m_table(0)
+        , m_control(0)
+        , m_tableSize(0)
+        , m_tableSizeMask(0)
+        , m_keyCount(0)
+        , m_deletedCount(0)
+    {
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    template<typename HashTranslator, typename T>
+    inline Value* GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::lookupInGroups(const T& key, unsigned hash, ValueType** insertionEntry)
+    {
+        ASSERT(m_table);
+
+        int8_t tag = tagForHash(hash);
+        int groupMask = m_tableSizeMask & ~(groupSize - 1);
+        int position = hash & groupMask;
+        int step = 0;
+
+        if (insertionEntry)
+            *insertionEntry = 0;
+
+        // Stepping by 1, 2, 3... groups visits every group when the number of groups is a power of two.
+        while (1) {
+            GroupProbingControlGroup group(m_control + position);
+            for (unsigned matches = group.match(tag); matches; matches &= matches - 1) {
+                ValueType* entry = m_table + position + GroupProbingControlGroup::firstIndex(matches);
+                if (HashTranslator::equal(Extractor::extract(*entry), key))
+                    return entry;
+            }
+
+            if (insertionEntry && !*insertionEntry) {
+                if (unsigned available = group.matchEmptyOrDeleted())
+                    *insertionEntry = m_table + position + GroupProbingControlGroup::firstIndex(available);
+            }
+
+            // A key is never placed past a group that had an empty bucket.
+            if (group.matchEmpty())
+                return 0;
+
+            step += groupSize;
+            position = (position + step) & groupMask;
+        }
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    inline Value* GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::findEmptyBucket(unsigned hash)
+    {
+        int groupMask = m_tableSizeMask & ~(groupSize - 1);
+        int position = hash & groupMask;
+        int step = 0;
+
+        while (1) {
+            if (unsigned empty = GroupProbingControlGroup(m_control + position).matchEmpty())
+                return m_table + position + GroupProbingControlGroup::firstIndex(empty);
+
+            step += groupSize;
+            position = (position + step) & groupMask;
+        }
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    template<typename HashTranslator, typename T>
+    inline Value* GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::lookup(const T& key)
+    {
+        if (!m_table)
+            return 0;
+
+        return lookupInGroups<HashTranslator>(key, HashTranslator::hash(key), 0);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    template<typename HashTranslator, typename T, typename Extra>
+    inline typename GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::AddResult GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::add(const T& key, const Extra& extra)
+    {
+        if (!m_table)
+            expand();
+
+        internalCheckTableConsistency();
+
+        unsigned hash = HashTranslator::hash(key);
+        ValueType* entry;
+        if (ValueType* existingEntry = lookupInGroups<HashTranslator>(key, hash, &entry))
+            return AddResult(makeKnownGoodIterator(existingEntry), false);
+
+        HashTranslator::translate(*entry, key, extra);
+        return didAdd(entry, hash);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    template<typename HashTranslator, typename T, typename Extra>
+    inline typename GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::AddResult GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::addPassingHashCode(const T& key, const Extra& extra)
+    {
+        if (!m_table)
+            expand();
+
+        internalCheckTableConsistency();
+
+        unsigned hash = HashTranslator::hash(key);
+        ValueType* entry;
+        if (ValueType* existingEntry = lookupInGroups<HashTranslator>(key, hash, &entry))
+            return AddResult(makeKnownGoodIterator(existingEntry), false);
+
+        HashTranslator::translate(*entry, key, extra, hash);
+        return didAdd(entry, hash);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    inline typename GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::AddResult GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::didAdd(ValueType* entry, unsigned hash)
+    {
+        int8_t& control = m_control[entry - m_table];
+        if (control == GroupProbingControlGroup::deleted)
+            --m_deletedCount;
+        control = tagForHash(hash);
+        ++m_keyCount;
+
+        if (shouldExpand()) {
+            KeyType enteredKey = Extractor::extract(*entry);
+            expand();
+            AddResult result(find(enteredKey), true);
+            ASSERT(result.iterator != end());
+            return result;
+        }
+
+        internalCheckTableConsistency();
+
+        return AddResult(makeKnownGoodIterator(entry), true);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    inline void GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::reinsert(ValueType& entry)
+    {
+        unsigned hash = HashFunctions::hash(Extractor::extract(entry));
+        ValueType* newEntry = findEmptyBucket(hash);
+        Mover<ValueType, Traits::needsDestruction>::move(entry, *newEntry);
+        m_control[newEntry - m_table] = tagForHash(hash);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    template<typename HashTranslator, typename T>
+    inline typename GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::iterator GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::find(const T& key)
+    {
+        ValueType* entry = lookup<HashTranslator>(key);
+        if (!entry)
+            return end();
+
+        return makeKnownGoodIterator(entry);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    template<typename HashTranslator, typename T>
+    inline typename GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::const_iterator GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::find(const T& key) const
+    {
+        ValueType* entry = const_cast<GroupProbingHashTable*>(this)->lookup<HashTranslator>(key);
+        if (!entry)
+            return end();
+
+        return makeKnownGoodConstIterator(entry);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    template<typename HashTranslator, typename T>
+    inline bool GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::contains(const T& key) const
+    {
+        return const_cast<GroupProbingHashTable*>(this)->lookup<HashTranslator>(key);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    void GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::remove(ValueType* pos)
+    {
+        pos->~ValueType();
+        initializeBucket(*pos);
+
+        // If the group still has an empty bucket, no probe sequence continues past it, so the
+        // bucket can become empty rather than deleted.
+        int index = pos - m_table;
+        if (GroupProbingControlGroup(m_control + (index & ~(groupSize - 1))).matchEmpty())
+            m_control[index] = GroupProbingControlGroup::empty;
+        else {
+            m_control[index] = GroupProbingControlGroup::deleted;
+            ++m_deletedCount;
+        }
+        --m_keyCount;
+
+        if (shouldShrink())
+            shrink();
+
+        internalCheckTableConsistency();
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    inline void GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::remove(iterator it)
+    {
+        if (it == end())
+            return;
+
+        internalCheckTableConsistency();
+        remove(const_cast<ValueType*>(it.m_iterator.m_position));
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    inline void GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::removeWithoutEntryConsistencyCheck(iterator it)
+    {
+        if (it == end())
+            return;
+
+        remove(const_cast<ValueType*>(it.m_iterator.m_position));
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    inline void GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::removeWithoutEntryConsistencyCheck(const_iterator it)
+    {
+        if (it == end())
+            return;
+
+        remove(const_cast<ValueType*>(it.m_position));
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    inline void GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::remove(const KeyType& key)
+    {
+        remove(find(key));
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    Value* GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::allocateTable(int size, int8_t*& control)
+    {
+        // The control bytes live in the same allocation, right after the buckets.
+        size_t bucketsSize = size * sizeof(ValueType);
+        ValueType* result;
+        if (Traits::emptyValueIsZero)
+            result = static_cast<ValueType*>(Allocator::allocateZeroed(bucketsSize + size));
+        else {
+            result = static_cast<ValueType*>(Allocator::allocate(bucketsSize + size));
+            for (int i = 0; i < size; i++)
+                initializeBucket(result[i]);
+        }
+        control = reinterpret_cast<int8_t*>(result) + bucketsSize;
+        memset(control, GroupProbingControlGroup::empty, size);
+        return result;
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    void GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::deallocateTable(ValueType* table, int size)
+    {
+        if (Traits::needsDestruction) {
+            for (int i = 0; i < size; ++i)
+                table[i].~ValueType();
+        }
+        Allocator::deallocate(table);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    void GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::expand()
+    {
+        int newSize;
+        if (m_tableSize == 0)
+            newSize = minimumTableSize;
+        else if (mustRehashInPlace())
+            newSize = m_tableSize;
+        else
+            newSize = m_tableSize * 2;
+
+        rehash(newSize);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    void GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::rehash(int newTableSize)
+    {
+        int oldTableSize = m_tableSize;
+        ValueType* oldTable = m_table;
+        int8_t* oldControl = m_control;
+
+        m_tableSize = newTableSize;
+        m_tableSizeMask = newTableSize - 1;
+        m_table = allocateTable(newTableSize, m_control);
+
+        for (int i = 0; i != oldTableSize; ++i) {
+            if (oldControl[i] >= 0)
+                reinsert(oldTable[i]);
+        }
+
+        m_deletedCount = 0;
+
+        if (oldTable)
+            deallocateTable(oldTable, oldTableSize);
+
+        internalCheckTableConsistency();
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    void GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::clear()
+    {
+        if (!m_table)
+            return;
+
+        deallocateTable(m_table, m_tableSize);
+        m_table = 0;
+        m_control = 0;
+        m_tableSize = 0;
+        m_tableSizeMask = 0;
+        m_keyCount = 0;
+        m_deletedCount = 0;
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::GroupProbingHashTable(const GroupProbingHashTable& other)
+        : Allocator(other)
+        , m_table(0)
+        , m_control(0)
+        , m_tableSize(0)
+        , m_tableSizeMask(0)
+        , m_keyCount(0)
+        , m_deletedCount(0)
+    {
+        const_iterator end = other.end();
+        for (const_iterator it = other.begin(); it != end; ++it)
+            add(*it);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    void GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::swap(GroupProbingHashTable& other)
+    {
+        std::swap(m_table, other.m_table);
+        std::swap(m_control, other.m_control);
+        std::swap(m_tableSize, other.m_tableSize);
+        std::swap(m_tableSizeMask, other.m_tableSizeMask);
+        std::swap(m_keyCount, other.m_keyCount);
+        std::swap(m_deletedCount, other.m_deletedCount);
+        std::swap(static_cast<Allocator&>(*this), static_cast<Allocator&>(other));
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>& GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::operator=(const GroupProbingHashTable& other)
+    {
+        GroupProbingHashTable tmp(other);
+        swap(tmp);
+        return *this;
+    }
+
+#if !ASSERT_DISABLED
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    void GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::checkTableConsistency() const
+    {
+        if (!m_table)
+            return;
+
+        int count = 0;
+        int deletedCount = 0;
+        for (int j = 0; j < m_tableSize; ++j) {
+            if (m_control[j] == GroupProbingControlGroup::empty)
+                continue;
+
+            if (m_control[j] == GroupProbingControlGroup::deleted) {
+                ++deletedCount;
+                continue;
+            }
+
+            ValueType* entry = m_table + j;
+            const_iterator it = find(Extractor::extract(*entry));
+            ASSERT(entry == it.m_position);
+            ASSERT(m_control[j] == tagForHash(HashFunctions::hash(Extractor::extract(*entry))));
+            ++count;
+
+            ValueCheck<Key>::checkConsistency(Extractor::extract(*entry));
+        }
+
+        ASSERT(count == m_keyCount);
+        ASSERT(deletedCount == m_deletedCount);
+        ASSERT(m_tableSize >= minimumTableSize);
+        ASSERT(m_tableSize == m_tableSizeMask + 1);
+        ASSERT(!shouldExpand());
+        ASSERT(!shouldShrink());
+    }
+
+#endif // ASSERT_DISABLED
+
+    // Picks the hash table implementation for a HashMap or HashSet from its key traits.
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits, bool useGroupProbing = KeyTraits::useGroupProbing>
+    struct HashTableSelector {
+        typedef HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits> Type;
+    };
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    struct HashTableSelector<Key, Value, Extractor, HashFunctions, Traits, KeyTraits, true> {
+        typedef GroupProbingHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits> Type;
+    };
+
+} // namespace WTF
+
+#endif // WTF_GroupProbingHashTable_h
@@ -21,7 +21,7 @@
 #ifndef WTF_HashMap_h
 #define WTF_HashMap_h
 
-#include <wtf/HashTable.h>
+#include <wtf/GroupProbingHashTable.h>
 
 namespace WTF {
 
@@ -61,8 +61,8 @@ namespace WTF {
 
         typedef HashArg HashFunctions;
 
-        typedef HashTable<KeyType, ValueType, KeyValuePairKeyExtractor<ValueType>,
-            HashFunctions, ValueTraits, KeyTraits> HashTableType;
+        typedef typename HashTableSelector<KeyType, ValueType, KeyValuePairKeyExtractor<ValueType>,
+            HashFunctions, ValueTraits, KeyTraits>::Type HashTableType;
 
         class HashMapKeysProxy;
         class HashMapValuesProxy;
@@ -71,8 +71,18 @@ namespace WTF {
         typedef HashTableIteratorAdapter<HashTableType, ValueType> iterator;
         typedef HashTableConstIteratorAdapter<HashTableType, ValueType> const_iterator;
         typedef typename HashTableType::AddResult AddResult;
+        typedef typename HashTableType::Allocator Allocator;
 
     public:
+        HashMap()
+        {
+        }
+
+        explicit HashMap(const Allocator& allocator)
+            : m_impl(allocator)
+        {
+        }
+
         void swap(HashMap&);
 
         int size() const;
@@ -22,7 +22,7 @@
 #define WTF_HashSet_h
 
 #include <wtf/FastAllocBase.h>
-#include <wtf/HashTable.h>
+#include <wtf/GroupProbingHashTable.h>
 
 namespace WTF {
 
@@ -43,13 +43,23 @@ namespace WTF {
         typedef typename ValueTraits::TraitType ValueType;
 
     private:
-        typedef HashTable<ValueType, ValueType, IdentityExtractor,
-            HashFunctions, ValueTraits, ValueTraits> HashTableType;
+        typedef typename HashTableSelector<ValueType, ValueType, IdentityExtractor,
+            HashFunctions, ValueTraits, ValueTraits>::Type HashTableType;
 
     public:
         typedef HashTableConstIteratorAdapter<HashTableType, ValueType> iterator;
         typedef HashTableConstIteratorAdapter<HashTableType, ValueType> const_iterator;
         typedef typename HashTableType::AddResult AddResult;
+        typedef typename HashTableType::Allocator Allocator;
+
+        HashSet()
+        {
+        }
+
+        explicit HashSet(const Allocator& allocator)
+            : m_impl(allocator)
+        {
+        }
 
         void swap(HashSet&);
 
@@ -311,7 +311,7 @@ namespace WTF {
     };
 
     template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
-    class HashTable {
+    class HashTable : private Traits::Allocator {
     public:
         typedef HashTableIterator<Key, Value, Extractor, HashFunctions, Traits, KeyTraits> iterator;
         typedef HashTableConstIterator<Key, Value, Extractor, HashFunctions, Traits, KeyTraits> const_iterator;
@@ -320,6 +320,7 @@ namespace WTF {
         typedef Value ValueType;
         typedef IdentityHashTranslator<HashFunctions> IdentityTranslatorType;
         typedef HashTableAddResult<iterator> AddResult;
+        typedef typename Traits::Allocator Allocator;
 
 #if DUMP_HASHTABLE_STATS_PER_TABLE
         struct Stats {
@@ -367,6 +368,7 @@ namespace WTF {
 #endif
 
         HashTable();
+        explicit HashTable(const Allocator&);
         ~HashTable() 
         {
             invalidateIterators(); 
@@ -381,6 +383,8 @@ namespace WTF {
         void swap(HashTable&);
         HashTable& operator=(const HashTable&);
 
+        const Allocator& allocator() const { return *this; }
+
         // When the hash table is empty, just return the same iterator for end as for begin.
         // This is more efficient because we don't have to skip all the empty and deleted
         // buckets, and iterating an empty table is a common case that's worth optimizing.
@@ -436,8 +440,8 @@ namespace WTF {
 #endif
 
     private:
-        static ValueType* allocateTable(int size);
-        static void deallocateTable(ValueType* table, int size);
+        ValueType* allocateTable(int size);
+        void deallocateTable(ValueType* table, int size);
 
         typedef std::pair<ValueType*, bool> LookupType;
         typedef std::pair<LookupType, unsigned> FullLookupType;
@@ -562,6 +566,24 @@ namespace WTF {
     {
     }
 
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    inline HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::HashTable(const Allocator& allocator)
+        : Allocator(allocator)
+        , m_table(0)
+        , m_tableSize(0)
+        , m_tableSizeMask(0)
+        , m_keyCount(0)
+        , m_deletedCount(0)
+#if CHECK_HASHTABLE_ITERATORS
+        , m_iterators(0)
+        , m_mutex(adoptPtr(new Mutex))
+#endif
+#if DUMP_HASHTABLE_STATS_PER_TABLE
+        , m_stats(adoptPtr(new Stats))
+#endif
+    {
+    }
+
     inline unsigned doubleHash(unsigned key)
     {
         key = ~key + (key >> 23);
@@ -1076,8 +1098,8 @@ namespace WTF {
         // would use a template member function with explicit specializations here, but
         // gcc doesn't appear to support that
         if (Traits::emptyValueIsZero)
-            return static_cast<ValueType*>(fastZeroedMalloc(size * sizeof(ValueType)));
-        ValueType* result = static_cast<ValueType*>(fastMalloc(size * sizeof(ValueType)));
+            return static_cast<ValueType*>(Allocator::allocateZeroed(size * sizeof(ValueType)));
+        ValueType* result = static_cast<ValueType*>(Allocator::allocate(size * sizeof(ValueType)));
         for (int i = 0; i < size; i++)
             initializeBucket(result[i]);
         return result;
@@ -1092,7 +1114,7 @@ namespace WTF {
                     table[i].~ValueType();
             }
         }
-        fastFree(table);
+        Allocator::deallocate(table);
     }
 
     template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
@@ -1158,7 +1180,8 @@ namespace WTF {
 
     template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
     HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::HashTable(const HashTable& other)
-        : m_table(0)
+        : Allocator(other)
+        , m_table(0)
         , m_tableSize(0)
         , m_tableSizeMask(0)
         , m_keyCount(0)
@@ -1204,6 +1227,8 @@ namespace WTF {
         m_deletedCount = other.m_deletedCount;
         other.m_deletedCount = tmp_deletedCount;
 
+        std::swap(static_cast<Allocator&>(*this), static_cast<Allocator&>(other));
+
 #if DUMP_HASHTABLE_STATS_PER_TABLE
         m_stats.swap(other.m_stats);
 #endif
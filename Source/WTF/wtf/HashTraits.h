@@ -30,6 +30,7 @@
 namespace WTF {
 
     class String;
+    struct FastMallocAllocator;
 
     template<typename T> class OwnPtr;
     template<typename T> class PassOwnPtr;
@@ -53,6 +54,15 @@ namespace WTF {
         // The starting table size. Can be overridden when we know beforehand that
         // a hash table will have at least N entries.
         static const int minimumTableSize = 8;
+
+        // The useGroupProbing flag selects GroupProbingHashTable instead of HashTable. It suits large,
+        // lookup-heavy tables whose keys are expensive to compare, since most misses are rejected by
+        // comparing one byte of the hash for 16 buckets at a time.
+        static const bool useGroupProbing = false;
+
+        // The allocator for the table. HashMap and HashSet take an instance of it in their constructor,
+        // so a BumpArenaAllocator can put the table of a short-lived container in an arena.
+        typedef FastMallocAllocator Allocator;
     };
 
     // Default integer traits disallow both 0 and -1 as keys (max value instead of -1 for unsigned).
@@ -187,6 +197,8 @@ namespace WTF {
 
         static const int minimumTableSize = FirstTraits::minimumTableSize;
 
+        typedef typename FirstTraits::Allocator Allocator;
+
         static void constructDeletedValue(TraitType& slot) { FirstTraits::constructDeletedValue(slot.first); }
         static bool isDeletedValue(const TraitType& value) { return FirstTraits::isDeletedValue(value.first); }
     };
@@ -233,6 +245,8 @@ namespace WTF {
 
         static const int minimumTableSize = KeyTraits::minimumTableSize;
 
+        typedef typename KeyTraits::Allocator Allocator;
+
         static void constructDeletedValue(TraitType& slot) { KeyTraits::constructDeletedValue(slot.key); }
         static bool isDeletedValue(const TraitType& value) { return KeyTraits::isDeletedValue(value.key); }
     };
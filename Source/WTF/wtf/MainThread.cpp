@@ -29,12 +29,15 @@
 #include "config.h"
 #include "MainThread.h"
 
+#include "Atomics.h"
 #include "CurrentTime.h"
 #include "Deque.h"
 #include "Functional.h"
 #include "StdLibExtras.h"
+#include "TCSpinLock.h"
 #include "Threading.h"
 #include <wtf/ThreadSpecific.h>
+#include <wtf/text/AtomicStringTable.h>
 
 namespace WTF {
 
@@ -67,6 +70,77 @@ public:
 
 typedef Deque<FunctionWithContext> FunctionQueue;
 
+// Functions posted from any thread are pushed onto one stack per priority without taking a lock.
+// The main thread takes a whole stack at once and moves it to the matching function queue, so
+// posting a function never contends with dispatching, which only locks to take the next function.
+struct PendingFunction {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    explicit PendingFunction(const FunctionWithContext& invocation)
+        : invocation(invocation)
+        , next(0)
+    {
+    }
+
+    FunctionWithContext invocation;
+    PendingFunction* next;
+};
+
+static PendingFunction* volatile pendingFunctions[numberOfMainThreadTaskPriorities];
+
+// Nodes are recycled instead of freed, so posting a function does not go through the allocator.
+// The main thread hands back a whole batch at once and any thread can take one node out.
+static const unsigned maxFreePendingFunctions = 256;
+static SpinLock freePendingFunctionsLock = SPINLOCK_INITIALIZER;
+static PendingFunction* freePendingFunctions;
+static unsigned freePendingFunctionCount;
+
+static PendingFunction* allocatePendingFunction(const FunctionWithContext& invocation)
+{
+    PendingFunction* function;
+    {
+        SpinLockHolder locker(&freePendingFunctionsLock);
+        function = freePendingFunctions;
+        if (function) {
+            freePendingFunctions = function->next;
+            --freePendingFunctionCount;
+        }
+    }
+
+    if (!function)
+        return new PendingFunction(invocation);
+
+    function->invocation = invocation;
+    function->next = 0;
+    return function;
+}
+
+// Frees the list of count nodes running from first to last.
+static void recyclePendingFunctions(PendingFunction* first, PendingFunction* last, unsigned count)
+{
+    {
+        SpinLockHolder locker(&freePendingFunctionsLock);
+        if (freePendingFunctionCount + count <= maxFreePendingFunctions) {
+            last->next = freePendingFunctions;
+            freePendingFunctions = first;
+            freePendingFunctionCount += count;
+            return;
+        }
+    }
+
+    while (first) {
+        PendingFunction* next = first->next;
+        delete first;
+        first = next;
+    }
+}
+
+// Set while a dispatch is scheduled and has not started yet, so that posting a batch of functions
+// wakes the main thread only once.
+static unsigned dispatchScheduled;
+
+static MainThreadDispatchStatistics dispatchStatistics;
+
 static bool callbacksPaused; // This global variable is only accessed from main thread.
 #if !PLATFORM(MAC)
 static ThreadIdentifier mainThreadIdentifier;
@@ -78,12 +152,127 @@ static Mutex& mainThreadFunctionQueueMutex()
     return staticMutex;
 }
 
-static FunctionQueue& functionQueue()
+static FunctionQueue& functionQueue(MainThreadTaskPriority priority)
+{
+    static FunctionQueue* staticFunctionQueues = new FunctionQueue[numberOfMainThreadTaskPriorities];
+    return staticFunctionQueues[priority];
+}
+
+#if !ENABLE(COMPARE_AND_SWAP)
+static Mutex& pendingFunctionsMutex()
+{
+    DEFINE_STATIC_LOCAL(Mutex, staticMutex, ());
+    return staticMutex;
+}
+#endif
+
+static void initializeFunctionQueueMutexes()
+{
+    mainThreadFunctionQueueMutex();
+#if !ENABLE(COMPARE_AND_SWAP)
+    pendingFunctionsMutex();
+#endif
+}
+
+static void pushPendingFunction(MainThreadTaskPriority priority, PendingFunction* function)
+{
+#if ENABLE(COMPARE_AND_SWAP)
+    PendingFunction* head;
+    do {
+        head = pendingFunctions[priority];
+        function->next = head;
+    } while (!weakCompareAndSwap(reinterpret_cast<void* volatile*>(&pendingFunctions[priority]), head, function));
+#else
+    MutexLocker locker(pendingFunctionsMutex());
+    function->next = pendingFunctions[priority];
+    pendingFunctions[priority] = function;
+#endif
+}
+
+// Only ever swaps the whole stack out, so there is no ABA problem with nodes being freed and reused.
+static PendingFunction* takePendingFunctions(MainThreadTaskPriority priority)
+{
+    PendingFunction* head;
+#if ENABLE(COMPARE_AND_SWAP)
+    do {
+        head = pendingFunctions[priority];
+        if (!head)
+            return 0;
+    } while (!weakCompareAndSwap(reinterpret_cast<void* volatile*>(&pendingFunctions[priority]), head, 0));
+#else
+    MutexLocker locker(pendingFunctionsMutex());
+    head = pendingFunctions[priority];
+    pendingFunctions[priority] = 0;
+#endif
+    return head;
+}
+
+// Must be called with mainThreadFunctionQueueMutex() held.
+static void movePendingFunctionsToQueue(MainThreadTaskPriority priority)
+{
+    if (!pendingFunctions[priority])
+        return;
+
+    // The stack holds the most recently posted function first.
+    PendingFunction* reversed = 0;
+    for (PendingFunction* function = takePendingFunctions(priority); function;) {
+        PendingFunction* next = function->next;
+        function->next = reversed;
+        reversed = function;
+        function = next;
+    }
+
+    FunctionQueue& queue = functionQueue(priority);
+    PendingFunction* last = 0;
+    unsigned count = 0;
+    for (PendingFunction* function = reversed; function; function = function->next) {
+        queue.append(function->invocation);
+        last = function;
+        ++count;
+    }
+    dispatchStatistics.postedFunctions[priority] += count;
+
+    recyclePendingFunctions(reversed, last, count);
+}
+
+// Must be called with mainThreadFunctionQueueMutex() held. Functions of a higher priority are
+// checked for before each function, so input posted in the middle of a long batch runs next.
+static bool takeNextFunction(FunctionWithContext& invocation, MainThreadTaskPriority& priority)
 {
-    DEFINE_STATIC_LOCAL(FunctionQueue, staticFunctionQueue, ());
-    return staticFunctionQueue;
+    for (unsigned i = 0; i < numberOfMainThreadTaskPriorities; ++i) {
+        priority = static_cast<MainThreadTaskPriority>(i);
+        movePendingFunctionsToQueue(priority);
+        FunctionQueue& queue = functionQueue(priority);
+        if (!queue.isEmpty()) {
+            invocation = queue.takeFirst();
+            return true;
+        }
+    }
+    return false;
 }
 
+static void scheduleDispatchIfNeeded()
+{
+#if ENABLE(COMPARE_AND_SWAP)
+    while (!dispatchScheduled) {
+        if (weakCompareAndSwap(&dispatchScheduled, 0, 1)) {
+            // Only the thread that set the flag gets here until the main thread clears it.
+            ++dispatchStatistics.scheduledDispatches;
+            scheduleDispatchFunctionsOnMainThread();
+            return;
+        }
+    }
+#else
+    {
+        MutexLocker locker(pendingFunctionsMutex());
+        if (dispatchScheduled)
+            return;
+        dispatchScheduled = 1;
+        ++dispatchStatistics.scheduledDispatches;
+    }
+    scheduleDispatchFunctionsOnMainThread();
+#endif
+}
 
 #if !PLATFORM(MAC)
 
@@ -95,8 +284,9 @@ void initializeMainThread()
     initializedMainThread = true;
 
     mainThreadIdentifier = currentThread();
+    AtomicStringTable::didInitializeMainThread();
 
-    mainThreadFunctionQueueMutex();
+    initializeFunctionQueueMutexes();
     initializeMainThreadPlatform();
     initializeGCThreads();
 }
@@ -107,7 +297,7 @@ static pthread_once_t initializeMainThreadKeyOnce = PTHREAD_ONCE_INIT;
 
 static void initializeMainThreadOnce()
 {
-    mainThreadFunctionQueueMutex();
+    initializeFunctionQueueMutexes();
     initializeMainThreadPlatform();
 }
 
@@ -119,7 +309,7 @@ void initializeMainThread()
 #if !USE(WEB_THREAD)
 static void initializeMainThreadToProcessMainThreadOnce()
 {
-    mainThreadFunctionQueueMutex();
+    initializeFunctionQueueMutexes();
     initializeMainThreadToProcessMainThreadPlatform();
 }
 
@@ -141,15 +331,30 @@ void dispatchFunctionsFromMainThread()
     if (callbacksPaused)
         return;
 
+    // Functions posted from now on must schedule another dispatch, since this one may already
+    // have looked at their queue.
+#if ENABLE(COMPARE_AND_SWAP)
+    dispatchScheduled = 0;
+    storeLoadFence();
+#else
+    {
+        MutexLocker locker(pendingFunctionsMutex());
+        dispatchScheduled = 0;
+    }
+#endif
+
+    ++dispatchStatistics.dispatches;
+
     double startTime = currentTime();
+    double functionStartTime = startTime;
 
     FunctionWithContext invocation;
+    MainThreadTaskPriority priority;
     while (true) {
         {
             MutexLocker locker(mainThreadFunctionQueueMutex());
-            if (!functionQueue().size())
+            if (!takeNextFunction(invocation, priority))
                 break;
-            invocation = functionQueue().takeFirst();
         }
 
         invocation.function(invocation.context);
@@ -158,28 +363,33 @@ void dispatchFunctionsFromMainThread()
             invocation.syncFlag->signal();
         }
 
+        double now = currentTime();
+        ++dispatchStatistics.dispatchedFunctions[priority];
+        dispatchStatistics.dispatchTime[priority] += now - functionStartTime;
+        functionStartTime = now;
+
         // If we are running accumulated functions for too long so UI may become unresponsive, we need to
         // yield so the user input can be processed. Otherwise user may not be able to even close the window.
         // This code has effect only in case the scheduleDispatchFunctionsOnMainThread() is implemented in a way that
         // allows input events to be processed before we are back here.
-        if (currentTime() - startTime > maxRunLoopSuspensionTime) {
-            scheduleDispatchFunctionsOnMainThread();
+        if (now - startTime > maxRunLoopSuspensionTime) {
+            ++dispatchStatistics.yieldedDispatches;
+            scheduleDispatchIfNeeded();
             break;
         }
     }
 }
 
-void callOnMainThread(MainThreadFunction* function, void* context)
+void callOnMainThread(MainThreadFunction* function, void* context, MainThreadTaskPriority priority)
 {
     ASSERT(function);
-    bool needToSchedule = false;
-    {
-        MutexLocker locker(mainThreadFunctionQueueMutex());
-        needToSchedule = functionQueue().size() == 0;
-        functionQueue().append(FunctionWithContext(function, context));
-    }
-    if (needToSchedule)
-        scheduleDispatchFunctionsOnMainThread();
+    pushPendingFunction(priority, allocatePendingFunction(FunctionWithContext(function, context)));
+    scheduleDispatchIfNeeded();
+}
+
+void callOnMainThread(MainThreadFunction* function, void* context)
+{
+    callOnMainThread(function, context, MainThreadNormalPriority);
 }
 
 void callOnMainThreadAndWait(MainThreadFunction* function, void* context)
@@ -194,9 +404,8 @@ void callOnMainThreadAndWait(MainThreadFunction* function, void* context)
     ThreadCondition syncFlag;
     Mutex& functionQueueMutex = mainThreadFunctionQueueMutex();
     MutexLocker locker(functionQueueMutex);
-    functionQueue().append(FunctionWithContext(function, context, &syncFlag));
-    if (functionQueue().size() == 1)
-        scheduleDispatchFunctionsOnMainThread();
+    pushPendingFunction(MainThreadNormalPriority, allocatePendingFunction(FunctionWithContext(function, context, &syncFlag)));
+    scheduleDispatchIfNeeded();
     syncFlag.wait(functionQueueMutex);
 }
 
@@ -208,13 +417,18 @@ void cancelCallOnMainThread(MainThreadFunction* function, void* context)
 
     FunctionWithContextFinder pred(FunctionWithContext(function, context));
 
-    while (true) {
-        // We must redefine 'i' each pass, because the itererator's operator= 
-        // requires 'this' to be valid, and remove() invalidates all iterators
-        FunctionQueue::iterator i(functionQueue().findIf(pred));
-        if (i == functionQueue().end())
-            break;
-        functionQueue().remove(i);
+    for (unsigned priorityIndex = 0; priorityIndex < numberOfMainThreadTaskPriorities; ++priorityIndex) {
+        MainThreadTaskPriority priority = static_cast<MainThreadTaskPriority>(priorityIndex);
+        movePendingFunctionsToQueue(priority);
+        FunctionQueue& queue = functionQueue(priority);
+        while (true) {
+            // We must redefine 'i' each pass, because the itererator's operator= 
+            // requires 'this' to be valid, and remove() invalidates all iterators
+            FunctionQueue::iterator i(queue.findIf(pred));
+            if (i == queue.end())
+                break;
+            queue.remove(i);
+        }
     }
 }
 
@@ -225,9 +439,22 @@ static void callFunctionObject(void* context)
     delete function;
 }
 
+void callOnMainThread(const Function<void ()>& function, MainThreadTaskPriority priority)
+{
+    callOnMainThread(callFunctionObject, new Function<void ()>(function), priority);
+}
+
 void callOnMainThread(const Function<void ()>& function)
 {
-    callOnMainThread(callFunctionObject, new Function<void ()>(function));
+    callOnMainThread(function, MainThreadNormalPriority);
+}
+
+MainThreadDispatchStatistics mainThreadDispatchStatistics()
+{
+    ASSERT(isMainThread());
+
+    MutexLocker locker(mainThreadFunctionQueueMutex());
+    return dispatchStatistics;
 }
 
 void setMainThreadCallbacksPaused(bool paused)
@@ -37,15 +37,49 @@ namespace WTF {
 typedef uint32_t ThreadIdentifier;
 typedef void MainThreadFunction(void*);
 
+enum MainThreadTaskPriority {
+    // Input handling and animation. Runs before any other pending function.
+    MainThreadInputPriority,
+    MainThreadNormalPriority,
+    // Only runs when no function of a higher priority is pending.
+    MainThreadBackgroundPriority
+};
+
+const unsigned numberOfMainThreadTaskPriorities = MainThreadBackgroundPriority + 1;
+
+// Accounting for the functions dispatched by callOnMainThread. The arrays are indexed by MainThreadTaskPriority.
+struct MainThreadDispatchStatistics {
+    uint64_t postedFunctions[numberOfMainThreadTaskPriorities];
+    uint64_t dispatchedFunctions[numberOfMainThreadTaskPriorities];
+    double dispatchTime[numberOfMainThreadTaskPriorities];
+
+    // Each dispatch is one wakeup of the main thread. Posting functions while a dispatch is
+    // already scheduled does not wake it up again, so postedFunctions / dispatches is the
+    // average batch size.
+    uint64_t dispatches;
+
+    // Times the main thread was asked to wake up. A batch posted before the main thread gets
+    // to it schedules one dispatch, so this only grows by one per batch.
+    uint64_t scheduledDispatches;
+
+    // Dispatches that ran out of their time slice and yielded to the run loop with functions still pending.
+    uint64_t yieldedDispatches;
+};
+
 // Must be called from the main thread.
 WTF_EXPORT_PRIVATE void initializeMainThread();
 
 WTF_EXPORT_PRIVATE void callOnMainThread(MainThreadFunction*, void* context);
+WTF_EXPORT_PRIVATE void callOnMainThread(MainThreadFunction*, void* context, MainThreadTaskPriority);
 WTF_EXPORT_PRIVATE void callOnMainThreadAndWait(MainThreadFunction*, void* context);
 WTF_EXPORT_PRIVATE void cancelCallOnMainThread(MainThreadFunction*, void* context);
 
 template<typename> class Function;
 WTF_EXPORT_PRIVATE void callOnMainThread(const Function<void ()>&);
+WTF_EXPORT_PRIVATE void callOnMainThread(const Function<void ()>&, MainThreadTaskPriority);
+
+// Must be called from the main thread.
+WTF_EXPORT_PRIVATE MainThreadDispatchStatistics mainThreadDispatchStatistics();
     
 WTF_EXPORT_PRIVATE void setMainThreadCallbacksPaused(bool paused);
 
@@ -73,7 +107,7 @@ inline bool isMainThreadOrGCThread() { return isMainThread(); }
 // NOTE: these functions are internal to the callOnMainThread implementation.
 void initializeMainThreadPlatform();
 void scheduleDispatchFunctionsOnMainThread();
-void dispatchFunctionsFromMainThread();
+WTF_EXPORT_PRIVATE void dispatchFunctionsFromMainThread();
 
 #if PLATFORM(MAC)
 #if !USE(WEB_THREAD)
@@ -90,6 +124,12 @@ void initializeMainThreadToProcessMainThreadPlatform();
 using WTF::callOnMainThread;
 using WTF::callOnMainThreadAndWait;
 using WTF::cancelCallOnMainThread;
+using WTF::mainThreadDispatchStatistics;
+using WTF::MainThreadDispatchStatistics;
+using WTF::MainThreadBackgroundPriority;
+using WTF::MainThreadInputPriority;
+using WTF::MainThreadNormalPriority;
+using WTF::MainThreadTaskPriority;
 using WTF::setMainThreadCallbacksPaused;
 using WTF::isMainThread;
 using WTF::isMainThreadOrGCThread;
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "MemoryUsageRegistry.h"
+
+#include "CurrentTime.h"
+#include "StdLibExtras.h"
+#include <string.h>
+
+namespace WTF {
+
+size_t MemoryUsageReport::totalBytes() const
+{
+    size_t total = 0;
+    for (size_t i = 0; i < m_entries.size(); ++i)
+        total += m_entries[i].bytes;
+    return total;
+}
+
+bool MemoryUsageReport::isInCategory(const char* name, const char* category)
+{
+    size_t length = strlen(category);
+    return !strncmp(name, category, length) && (!name[length] || name[length] == '.');
+}
+
+size_t MemoryUsageReport::bytes(const char* category) const
+{
+    size_t total = 0;
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        if (isInCategory(m_entries[i].category, category))
+            total += m_entries[i].bytes;
+    }
+    return total;
+}
+
+MemoryUsageRegistry& MemoryUsageRegistry::shared()
+{
+    DEFINE_STATIC_LOCAL(MemoryUsageRegistry, registry, ());
+    return registry;
+}
+
+void MemoryUsageRegistry::addReporter(MemoryUsageReporter reporter)
+{
+    MutexLocker locker(m_mutex);
+    if (m_reporters.find(reporter) == notFound)
+        m_reporters.append(reporter);
+}
+
+void MemoryUsageRegistry::removeReporter(MemoryUsageReporter reporter)
+{
+    MutexLocker locker(m_mutex);
+    size_t index = m_reporters.find(reporter);
+    if (index != notFound)
+        m_reporters.remove(index);
+}
+
+size_t MemoryUsageRegistry::findBudget(const char* category) const
+{
+    for (size_t i = 0; i < m_budgets.size(); ++i) {
+        if (!strcmp(m_budgets[i].category, category))
+            return i;
+    }
+    return notFound;
+}
+
+void MemoryUsageRegistry::setBudget(const char* category, size_t bytes)
+{
+    MutexLocker locker(m_mutex);
+    size_t index = findBudget(category);
+    if (index == notFound)
+        m_budgets.append(Budget(category, bytes));
+    else
+        m_budgets[index].bytes = bytes;
+}
+
+void MemoryUsageRegistry::clearBudget(const char* category)
+{
+    MutexLocker locker(m_mutex);
+    size_t index = findBudget(category);
+    if (index != notFound)
+        m_budgets.remove(index);
+}
+
+void MemoryUsageRegistry::collect(MemoryUsageReport& report)
+{
+    Vector<MemoryUsageReporter> reporters;
+    Vector<Budget> budgets;
+    {
+        // Reporters may take locks of their own, so they run without holding the registry lock.
+        MutexLocker locker(m_mutex);
+        reporters = m_reporters;
+        budgets = m_budgets;
+    }
+
+    report.m_entries.clear();
+    report.m_categoriesOverBudget.clear();
+    report.m_timestamp = currentTime();
+
+    for (size_t i = 0; i < reporters.size(); ++i)
+        reporters[i](report);
+
+    for (size_t i = 0; i < budgets.size(); ++i) {
+        if (report.bytes(budgets[i].category) > budgets[i].bytes)
+            report.m_categoriesOverBudget.append(budgets[i].category);
+    }
+}
+
+} // namespace WTF
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MemoryUsageRegistry_h
+#define MemoryUsageRegistry_h
+
+#include <wtf/Noncopyable.h>
+#include <wtf/ThreadingPrimitives.h>
+#include <wtf/Vector.h>
+
+namespace WTF {
+
+// The live bytes of every subsystem that registered a reporter, collected at one point in time.
+// Categories are dotted names such as "WebCore.MemoryCache.Images". Reporters must not report
+// the same bytes under two categories, so that the bytes of a report add up.
+class MemoryUsageReport {
+public:
+    struct Entry {
+        Entry(const char* category, size_t bytes)
+            : category(category)
+            , bytes(bytes)
+        {
+        }
+
+        const char* category;
+        size_t bytes;
+    };
+
+    MemoryUsageReport()
+        : m_timestamp(0)
+    {
+    }
+
+    // The category must be a string literal, since the report keeps the pointer.
+    void add(const char* category, size_t bytes) { m_entries.append(Entry(category, bytes)); }
+
+    const Vector<Entry>& entries() const { return m_entries; }
+    double timestamp() const { return m_timestamp; }
+
+    WTF_EXPORT_PRIVATE size_t totalBytes() const;
+
+    // The bytes of a category and its subcategories, so "WebCore.MemoryCache" includes
+    // "WebCore.MemoryCache.Images".
+    WTF_EXPORT_PRIVATE size_t bytes(const char* category) const;
+
+    // The categories with a budget in the registry that this report exceeds.
+    const Vector<const char*>& categoriesOverBudget() const { return m_categoriesOverBudget; }
+
+    WTF_EXPORT_PRIVATE static bool isInCategory(const char* name, const char* category);
+
+private:
+    friend class MemoryUsageRegistry;
+
+    Vector<Entry> m_entries;
+    Vector<const char*> m_categoriesOverBudget;
+    double m_timestamp;
+};
+
+typedef void (*MemoryUsageReporter)(MemoryUsageReport&);
+
+// One place to ask every subsystem how much memory it holds, instead of gathering the
+// statistics of each one in its own shape. Reporters run on the thread that calls collect(),
+// and most of them read main thread data structures.
+class MemoryUsageRegistry {
+    WTF_MAKE_NONCOPYABLE(MemoryUsageRegistry); WTF_MAKE_FAST_ALLOCATED;
+public:
+    WTF_EXPORT_PRIVATE static MemoryUsageRegistry& shared();
+
+    WTF_EXPORT_PRIVATE void addReporter(MemoryUsageReporter);
+    WTF_EXPORT_PRIVATE void removeReporter(MemoryUsageReporter);
+
+    // Budgets apply to a category and its subcategories. The category must be a string literal.
+    WTF_EXPORT_PRIVATE void setBudget(const char* category, size_t bytes);
+    WTF_EXPORT_PRIVATE void clearBudget(const char* category);
+
+    WTF_EXPORT_PRIVATE void collect(MemoryUsageReport&);
+
+private:
+    MemoryUsageRegistry() { }
+
+    struct Budget {
+        Budget(const char* category, size_t bytes)
+            : category(category)
+            , bytes(bytes)
+        {
+        }
+
+        const char* category;
+        size_t bytes;
+    };
+
+    size_t findBudget(const char* category) const;
+
+    Mutex m_mutex;
+    Vector<MemoryUsageReporter> m_reporters;
+    Vector<Budget> m_budgets;
+};
+
+} // namespace WTF
+
+using WTF::MemoryUsageRegistry;
+using WTF::MemoryUsageReport;
+using WTF::MemoryUsageReporter;
+
+#endif // MemoryUsageRegistry_h
@@ -30,11 +30,11 @@
 
 #if ENABLE(THREADING_GENERIC)
 
-#include <wtf/RefCounted.h>
-#include <wtf/Threading.h>
+#include <wtf/FastAllocBase.h>
 
 namespace WTF {
 
+// Runs the jobs on the shared ThreadPool. The calling thread runs one of them.
 class ParallelEnvironment {
     WTF_MAKE_FAST_ALLOCATED;
 public:
@@ -49,47 +49,10 @@ public:
 
     WTF_EXPORT_PRIVATE void execute(void* parameters);
 
-    class ThreadPrivate : public RefCounted<ThreadPrivate> {
-    public:
-        ThreadPrivate()
-            : m_threadID(0)
-            , m_running(false)
-            , m_parent(0)
-        {
-        }
-
-        bool tryLockFor(ParallelEnvironment*);
-
-        void execute(ThreadFunction, void*);
-
-        void waitForFinish();
-
-        static PassRefPtr<ThreadPrivate> create()
-        {
-            return adoptRef(new ThreadPrivate());
-        }
-
-        static void workerThread(void*);
-
-    private:
-        ThreadIdentifier m_threadID;
-        bool m_running;
-        ParallelEnvironment* m_parent;
-
-        mutable Mutex m_mutex;
-        ThreadCondition m_threadCondition;
-
-        ThreadFunction m_threadFunction;
-        void* m_parameters;
-    };
-
 private:
     ThreadFunction m_threadFunction;
     size_t m_sizeOfParameter;
     int m_numberOfJobs;
-
-    Vector< RefPtr<ThreadPrivate> > m_threads;
-    static Vector< RefPtr<ThreadPrivate> >* s_threadPool;
 };
 
 } // namespace WTF
@@ -51,8 +51,8 @@ namespace WTF {
         
         typedef HashArg HashFunctions;
 
-        typedef HashTable<KeyType, ValueType, KeyValuePairKeyExtractor<ValueType>,
-            HashFunctions, ValueTraits, KeyTraits> HashTableType;
+        typedef typename HashTableSelector<KeyType, ValueType, KeyValuePairKeyExtractor<ValueType>,
+            HashFunctions, ValueTraits, KeyTraits>::Type HashTableType;
 
         typedef HashMapTranslator<ValueTraits, HashFunctions>
             Translator;
@@ -22,20 +22,24 @@
 #ifndef WTF_StringHasher_h
 #define WTF_StringHasher_h
 
+#include <string.h>
 #include <wtf/unicode/Unicode.h>
 
 namespace WTF {
 
-// Paul Hsieh's SuperFastHash
-// http://www.azillionmonkeys.com/qed/hash.html
+// The hasher consumes characters as 16-bit code units, four at a time, so that each round
+// mixes one 64-bit word with a multiply and a rotate. The dependency chain per round is
+// short, and 8-bit and 16-bit strings with the same code points produce the same words.
+// The finalizer is the 64-bit finalizer from Austin Appleby's MurmurHash3.
 
 // LChar data is interpreted as Latin-1-encoded (zero extended to 16 bits).
 
 // NOTE: The hash computation here must stay in sync with the create_hash_table script in
-// JavaScriptCore and the CodeGeneratorJS.pm script in WebCore.
+// JavaScriptCore and the Hasher.pm script in WebCore.
 
 // Golden ratio. Arbitrary start value to avoid mapping all zeros to a hash value of zero.
-static const unsigned stringHashingStartValue = 0x9E3779B9U;
+static const uint64_t stringHashingStartValue = 0x9E3779B97F4A7C15ULL;
+static const uint64_t stringHashingMultiplier = 0xFF51AFD7ED558CCDULL;
 
 class StringHasher {
 public:
@@ -43,84 +47,54 @@ public:
 
     StringHasher()
         : m_hash(stringHashingStartValue)
-        , m_hasPendingCharacter(false)
-        , m_pendingCharacter(0)
+        , m_pendingCharacters(0)
+        , m_pendingCharacterCount(0)
+        , m_length(0)
     {
     }
 
-    // The hasher hashes two characters at a time, and thus an "aligned" hasher is one
-    // where an even number of characters have been added. Callers that always add
-    // characters two at a time can use the "assuming aligned" functions.
+    // The "aligned" functions are for callers that always add characters two at a time,
+    // and thus only ever leave an even number of characters pending.
     void addCharactersAssumingAligned(UChar a, UChar b)
     {
-        ASSERT(!m_hasPendingCharacter);
-        m_hash += a;
-        m_hash = (m_hash << 16) ^ ((b << 11) ^ m_hash);
-        m_hash += m_hash >> 11;
+        ASSERT(!(m_pendingCharacterCount & 1));
+        m_pendingCharacters |= (static_cast<uint64_t>(a) | static_cast<uint64_t>(b) << 16) << (16 * m_pendingCharacterCount);
+        m_pendingCharacterCount += 2;
+        m_length += 2;
+        if (m_pendingCharacterCount == charactersPerWord)
+            addPendingWord();
     }
 
     void addCharacter(UChar character)
     {
-        if (m_hasPendingCharacter) {
-            m_hasPendingCharacter = false;
-            addCharactersAssumingAligned(m_pendingCharacter, character);
-            return;
-        }
-
-        m_pendingCharacter = character;
-        m_hasPendingCharacter = true;
+        m_pendingCharacters |= static_cast<uint64_t>(character) << (16 * m_pendingCharacterCount);
+        ++m_length;
+        if (++m_pendingCharacterCount == charactersPerWord)
+            addPendingWord();
     }
 
     void addCharacters(UChar a, UChar b)
     {
-        if (m_hasPendingCharacter) {
-#if !ASSERT_DISABLED
-            m_hasPendingCharacter = false;
-#endif
-            addCharactersAssumingAligned(m_pendingCharacter, a);
-            m_pendingCharacter = b;
-#if !ASSERT_DISABLED
-            m_hasPendingCharacter = true;
-#endif
-            return;
-        }
-
-        addCharactersAssumingAligned(a, b);
+        addCharacter(a);
+        addCharacter(b);
     }
 
     template<typename T, UChar Converter(T)> void addCharactersAssumingAligned(const T* data, unsigned length)
     {
-        ASSERT(!m_hasPendingCharacter);
-
-        bool remainder = length & 1;
-        length >>= 1;
-
-        while (length--) {
-            addCharactersAssumingAligned(Converter(data[0]), Converter(data[1]));
-            data += 2;
-        }
-
-        if (remainder)
-            addCharacter(Converter(*data));
+        ASSERT(!(m_pendingCharacterCount & 1));
+        addCharacters<T, Converter>(data, length);
     }
 
     template<typename T> void addCharactersAssumingAligned(const T* data, unsigned length)
     {
-        addCharactersAssumingAligned<T, defaultConverter>(data, length);
+        ASSERT(!(m_pendingCharacterCount & 1));
+        addCharacters(data, length);
     }
 
     template<typename T, UChar Converter(T)> void addCharactersAssumingAligned(const T* data)
     {
-        ASSERT(!m_hasPendingCharacter);
-
-        while (T a = *data++) {
-            T b = *data++;
-            if (!b) {
-                addCharacter(Converter(a));
-                break;
-            }
-            addCharactersAssumingAligned(Converter(a), Converter(b));
-        }
+        ASSERT(!(m_pendingCharacterCount & 1));
+        addCharacters<T, Converter>(data);
     }
 
     template<typename T> void addCharactersAssumingAligned(const T* data)
@@ -130,26 +104,33 @@ public:
 
     template<typename T, UChar Converter(T)> void addCharacters(const T* data, unsigned length)
     {
-        if (m_hasPendingCharacter && length) {
-            m_hasPendingCharacter = false;
-            addCharactersAssumingAligned(m_pendingCharacter, Converter(*data++));
+        while (m_pendingCharacterCount && length) {
+            addCharacter(Converter(*data++));
             --length;
         }
-        addCharactersAssumingAligned<T, Converter>(data, length);
+        for (; length >= charactersPerWord; length -= charactersPerWord, data += charactersPerWord)
+            addWord(Converter(data[0]) | static_cast<uint64_t>(Converter(data[1])) << 16 | static_cast<uint64_t>(Converter(data[2])) << 32 | static_cast<uint64_t>(Converter(data[3])) << 48);
+        while (length--)
+            addCharacter(Converter(*data++));
     }
 
+    // Without a converter, whole words are loaded directly from the character data.
     template<typename T> void addCharacters(const T* data, unsigned length)
     {
-        addCharacters<T, defaultConverter>(data, length);
+        while (m_pendingCharacterCount && length) {
+            addCharacter(*data++);
+            --length;
+        }
+        for (; length >= charactersPerWord; length -= charactersPerWord, data += charactersPerWord)
+            addWord(loadWord(data));
+        while (length--)
+            addCharacter(*data++);
     }
 
     template<typename T, UChar Converter(T)> void addCharacters(const T* data)
     {
-        if (m_hasPendingCharacter && *data) {
-            m_hasPendingCharacter = false;
-            addCharactersAssumingAligned(m_pendingCharacter, Converter(*data++));
-        }
-        addCharactersAssumingAligned<T, Converter>(data);
+        while (T character = *data++)
+            addCharacter(Converter(character));
     }
 
     template<typename T> void addCharacters(const T* data)
@@ -159,53 +140,31 @@ public:
 
     unsigned hashWithTop8BitsMasked() const
     {
-        unsigned result = avalancheBits();
-
-        // Reserving space from the high bits for flags preserves most of the hash's
-        // value, since hash lookup typically masks out the high bits anyway.
-        result &= (1U << (sizeof(result) * 8 - flagCount)) - 1;
-
-        // This avoids ever returning a hash code of 0, since that is used to
-        // signal "hash not computed yet". Setting the high bit maintains
-        // reasonable fidelity to a hash code of 0 because it is likely to yield
-        // exactly 0 when hash lookup masks out the high bits.
-        if (!result)
-            result = 0x80000000 >> flagCount;
-
-        return result;
+        return maskTop8Bits(avalancheBits());
     }
 
     unsigned hash() const
     {
-        unsigned result = avalancheBits();
-
-        // This avoids ever returning a hash code of 0, since that is used to
-        // signal "hash not computed yet". Setting the high bit maintains
-        // reasonable fidelity to a hash code of 0 because it is likely to yield
-        // exactly 0 when hash lookup masks out the high bits.
-        if (!result)
-            result = 0x80000000;
-
-        return result;
+        return avoidZero(avalancheBits());
     }
 
     template<typename T, UChar Converter(T)> static unsigned computeHashAndMaskTop8Bits(const T* data, unsigned length)
     {
         StringHasher hasher;
-        hasher.addCharactersAssumingAligned<T, Converter>(data, length);
+        hasher.addCharacters<T, Converter>(data, length);
         return hasher.hashWithTop8BitsMasked();
     }
 
     template<typename T, UChar Converter(T)> static unsigned computeHashAndMaskTop8Bits(const T* data)
     {
         StringHasher hasher;
-        hasher.addCharactersAssumingAligned<T, Converter>(data);
+        hasher.addCharacters<T, Converter>(data);
         return hasher.hashWithTop8BitsMasked();
     }
 
     template<typename T> static unsigned computeHashAndMaskTop8Bits(const T* data, unsigned length)
     {
-        return computeHashAndMaskTop8Bits<T, defaultConverter>(data, length);
+        return maskTop8Bits(avalancheBits(hashWords(data, length), length));
     }
 
     template<typename T> static unsigned computeHashAndMaskTop8Bits(const T* data)
@@ -216,20 +175,20 @@ public:
     template<typename T, UChar Converter(T)> static unsigned computeHash(const T* data, unsigned length)
     {
         StringHasher hasher;
-        hasher.addCharactersAssumingAligned<T, Converter>(data, length);
+        hasher.addCharacters<T, Converter>(data, length);
         return hasher.hash();
     }
 
     template<typename T, UChar Converter(T)> static unsigned computeHash(const T* data)
     {
         StringHasher hasher;
-        hasher.addCharactersAssumingAligned<T, Converter>(data);
+        hasher.addCharacters<T, Converter>(data);
         return hasher.hash();
     }
 
     template<typename T> static unsigned computeHash(const T* data, unsigned length)
     {
-        return computeHash<T, defaultConverter>(data, length);
+        return avoidZero(avalancheBits(hashWords(data, length), length));
     }
 
     template<typename T> static unsigned computeHash(const T* data)
@@ -253,6 +212,8 @@ public:
     }
 
 private:
+    static const unsigned charactersPerWord = 4;
+
     static UChar defaultConverter(UChar character)
     {
         return character;
@@ -263,30 +224,128 @@ private:
         return character;
     }
 
-    unsigned avalancheBits() const
+    // A word holds four characters as 16-bit lanes, the first character in the low lane.
+    static uint64_t loadWord(const UChar* data)
     {
-        unsigned result = m_hash;
+#if CPU(BIG_ENDIAN) || CPU(MIDDLE_ENDIAN)
+        return data[0] | static_cast<uint64_t>(data[1]) << 16 | static_cast<uint64_t>(data[2]) << 32 | static_cast<uint64_t>(data[3]) << 48;
+#else
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+        return word;
+#endif
+    }
 
-        // Handle end case.
-        if (m_hasPendingCharacter) {
-            result += m_pendingCharacter;
-            result ^= result << 11;
-            result += result >> 17;
+    static uint64_t loadWord(const LChar* data)
+    {
+#if CPU(BIG_ENDIAN) || CPU(MIDDLE_ENDIAN)
+        return data[0] | static_cast<uint64_t>(data[1]) << 16 | static_cast<uint64_t>(data[2]) << 32 | static_cast<uint64_t>(data[3]) << 48;
+#else
+        uint32_t characters;
+        memcpy(&characters, data, sizeof(characters));
+        // Spread the four bytes out into the four 16-bit lanes.
+        uint64_t word = characters;
+        word = (word | word << 16) & 0x0000FFFF0000FFFFULL;
+        word = (word | word << 8) & 0x00FF00FF00FF00FFULL;
+        return word;
+#endif
+    }
+
+    static uint64_t mixWord(uint64_t hash, uint64_t word)
+    {
+        hash = (hash ^ word) * stringHashingMultiplier;
+        return (hash << 31) | (hash >> 33);
+    }
+
+    void addWord(uint64_t word)
+    {
+        ASSERT(!m_pendingCharacterCount);
+        m_hash = mixWord(m_hash, word);
+        m_length += charactersPerWord;
+    }
+
+    void addPendingWord()
+    {
+        m_hash = mixWord(m_hash, m_pendingCharacters);
+        m_pendingCharacters = 0;
+        m_pendingCharacterCount = 0;
+    }
+
+    // Hashes the characters in whole words, with the last partial word padded with null characters.
+    template<typename T> static uint64_t hashWords(const T* data, unsigned length)
+    {
+        uint64_t hash = stringHashingStartValue;
+        for (unsigned words = length / charactersPerWord; words; --words, data += charactersPerWord)
+            hash = mixWord(hash, loadWord(data));
+
+        unsigned remainder = length % charactersPerWord;
+        if (remainder) {
+            uint64_t word = data[0];
+            if (remainder > 1)
+                word |= static_cast<uint64_t>(data[1]) << 16;
+            if (remainder > 2)
+                word |= static_cast<uint64_t>(data[2]) << 32;
+            hash = mixWord(hash, word);
         }
+        return hash;
+    }
+
+    unsigned avalancheBits() const
+    {
+        uint64_t result = m_hash;
+        if (m_pendingCharacterCount)
+            result = mixWord(result, m_pendingCharacters);
+        return avalancheBits(result, m_length);
+    }
+
+    static unsigned avalancheBits(uint64_t result, unsigned length)
+    {
+        // Handle end case. Mixing in the length keeps strings that differ only in trailing
+        // null characters apart.
+        result ^= length;
+
+        // Force "avalanching" of all 64 bits.
+        result ^= result >> 33;
+        result *= 0xFF51AFD7ED558CCDULL;
+        result ^= result >> 33;
+        result *= 0xC4CEB9FE1A85EC53ULL;
+        result ^= result >> 33;
+
+        return static_cast<unsigned>(result);
+    }
+
+    static unsigned maskTop8Bits(unsigned result)
+    {
+        // Reserving space from the high bits for flags preserves most of the hash's
+        // value, since hash lookup typically masks out the high bits anyway.
+        result &= (1U << (sizeof(result) * 8 - flagCount)) - 1;
+
+        // This avoids ever returning a hash code of 0, since that is used to
+        // signal "hash not computed yet". Setting the high bit maintains
+        // reasonable fidelity to a hash code of 0 because it is likely to yield
+        // exactly 0 when hash lookup masks out the high bits.
+        if (!result)
+            result = 0x80000000 >> flagCount;
 
-        // Force "avalanching" of final 31 bits.
-        result ^= result << 3;
-        result += result >> 5;
-        result ^= result << 2;
-        result += result >> 15;
-        result ^= result << 10;
+        return result;
+    }
+
+    static unsigned avoidZero(unsigned result)
+    {
+        // This avoids ever returning a hash code of 0, since that is used to
+        // signal "hash not computed yet". Setting the high bit maintains
+        // reasonable fidelity to a hash code of 0 because it is likely to yield
+        // exactly 0 when hash lookup masks out the high bits.
+        if (!result)
+            result = 0x80000000;
 
         return result;
     }
 
-    unsigned m_hash;
-    bool m_hasPendingCharacter;
-    UChar m_pendingCharacter;
+    uint64_t m_hash;
+    uint64_t m_pendingCharacters;
+    unsigned m_pendingCharacterCount;
+    unsigned m_length;
 };
 
 } // namespace WTF
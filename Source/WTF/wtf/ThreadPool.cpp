@@ -0,0 +1,326 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <wtf/Atomics.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/NumberOfCores.h>
+
+namespace WTF {
+
+// How long TaskGroup::wait() sleeps before looking for pending tasks to run again.
+static const double taskGroupWaitInterval = 0.01;
+
+// How long a worker waits for a task before its thread exits.
+static const double workerIdleTimeout = 1;
+
+class ThreadPool::Worker {
+    WTF_MAKE_NONCOPYABLE(Worker); WTF_MAKE_FAST_ALLOCATED;
+public:
+    Worker(ThreadPool& pool, size_t index)
+        : pool(pool)
+        , index(index)
+        , thread(0)
+        , isRunning(false)
+    {
+    }
+
+    ThreadPool& pool;
+    size_t index;
+    volatile ThreadIdentifier thread;
+
+    // Set with the pool's lock held, from the moment the thread is created until it has
+    // decided to exit. A worker only exits with an empty deque.
+    bool isRunning;
+
+    Mutex lock;
+    Deque<Task> tasks;
+};
+
+ThreadPool& ThreadPool::shared()
+{
+    AtomicallyInitializedStatic(ThreadPool&, pool = *new ThreadPool(std::max(numberOfProcessorCores() - 1, 1)));
+    return pool;
+}
+
+ThreadPool::ThreadPool(unsigned numberOfWorkers)
+    : m_numberOfIdleWorkers(0)
+    , m_numberOfPendingTasks(0)
+    , m_numberOfRunningWorkers(0)
+{
+    // Workers steal from each other, so all of them exist up front, but their threads are
+    // only started once there is work for them.
+    for (unsigned i = 0; i < numberOfWorkers; ++i)
+        m_workers.append(adoptPtr(new Worker(*this, i)));
+}
+
+void ThreadPool::dispatch(const Function<void()>& function, Priority priority)
+{
+    Task task;
+    task.function = function;
+    enqueue(task, priority);
+}
+
+void ThreadPool::enqueue(const Task& task, Priority priority)
+{
+    if (Worker* worker = currentWorker()) {
+        MutexLocker locker(worker->lock);
+        worker->tasks.append(task);
+    } else {
+        MutexLocker locker(m_lock);
+        m_queues[priority].append(task);
+    }
+
+    // A worker that is about to sleep first counts itself idle, then checks for pending
+    // tasks, so either it sees this task or we see it and wake it up.
+    atomicIncrement(&m_numberOfPendingTasks);
+    if (m_numberOfIdleWorkers || m_numberOfRunningWorkers < m_workers.size())
+        wakeOrStartWorker();
+}
+
+void ThreadPool::wakeOrStartWorker()
+{
+    // A worker only stops with m_lock held, after seeing no pending tasks, so under the
+    // lock it is either still idle and gets the signal or already counted as stopped.
+    MutexLocker locker(m_lock);
+    if (m_numberOfIdleWorkers) {
+        m_condition.signal();
+        return;
+    }
+
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        Worker* worker = m_workers[i].get();
+        if (worker->isRunning)
+            continue;
+        worker->isRunning = true;
+        ++m_numberOfRunningWorkers;
+        detachThread(createThread(workerThreadStart, worker, "WTF::ThreadPool"));
+        return;
+    }
+}
+
+ThreadPool::Worker* ThreadPool::currentWorker() const
+{
+    ThreadIdentifier thread = currentThread();
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        if (m_workers[i]->thread == thread)
+            return m_workers[i].get();
+    }
+    return 0;
+}
+
+bool ThreadPool::takeTaskFromOwnDeque(Worker* worker, Task& task)
+{
+    MutexLocker locker(worker->lock);
+    if (worker->tasks.isEmpty())
+        return false;
+    task = worker->tasks.takeLast();
+    return true;
+}
+
+bool ThreadPool::takeTaskFromSharedQueues(Task& task)
+{
+    MutexLocker locker(m_lock);
+    for (unsigned priority = 0; priority < numberOfPriorities; ++priority) {
+        if (!m_queues[priority].isEmpty()) {
+            task = m_queues[priority].takeFirst();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::stealTask(Worker* thief, Task& task)
+{
+    // Start with the worker after the thief so that thieves spread over the victims.
+    size_t start = thief ? thief->index + 1 : 0;
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        Worker* victim = m_workers[(start + i) % m_workers.size()].get();
+        if (victim == thief)
+            continue;
+
+        MutexLocker locker(victim->lock);
+        if (!victim->tasks.isEmpty()) {
+            task = victim->tasks.takeFirst();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::takeTask(Worker* worker, Task& task)
+{
+    if (!m_numberOfPendingTasks)
+        return false;
+
+    if ((worker && takeTaskFromOwnDeque(worker, task)) || takeTaskFromSharedQueues(task) || stealTask(worker, task)) {
+        atomicDecrement(&m_numberOfPendingTasks);
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::runTask(Task& task)
+{
+    if (!task.group) {
+        task.function();
+        return;
+    }
+
+    if (!task.group->isCancelled())
+        task.function();
+    task.group->taskDidFinish();
+}
+
+bool ThreadPool::takeTaskFromGroup(Deque<Task>& tasks, TaskGroup* group, Task& task)
+{
+    for (Deque<Task>::iterator it = tasks.begin(); it != tasks.end(); ++it) {
+        if (it->group == group) {
+            task = *it;
+            tasks.remove(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::takeTaskFromGroup(TaskGroup* group, Task& task)
+{
+    if (!m_numberOfPendingTasks)
+        return false;
+
+    // Unlike takeTask(), this has to scan the queues, but it only runs on threads
+    // that would otherwise be blocked in TaskGroup::wait().
+    bool found = false;
+    if (Worker* worker = currentWorker()) {
+        MutexLocker locker(worker->lock);
+        found = takeTaskFromGroup(worker->tasks, group, task);
+    }
+    if (!found) {
+        MutexLocker locker(m_lock);
+        found = takeTaskFromGroup(m_queues[group->m_priority], group, task);
+    }
+    for (size_t i = 0; !found && i < m_workers.size(); ++i) {
+        MutexLocker locker(m_workers[i]->lock);
+        found = takeTaskFromGroup(m_workers[i]->tasks, group, task);
+    }
+
+    if (found)
+        atomicDecrement(&m_numberOfPendingTasks);
+    return found;
+}
+
+void ThreadPool::workerThreadStart(void* argument)
+{
+    Worker* worker = static_cast<Worker*>(argument);
+    worker->thread = currentThread();
+    worker->pool.workerLoop(worker);
+}
+
+void ThreadPool::workerLoop(Worker* worker)
+{
+    while (true) {
+        {
+            Task task;
+            if (takeTask(worker, task)) {
+                runTask(task);
+                continue;
+            }
+        }
+
+        MutexLocker locker(m_lock);
+        atomicIncrement(&m_numberOfIdleWorkers);
+        double deadline = currentTime() + workerIdleTimeout;
+        bool timedOut = false;
+        while (!m_numberOfPendingTasks && !timedOut)
+            timedOut = !m_condition.timedWait(m_lock, deadline);
+        atomicDecrement(&m_numberOfIdleWorkers);
+
+        if (timedOut && !m_numberOfPendingTasks) {
+            ASSERT(worker->tasks.isEmpty());
+            worker->thread = 0;
+            worker->isRunning = false;
+            --m_numberOfRunningWorkers;
+            return;
+        }
+    }
+}
+
+TaskGroup::TaskGroup(ThreadPool::Priority priority)
+    : m_priority(priority)
+    , m_cancelled(false)
+    , m_numberOfUnfinishedTasks(0)
+{
+}
+
+void TaskGroup::dispatch(const Function<void()>& function)
+{
+    {
+        MutexLocker locker(m_lock);
+        ++m_numberOfUnfinishedTasks;
+    }
+
+    ThreadPool::Task task;
+    task.function = function;
+    task.group = this;
+    ThreadPool::shared().enqueue(task, m_priority);
+}
+
+void TaskGroup::taskDidFinish()
+{
+    MutexLocker locker(m_lock);
+    ASSERT(m_numberOfUnfinishedTasks);
+    if (!--m_numberOfUnfinishedTasks)
+        m_condition.broadcast();
+}
+
+void TaskGroup::wait()
+{
+    ThreadPool& pool = ThreadPool::shared();
+    while (true) {
+        {
+            MutexLocker locker(m_lock);
+            if (!m_numberOfUnfinishedTasks)
+                return;
+        }
+
+        ThreadPool::Task task;
+        if (pool.takeTaskFromGroup(this, task)) {
+            ThreadPool::runTask(task);
+            continue;
+        }
+
+        // Our remaining tasks are running on other threads. Wake up now and then in case
+        // they dispatch more work that we could help with.
+        MutexLocker locker(m_lock);
+        if (m_numberOfUnfinishedTasks)
+            m_condition.timedWait(m_lock, currentTime() + taskGroupWaitInterval);
+    }
+}
+
+} // namespace WTF
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ThreadPool_h
+#define ThreadPool_h
+
+#include <wtf/Deque.h>
+#include <wtf/Functional.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/OwnPtr.h>
+#include <wtf/PassOwnPtr.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/ThreadSafeRefCounted.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+namespace WTF {
+
+class TaskGroup;
+
+// A process-wide pool with up to one worker thread per additional processor core.
+// Workers are started when tasks are dispatched and no worker is idle, and exit
+// after sitting idle for a while, so an idle process keeps no pool threads around.
+//
+// Each worker owns a deque. Tasks dispatched while running on a worker are pushed
+// onto that worker's deque and popped in LIFO order; idle workers steal from the
+// other end. Tasks dispatched from any other thread wait in one shared queue per
+// priority, and workers drain higher priorities first.
+class ThreadPool {
+    WTF_MAKE_NONCOPYABLE(ThreadPool); WTF_MAKE_FAST_ALLOCATED;
+public:
+    enum Priority {
+        HighPriority,
+        NormalPriority,
+        BackgroundPriority
+    };
+
+    WTF_EXPORT_PRIVATE static ThreadPool& shared();
+
+    // The most workers the pool runs at once.
+    size_t numberOfWorkers() const { return m_workers.size(); }
+    size_t numberOfRunningWorkers() const { return m_numberOfRunningWorkers; }
+
+    // Tasks dispatched from a worker thread inherit the position of the task that
+    // dispatched them, so the priority only applies to tasks from other threads.
+    WTF_EXPORT_PRIVATE void dispatch(const Function<void()>&, Priority = NormalPriority);
+
+private:
+    friend class TaskGroup;
+
+    struct Task {
+        Function<void()> function;
+        RefPtr<TaskGroup> group;
+    };
+
+    class Worker;
+    static const unsigned numberOfPriorities = BackgroundPriority + 1;
+
+    explicit ThreadPool(unsigned numberOfWorkers);
+
+    void enqueue(const Task&, Priority);
+    void wakeOrStartWorker();
+    bool takeTask(Worker*, Task&);
+    bool takeTaskFromOwnDeque(Worker*, Task&);
+    bool takeTaskFromSharedQueues(Task&);
+    bool stealTask(Worker*, Task&);
+    bool takeTaskFromGroup(TaskGroup*, Task&);
+    static bool takeTaskFromGroup(Deque<Task>&, TaskGroup*, Task&);
+    Worker* currentWorker() const;
+
+    static void workerThreadStart(void*);
+    void workerLoop(Worker*);
+    static void runTask(Task&);
+
+    Vector<OwnPtr<Worker> > m_workers;
+
+    // Protects the shared queues and starting and stopping workers. Idle workers sleep on m_condition.
+    Mutex m_lock;
+    ThreadCondition m_condition;
+    Deque<Task> m_queues[numberOfPriorities];
+
+    // Both are updated with atomic operations so that dispatching onto a worker's
+    // deque only takes m_lock when some worker is asleep.
+    volatile int m_numberOfIdleWorkers;
+    volatile int m_numberOfPendingTasks;
+
+    // Only changed with m_lock held.
+    volatile size_t m_numberOfRunningWorkers;
+};
+
+// A set of tasks that can be waited on or cancelled together.
+class TaskGroup : public ThreadSafeRefCounted<TaskGroup> {
+public:
+    static PassRefPtr<TaskGroup> create(ThreadPool::Priority priority = ThreadPool::NormalPriority)
+    {
+        return adoptRef(new TaskGroup(priority));
+    }
+
+    WTF_EXPORT_PRIVATE void dispatch(const Function<void()>&);
+
+    // Returns once every task of the group has run or has been cancelled. The calling
+    // thread runs the group's own pending tasks while it waits, so waiting from a task
+    // that is itself running on a worker does not starve the pool, and the caller is
+    // never held up by an unrelated long-running task.
+    WTF_EXPORT_PRIVATE void wait();
+
+    // Tasks of the group that have not started yet are dropped. Running tasks can
+    // poll isCancelled() to stop early.
+    void cancel() { m_cancelled = true; }
+    bool isCancelled() const { return m_cancelled; }
+
+private:
+    friend class ThreadPool;
+
+    explicit TaskGroup(ThreadPool::Priority);
+
+    void taskDidFinish();
+
+    ThreadPool::Priority m_priority;
+    volatile bool m_cancelled;
+
+    Mutex m_lock;
+    ThreadCondition m_condition;
+    unsigned m_numberOfUnfinishedTasks;
+};
+
+} // namespace WTF
+
+using WTF::TaskGroup;
+using WTF::ThreadPool;
+
+#endif // ThreadPool_h
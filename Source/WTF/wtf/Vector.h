@@ -245,8 +245,8 @@ namespace WTF {
         }
     };
 
-    template<typename T>
-    class VectorBufferBase {
+    template<typename T, typename Allocator>
+    class VectorBufferBase : private Allocator {
         WTF_MAKE_NONCOPYABLE(VectorBufferBase);
     public:
         void allocateBuffer(size_t newCapacity)
@@ -254,9 +254,9 @@ namespace WTF {
             ASSERT(newCapacity);
             if (newCapacity > std::numeric_limits<unsigned>::max() / sizeof(T))
                 CRASH();
-            size_t sizeToAllocate = fastMallocGoodSize(newCapacity * sizeof(T));
+            size_t sizeToAllocate = Allocator::goodSize(newCapacity * sizeof(T));
             m_capacity = sizeToAllocate / sizeof(T);
-            m_buffer = static_cast<T*>(fastMalloc(sizeToAllocate));
+            m_buffer = static_cast<T*>(Allocator::allocate(sizeToAllocate));
         }
 
         bool tryAllocateBuffer(size_t newCapacity)
@@ -265,9 +265,9 @@ namespace WTF {
             if (newCapacity > std::numeric_limits<unsigned>::max() / sizeof(T))
                 return false;
 
-            size_t sizeToAllocate = fastMallocGoodSize(newCapacity * sizeof(T));
+            size_t sizeToAllocate = Allocator::goodSize(newCapacity * sizeof(T));
             T* newBuffer;
-            if (tryFastMalloc(sizeToAllocate).getValue(newBuffer)) {
+            if (Allocator::tryAllocate(sizeToAllocate).getValue(newBuffer)) {
                 m_capacity = sizeToAllocate / sizeof(T);
                 m_buffer = newBuffer;
                 return true;
@@ -285,9 +285,10 @@ namespace WTF {
             ASSERT(shouldReallocateBuffer(newCapacity));
             if (newCapacity > std::numeric_limits<size_t>::max() / sizeof(T))
                 CRASH();
-            size_t sizeToAllocate = fastMallocGoodSize(newCapacity * sizeof(T));
+            size_t sizeToAllocate = Allocator::goodSize(newCapacity * sizeof(T));
+            size_t oldSize = m_capacity * sizeof(T);
             m_capacity = sizeToAllocate / sizeof(T);
-            m_buffer = static_cast<T*>(fastRealloc(m_buffer, sizeToAllocate));
+            m_buffer = static_cast<T*>(Allocator::reallocate(m_buffer, oldSize, sizeToAllocate));
         }
 
         void deallocateBuffer(T* bufferToDeallocate)
@@ -300,13 +301,15 @@ namespace WTF {
                 m_capacity = 0;
             }
 
-            fastFree(bufferToDeallocate);
+            Allocator::deallocate(bufferToDeallocate);
         }
 
         T* buffer() { return m_buffer; }
         const T* buffer() const { return m_buffer; }
         size_t capacity() const { return m_capacity; }
 
+        const Allocator& allocator() const { return *this; }
+
         T* releaseBuffer()
         {
             T* buffer = m_buffer;
@@ -322,8 +325,16 @@ namespace WTF {
         {
         }
 
-        VectorBufferBase(T* buffer, size_t capacity)
-            : m_buffer(buffer)
+        explicit VectorBufferBase(const Allocator& allocator)
+            : Allocator(allocator)
+            , m_buffer(0)
+            , m_capacity(0)
+        {
+        }
+
+        VectorBufferBase(T* buffer, size_t capacity, const Allocator& allocator = Allocator())
+            : Allocator(allocator)
+            , m_buffer(buffer)
             , m_capacity(capacity)
         {
         }
@@ -333,23 +344,34 @@ namespace WTF {
             // FIXME: It would be nice to find a way to ASSERT that m_buffer hasn't leaked here.
         }
 
+        void swapAllocator(VectorBufferBase& other)
+        {
+            std::swap(static_cast<Allocator&>(*this), static_cast<Allocator&>(other));
+        }
+
         T* m_buffer;
         unsigned m_capacity;
     };
 
-    template<typename T, size_t inlineCapacity>
+    template<typename T, size_t inlineCapacity, typename Allocator = FastMallocAllocator>
     class VectorBuffer;
 
-    template<typename T>
-    class VectorBuffer<T, 0> : private VectorBufferBase<T> {
+    template<typename T, typename Allocator>
+    class VectorBuffer<T, 0, Allocator> : private VectorBufferBase<T, Allocator> {
     private:
-        typedef VectorBufferBase<T> Base;
+        typedef VectorBufferBase<T, Allocator> Base;
     public:
         VectorBuffer()
         {
         }
 
-        VectorBuffer(size_t capacity)
+        explicit VectorBuffer(const Allocator& allocator)
+            : Base(allocator)
+        {
+        }
+
+        VectorBuffer(size_t capacity, const Allocator& allocator = Allocator())
+            : Base(allocator)
         {
             // Calling malloc(0) might take a lock and may actually do an
             // allocation on some systems.
@@ -362,14 +384,17 @@ namespace WTF {
             deallocateBuffer(buffer());
         }
         
-        void swap(VectorBuffer<T, 0>& other)
+        void swap(VectorBuffer<T, 0, Allocator>& other)
         {
             std::swap(m_buffer, other.m_buffer);
             std::swap(m_capacity, other.m_capacity);
+            Base::swapAllocator(other);
         }
         
         void restoreInlineBufferIfNeeded() { }
 
+        bool usesInlineBuffer() const { return false; }
+
         using Base::allocateBuffer;
         using Base::tryAllocateBuffer;
         using Base::shouldReallocateBuffer;
@@ -378,6 +403,7 @@ namespace WTF {
 
         using Base::buffer;
         using Base::capacity;
+        using Base::allocator;
 
         using Base::releaseBuffer;
     private:
@@ -385,19 +411,24 @@ namespace WTF {
         using Base::m_capacity;
     };
 
-    template<typename T, size_t inlineCapacity>
-    class VectorBuffer : private VectorBufferBase<T> {
+    template<typename T, size_t inlineCapacity, typename Allocator>
+    class VectorBuffer : private VectorBufferBase<T, Allocator> {
         WTF_MAKE_NONCOPYABLE(VectorBuffer);
     private:
-        typedef VectorBufferBase<T> Base;
+        typedef VectorBufferBase<T, Allocator> Base;
     public:
         VectorBuffer()
             : Base(inlineBuffer(), inlineCapacity)
         {
         }
 
-        VectorBuffer(size_t capacity)
-            : Base(inlineBuffer(), inlineCapacity)
+        explicit VectorBuffer(const Allocator& allocator)
+            : Base(inlineBuffer(), inlineCapacity, allocator)
+        {
+        }
+
+        VectorBuffer(size_t capacity, const Allocator& allocator = Allocator())
+            : Base(inlineBuffer(), inlineCapacity, allocator)
         {
             if (capacity > inlineCapacity)
                 Base::allocateBuffer(capacity);
@@ -447,8 +478,9 @@ namespace WTF {
             Base::reallocateBuffer(newCapacity);
         }
 
-        void swap(VectorBuffer<T, inlineCapacity>& other)
+        void swap(VectorBuffer<T, inlineCapacity, Allocator>& other)
         {
+            Base::swapAllocator(other);
             if (buffer() == inlineBuffer() && other.buffer() == other.inlineBuffer()) {
                 WTF::swap(m_inlineBuffer, other.m_inlineBuffer);
                 std::swap(m_capacity, other.m_capacity);
@@ -478,6 +510,9 @@ namespace WTF {
 
         using Base::buffer;
         using Base::capacity;
+        using Base::allocator;
+
+        bool usesInlineBuffer() const { return buffer() == inlineBuffer(); }
 
         T* releaseBuffer()
         {
@@ -504,11 +539,19 @@ namespace WTF {
         }
     };
 
-    template<typename T, size_t inlineCapacity = 0, typename OverflowHandler = CrashOnOverflow>
-    class Vector : private VectorBuffer<T, inlineCapacity> {
+    // The inline capacity that fits in a byte budget, for scratch vectors that are sized against
+    // the stack space they may take rather than a guess at the element count:
+    //     Vector<CSSSelector*, VectorInlineCapacityForBytes<CSSSelector*, 256>::value> selectors;
+    template<typename T, size_t bytes>
+    struct VectorInlineCapacityForBytes {
+        static const size_t value = bytes / sizeof(T);
+    };
+
+    template<typename T, size_t inlineCapacity = 0, typename OverflowHandler = CrashOnOverflow, typename Allocator = FastMallocAllocator>
+    class Vector : private VectorBuffer<T, inlineCapacity, Allocator> {
         WTF_MAKE_FAST_ALLOCATED;
     private:
-        typedef VectorBuffer<T, inlineCapacity> Base;
+        typedef VectorBuffer<T, inlineCapacity, Allocator> Base;
         typedef VectorTypeOperations<T> TypeOperations;
 
     public:
@@ -523,6 +566,12 @@ namespace WTF {
             : m_size(0)
         {
         }
+
+        explicit Vector(const Allocator& allocator)
+            : Base(allocator)
+            , m_size(0)
+        {
+        }
         
         explicit Vector(size_t size)
             : Base(size)
@@ -555,6 +604,11 @@ namespace WTF {
         size_t capacity() const { return Base::capacity(); }
         bool isEmpty() const { return !size(); }
 
+        const Allocator& allocator() const { return Base::allocator(); }
+
+        // True while the elements are stored in the inline buffer, without a heap allocation.
+        bool usesInlineBuffer() const { return Base::usesInlineBuffer(); }
+
         T& at(size_t i)
         {
             if (UNLIKELY(i >= size()))
@@ -652,7 +706,7 @@ namespace WTF {
 
         T* releaseBuffer();
 
-        void swap(Vector<T, inlineCapacity, OverflowHandler>& other)
+        void swap(Vector<T, inlineCapacity, OverflowHandler, Allocator>& other)
         {
             std::swap(m_size, other.m_size);
             Base::swap(other);
@@ -684,18 +738,18 @@ namespace WTF {
         using Base::releaseBuffer;
     };
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    Vector<T, inlineCapacity, OverflowHandler>::Vector(const Vector& other)
-        : Base(other.capacity())
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    Vector<T, inlineCapacity, OverflowHandler, Allocator>::Vector(const Vector& other)
+        : Base(other.capacity(), other.allocator())
         , m_size(other.size())
     {
         if (begin())
             TypeOperations::uninitializedCopy(other.begin(), other.end(), begin());
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
     template<size_t otherCapacity, typename otherOverflowBehaviour>
-    Vector<T, inlineCapacity, OverflowHandler>::Vector(const Vector<T, otherCapacity, otherOverflowBehaviour>& other)
+    Vector<T, inlineCapacity, OverflowHandler, Allocator>::Vector(const Vector<T, otherCapacity, otherOverflowBehaviour>& other)
         : Base(other.capacity())
         , m_size(other.size())
     {
@@ -703,8 +757,8 @@ namespace WTF {
             TypeOperations::uninitializedCopy(other.begin(), other.end(), begin());
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    Vector<T, inlineCapacity, OverflowHandler>& Vector<T, inlineCapacity, OverflowHandler>::operator=(const Vector<T, inlineCapacity, OverflowHandler>& other)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    Vector<T, inlineCapacity, OverflowHandler, Allocator>& Vector<T, inlineCapacity, OverflowHandler, Allocator>::operator=(const Vector<T, inlineCapacity, OverflowHandler, Allocator>& other)
     {
         if (&other == this)
             return *this;
@@ -733,9 +787,9 @@ namespace WTF {
 
     inline bool typelessPointersAreEqual(const void* a, const void* b) { return a == b; }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
     template<size_t otherCapacity, typename otherOverflowBehaviour>
-    Vector<T, inlineCapacity, OverflowHandler>& Vector<T, inlineCapacity, OverflowHandler>::operator=(const Vector<T, otherCapacity, otherOverflowBehaviour>& other)
+    Vector<T, inlineCapacity, OverflowHandler, Allocator>& Vector<T, inlineCapacity, OverflowHandler, Allocator>::operator=(const Vector<T, otherCapacity, otherOverflowBehaviour>& other)
     {
         // If the inline capacities match, we should call the more specific
         // template.  If the inline capacities don't match, the two objects
@@ -765,8 +819,8 @@ namespace WTF {
     }
 
 #if COMPILER_SUPPORTS(CXX_RVALUE_REFERENCES)
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    Vector<T, inlineCapacity, OverflowHandler>::Vector(Vector<T, inlineCapacity, OverflowHandler>&& other)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    Vector<T, inlineCapacity, OverflowHandler, Allocator>::Vector(Vector<T, inlineCapacity, OverflowHandler, Allocator>&& other)
         : m_size(0)
     {
         // It's a little weird to implement a move constructor using swap but this way we
@@ -774,24 +828,24 @@ namespace WTF {
         swap(other);
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    Vector<T, inlineCapacity, OverflowHandler>& Vector<T, inlineCapacity, OverflowHandler>::operator=(Vector<T, inlineCapacity, OverflowHandler>&& other)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    Vector<T, inlineCapacity, OverflowHandler, Allocator>& Vector<T, inlineCapacity, OverflowHandler, Allocator>::operator=(Vector<T, inlineCapacity, OverflowHandler, Allocator>&& other)
     {
         swap(other);
         return *this;
     }
 #endif
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
     template<typename U>
-    bool Vector<T, inlineCapacity, OverflowHandler>::contains(const U& value) const
+    bool Vector<T, inlineCapacity, OverflowHandler, Allocator>::contains(const U& value) const
     {
         return find(value) != notFound;
     }
  
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
     template<typename U>
-    size_t Vector<T, inlineCapacity, OverflowHandler>::find(const U& value) const
+    size_t Vector<T, inlineCapacity, OverflowHandler, Allocator>::find(const U& value) const
     {
         for (size_t i = 0; i < size(); ++i) {
             if (at(i) == value)
@@ -800,9 +854,9 @@ namespace WTF {
         return notFound;
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
     template<typename U>
-    size_t Vector<T, inlineCapacity, OverflowHandler>::reverseFind(const U& value) const
+    size_t Vector<T, inlineCapacity, OverflowHandler, Allocator>::reverseFind(const U& value) const
     {
         for (size_t i = 1; i <= size(); ++i) {
             const size_t index = size() - i;
@@ -812,8 +866,8 @@ namespace WTF {
         return notFound;
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    void Vector<T, inlineCapacity, OverflowHandler>::fill(const T& val, size_t newSize)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    void Vector<T, inlineCapacity, OverflowHandler, Allocator>::fill(const T& val, size_t newSize)
     {
         if (size() > newSize)
             shrink(newSize);
@@ -829,22 +883,22 @@ namespace WTF {
         m_size = newSize;
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
     template<typename Iterator>
-    void Vector<T, inlineCapacity, OverflowHandler>::appendRange(Iterator start, Iterator end)
+    void Vector<T, inlineCapacity, OverflowHandler, Allocator>::appendRange(Iterator start, Iterator end)
     {
         for (Iterator it = start; it != end; ++it)
             append(*it);
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    void Vector<T, inlineCapacity, OverflowHandler>::expandCapacity(size_t newMinCapacity)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    void Vector<T, inlineCapacity, OverflowHandler, Allocator>::expandCapacity(size_t newMinCapacity)
     {
         reserveCapacity(std::max(newMinCapacity, std::max(static_cast<size_t>(16), capacity() + capacity() / 4 + 1)));
     }
     
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    const T* Vector<T, inlineCapacity, OverflowHandler>::expandCapacity(size_t newMinCapacity, const T* ptr)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    const T* Vector<T, inlineCapacity, OverflowHandler, Allocator>::expandCapacity(size_t newMinCapacity, const T* ptr)
     {
         if (ptr < begin() || ptr >= end()) {
             expandCapacity(newMinCapacity);
@@ -855,14 +909,14 @@ namespace WTF {
         return begin() + index;
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    bool Vector<T, inlineCapacity, OverflowHandler>::tryExpandCapacity(size_t newMinCapacity)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    bool Vector<T, inlineCapacity, OverflowHandler, Allocator>::tryExpandCapacity(size_t newMinCapacity)
     {
         return tryReserveCapacity(std::max(newMinCapacity, std::max(static_cast<size_t>(16), capacity() + capacity() / 4 + 1)));
     }
     
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    const T* Vector<T, inlineCapacity, OverflowHandler>::tryExpandCapacity(size_t newMinCapacity, const T* ptr)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    const T* Vector<T, inlineCapacity, OverflowHandler, Allocator>::tryExpandCapacity(size_t newMinCapacity, const T* ptr)
     {
         if (ptr < begin() || ptr >= end()) {
             if (!tryExpandCapacity(newMinCapacity))
@@ -875,15 +929,15 @@ namespace WTF {
         return begin() + index;
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler> template<typename U>
-    inline U* Vector<T, inlineCapacity, OverflowHandler>::expandCapacity(size_t newMinCapacity, U* ptr)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator> template<typename U>
+    inline U* Vector<T, inlineCapacity, OverflowHandler, Allocator>::expandCapacity(size_t newMinCapacity, U* ptr)
     {
         expandCapacity(newMinCapacity);
         return ptr;
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    inline void Vector<T, inlineCapacity, OverflowHandler>::resize(size_t size)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    inline void Vector<T, inlineCapacity, OverflowHandler, Allocator>::resize(size_t size)
     {
         if (size <= m_size)
             TypeOperations::destruct(begin() + size, end());
@@ -897,23 +951,23 @@ namespace WTF {
         m_size = size;
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    void Vector<T, inlineCapacity, OverflowHandler>::resizeToFit(size_t size)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    void Vector<T, inlineCapacity, OverflowHandler, Allocator>::resizeToFit(size_t size)
     {
         reserveCapacity(size);
         resize(size);
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    void Vector<T, inlineCapacity, OverflowHandler>::shrink(size_t size)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    void Vector<T, inlineCapacity, OverflowHandler, Allocator>::shrink(size_t size)
     {
         ASSERT(size <= m_size);
         TypeOperations::destruct(begin() + size, end());
         m_size = size;
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    void Vector<T, inlineCapacity, OverflowHandler>::grow(size_t size)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    void Vector<T, inlineCapacity, OverflowHandler, Allocator>::grow(size_t size)
     {
         ASSERT(size >= m_size);
         if (size > capacity())
@@ -923,8 +977,8 @@ namespace WTF {
         m_size = size;
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    void Vector<T, inlineCapacity, OverflowHandler>::reserveCapacity(size_t newCapacity)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    void Vector<T, inlineCapacity, OverflowHandler, Allocator>::reserveCapacity(size_t newCapacity)
     {
         if (newCapacity <= capacity())
             return;
@@ -936,8 +990,8 @@ namespace WTF {
         Base::deallocateBuffer(oldBuffer);
     }
     
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    bool Vector<T, inlineCapacity, OverflowHandler>::tryReserveCapacity(size_t newCapacity)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    bool Vector<T, inlineCapacity, OverflowHandler, Allocator>::tryReserveCapacity(size_t newCapacity)
     {
         if (newCapacity <= capacity())
             return true;
@@ -951,8 +1005,8 @@ namespace WTF {
         return true;
     }
     
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    inline void Vector<T, inlineCapacity, OverflowHandler>::reserveInitialCapacity(size_t initialCapacity)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    inline void Vector<T, inlineCapacity, OverflowHandler, Allocator>::reserveInitialCapacity(size_t initialCapacity)
     {
         ASSERT(!m_size);
         ASSERT(capacity() == inlineCapacity);
@@ -960,8 +1014,8 @@ namespace WTF {
             Base::allocateBuffer(initialCapacity);
     }
     
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    void Vector<T, inlineCapacity, OverflowHandler>::shrinkCapacity(size_t newCapacity)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    void Vector<T, inlineCapacity, OverflowHandler, Allocator>::shrinkCapacity(size_t newCapacity)
     {
         if (newCapacity >= capacity())
             return;
@@ -990,8 +1044,8 @@ namespace WTF {
     // because for instance it allows a PassRefPtr to be appended to a RefPtr vector
     // without refcount thrash.
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler> template<typename U>
-    void Vector<T, inlineCapacity, OverflowHandler>::append(const U* data, size_t dataSize)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator> template<typename U>
+    void Vector<T, inlineCapacity, OverflowHandler, Allocator>::append(const U* data, size_t dataSize)
     {
         size_t newSize = m_size + dataSize;
         if (newSize > capacity()) {
@@ -1007,8 +1061,8 @@ namespace WTF {
         m_size = newSize;
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler> template<typename U>
-    bool Vector<T, inlineCapacity, OverflowHandler>::tryAppend(const U* data, size_t dataSize)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator> template<typename U>
+    bool Vector<T, inlineCapacity, OverflowHandler, Allocator>::tryAppend(const U* data, size_t dataSize)
     {
         size_t newSize = m_size + dataSize;
         if (newSize > capacity()) {
@@ -1026,8 +1080,8 @@ namespace WTF {
         return true;
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler> template<typename U>
-    ALWAYS_INLINE void Vector<T, inlineCapacity, OverflowHandler>::append(const U& val)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator> template<typename U>
+    ALWAYS_INLINE void Vector<T, inlineCapacity, OverflowHandler, Allocator>::append(const U& val)
     {
         if (size() != capacity()) {
             new (NotNull, end()) T(val);
@@ -1038,8 +1092,8 @@ namespace WTF {
         appendSlowCase(val);
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler> template<typename U>
-    void Vector<T, inlineCapacity, OverflowHandler>::appendSlowCase(const U& val)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator> template<typename U>
+    void Vector<T, inlineCapacity, OverflowHandler, Allocator>::appendSlowCase(const U& val)
     {
         ASSERT(size() == capacity());
 
@@ -1055,8 +1109,8 @@ namespace WTF {
     // This version of append saves a branch in the case where you know that the
     // vector's capacity is large enough for the append to succeed.
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler> template<typename U>
-    inline void Vector<T, inlineCapacity, OverflowHandler>::uncheckedAppend(const U& val)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator> template<typename U>
+    inline void Vector<T, inlineCapacity, OverflowHandler, Allocator>::uncheckedAppend(const U& val)
     {
         ASSERT(size() < capacity());
         const U* ptr = &val;
@@ -1064,14 +1118,14 @@ namespace WTF {
         ++m_size;
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler> template<typename U, size_t otherCapacity>
-    inline void Vector<T, inlineCapacity, OverflowHandler>::appendVector(const Vector<U, otherCapacity>& val)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator> template<typename U, size_t otherCapacity>
+    inline void Vector<T, inlineCapacity, OverflowHandler, Allocator>::appendVector(const Vector<U, otherCapacity>& val)
     {
         append(val.begin(), val.size());
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler> template<typename U>
-    void Vector<T, inlineCapacity, OverflowHandler>::insert(size_t position, const U* data, size_t dataSize)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator> template<typename U>
+    void Vector<T, inlineCapacity, OverflowHandler, Allocator>::insert(size_t position, const U* data, size_t dataSize)
     {
         ASSERT_WITH_SECURITY_IMPLICATION(position <= size());
         size_t newSize = m_size + dataSize;
@@ -1089,8 +1143,8 @@ namespace WTF {
         m_size = newSize;
     }
      
-    template<typename T, size_t inlineCapacity, typename OverflowHandler> template<typename U>
-    inline void Vector<T, inlineCapacity, OverflowHandler>::insert(size_t position, const U& val)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator> template<typename U>
+    inline void Vector<T, inlineCapacity, OverflowHandler, Allocator>::insert(size_t position, const U& val)
     {
         ASSERT_WITH_SECURITY_IMPLICATION(position <= size());
         const U* data = &val;
@@ -1105,14 +1159,14 @@ namespace WTF {
         ++m_size;
     }
    
-    template<typename T, size_t inlineCapacity, typename OverflowHandler> template<typename U, size_t c>
-    inline void Vector<T, inlineCapacity, OverflowHandler>::insert(size_t position, const Vector<U, c>& val)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator> template<typename U, size_t c>
+    inline void Vector<T, inlineCapacity, OverflowHandler, Allocator>::insert(size_t position, const Vector<U, c>& val)
     {
         insert(position, val.begin(), val.size());
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    inline void Vector<T, inlineCapacity, OverflowHandler>::remove(size_t position)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    inline void Vector<T, inlineCapacity, OverflowHandler, Allocator>::remove(size_t position)
     {
         ASSERT_WITH_SECURITY_IMPLICATION(position < size());
         T* spot = begin() + position;
@@ -1121,8 +1175,8 @@ namespace WTF {
         --m_size;
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    inline void Vector<T, inlineCapacity, OverflowHandler>::remove(size_t position, size_t length)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    inline void Vector<T, inlineCapacity, OverflowHandler, Allocator>::remove(size_t position, size_t length)
     {
         ASSERT_WITH_SECURITY_IMPLICATION(position <= size());
         ASSERT_WITH_SECURITY_IMPLICATION(position + length <= size());
@@ -1133,18 +1187,20 @@ namespace WTF {
         m_size -= length;
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    inline void Vector<T, inlineCapacity, OverflowHandler>::reverse()
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    inline void Vector<T, inlineCapacity, OverflowHandler, Allocator>::reverse()
     {
         for (size_t i = 0; i < m_size / 2; ++i)
             std::swap(at(i), at(m_size - 1 - i));
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    inline T* Vector<T, inlineCapacity, OverflowHandler>::releaseBuffer()
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    inline T* Vector<T, inlineCapacity, OverflowHandler, Allocator>::releaseBuffer()
     {
-        T* buffer = Base::releaseBuffer();
-        if (inlineCapacity && !buffer && m_size) {
+        // Callers free the released buffer with fastFree(), so a buffer that came from another
+        // allocator is copied like the inline buffer is, and then given back to the allocator.
+        T* buffer = Allocator::usesFastMalloc ? Base::releaseBuffer() : 0;
+        if ((inlineCapacity || !Allocator::usesFastMalloc) && !buffer && m_size) {
             // If the vector had some data, but no buffer to release,
             // that means it was using the inline buffer. In that case,
             // we create a brand new buffer so the caller always gets one.
@@ -1152,12 +1208,16 @@ namespace WTF {
             buffer = static_cast<T*>(fastMalloc(bytes));
             memcpy(buffer, data(), bytes);
         }
+        if (!Allocator::usesFastMalloc) {
+            deallocateBuffer(Base::buffer());
+            restoreInlineBufferIfNeeded();
+        }
         m_size = 0;
         return buffer;
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    inline void Vector<T, inlineCapacity, OverflowHandler>::checkConsistency()
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    inline void Vector<T, inlineCapacity, OverflowHandler, Allocator>::checkConsistency()
     {
 #if !ASSERT_DISABLED
         for (size_t i = 0; i < size(); ++i)
@@ -1165,23 +1225,23 @@ namespace WTF {
 #endif
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    void deleteAllValues(const Vector<T, inlineCapacity, OverflowHandler>& collection)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    void deleteAllValues(const Vector<T, inlineCapacity, OverflowHandler, Allocator>& collection)
     {
-        typedef typename Vector<T, inlineCapacity, OverflowHandler>::const_iterator iterator;
+        typedef typename Vector<T, inlineCapacity, OverflowHandler, Allocator>::const_iterator iterator;
         iterator end = collection.end();
         for (iterator it = collection.begin(); it != end; ++it)
             delete *it;
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    inline void swap(Vector<T, inlineCapacity, OverflowHandler>& a, Vector<T, inlineCapacity, OverflowHandler>& b)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    inline void swap(Vector<T, inlineCapacity, OverflowHandler, Allocator>& a, Vector<T, inlineCapacity, OverflowHandler, Allocator>& b)
     {
         a.swap(b);
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    bool operator==(const Vector<T, inlineCapacity, OverflowHandler>& a, const Vector<T, inlineCapacity, OverflowHandler>& b)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    bool operator==(const Vector<T, inlineCapacity, OverflowHandler, Allocator>& a, const Vector<T, inlineCapacity, OverflowHandler, Allocator>& b)
     {
         if (a.size() != b.size())
             return false;
@@ -1189,8 +1249,8 @@ namespace WTF {
         return VectorTypeOperations<T>::compare(a.data(), b.data(), a.size());
     }
 
-    template<typename T, size_t inlineCapacity, typename OverflowHandler>
-    inline bool operator!=(const Vector<T, inlineCapacity, OverflowHandler>& a, const Vector<T, inlineCapacity, OverflowHandler>& b)
+    template<typename T, size_t inlineCapacity, typename OverflowHandler, typename Allocator>
+    inline bool operator!=(const Vector<T, inlineCapacity, OverflowHandler, Allocator>& a, const Vector<T, inlineCapacity, OverflowHandler, Allocator>& b)
     {
         return !(a == b);
     }
@@ -1208,6 +1268,7 @@ namespace WTF {
 } // namespace WTF
 
 using WTF::Vector;
+using WTF::VectorInlineCapacityForBytes;
 using WTF::UnsafeVectorOverflow;
 
 #endif // WTF_Vector_h
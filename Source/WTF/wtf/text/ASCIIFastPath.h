@@ -22,12 +22,10 @@
 #ifndef ASCIIFastPath_h
 #define ASCIIFastPath_h
 
-#if OS(DARWIN) && (CPU(X86) || CPU(X86_64))
-#include <emmintrin.h>
-#endif
 #include <stdint.h>
 #include <wtf/Alignment.h>
 #include <wtf/StdLibExtras.h>
+#include <wtf/text/StringSIMD.h>
 #include <wtf/unicode/Unicode.h>
 
 namespace WTF {
@@ -102,7 +100,7 @@ inline bool charactersAreAllASCII(const CharacterType* characters, size_t length
 
 inline void copyLCharsFromUCharSource(LChar* destination, const UChar* source, size_t length)
 {
-#if OS(DARWIN) && (CPU(X86) || CPU(X86_64))
+#if defined(WTF_STRING_USE_SSE2)
     const uintptr_t memoryAccessSize = 16; // Memory accesses on 16 byte (128 bit) alignment
     const uintptr_t memoryAccessMask = memoryAccessSize - 1;
 
@@ -31,55 +31,116 @@
 #include <wtf/WTFThreadData.h>
 #include <wtf/unicode/UTF8.h>
 
-#if USE(WEB_THREAD)
-#include <wtf/MainThread.h>
-#include <wtf/TCSpinLock.h>
-#endif
-
 namespace WTF {
 
 using namespace Unicode;
 
 COMPILE_ASSERT(sizeof(AtomicString) == sizeof(String), atomic_string_and_string_must_be_same_size);
 
-#if USE(WEB_THREAD)
-class AtomicStringTableLocker : public SpinLockHolder {
-    WTF_MAKE_NONCOPYABLE(AtomicStringTableLocker);
+typedef AtomicStringTable::StringTable StringTable;
+
+static ALWAYS_INLINE AtomicStringTable& currentTable()
+{
+    return *wtfThreadData().atomicStringTable();
+}
+
+// Stripes are picked by hash, so lookups in the main table hash the value once up front and
+// hand the result to the stripe's hash set through this translator.
+template<typename T>
+struct HashedValue {
+    const T& value;
+    unsigned hash;
+};
 
-    static SpinLock s_stringTableLock;
-public:
-    AtomicStringTableLocker()
-        : SpinLockHolder(&s_stringTableLock)
+template<typename T, typename HashTranslator>
+struct HashedValueTranslator {
+    static unsigned hash(const HashedValue<T>& buffer)
     {
+        return buffer.hash;
     }
-};
 
-SpinLock AtomicStringTableLocker::s_stringTableLock = SPINLOCK_INITIALIZER;
-#else
+    static bool equal(StringImpl* const& string, const HashedValue<T>& buffer)
+    {
+        return HashTranslator::equal(string, buffer.value);
+    }
 
-class AtomicStringTableLocker {
-    WTF_MAKE_NONCOPYABLE(AtomicStringTableLocker);
-public:
-    AtomicStringTableLocker() { }
-    ~AtomicStringTableLocker() { }
+    static void translate(StringImpl*& location, const HashedValue<T>& buffer, unsigned hash)
+    {
+        HashTranslator::translate(location, buffer.value, hash);
+    }
 };
-#endif // USE(WEB_THREAD)
 
-static ALWAYS_INLINE HashSet<StringImpl*>& stringTable()
+static ALWAYS_INLINE bool canAddSharedString(AtomicStringTable::Stripe& stripe)
+{
+    return stripe.sharedStringCount < AtomicStringTable::maximumSharedStringsPerStripe;
+}
+
+static ALWAYS_INLINE void shareString(AtomicStringTable::Stripe& stripe, StringImpl* string)
+{
+    ASSERT(canAddSharedString(stripe));
+    string->setIsSharedAtomic();
+    ++stripe.sharedStringCount;
+}
+
+// Returns the shared string for the value, adding it to the process-wide table if needed, or 0
+// if the current thread cannot have a shared string for it. Threads other than the main one
+// must have checked their own table first: a string they atomized on their own stays the atomic
+// string for its characters there.
+template<typename T, typename HashTranslator>
+static StringImpl* findOrAddSharedString(AtomicStringTable& table, const HashedValue<T>& value)
 {
-    return wtfThreadData().atomicStringTable()->table();
+    typedef HashedValueTranslator<T, HashTranslator> Translator;
+    ASSERT(table.isMainTable() || table.usesSharedStrings());
+
+    AtomicStringTable::Stripe& stripe = AtomicStringTable::stripeForHash(value.hash);
+    AtomicStringTable::StripeLocker locker(stripe);
+    StringTable::iterator iterator = stripe.table.find<Translator>(value);
+    if (iterator != stripe.table.end()) {
+        StringImpl* string = *iterator;
+        if (string->isSharedAtomic())
+            return string;
+        // Only the main thread may touch the reference count of its other strings.
+        if (!table.isMainTable() || !canAddSharedString(stripe))
+            return 0;
+        shareString(stripe, string);
+        return string;
+    }
+
+    if (!canAddSharedString(stripe))
+        return 0;
+    StringImpl* string = *stripe.table.add<Translator>(value).iterator;
+    shareString(stripe, string);
+    return string;
 }
 
 template<typename T, typename HashTranslator>
 static inline PassRefPtr<StringImpl> addToStringTable(const T& value)
 {
-    AtomicStringTableLocker locker;
+    AtomicStringTable& table = currentTable();
+    if (!table.isMainTable() && !table.usesSharedStrings()) {
+        StringTable::AddResult addResult = table.table().add<HashTranslator>(value);
+
+        // If the string is newly-translated, then we need to adopt it.
+        // The boolean in the pair tells us if that is so.
+        return addResult.isNewEntry ? adoptRef(*addResult.iterator) : *addResult.iterator;
+    }
+
+    typedef HashedValueTranslator<T, HashTranslator> Translator;
+    HashedValue<T> hashedValue = { value, HashTranslator::hash(value) };
 
-    HashSet<StringImpl*>::AddResult addResult = stringTable().add<HashTranslator>(value);
+    if (table.isMainTable()) {
+        AtomicStringTable::Stripe& stripe = AtomicStringTable::stripeForHash(hashedValue.hash);
+        AtomicStringTable::StripeLocker locker(stripe);
+        StringTable::AddResult addResult = stripe.table.add<Translator>(hashedValue);
+        return addResult.isNewEntry ? adoptRef(*addResult.iterator) : *addResult.iterator;
+    }
 
-    // If the string is newly-translated, then we need to adopt it.
-    // The boolean in the pair tells us if that is so.
-    return addResult.isNewEntry ? adoptRef(*addResult.iterator) : *addResult.iterator;
+    StringTable::iterator iterator = table.table().find<Translator>(hashedValue);
+    if (iterator != table.table().end())
+        return *iterator;
+    if (StringImpl* string = findOrAddSharedString<T, HashTranslator>(table, hashedValue))
+        return string;
+    return adoptRef(*table.table().add<Translator>(hashedValue).iterator);
 }
 
 struct CStringTranslator {
@@ -384,8 +445,27 @@ PassRefPtr<StringImpl> AtomicString::addSlowCase(StringImpl* string)
 
     ASSERT_WITH_MESSAGE(!string->isAtomic(), "AtomicString should not hit the slow case if the string is already atomic.");
 
-    AtomicStringTableLocker locker;
-    HashSet<StringImpl*>::AddResult addResult = stringTable().add(string);
+    AtomicStringTable& table = currentTable();
+    if (table.isMainTable()) {
+        AtomicStringTable::Stripe& stripe = AtomicStringTable::stripeForHash(string->hash());
+        AtomicStringTable::StripeLocker locker(stripe);
+        StringTable::AddResult addResult = stripe.table.add(string);
+        if (addResult.isNewEntry) {
+            ASSERT(*addResult.iterator == string);
+            string->setIsAtomic(true);
+        }
+        return *addResult.iterator;
+    }
+
+    if (table.usesSharedStrings() && !table.table().contains(string)) {
+        AtomicStringTable::Stripe& stripe = AtomicStringTable::stripeForHash(string->hash());
+        AtomicStringTable::StripeLocker locker(stripe);
+        StringTable::iterator iterator = stripe.table.find(string);
+        if (iterator != stripe.table.end() && (*iterator)->isSharedAtomic())
+            return *iterator;
+    }
+
+    StringTable::AddResult addResult = table.table().add(string);
 
     if (addResult.isNewEntry) {
         ASSERT(*addResult.iterator == string);
@@ -396,10 +476,28 @@ PassRefPtr<StringImpl> AtomicString::addSlowCase(StringImpl* string)
 }
 
 template<typename CharacterType>
-static inline HashSet<StringImpl*>::iterator findString(const StringImpl* stringImpl)
+static inline AtomicStringImpl* findString(const StringImpl* stringImpl)
 {
+    typedef HashAndCharactersTranslator<CharacterType> Translator;
     HashAndCharacters<CharacterType> buffer = { stringImpl->existingHash(), stringImpl->getCharacters<CharacterType>(), stringImpl->length() };
-    return stringTable().find<HashAndCharactersTranslator<CharacterType> >(buffer);
+
+    AtomicStringTable& table = currentTable();
+    if (!table.isMainTable()) {
+        StringTable::iterator iterator = table.table().find<Translator>(buffer);
+        if (iterator != table.table().end())
+            return static_cast<AtomicStringImpl*>(*iterator);
+        if (!table.usesSharedStrings())
+            return 0;
+    }
+
+    AtomicStringTable::Stripe& stripe = AtomicStringTable::stripeForHash(buffer.hash);
+    AtomicStringTable::StripeLocker locker(stripe);
+    StringTable::iterator iterator = stripe.table.find<Translator>(buffer);
+    if (iterator == stripe.table.end())
+        return 0;
+    if (!table.isMainTable() && !(*iterator)->isSharedAtomic())
+        return 0;
+    return static_cast<AtomicStringImpl*>(*iterator);
 }
 
 AtomicStringImpl* AtomicString::find(const StringImpl* stringImpl)
@@ -410,23 +508,58 @@ AtomicStringImpl* AtomicString::find(const StringImpl* stringImpl)
     if (!stringImpl->length())
         return static_cast<AtomicStringImpl*>(StringImpl::empty());
 
-    AtomicStringTableLocker locker;
-    HashSet<StringImpl*>::iterator iterator;
     if (stringImpl->is8Bit())
-        iterator = findString<LChar>(stringImpl);
-    else
-        iterator = findString<UChar>(stringImpl);
-    if (iterator == stringTable().end())
+        return findString<LChar>(stringImpl);
+    return findString<UChar>(stringImpl);
+}
+
+template<typename CharacterType>
+static AtomicStringImpl* addSharedString(const CharacterType* characters, unsigned length)
+{
+    ASSERT(characters);
+    ASSERT(length);
+
+    typedef HashTranslatorCharBuffer<CharacterType> Buffer;
+    typedef typename Conditional<sizeof(CharacterType) == 1, LCharBufferTranslator, UCharBufferTranslator>::Type HashTranslator;
+    typedef HashedValueTranslator<Buffer, HashTranslator> Translator;
+
+    AtomicStringTable& table = currentTable();
+    if (!table.isMainTable() && !table.usesSharedStrings())
         return 0;
-    return static_cast<AtomicStringImpl*>(*iterator);
+
+    Buffer buffer = { characters, length };
+    HashedValue<Buffer> hashedValue = { buffer, HashTranslator::hash(buffer) };
+    if (!table.isMainTable() && table.table().find<Translator>(hashedValue) != table.table().end())
+        return 0;
+    return static_cast<AtomicStringImpl*>(findOrAddSharedString<Buffer, HashTranslator>(table, hashedValue));
+}
+
+AtomicStringImpl* AtomicString::addShared(const LChar* characters, unsigned length)
+{
+    return addSharedString(characters, length);
+}
+
+AtomicStringImpl* AtomicString::addShared(const UChar* characters, unsigned length)
+{
+    return addSharedString(characters, length);
 }
 
 void AtomicString::remove(StringImpl* string)
 {
     ASSERT(string->isAtomic());
-    AtomicStringTableLocker locker;
-    HashSet<StringImpl*>& atomicStringTable = stringTable();
-    HashSet<StringImpl*>::iterator iterator = atomicStringTable.find(string);
+    ASSERT(!string->isSharedAtomic());
+    AtomicStringTable& table = currentTable();
+    if (table.isMainTable()) {
+        AtomicStringTable::Stripe& stripe = AtomicStringTable::stripeForHash(string->existingHash());
+        AtomicStringTable::StripeLocker locker(stripe);
+        StringTable::iterator iterator = stripe.table.find(string);
+        ASSERT_WITH_MESSAGE(iterator != stripe.table.end(), "The string being removed is atomic in the string table of an other thread!");
+        stripe.table.remove(iterator);
+        return;
+    }
+
+    StringTable& atomicStringTable = table.table();
+    StringTable::iterator iterator = atomicStringTable.find(string);
     ASSERT_WITH_MESSAGE(iterator != atomicStringTable.end(), "The string being removed is atomic in the string table of an other thread!");
     atomicStringTable.remove(iterator);
 }
@@ -464,8 +597,17 @@ AtomicString AtomicString::fromUTF8Internal(const char* charactersStart, const c
 #if !ASSERT_DISABLED
 bool AtomicString::isInAtomicStringTable(StringImpl* string)
 {
-    AtomicStringTableLocker locker;
-    return stringTable().contains(string);
+    AtomicStringTable& table = currentTable();
+    if (!table.isMainTable()) {
+        if (table.table().contains(string))
+            return true;
+        if (!string->isSharedAtomic())
+            return false;
+    }
+
+    AtomicStringTable::Stripe& stripe = AtomicStringTable::stripeForHash(string->hash());
+    AtomicStringTable::StripeLocker locker(stripe);
+    return stripe.table.contains(string);
 }
 #endif
 
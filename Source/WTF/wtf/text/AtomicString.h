@@ -89,6 +89,11 @@ public:
 
     WTF_EXPORT_STRING_API static AtomicStringImpl* find(const StringImpl*);
 
+    // Returns the shared atomic string for the characters, which any thread can use, or 0 if the
+    // current thread cannot share it. See AtomicStringTable for which threads can.
+    WTF_EXPORT_STRING_API static AtomicStringImpl* addShared(const LChar*, unsigned length);
+    WTF_EXPORT_STRING_API static AtomicStringImpl* addShared(const UChar*, unsigned length);
+
     operator const String&() const { return m_string; }
     const String& string() const { return m_string; };
 
@@ -26,36 +26,107 @@
 #include <wtf/HashSet.h>
 #include <wtf/MainThread.h>
 #include <wtf/WTFThreadData.h>
+#include <wtf/text/StringImpl.h>
 
 namespace WTF {
 
+AtomicStringTable::Stripe* AtomicStringTable::s_stripes;
+bool AtomicStringTable::s_stripesAreShared;
+
 void AtomicStringTable::create(WTFThreadData& data)
 {
+    // initializeThreading() creates the first WTFThreadData before any other thread exists.
+    if (!s_stripes)
+        s_stripes = new Stripe[stripeCount];
+
+    // On ports that only learn which thread is the main one in initializeMainThread(), this
+    // is false for the main thread until then; didInitializeMainThread() fixes its table up.
+    bool isMainTable = isMainThread();
+
 #if USE(WEB_THREAD)
-    // On iOS, one AtomicStringTable is shared between the main UI thread and the WebThread.
-    static AtomicStringTable* sharedStringTable = new AtomicStringTable;
+    // On iOS, one AtomicStringTable is shared between the main UI thread and the WebThread. Both
+    // use its stripes from the start, so they are always locked.
+    s_stripesAreShared = true;
+    static AtomicStringTable* sharedStringTable = new AtomicStringTable(true);
 
     bool currentThreadIsWebThread = isWebThread();
     if (currentThreadIsWebThread || isUIThread())
         data.m_atomicStringTable = sharedStringTable;
     else
-        data.m_atomicStringTable = new AtomicStringTable;
+        data.m_atomicStringTable = new AtomicStringTable(false);
 
     // We do the following so that its destruction happens only
     // once - on the main UI thread.
     if (!currentThreadIsWebThread)
         data.m_atomicStringTableDestructor = AtomicStringTable::destroy;
 #else
-    data.m_atomicStringTable = new AtomicStringTable;
+    data.m_atomicStringTable = new AtomicStringTable(isMainTable);
     data.m_atomicStringTableDestructor = AtomicStringTable::destroy;
 #endif // USE(WEB_THREAD)
 }
 
+void AtomicStringTable::shareStringsWithOtherThreads()
+{
+    ASSERT(isMainThread());
+    s_stripesAreShared = true;
+}
+
+void AtomicStringTable::useSharedStringsOnCurrentThread()
+{
+    AtomicStringTable* table = wtfThreadData().atomicStringTable();
+    ASSERT(!table->isMainTable());
+    ASSERT(s_stripesAreShared);
+    table->m_usesSharedStrings = true;
+}
+
+void AtomicStringTable::didInitializeMainThread()
+{
+    AtomicStringTable* table = wtfThreadData().atomicStringTable();
+    if (table->m_isMainTable)
+        return;
+
+    // No other thread can have added shared strings yet, so none of these can clash with a
+    // string already in the stripes.
+    ASSERT(!table->m_usesSharedStrings);
+    StringTable::iterator end = table->m_table.end();
+    for (StringTable::iterator iter = table->m_table.begin(); iter != end; ++iter) {
+        StringImpl* string = *iter;
+        Stripe& stripe = stripeForHash(string->existingHash());
+        StripeLocker locker(stripe);
+        bool isNewEntry = stripe.table.add(string).isNewEntry;
+        ASSERT_UNUSED(isNewEntry, isNewEntry);
+    }
+    table->m_table.clear();
+    table->m_isMainTable = true;
+}
+
 void AtomicStringTable::destroy(AtomicStringTable* table)
 {
-    HashSet<StringImpl*>::iterator end = table->m_table.end();
-    for (HashSet<StringImpl*>::iterator iter = table->m_table.begin(); iter != end; ++iter)
+    StringTable::iterator end = table->m_table.end();
+    for (StringTable::iterator iter = table->m_table.begin(); iter != end; ++iter)
         (*iter)->setIsAtomic(false);
+
+    // The main table's strings live in the stripes. Shared strings stay there for the threads
+    // that still use them; the others would otherwise be removed from whichever thread's table
+    // happens to release them last.
+    if (table->m_isMainTable) {
+        Vector<StringImpl*> unsharedStrings;
+        for (unsigned i = 0; i < stripeCount; ++i) {
+            Stripe& stripe = s_stripes[i];
+            StripeLocker locker(stripe);
+            StringTable::iterator stripeEnd = stripe.table.end();
+            for (StringTable::iterator iter = stripe.table.begin(); iter != stripeEnd; ++iter) {
+                if (!(*iter)->isSharedAtomic())
+                    unsharedStrings.append(*iter);
+            }
+            for (size_t j = 0; j < unsharedStrings.size(); ++j) {
+                unsharedStrings[j]->setIsAtomic(false);
+                stripe.table.remove(unsharedStrings[j]);
+            }
+            unsharedStrings.clear();
+        }
+    }
+
     delete table;
 }
 
@@ -24,25 +24,117 @@
 #define WTF_AtomicStringTable_h
 
 #include <wtf/HashSet.h>
+#include <wtf/TCSpinLock.h>
 #include <wtf/WTFThreadData.h>
 
 namespace WTF {
 
 class StringImpl;
 
+// Most lookups in the atomic string table are for strings that are not in it yet, so it
+// uses group probing to avoid comparing the characters of unrelated strings.
+struct AtomicStringTableHashTraits : HashTraits<StringImpl*> {
+    static const bool useGroupProbing = true;
+};
+
+// The main thread's atomic strings live in a process-wide table, split into stripes that each
+// have their own lock, so that other threads can look strings up in it. A string in that table
+// can only be used by another thread once it is shared. Shared strings are immortal, so their
+// unsynchronized reference counts are harmless, and they are never removed.
+//
+// The stripe locks are only taken once the main thread has called shareStringsWithOtherThreads();
+// until then it is the only user of the stripes and does without the atomic operation, which
+// costs about 10ns per atomized string on x86-64. With USE(WEB_THREAD), the UI thread and the
+// WebThread both use the main table, so the locks are always taken.
+//
+// Other threads keep their own table. A thread that calls useSharedStringsOnCurrentThread()
+// looks in its own table first, then takes shared strings from the process-wide table and adds
+// strings missing from both to it as shared ones. Threads running JavaScript must not do this,
+// because the identifier flag of a string belongs to the main thread's VM.
 class AtomicStringTable {
     WTF_MAKE_FAST_ALLOCATED;
 public:
+    typedef HashSet<StringImpl*, DefaultHash<StringImpl*>::Hash, AtomicStringTableHashTraits> StringTable;
+
+    struct Stripe {
+        WTF_MAKE_NONCOPYABLE(Stripe); WTF_MAKE_FAST_ALLOCATED;
+    public:
+        Stripe()
+            : sharedStringCount(0)
+        {
+            lock.Init();
+        }
+
+        SpinLock lock;
+        StringTable table;
+        unsigned sharedStringCount;
+    };
+
+    static const unsigned stripeCount = 16;
+    // Shared strings are never freed, so their number is capped.
+    static const unsigned maximumSharedStringsPerStripe = 1024;
 
     static void create(WTFThreadData&);
-    HashSet<StringImpl*>& table() { return m_table; }
+
+    // Must be called on the main thread before starting any thread that calls
+    // useSharedStringsOnCurrentThread().
+    WTF_EXPORT_PRIVATE static void shareStringsWithOtherThreads();
+    WTF_EXPORT_PRIVATE static void useSharedStringsOnCurrentThread();
+
+    // Called by initializeMainThread() on ports where isMainThread() is only reliable from then
+    // on. Moves the strings the main thread atomized so far to the process-wide table.
+    static void didInitializeMainThread();
+
+    // The string hash only has 24 significant bits; its top bits pick the stripe and its low
+    // bits the bucket within it.
+    static Stripe& stripeForHash(unsigned hash) { return s_stripes[(hash >> 20) % stripeCount]; }
+
+    class StripeLocker {
+        WTF_MAKE_NONCOPYABLE(StripeLocker);
+    public:
+        explicit StripeLocker(Stripe& stripe)
+            : m_lock(s_stripesAreShared ? &stripe.lock : 0)
+        {
+            if (m_lock)
+                m_lock->Lock();
+        }
+
+        ~StripeLocker()
+        {
+            if (m_lock)
+                m_lock->Unlock();
+        }
+
+    private:
+        SpinLock* m_lock;
+    };
+
+    bool isMainTable() const { return m_isMainTable; }
+    bool usesSharedStrings() const { return m_usesSharedStrings; }
+
+    // Only meaningful for tables other than the main one.
+    StringTable& table() { return m_table; }
 
 private:
+    explicit AtomicStringTable(bool isMainTable)
+        : m_isMainTable(isMainTable)
+        , m_usesSharedStrings(false)
+    {
+    }
+
     static void destroy(AtomicStringTable*);
 
-    HashSet<StringImpl*> m_table;
+    static Stripe* s_stripes;
+    // Only written by the main thread before it starts a thread that uses the stripes.
+    static bool s_stripesAreShared;
+
+    StringTable m_table;
+    bool m_isMainTable;
+    bool m_usesSharedStrings;
 };
 
 }
 
+using WTF::AtomicStringTable;
+
 #endif
@@ -32,12 +32,24 @@
 
 namespace WTF {
 
+// A segmented builder whose current segment is at least this long starts a new 16-bit segment
+// for non-Latin-1 characters, rather than upconverting the whole segment.
+static const unsigned minimumSegmentLengthToKeep8Bit = 4096;
+
 static size_t expandedCapacity(size_t capacity, size_t newLength)
 {
     static const size_t minimumCapacity = 16;
     return std::max(capacity, std::max(minimumCapacity, newLength * 2));
 }
 
+unsigned StringBuilder::newCapacity(unsigned requiredLength) const
+{
+    size_t capacity = expandedCapacity(this->capacity(), requiredLength);
+    if (m_isSegmented)
+        capacity = std::min(capacity, std::max<size_t>(maximumSegmentLength, requiredLength));
+    return capacity;
+}
+
 void StringBuilder::reifyString() const
 {
     // Check if the string already exists.
@@ -65,6 +77,12 @@ void StringBuilder::reifyString() const
 }
 
 void StringBuilder::resize(unsigned newSize)
+{
+    ASSERT(!m_segments);
+    truncate(newSize);
+}
+
+void StringBuilder::truncate(unsigned newSize)
 {
     // Check newSize < m_length, hence m_length > 0.
     ASSERT(newSize <= m_length);
@@ -228,10 +246,10 @@ CharType* StringBuilder::appendUninitializedSlow(unsigned requiredLength)
         // If the buffer is valid it must be at least as long as the current builder contents!
         ASSERT(m_buffer->length() >= m_length);
         
-        reallocateBuffer<CharType>(expandedCapacity(capacity(), requiredLength));
+        reallocateBuffer<CharType>(newCapacity(requiredLength));
     } else {
         ASSERT(m_string.length() == m_length);
-        allocateBuffer(m_length ? m_string.getCharacters<CharType>() : 0, expandedCapacity(capacity(), requiredLength));
+        allocateBuffer(m_length ? m_string.getCharacters<CharType>() : 0, newCapacity(requiredLength));
     }
     
     CharType* result = getBufferCharacters<CharType>() + m_length;
@@ -246,14 +264,54 @@ void StringBuilder::append(const UChar* characters, unsigned length)
 
     ASSERT(characters);
 
+    if (m_isSegmented)
+        appendSegmented(characters, length);
+    else
+        appendCharacters(characters, length);
+}
+
+void StringBuilder::append(const LChar* characters, unsigned length)
+{
+    if (!length)
+        return;
+
+    ASSERT(characters);
+
+    if (m_isSegmented)
+        appendSegmented(characters, length);
+    else
+        appendCharacters(characters, length);
+}
+
+static inline bool charactersAreAllLatin1(const UChar* characters, unsigned length)
+{
+    UChar ored = 0;
+    for (unsigned i = 0; i < length; ++i)
+        ored |= characters[i];
+    return !(ored & ~0xff);
+}
+
+void StringBuilder::appendCharacters(const UChar* characters, unsigned length)
+{
     if (m_is8Bit) {
         if (length == 1 && !(*characters & ~0xff)) {
             // Append as 8 bit character
             LChar lChar = static_cast<LChar>(*characters);
-            append(&lChar, 1);
+            appendCharacters(&lChar, 1);
             return;
         }
 
+        if (m_isSegmented) {
+            if (charactersAreAllLatin1(characters, length)) {
+                LChar* dest = appendUninitialized<LChar>(length);
+                for (unsigned i = 0; i < length; ++i)
+                    dest[i] = static_cast<LChar>(characters[i]);
+                return;
+            }
+            if (m_length >= minimumSegmentLengthToKeep8Bit)
+                startNewSegment(false);
+        }
+
         // Calculate the new size of the builder after appending.
         unsigned requiredLength = length + m_length;
         if (requiredLength < length)
@@ -263,10 +321,10 @@ void StringBuilder::append(const UChar* characters, unsigned length)
             // If the buffer is valid it must be at least as long as the current builder contents!
             ASSERT(m_buffer->length() >= m_length);
             
-            allocateBufferUpConvert(m_buffer->characters8(), expandedCapacity(capacity(), requiredLength));
+            allocateBufferUpConvert(m_buffer->characters8(), newCapacity(requiredLength));
         } else {
             ASSERT(m_string.length() == m_length);
-            allocateBufferUpConvert(m_string.isNull() ? 0 : m_string.characters8(), expandedCapacity(capacity(), requiredLength));
+            allocateBufferUpConvert(m_string.isNull() ? 0 : m_string.characters8(), newCapacity(requiredLength));
         }
 
         memcpy(m_bufferCharacters16 + m_length, characters, static_cast<size_t>(length) * sizeof(UChar));        
@@ -275,12 +333,8 @@ void StringBuilder::append(const UChar* characters, unsigned length)
         memcpy(appendUninitialized<UChar>(length), characters, static_cast<size_t>(length) * sizeof(UChar));
 }
 
-void StringBuilder::append(const LChar* characters, unsigned length)
+void StringBuilder::appendCharacters(const LChar* characters, unsigned length)
 {
-    if (!length)
-        return;
-    ASSERT(characters);
-
     if (m_is8Bit) {
         LChar* dest = appendUninitialized<LChar>(length);
         if (length > 8)
@@ -298,6 +352,140 @@ void StringBuilder::append(const LChar* characters, unsigned length)
     }
 }
 
+// Appends into the current segment until it reaches maximumSegmentLength, then continues in new segments.
+template <typename CharType>
+void StringBuilder::appendSegmented(const CharType* characters, unsigned length)
+{
+    ASSERT(m_isSegmented);
+
+    if (length + this->length() < length)
+        CRASH();
+
+    while (length) {
+        unsigned count = std::min(length, m_length < maximumSegmentLength ? maximumSegmentLength - m_length : 0);
+        // Keep surrogate pairs within one segment.
+        if (count && count < length && sizeof(CharType) == sizeof(UChar) && U16_IS_LEAD(characters[count - 1]))
+            --count;
+        if (!count) {
+            startNewSegment(sizeof(CharType) == sizeof(UChar) && U16_IS_TRAIL(characters[0]));
+            continue;
+        }
+        appendCharacters(characters, count);
+        characters += count;
+        length -= count;
+    }
+}
+
+void StringBuilder::appendSegments(const StringBuilder& other)
+{
+    ASSERT(other.m_segments);
+    const Vector<String>& strings = other.m_segments->strings;
+    for (size_t i = 0; i < strings.size(); ++i)
+        append(strings[i]);
+
+    if (!other.m_length)
+        return;
+    if (other.m_is8Bit)
+        append(other.m_string.isNull() ? other.m_buffer->characters8() : other.m_string.characters8(), other.m_length);
+    else
+        append(other.m_string.isNull() ? other.m_buffer->characters16() : other.m_string.characters16(), other.m_length);
+}
+
+// Sets the current segment aside and starts an empty one. If keepLeadSurrogate is set and the current
+// segment ends with a lead surrogate, that character is moved to the new segment instead.
+void StringBuilder::startNewSegment(bool keepLeadSurrogate)
+{
+    ASSERT(m_isSegmented);
+    if (!m_length)
+        return;
+
+    UChar leadSurrogate = 0;
+    if (keepLeadSurrogate && !m_is8Bit) {
+        UChar lastCharacter = m_string.isNull() ? m_buffer->characters16()[m_length - 1] : m_string[m_length - 1];
+        if (U16_IS_LEAD(lastCharacter)) {
+            ASSERT(m_length > 1);
+            leadSurrogate = lastCharacter;
+            truncate(m_length - 1);
+        }
+    }
+
+    if (canShrink()) {
+        if (m_is8Bit)
+            reallocateBuffer<LChar>(m_length);
+        else
+            reallocateBuffer<UChar>(m_length);
+    }
+    reifyString();
+
+    if (!m_segments)
+        m_segments = adoptPtr(new SegmentList);
+    m_segments->strings.append(m_string);
+    m_segments->length += m_length;
+    m_segments->is8Bit = m_segments->is8Bit && m_is8Bit;
+
+    m_length = 0;
+    m_string = String();
+    m_buffer = 0;
+    m_bufferCharacters8 = 0;
+    m_is8Bit = true;
+    m_valid16BitShadowLength = 0;
+
+    if (leadSurrogate)
+        appendCharacters(&leadSurrogate, 1);
+}
+
+void StringBuilder::flattenSegments()
+{
+    ASSERT(m_segments);
+    const Vector<String>& strings = m_segments->strings;
+    unsigned length = this->length();
+    String result;
+
+    if (is8Bit()) {
+        LChar* characters;
+        result = StringImpl::createUninitialized(length, characters);
+        for (size_t i = 0; i < strings.size(); ++i) {
+            memcpy(characters, strings[i].characters8(), strings[i].length() * sizeof(LChar));
+            characters += strings[i].length();
+        }
+        if (m_length)
+            memcpy(characters, m_string.isNull() ? m_buffer->characters8() : m_string.characters8(), m_length * sizeof(LChar));
+    } else {
+        UChar* characters;
+        result = StringImpl::createUninitialized(length, characters);
+        for (size_t i = 0; i < strings.size(); ++i) {
+            if (strings[i].is8Bit())
+                StringImpl::copyChars(characters, strings[i].characters8(), strings[i].length());
+            else
+                StringImpl::copyChars(characters, strings[i].characters16(), strings[i].length());
+            characters += strings[i].length();
+        }
+        if (m_length) {
+            if (m_is8Bit)
+                StringImpl::copyChars(characters, m_string.isNull() ? m_buffer->characters8() : m_string.characters8(), m_length);
+            else
+                StringImpl::copyChars(characters, m_string.isNull() ? m_buffer->characters16() : m_string.characters16(), m_length);
+        }
+    }
+
+    m_segments.clear();
+    m_buffer = 0;
+    m_bufferCharacters8 = 0;
+    m_valid16BitShadowLength = 0;
+    m_string = result;
+    m_length = length;
+    m_is8Bit = result.is8Bit();
+}
+
+String StringBuilder::segmentAt(unsigned index) const
+{
+    ASSERT_WITH_SECURITY_IMPLICATION(index < segmentCount());
+    if (m_segments && index < m_segments->strings.size())
+        return m_segments->strings[index];
+    reifyString();
+    return m_string;
+}
+
 void StringBuilder::appendNumber(int number)
 {
     numberToStringSigned<StringBuilder>(number, this);
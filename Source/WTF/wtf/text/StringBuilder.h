@@ -27,6 +27,9 @@
 #ifndef StringBuilder_h
 #define StringBuilder_h
 
+#include <wtf/OwnPtr.h>
+#include <wtf/PassOwnPtr.h>
+#include <wtf/Vector.h>
 #include <wtf/text/AtomicString.h>
 #include <wtf/text/WTFString.h>
 
@@ -37,14 +40,33 @@ class StringBuilder {
     WTF_MAKE_NONCOPYABLE(StringBuilder);
 
 public:
+    // A segmented builder never grows its buffer past maximumSegmentLength. Once the current segment
+    // is full it is set aside without copying and appending continues in a new one, so very large
+    // outputs are not repeatedly reallocated, and each segment is 8-bit or 16-bit on its own.
+    // Segments never split a surrogate pair. The contents are flattened by toString(), or can be
+    // consumed a segment at a time with segmentCount() and segmentAt().
+    enum BufferMode { SingleBuffer, SegmentedBuffer };
+
     StringBuilder()
         : m_length(0)
         , m_is8Bit(true)
+        , m_isSegmented(false)
         , m_valid16BitShadowLength(0)
         , m_bufferCharacters8(0)
     {
     }
 
+    explicit StringBuilder(BufferMode mode)
+        : m_length(0)
+        , m_is8Bit(true)
+        , m_isSegmented(mode == SegmentedBuffer)
+        , m_valid16BitShadowLength(0)
+        , m_bufferCharacters8(0)
+    {
+    }
+
+    static const unsigned maximumSegmentLength = 1 << 16;
+
     WTF_EXPORT_PRIVATE void append(const UChar*, unsigned);
     WTF_EXPORT_PRIVATE void append(const LChar*, unsigned);
 
@@ -72,6 +94,11 @@ public:
 
     void append(const StringBuilder& other)
     {
+        if (other.m_segments) {
+            appendSegments(other);
+            return;
+        }
+
         if (!other.m_length)
             return;
 
@@ -163,6 +190,8 @@ public:
 
     String toString()
     {
+        if (m_segments)
+            flattenSegments();
         shrinkToFit();
         if (m_string.isNull())
             reifyString();
@@ -171,6 +200,7 @@ public:
 
     const String& toStringPreserveCapacity() const
     {
+        ASSERT(!m_segments);
         if (m_string.isNull())
             reifyString();
         return m_string;
@@ -178,6 +208,7 @@ public:
 
     AtomicString toAtomicString() const
     {
+        ASSERT(!m_segments);
         if (!m_length)
             return emptyAtom;
 
@@ -197,10 +228,22 @@ public:
 
     unsigned length() const
     {
+        if (m_segments)
+            return m_segments->length + m_length;
         return m_length;
     }
 
-    bool isEmpty() const { return !m_length; }
+    bool isEmpty() const { return !length(); }
+
+    bool isSegmented() const { return m_isSegmented; }
+
+    // The last segment is the one being appended to. A builder that is not segmented has at most one segment.
+    unsigned segmentCount() const
+    {
+        return (m_segments ? m_segments->strings.size() : 0) + (m_length ? 1 : 0);
+    }
+
+    WTF_EXPORT_PRIVATE String segmentAt(unsigned) const;
 
     WTF_EXPORT_PRIVATE void reserveCapacity(unsigned newCapacity);
 
@@ -217,6 +260,7 @@ public:
 
     UChar operator[](unsigned i) const
     {
+        ASSERT(!m_segments);
         ASSERT_WITH_SECURITY_IMPLICATION(i < m_length);
         if (m_is8Bit)
             return characters8()[i];
@@ -226,6 +270,7 @@ public:
     const LChar* characters8() const
     {
         ASSERT(m_is8Bit);
+        ASSERT(!m_segments);
         if (!m_length)
             return 0;
         if (!m_string.isNull())
@@ -237,6 +282,7 @@ public:
     const UChar* characters16() const
     {
         ASSERT(!m_is8Bit);
+        ASSERT(!m_segments);
         if (!m_length)
             return 0;
         if (!m_string.isNull())
@@ -247,6 +293,7 @@ public:
     
     const UChar* characters() const
     {
+        ASSERT(!m_segments);
         if (!m_length)
             return 0;
         if (!m_string.isNull())
@@ -260,13 +307,14 @@ public:
         return m_buffer->characters();
     }
     
-    bool is8Bit() const { return m_is8Bit; }
+    bool is8Bit() const { return m_is8Bit && (!m_segments || m_segments->is8Bit); }
 
     void clear()
     {
         m_length = 0;
         m_string = String();
         m_buffer = 0;
+        m_segments.clear();
         m_bufferCharacters8 = 0;
         m_is8Bit = true;
         m_valid16BitShadowLength = 0;
@@ -278,11 +326,36 @@ public:
         m_string.swap(stringBuilder.m_string);
         m_buffer.swap(stringBuilder.m_buffer);
         std::swap(m_is8Bit, stringBuilder.m_is8Bit);
+        std::swap(m_isSegmented, stringBuilder.m_isSegmented);
+        m_segments.swap(stringBuilder.m_segments);
         std::swap(m_valid16BitShadowLength, stringBuilder.m_valid16BitShadowLength);
         std::swap(m_bufferCharacters8, stringBuilder.m_bufferCharacters8);
     }
 
 private:
+    struct SegmentList {
+        WTF_MAKE_FAST_ALLOCATED;
+    public:
+        SegmentList()
+            : length(0)
+            , is8Bit(true)
+        {
+        }
+
+        Vector<String> strings;
+        unsigned length;
+        bool is8Bit;
+    };
+
+    void appendCharacters(const UChar*, unsigned);
+    void appendCharacters(const LChar*, unsigned);
+    template <typename CharType>
+    void appendSegmented(const CharType*, unsigned);
+    WTF_EXPORT_PRIVATE void appendSegments(const StringBuilder&);
+    void startNewSegment(bool keepLeadSurrogate);
+    WTF_EXPORT_PRIVATE void flattenSegments();
+    void truncate(unsigned newSize);
+    unsigned newCapacity(unsigned requiredLength) const;
     void allocateBuffer(const LChar* currentCharacters, unsigned requiredLength);
     void allocateBuffer(const UChar* currentCharacters, unsigned requiredLength);
     void allocateBufferUpConvert(const LChar* currentCharacters, unsigned requiredLength);
@@ -300,11 +373,13 @@ private:
     mutable String m_string;
     RefPtr<StringImpl> m_buffer;
     bool m_is8Bit;
+    bool m_isSegmented;
     mutable unsigned m_valid16BitShadowLength;
     union {
         LChar* m_bufferCharacters8;
         UChar* m_bufferCharacters16;
     };
+    OwnPtr<SegmentList> m_segments;
 };
 
 template <>
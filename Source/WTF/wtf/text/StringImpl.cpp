@@ -332,8 +332,7 @@ void StringImpl::upconvertCharacters(unsigned start, unsigned end) const
     ASSERT(is8Bit());
     ASSERT(has16BitShadow());
 
-    for (size_t i = start; i < end; ++i)
-        m_copyData16[i] = m_data8[i];
+    copyChars(m_copyData16 + start, m_data8 + start, end - start);
 }
     
 
@@ -396,7 +395,7 @@ PassRefPtr<StringImpl> StringImpl::lower()
     bool noUpper = true;
     if (is8Bit()) {
         unsigned failingIndex;
-        for (unsigned i = 0; i < m_length; ++i) {
+        for (unsigned i = findBlockWithNonASCIIOrASCIIUpper(m_data8, m_length); i < m_length; ++i) {
             LChar character = m_data8[i];
             if (UNLIKELY((character & ~0x7F) || isASCIIUpper(character))) {
                 failingIndex = i;
@@ -412,7 +411,7 @@ SlowPath8bitLower:
         for (unsigned i = 0; i < failingIndex; ++i)
             data8[i] = m_data8[i];
 
-        for (unsigned i = failingIndex; i < m_length; ++i) {
+        for (unsigned i = failingIndex + convertToASCIILowercaseInBlocks(data8 + failingIndex, m_data8 + failingIndex, m_length - failingIndex); i < m_length; ++i) {
             LChar character = m_data8[i];
             if (!(character & ~0x7F))
                 data8[i] = toASCIILower(character);
@@ -424,7 +423,8 @@ SlowPath8bitLower:
     }
     unsigned ored = 0;
 
-    for (unsigned i = 0; i < m_length; ++i) {
+    // The characters before the first block with uppercase or non-ASCII characters change neither noUpper nor ored.
+    for (unsigned i = findBlockWithNonASCIIOrASCIIUpper(m_data16, m_length); i < m_length; ++i) {
         UChar character = m_data16[i];
         if (UNLIKELY(isASCIIUpper(character)))
             noUpper = false;
@@ -438,7 +438,7 @@ SlowPath8bitLower:
         UChar* data16;
         RefPtr<StringImpl> newImpl = createUninitialized(m_length, data16);
         
-        for (unsigned i = 0; i < m_length; ++i) {
+        for (unsigned i = convertToASCIILowercaseInBlocks(data16, m_data16, m_length); i < m_length; ++i) {
             UChar c = m_data16[i];
             data16[i] = toASCIILower(c);
         }
@@ -481,7 +481,7 @@ PassRefPtr<StringImpl> StringImpl::upper()
         
         // Do a faster loop for the case where all the characters are ASCII.
         unsigned ored = 0;
-        for (int i = 0; i < length; ++i) {
+        for (int i = convertToASCIIUppercaseInBlocks(data8, m_data8, length); i < length; ++i) {
             LChar c = m_data8[i];
             ored |= c;
 #if CPU(X86) && defined(_MSC_VER) && _MSC_VER >=1700
@@ -542,7 +542,7 @@ upconvert:
     
     // Do a faster loop for the case where all the characters are ASCII.
     unsigned ored = 0;
-    for (int i = 0; i < length; ++i) {
+    for (int i = convertToASCIIUppercaseInBlocks(data16, source16, length); i < length; ++i) {
         UChar c = source16[i];
         ored |= c;
         data16[i] = toASCIIUpper(c);
@@ -870,6 +870,9 @@ float StringImpl::toFloat(bool* ok)
 
 bool equalIgnoringCase(const LChar* a, const LChar* b, unsigned length)
 {
+    if (!equalIgnoringASCIICaseInBlocks(a, b, length))
+        return false;
+
     while (length--) {
         LChar bc = *b++;
         if (foldCase(*a++) != foldCase(bc))
@@ -880,6 +883,9 @@ bool equalIgnoringCase(const LChar* a, const LChar* b, unsigned length)
 
 bool equalIgnoringCase(const UChar* a, const LChar* b, unsigned length)
 {
+    if (!equalIgnoringASCIICaseInBlocks(a, b, length))
+        return false;
+
     while (length--) {
         LChar bc = *b++;
         if (foldCase(*a++) != foldCase(bc))
@@ -1005,6 +1011,44 @@ ALWAYS_INLINE static size_t findInner(const SearchCharacterType* searchCharacter
     return index + i;        
 }
 
+#if defined(WTF_STRING_USE_SIMD)
+// When both strings have the same width, check the first and last character of the match for a
+// whole block of positions at once instead of keeping a running hash.
+template <typename CharacterType>
+ALWAYS_INLINE static size_t findInner(const CharacterType* searchCharacters, const CharacterType* matchCharacters, unsigned index, unsigned searchLength, unsigned matchLength)
+{
+    ASSERT(matchLength >= 2);
+    ASSERT(matchLength <= searchLength);
+
+    const unsigned charactersPerBlock = characterBlockSize / sizeof(CharacterType);
+    const unsigned characterMask = (1 << sizeof(CharacterType)) - 1;
+    typedef CharacterBlockOperations<CharacterType> Operations;
+
+    unsigned delta = searchLength - matchLength;
+    CharacterBlock first = Operations::splat(matchCharacters[0]);
+    CharacterBlock last = Operations::splat(matchCharacters[matchLength - 1]);
+
+    unsigned i = 0;
+    for (; i <= delta && delta - i >= charactersPerBlock - 1; i += charactersPerBlock) {
+        CharacterBlock firstMatches = Operations::equal(loadCharacterBlock(searchCharacters + i), first);
+        CharacterBlock lastMatches = Operations::equal(loadCharacterBlock(searchCharacters + i + matchLength - 1), last);
+        for (unsigned mask = byteMask(bitAnd(firstMatches, lastMatches)); mask;) {
+            unsigned bit = firstSetBit(mask);
+            unsigned offset = i + bit / sizeof(CharacterType);
+            if (equal(searchCharacters + offset + 1, matchCharacters + 1, matchLength - 2))
+                return index + offset;
+            mask &= ~(characterMask << bit);
+        }
+    }
+
+    for (; i <= delta; ++i) {
+        if (searchCharacters[i] == matchCharacters[0] && equal(searchCharacters + i + 1, matchCharacters + 1, matchLength - 1))
+            return index + i;
+    }
+    return notFound;
+}
+#endif
+
 size_t StringImpl::find(StringImpl* matchString)
 {
     // Check for null string to match against
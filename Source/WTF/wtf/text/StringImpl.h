@@ -29,6 +29,7 @@
 #include <wtf/StdLibExtras.h>
 #include <wtf/StringHasher.h>
 #include <wtf/Vector.h>
+#include <wtf/text/StringSIMD.h>
 #include <wtf/unicode/Unicode.h>
 
 #if PLATFORM(QT)
@@ -526,7 +527,7 @@ public:
     bool isIdentifier() const { return m_hashAndFlags & s_hashFlagIsIdentifier; }
     void setIsIdentifier(bool isIdentifier)
     {
-        ASSERT(!isStatic());
+        ASSERT(!isStatic() || isSharedAtomic());
         if (isIdentifier)
             m_hashAndFlags |= s_hashFlagIsIdentifier;
         else
@@ -550,6 +551,18 @@ public:
             m_hashAndFlags &= ~s_hashFlagIsAtomic;
     }
 
+    // A shared atomic string is in the process-wide atomic string table and may be used from any
+    // thread. It is immortal, so unsynchronized ref() and deref() calls cannot free it.
+    bool isSharedAtomic() const { return isAtomic() && isStatic(); }
+    void setIsSharedAtomic()
+    {
+        ASSERT(isAtomic());
+        // Create the 16-bit shadow now, since creating it lazily from several threads would race.
+        if (is8Bit())
+            characters();
+        m_refCount |= s_refCountFlagIsStaticString;
+    }
+
 #ifdef STRING_STATS
     bool isSubString() const { return  bufferOwnership() == BufferSubstring; }
 #endif
@@ -652,7 +665,7 @@ public:
 
     ALWAYS_INLINE static void copyChars(UChar* destination, const LChar* source, unsigned numCharacters)
     {
-        for (unsigned i = 0; i < numCharacters; ++i)
+        for (unsigned i = copyLCharsToUCharsInBlocks(destination, source, numCharacters); i < numCharacters; ++i)
             destination[i] = source[i];
     }
 
@@ -887,6 +900,9 @@ WTF_EXPORT_STRING_API bool equalNonNull(const StringImpl* a, const StringImpl* b
 #if CPU(X86_64)
 ALWAYS_INLINE bool equal(const LChar* a, const LChar* b, unsigned length)
 {
+    if (!equalInBlocks(a, b, length))
+        return false;
+
     unsigned dwordLength = length >> 3;
 
     if (dwordLength) {
@@ -926,6 +942,9 @@ ALWAYS_INLINE bool equal(const LChar* a, const LChar* b, unsigned length)
 
 ALWAYS_INLINE bool equal(const UChar* a, const UChar* b, unsigned length)
 {
+    if (!equalInBlocks(a, b, length))
+        return false;
+
     unsigned dwordLength = length >> 2;
     
     if (dwordLength) {
@@ -957,6 +976,9 @@ ALWAYS_INLINE bool equal(const UChar* a, const UChar* b, unsigned length)
 #elif CPU(X86)
 ALWAYS_INLINE bool equal(const LChar* a, const LChar* b, unsigned length)
 {
+    if (!equalInBlocks(a, b, length))
+        return false;
+
     const uint32_t* aCharacters = reinterpret_cast<const uint32_t*>(a);
     const uint32_t* bCharacters = reinterpret_cast<const uint32_t*>(b);
 
@@ -983,6 +1005,9 @@ ALWAYS_INLINE bool equal(const LChar* a, const LChar* b, unsigned length)
 
 ALWAYS_INLINE bool equal(const UChar* a, const UChar* b, unsigned length)
 {
+    if (!equalInBlocks(a, b, length))
+        return false;
+
     const uint32_t* aCharacters = reinterpret_cast<const uint32_t*>(a);
     const uint32_t* bCharacters = reinterpret_cast<const uint32_t*>(b);
     
@@ -1092,6 +1117,9 @@ ALWAYS_INLINE bool equal(const UChar* a, const UChar* b, unsigned length) { retu
 
 ALWAYS_INLINE bool equal(const LChar* a, const UChar* b, unsigned length)
 {
+    if (!equalInBlocks(a, b, length))
+        return false;
+
     for (unsigned i = 0; i < length; ++i) {
         if (a[i] != b[i])
             return false;
@@ -1122,6 +1150,11 @@ WTF_EXPORT_STRING_API bool equalIgnoringNullity(StringImpl*, StringImpl*);
 template<typename CharacterType>
 inline size_t find(const CharacterType* characters, unsigned length, CharacterType matchCharacter, unsigned index = 0)
 {
+    bool found;
+    index = findInBlocks(characters, length, matchCharacter, index, found);
+    if (found)
+        return index;
+
     while (index < length) {
         if (characters[index] == matchCharacter)
             return index;
@@ -0,0 +1,461 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef StringSIMD_h
+#define StringSIMD_h
+
+#include <wtf/ASCIICType.h>
+#include <wtf/NotFound.h>
+#include <wtf/unicode/Unicode.h>
+
+#if CPU(X86_64) || (CPU(X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#include <emmintrin.h>
+#define WTF_STRING_USE_SSE2 1
+#elif HAVE(ARM_NEON_INTRINSICS)
+#include <arm_neon.h>
+#define WTF_STRING_USE_NEON 1
+#endif
+
+#if COMPILER(MSVC)
+#include <intrin.h>
+#endif
+
+// Kernels for the hot loops of StringImpl that work on 16 bytes at a time, that is 16 LChars or
+// 8 UChars. The ...InBlocks functions only handle the whole blocks at the start of their input
+// and return how far they got, leaving the remainder to the scalar code of the caller. Without
+// SSE2 or NEON they do nothing, so callers do not need to be conditionally compiled.
+
+namespace WTF {
+
+#if defined(WTF_STRING_USE_SSE2) || defined(WTF_STRING_USE_NEON)
+#define WTF_STRING_USE_SIMD 1
+
+#if defined(WTF_STRING_USE_SSE2)
+typedef __m128i CharacterBlock;
+#else
+typedef uint8x16_t CharacterBlock;
+#endif
+
+const unsigned characterBlockSize = 16;
+
+ALWAYS_INLINE CharacterBlock loadCharacterBlock(const void* pointer)
+{
+#if defined(WTF_STRING_USE_SSE2)
+    return _mm_loadu_si128(static_cast<const __m128i*>(pointer));
+#else
+    return vld1q_u8(static_cast<const uint8_t*>(pointer));
+#endif
+}
+
+ALWAYS_INLINE void storeCharacterBlock(void* pointer, CharacterBlock block)
+{
+#if defined(WTF_STRING_USE_SSE2)
+    _mm_storeu_si128(static_cast<__m128i*>(pointer), block);
+#else
+    vst1q_u8(static_cast<uint8_t*>(pointer), block);
+#endif
+}
+
+// Loads 8 LChars and zero extends them to 8 UChars.
+ALWAYS_INLINE CharacterBlock loadWidenedCharacterBlock(const LChar* characters)
+{
+#if defined(WTF_STRING_USE_SSE2)
+    return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(characters)), _mm_setzero_si128());
+#else
+    return vreinterpretq_u8_u16(vmovl_u8(vld1_u8(characters)));
+#endif
+}
+
+ALWAYS_INLINE CharacterBlock bitAnd(CharacterBlock a, CharacterBlock b)
+{
+#if defined(WTF_STRING_USE_SSE2)
+    return _mm_and_si128(a, b);
+#else
+    return vandq_u8(a, b);
+#endif
+}
+
+ALWAYS_INLINE CharacterBlock bitOr(CharacterBlock a, CharacterBlock b)
+{
+#if defined(WTF_STRING_USE_SSE2)
+    return _mm_or_si128(a, b);
+#else
+    return vorrq_u8(a, b);
+#endif
+}
+
+// Returns a mask where bit i is set if the high bit of byte i is set. Comparisons set every bit
+// of the matching characters, so a matching UChar sets two adjacent bits of the mask.
+ALWAYS_INLINE unsigned byteMask(CharacterBlock block)
+{
+#if defined(WTF_STRING_USE_SSE2)
+    return _mm_movemask_epi8(block);
+#else
+    static const uint8_t bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    uint8x16_t masked = vandq_u8(vreinterpretq_u8_s8(vshrq_n_s8(vreinterpretq_s8_u8(block), 7)), vld1q_u8(bits));
+    uint8x8_t sum = vpadd_u8(vget_low_u8(masked), vget_high_u8(masked));
+    sum = vpadd_u8(sum, sum);
+    sum = vpadd_u8(sum, sum);
+    return vget_lane_u16(vreinterpret_u16_u8(sum), 0);
+#endif
+}
+
+const unsigned allBytesMask = 0xFFFF;
+
+// The mask must be non-zero.
+ALWAYS_INLINE unsigned firstSetBit(unsigned mask)
+{
+    ASSERT(mask);
+#if COMPILER(GCC)
+    return __builtin_ctz(mask);
+#elif COMPILER(MSVC)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    unsigned index = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+template<typename CharacterType> struct CharacterBlockOperations;
+
+template<> struct CharacterBlockOperations<LChar> {
+    static CharacterBlock splat(LChar character)
+    {
+#if defined(WTF_STRING_USE_SSE2)
+        return _mm_set1_epi8(static_cast<char>(character));
+#else
+        return vdupq_n_u8(character);
+#endif
+    }
+
+    static CharacterBlock equal(CharacterBlock a, CharacterBlock b)
+    {
+#if defined(WTF_STRING_USE_SSE2)
+        return _mm_cmpeq_epi8(a, b);
+#else
+        return vceqq_u8(a, b);
+#endif
+    }
+
+    // Characters between first and last, which must both be ASCII.
+    static CharacterBlock inASCIIRange(CharacterBlock block, LChar first, LChar last)
+    {
+#if defined(WTF_STRING_USE_SSE2)
+        // The comparisons are signed, so non-ASCII characters are never in range.
+        return _mm_and_si128(_mm_cmpgt_epi8(block, splat(first - 1)), _mm_cmplt_epi8(block, splat(last + 1)));
+#else
+        return vandq_u8(vcgeq_u8(block, splat(first)), vcleq_u8(block, splat(last)));
+#endif
+    }
+
+    static unsigned nonASCIIMask(CharacterBlock block) { return byteMask(block); }
+};
+
+template<> struct CharacterBlockOperations<UChar> {
+    static CharacterBlock splat(UChar character)
+    {
+#if defined(WTF_STRING_USE_SSE2)
+        return _mm_set1_epi16(static_cast<short>(character));
+#else
+        return vreinterpretq_u8_u16(vdupq_n_u16(character));
+#endif
+    }
+
+    static CharacterBlock equal(CharacterBlock a, CharacterBlock b)
+    {
+#if defined(WTF_STRING_USE_SSE2)
+        return _mm_cmpeq_epi16(a, b);
+#else
+        return vreinterpretq_u8_u16(vceqq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+#endif
+    }
+
+    static CharacterBlock inASCIIRange(CharacterBlock block, UChar first, UChar last)
+    {
+#if defined(WTF_STRING_USE_SSE2)
+        return _mm_and_si128(_mm_cmpgt_epi16(block, splat(first - 1)), _mm_cmplt_epi16(block, splat(last + 1)));
+#else
+        uint16x8_t characters = vreinterpretq_u16_u8(block);
+        return vreinterpretq_u8_u16(vandq_u16(vcgeq_u16(characters, vdupq_n_u16(first)), vcleq_u16(characters, vdupq_n_u16(last))));
+#endif
+    }
+
+    static unsigned nonASCIIMask(CharacterBlock block)
+    {
+        return ~byteMask(equal(bitAnd(block, splat(0xFF80)), splat(0))) & allBytesMask;
+    }
+};
+
+template<typename CharacterType>
+ALWAYS_INLINE CharacterBlock toASCIILowerBlock(CharacterBlock block)
+{
+    typedef CharacterBlockOperations<CharacterType> Operations;
+    return bitOr(block, bitAnd(Operations::inASCIIRange(block, 'A', 'Z'), Operations::splat(0x20)));
+}
+
+template<typename CharacterType>
+ALWAYS_INLINE CharacterBlock toASCIIUpperBlock(CharacterBlock block)
+{
+    typedef CharacterBlockOperations<CharacterType> Operations;
+    CharacterBlock lowercaseLetters = Operations::inASCIIRange(block, 'a', 'z');
+#if defined(WTF_STRING_USE_SSE2)
+    return _mm_xor_si128(block, bitAnd(lowercaseLetters, Operations::splat(0x20)));
+#else
+    return veorq_u8(block, bitAnd(lowercaseLetters, Operations::splat(0x20)));
+#endif
+}
+
+#endif // defined(WTF_STRING_USE_SSE2) || defined(WTF_STRING_USE_NEON)
+
+// Returns the index of the first occurrence of matchCharacter in the whole blocks of
+// characters[index..length), or the index where the caller's scalar loop should continue.
+template<typename CharacterType>
+ALWAYS_INLINE unsigned findInBlocks(const CharacterType* characters, unsigned length, CharacterType matchCharacter, unsigned index, bool& found)
+{
+    found = false;
+#if defined(WTF_STRING_USE_SIMD)
+    const unsigned charactersPerBlock = characterBlockSize / sizeof(CharacterType);
+    if (index >= length || length - index < charactersPerBlock)
+        return index;
+
+    typedef CharacterBlockOperations<CharacterType> Operations;
+    CharacterBlock match = Operations::splat(matchCharacter);
+    unsigned blocksEnd = length - charactersPerBlock;
+    for (; index <= blocksEnd; index += charactersPerBlock) {
+        if (unsigned mask = byteMask(Operations::equal(loadCharacterBlock(characters + index), match))) {
+            found = true;
+            return index + firstSetBit(mask) / sizeof(CharacterType);
+        }
+    }
+#else
+    UNUSED_PARAM(characters);
+    UNUSED_PARAM(length);
+    UNUSED_PARAM(matchCharacter);
+#endif
+    return index;
+}
+
+const unsigned maximumFindFirstOfCharacters = 6;
+
+// Like findInBlocks, but finds the first character that is any of the matchCount ASCII
+// characters in matchCharacters.
+template<typename CharacterType>
+ALWAYS_INLINE unsigned findFirstOfInBlocks(const CharacterType* characters, unsigned length, const LChar* matchCharacters, unsigned matchCount, unsigned index, bool& found)
+{
+    found = false;
+    ASSERT(matchCount && matchCount <= maximumFindFirstOfCharacters);
+#if defined(WTF_STRING_USE_SIMD)
+    const unsigned charactersPerBlock = characterBlockSize / sizeof(CharacterType);
+    if (index >= length || length - index < charactersPerBlock)
+        return index;
+
+    typedef CharacterBlockOperations<CharacterType> Operations;
+    CharacterBlock matches[maximumFindFirstOfCharacters];
+    for (unsigned i = 0; i < matchCount; ++i)
+        matches[i] = Operations::splat(matchCharacters[i]);
+    unsigned blocksEnd = length - charactersPerBlock;
+    for (; index <= blocksEnd; index += charactersPerBlock) {
+        CharacterBlock block = loadCharacterBlock(characters + index);
+        CharacterBlock matched = Operations::equal(block, matches[0]);
+        for (unsigned i = 1; i < matchCount; ++i)
+            matched = bitOr(matched, Operations::equal(block, matches[i]));
+        if (unsigned mask = byteMask(matched)) {
+            found = true;
+            return index + firstSetBit(mask) / sizeof(CharacterType);
+        }
+    }
+#else
+    UNUSED_PARAM(characters);
+    UNUSED_PARAM(length);
+    UNUSED_PARAM(matchCharacters);
+#endif
+    return index;
+}
+
+// Returns false if a mismatch was found, otherwise advances a, b and length past the whole blocks.
+template<typename CharacterType>
+ALWAYS_INLINE bool equalInBlocks(const CharacterType*& a, const CharacterType*& b, unsigned& length)
+{
+#if defined(WTF_STRING_USE_SIMD)
+    const unsigned charactersPerBlock = characterBlockSize / sizeof(CharacterType);
+    while (length >= charactersPerBlock) {
+        if (byteMask(CharacterBlockOperations<LChar>::equal(loadCharacterBlock(a), loadCharacterBlock(b))) != allBytesMask)
+            return false;
+        a += charactersPerBlock;
+        b += charactersPerBlock;
+        length -= charactersPerBlock;
+    }
+#else
+    UNUSED_PARAM(a);
+    UNUSED_PARAM(b);
+    UNUSED_PARAM(length);
+#endif
+    return true;
+}
+
+ALWAYS_INLINE bool equalInBlocks(const LChar*& a, const UChar*& b, unsigned& length)
+{
+#if defined(WTF_STRING_USE_SIMD)
+    const unsigned charactersPerBlock = characterBlockSize / sizeof(UChar);
+    while (length >= charactersPerBlock) {
+        if (byteMask(CharacterBlockOperations<UChar>::equal(loadWidenedCharacterBlock(a), loadCharacterBlock(b))) != allBytesMask)
+            return false;
+        a += charactersPerBlock;
+        b += charactersPerBlock;
+        length -= charactersPerBlock;
+    }
+#else
+    UNUSED_PARAM(a);
+    UNUSED_PARAM(b);
+    UNUSED_PARAM(length);
+#endif
+    return true;
+}
+
+// Like equalInBlocks, but ignoring ASCII case. Stops without a result at the first block with a
+// non-ASCII character, since those need the full case folding of the caller.
+template<typename CharacterType>
+ALWAYS_INLINE bool equalIgnoringASCIICaseInBlocks(const CharacterType*& a, const LChar*& b, unsigned& length)
+{
+#if defined(WTF_STRING_USE_SIMD)
+    typedef CharacterBlockOperations<CharacterType> Operations;
+    const unsigned charactersPerBlock = characterBlockSize / sizeof(CharacterType);
+    while (length >= charactersPerBlock) {
+        CharacterBlock aBlock = loadCharacterBlock(a);
+        CharacterBlock bBlock = sizeof(CharacterType) == sizeof(LChar) ? loadCharacterBlock(b) : loadWidenedCharacterBlock(b);
+        if (Operations::nonASCIIMask(bitOr(aBlock, bBlock)))
+            return true;
+        if (byteMask(Operations::equal(toASCIILowerBlock<CharacterType>(aBlock), toASCIILowerBlock<CharacterType>(bBlock))) != allBytesMask)
+            return false;
+        a += charactersPerBlock;
+        b += charactersPerBlock;
+        length -= charactersPerBlock;
+    }
+#else
+    UNUSED_PARAM(a);
+    UNUSED_PARAM(b);
+    UNUSED_PARAM(length);
+#endif
+    return true;
+}
+
+// Returns the index of the first block of characters that has a non-ASCII character or an ASCII
+// uppercase letter, or of the characters after the whole blocks if there is no such block.
+template<typename CharacterType>
+ALWAYS_INLINE unsigned findBlockWithNonASCIIOrASCIIUpper(const CharacterType* characters, unsigned length)
+{
+    unsigned i = 0;
+#if defined(WTF_STRING_USE_SIMD)
+    typedef CharacterBlockOperations<CharacterType> Operations;
+    const unsigned charactersPerBlock = characterBlockSize / sizeof(CharacterType);
+    for (; length - i >= charactersPerBlock; i += charactersPerBlock) {
+        CharacterBlock block = loadCharacterBlock(characters + i);
+        if (Operations::nonASCIIMask(block) | byteMask(Operations::inASCIIRange(block, 'A', 'Z')))
+            break;
+    }
+#else
+    UNUSED_PARAM(characters);
+    UNUSED_PARAM(length);
+#endif
+    return i;
+}
+
+// Convert the ASCII letters of the whole blocks of source. Stop before the first block that has a
+// non-ASCII character, since those need Unicode case mapping, and return how many characters were converted.
+template<typename CharacterType>
+ALWAYS_INLINE unsigned convertToASCIILowercaseInBlocks(CharacterType* destination, const CharacterType* source, unsigned length)
+{
+    unsigned i = 0;
+#if defined(WTF_STRING_USE_SIMD)
+    typedef CharacterBlockOperations<CharacterType> Operations;
+    const unsigned charactersPerBlock = characterBlockSize / sizeof(CharacterType);
+    for (; length - i >= charactersPerBlock; i += charactersPerBlock) {
+        CharacterBlock block = loadCharacterBlock(source + i);
+        if (Operations::nonASCIIMask(block))
+            break;
+        storeCharacterBlock(destination + i, toASCIILowerBlock<CharacterType>(block));
+    }
+#else
+    UNUSED_PARAM(destination);
+    UNUSED_PARAM(source);
+    UNUSED_PARAM(length);
+#endif
+    return i;
+}
+
+template<typename CharacterType>
+ALWAYS_INLINE unsigned convertToASCIIUppercaseInBlocks(CharacterType* destination, const CharacterType* source, unsigned length)
+{
+    unsigned i = 0;
+#if defined(WTF_STRING_USE_SIMD)
+    typedef CharacterBlockOperations<CharacterType> Operations;
+    const unsigned charactersPerBlock = characterBlockSize / sizeof(CharacterType);
+    for (; length - i >= charactersPerBlock; i += charactersPerBlock) {
+        CharacterBlock block = loadCharacterBlock(source + i);
+        if (Operations::nonASCIIMask(block))
+            break;
+        storeCharacterBlock(destination + i, toASCIIUpperBlock<CharacterType>(block));
+    }
+#else
+    UNUSED_PARAM(destination);
+    UNUSED_PARAM(source);
+    UNUSED_PARAM(length);
+#endif
+    return i;
+}
+
+// Zero extends the whole blocks of source. Returns how many characters were copied.
+ALWAYS_INLINE unsigned copyLCharsToUCharsInBlocks(UChar* destination, const LChar* source, unsigned length)
+{
+    unsigned i = 0;
+#if defined(WTF_STRING_USE_SIMD)
+    for (; length - i >= characterBlockSize; i += characterBlockSize) {
+        CharacterBlock block = loadCharacterBlock(source + i);
+#if defined(WTF_STRING_USE_SSE2)
+        __m128i zero = _mm_setzero_si128();
+        storeCharacterBlock(destination + i, _mm_unpacklo_epi8(block, zero));
+        storeCharacterBlock(destination + i + characterBlockSize / 2, _mm_unpackhi_epi8(block, zero));
+#else
+        vst1q_u16(reinterpret_cast<uint16_t*>(destination + i), vmovl_u8(vget_low_u8(block)));
+        vst1q_u16(reinterpret_cast<uint16_t*>(destination + i + characterBlockSize / 2), vmovl_u8(vget_high_u8(block)));
+#endif
+    }
+#else
+    UNUSED_PARAM(destination);
+    UNUSED_PARAM(source);
+    UNUSED_PARAM(length);
+#endif
+    return i;
+}
+
+} // namespace WTF
+
+#endif // StringSIMD_h
@@ -698,9 +698,10 @@ bool String::isSafeToSendToAnotherThread() const
     if (!impl())
         return true;
     // AtomicStrings are not safe to send between threads as ~StringImpl()
-    // will try to remove them from the wrong AtomicStringTable.
+    // will try to remove them from the wrong AtomicStringTable, unless they
+    // are shared ones, which are never destroyed.
     if (impl()->isAtomic())
-        return false;
+        return impl()->isSharedAtomic();
     if (impl()->hasOneRef())
         return true;
     if (isEmpty())
@@ -195,6 +195,7 @@ SOURCES += \
      bindings/js/ScriptEventListener.cpp \
      bindings/js/ScriptFunctionCall.cpp \
      bindings/js/ScriptGCEvent.cpp \
+     bindings/js/ScriptHeapSnapshot.cpp \
      bindings/js/ScriptObject.cpp \
      bindings/js/ScriptProfile.cpp \
      bindings/js/ScriptState.cpp \
@@ -302,6 +303,7 @@ SOURCES += \
     css/CSSValue.cpp \
     css/CSSValueList.cpp \
     css/CSSValuePool.cpp \
+    css/CompiledSelector.cpp \
     css/DOMWindowCSS.cpp \
     css/DeprecatedStyleBuilder.cpp \
     css/DocumentRuleSets.cpp \
@@ -737,6 +739,7 @@ SOURCES += \
     html/parser/HTMLElementStack.cpp \
     html/parser/HTMLEntityParser.cpp \
     html/parser/HTMLEntitySearch.cpp \
+    html/parser/HTMLFastPathParser.cpp \
     html/parser/HTMLFormattingElementList.cpp \
     html/parser/HTMLIdentifier.cpp \
     html/parser/HTMLMetaCharsetParser.cpp \
@@ -924,6 +927,7 @@ SOURCES += \
     page/GroupSettings.cpp \
     page/History.cpp \
     page/Location.cpp \
+    page/MemoryUsageReporters.cpp \
     page/MouseEventWithHitTestResults.cpp \
     page/Navigator.cpp \
     page/NavigatorBase.cpp \
@@ -1526,6 +1530,7 @@ HEADERS += \
     css/CSSValueList.h \
     css/CSSValuePool.h \
     css/CSSVariableValue.h \
+    css/CompiledSelector.h \
     css/DeprecatedStyleBuilder.h \
     css/DOMWindowCSS.h \
     css/FontFeatureValue.h \
@@ -1913,6 +1918,7 @@ HEADERS += \
     html/parser/HTMLEntityParser.h \
     html/parser/HTMLEntitySearch.h \
     html/parser/HTMLEntityTable.h \
+    html/parser/HTMLFastPathParser.h \
     html/parser/HTMLFormattingElementList.h \
     html/parser/HTMLParserScheduler.h \
     html/parser/HTMLPreloadScanner.h \
@@ -2087,6 +2093,7 @@ HEADERS += \
     page/History.h \
     page/LayoutMilestones.h \
     page/Location.h \
+    page/MemoryUsageReporters.h \
     page/MouseEventWithHitTestResults.h \
     page/NavigatorBase.h \
     page/Navigator.h \
@@ -145,6 +145,7 @@ list(APPEND WebCore_SOURCES
     bindings/js/ScriptEventListener.cpp
     bindings/js/ScriptFunctionCall.cpp
     bindings/js/ScriptGCEvent.cpp
+    bindings/js/ScriptHeapSnapshot.cpp
     bindings/js/ScriptObject.cpp
     bindings/js/ScriptProfile.cpp
     bindings/js/ScriptProfiler.cpp
@@ -165,6 +165,7 @@
 #include "ScriptEventListener.cpp"
 #include "ScriptFunctionCall.cpp"
 #include "ScriptGCEvent.cpp"
+#include "ScriptHeapSnapshot.cpp"
 #include "ScriptProfiler.cpp"
 #include "ScriptState.cpp"
 #include "SerializedScriptValue.cpp"
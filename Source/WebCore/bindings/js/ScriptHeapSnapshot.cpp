@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#if ENABLE(JAVASCRIPT_DEBUGGER)
+
+#include "ScriptHeapSnapshot.h"
+
+#include <stdio.h>
+#include <wtf/PrintStream.h>
+#include <wtf/text/StringBuilder.h>
+
+namespace WebCore {
+
+// Forwards the JSON produced by JSC::HeapSnapshot to the inspector in bounded
+// chunks, so that large heaps never need a single string holding the whole dump.
+class ChunkedOutputPrintStream : public PrintStream {
+public:
+    explicit ChunkedOutputPrintStream(ScriptHeapSnapshot::OutputStream* stream)
+        : m_stream(stream)
+    {
+    }
+
+    virtual void vprintf(const char* format, va_list argList) OVERRIDE WTF_ATTRIBUTE_PRINTF(2, 0)
+    {
+        char inlineBuffer[128];
+        va_list argListCopy;
+        va_copy(argListCopy, argList);
+        int length = vsnprintf(inlineBuffer, sizeof(inlineBuffer), format, argListCopy);
+        va_end(argListCopy);
+        if (length < 0)
+            return;
+
+        if (static_cast<size_t>(length) < sizeof(inlineBuffer))
+            m_builder.append(inlineBuffer, length);
+        else {
+            Vector<char> buffer(length + 1);
+            vsnprintf(buffer.data(), buffer.size(), format, argList);
+            m_builder.append(buffer.data(), length);
+        }
+
+        if (m_builder.length() >= chunkSize)
+            flush();
+    }
+
+    virtual void flush() OVERRIDE
+    {
+        if (m_builder.isEmpty())
+            return;
+        m_stream->Write(m_builder.toString());
+        m_builder.clear();
+    }
+
+private:
+    static const unsigned chunkSize = 64 * 1024;
+
+    ScriptHeapSnapshot::OutputStream* m_stream;
+    StringBuilder m_builder;
+};
+
+void ScriptHeapSnapshot::writeJSON(OutputStream* stream)
+{
+    ChunkedOutputPrintStream out(stream);
+    m_snapshot->writeJSON(out);
+    out.flush();
+    stream->Close();
+}
+
+} // namespace WebCore
+
+#endif // ENABLE(JAVASCRIPT_DEBUGGER)
@@ -31,7 +31,10 @@
 #ifndef ScriptHeapSnapshot_h
 #define ScriptHeapSnapshot_h
 
+#include <heap/HeapSnapshot.h>
+#include <wtf/PassRefPtr.h>
 #include <wtf/RefCounted.h>
+#include <wtf/RefPtr.h>
 #include <wtf/text/WTFString.h>
 
 namespace WebCore {
@@ -47,16 +50,30 @@ public:
         virtual void Close() = 0;
     };
 
+    static PassRefPtr<ScriptHeapSnapshot> create(PassRefPtr<JSC::HeapSnapshot> snapshot, const String& title, unsigned uid)
+    {
+        return adoptRef(new ScriptHeapSnapshot(snapshot, title, uid));
+    }
+
     virtual ~ScriptHeapSnapshot() { }
 
-    String title() const { return ""; }
-    unsigned int uid() const { return 0; }
+    String title() const { return m_title; }
+    unsigned int uid() const { return m_uid; }
 
-    void writeJSON(OutputStream*) { }
-    SnapshotObjectId maxSnapshotJSObjectId() const { return 0; }
+    void writeJSON(OutputStream*);
+    SnapshotObjectId maxSnapshotJSObjectId() const { return m_snapshot->nodeCount(); }
 
 private:
-    ScriptHeapSnapshot() { }
+    ScriptHeapSnapshot(PassRefPtr<JSC::HeapSnapshot> snapshot, const String& title, unsigned uid)
+        : m_snapshot(snapshot)
+        , m_title(title)
+        , m_uid(uid)
+    {
+    }
+
+    RefPtr<JSC::HeapSnapshot> m_snapshot;
+    String m_title;
+    unsigned m_uid;
 };
 
 } // namespace WebCore
@@ -37,6 +37,7 @@
 #include "Page.h"
 #include "ScriptObject.h"
 #include "ScriptState.h"
+#include <heap/HeapSnapshot.h>
 #include <profiler/LegacyProfiler.h>
 #include <wtf/Forward.h>
 
@@ -94,6 +95,20 @@ PassRefPtr<ScriptProfile> ScriptProfiler::stopForWorkerGlobalScope(WorkerGlobalS
 }
 #endif
 
+PassRefPtr<ScriptHeapSnapshot> ScriptProfiler::takeHeapSnapshot(const String& title, HeapSnapshotProgress* progress)
+{
+    static unsigned nextSnapshotUid = 1;
+
+    if (progress)
+        progress->Start(1);
+    RefPtr<JSC::HeapSnapshot> snapshot = JSC::HeapSnapshot::take(*JSDOMWindow::commonVM());
+    if (progress) {
+        progress->Worked(1);
+        progress->Done();
+    }
+    return ScriptHeapSnapshot::create(snapshot.release(), title, nextSnapshotUid++);
+}
+
 } // namespace WebCore
 
 #endif // ENABLE(JAVASCRIPT_DEBUGGER)
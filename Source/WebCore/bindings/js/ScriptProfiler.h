@@ -69,10 +69,10 @@ public:
 #if ENABLE(WORKERS)
     static PassRefPtr<ScriptProfile> stopForWorkerGlobalScope(WorkerGlobalScope*, const String& title);
 #endif
-    static PassRefPtr<ScriptHeapSnapshot> takeHeapSnapshot(const String&, HeapSnapshotProgress*) { return 0; }
+    static PassRefPtr<ScriptHeapSnapshot> takeHeapSnapshot(const String& title, HeapSnapshotProgress*);
     static bool causesRecompilation() { return true; }
     static bool isSampling() { return false; }
-    static bool hasHeapProfiler() { return false; }
+    static bool hasHeapProfiler() { return true; }
     // FIXME: Implement this counter for JSC. See bug 73936 for more details.
     static void visitNodeWrappers(WrappedNodeVisitor*) { }
     // FIXME: Support these methods for JSC. See bug 90358.
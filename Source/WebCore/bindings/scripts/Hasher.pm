@@ -28,65 +28,75 @@ package Hasher;
 
 use strict;
 
-sub leftShift($$) {
-    my ($value, $distance) = @_;
-    return (($value << $distance) & 0xFFFFFFFF);
+# 64-bit values are kept as pairs of 32-bit halves, high half first.
+sub multiply64($$$$)
+{
+    my ($aHigh, $aLow, $bHigh, $bLow) = @_;
+
+    my @a = ($aLow & 0xFFFF, $aLow >> 16, $aHigh & 0xFFFF, $aHigh >> 16);
+    my @b = ($bLow & 0xFFFF, $bLow >> 16, $bHigh & 0xFFFF, $bHigh >> 16);
+    my @result = ();
+    my $carry = 0;
+    for (my $k = 0; $k < 4; $k++) {
+        my $sum = $carry;
+        for (my $i = 0; $i <= $k; $i++) {
+            $sum += $a[$i] * $b[$k - $i];
+        }
+        push(@result, $sum & 0xFFFF);
+        $carry = $sum >> 16;
+    }
+
+    return (($result[3] << 16) | $result[2], ($result[1] << 16) | $result[0]);
+}
+
+sub mixWord($$$$)
+{
+    my ($hashHigh, $hashLow, $wordHigh, $wordLow) = @_;
+
+    ($hashHigh, $hashLow) = multiply64($hashHigh ^ $wordHigh, $hashLow ^ $wordLow, 0xFF51AFD7, 0xED558CCD);
+
+    # Rotate left by 31 bits.
+    return ((($hashLow >> 1) | (($hashHigh & 1) << 31)), (($hashHigh >> 1) | (($hashLow & 1) << 31)));
 }
 
-# Paul Hsieh's SuperFastHash
-# http://www.azillionmonkeys.com/qed/hash.html
+# Consumes four 16-bit characters per 64-bit word, then applies the MurmurHash3 64-bit finalizer.
+# This must stay in sync with StringHasher in WTF.
 sub GenerateHashValue
 {
     my @chars = split(/ */, $_[0]);
+    my $length = scalar @chars;
 
-    # This hash is designed to work on 16-bit chunks at a time. But since the normal case
-    # (above) is to hash UTF-16 characters, we just treat the 8-bit chars as if they
-    # were 16-bit chunks, which should give matching results
-    
-    my $EXP2_32 = 4294967296;
-    
-    my $hash = 0x9e3779b9;
-    my $l    = scalar @chars; #I wish this was in Ruby --- Maks
-    my $rem  = $l & 1;
-    $l = $l >> 1;
-    
-    my $s = 0;
-    
-    # Main loop
-    for (; $l > 0; $l--) {
-        $hash   += ord($chars[$s]);
-        my $tmp = leftShift(ord($chars[$s+1]), 11) ^ $hash;
-        $hash   = (leftShift($hash, 16)% $EXP2_32) ^ $tmp;
-        $s += 2;
-        $hash += $hash >> 11;
-        $hash %= $EXP2_32;
-    }
-    
-    # Handle end case
-    if ($rem != 0) {
-        $hash += ord($chars[$s]);
-        $hash ^= (leftShift($hash, 11)% $EXP2_32);
-        $hash += $hash >> 17;
+    # Golden ratio. Arbitrary start value to avoid mapping all zeros to a hash value of zero.
+    my ($hashHigh, $hashLow) = (0x9E3779B9, 0x7F4A7C15);
+
+    # Main loop. A partial word at the end is padded with null characters.
+    for (my $i = 0; $i < $length; $i += 4) {
+        my @word = (0, 0, 0, 0);
+        for (my $j = 0; $j < 4 && $i + $j < $length; $j++) {
+            $word[$j] = ord($chars[$i + $j]);
+        }
+        ($hashHigh, $hashLow) = mixWord($hashHigh, $hashLow, ($word[3] << 16) | $word[2], ($word[1] << 16) | $word[0]);
     }
-    
-    # Force "avalanching" of final 127 bits
-    $hash ^= leftShift($hash, 3);
-    $hash += ($hash >> 5);
-    $hash = ($hash% $EXP2_32);
-    $hash ^= (leftShift($hash, 2)% $EXP2_32);
-    $hash += ($hash >> 15);
-    $hash = $hash% $EXP2_32;
-    $hash ^= (leftShift($hash, 10)% $EXP2_32);
-    
+
+    # Handle end case.
+    $hashLow ^= $length;
+
+    # Force "avalanching" of all 64 bits.
+    $hashLow ^= $hashHigh >> 1;
+    ($hashHigh, $hashLow) = multiply64($hashHigh, $hashLow, 0xFF51AFD7, 0xED558CCD);
+    $hashLow ^= $hashHigh >> 1;
+    ($hashHigh, $hashLow) = multiply64($hashHigh, $hashLow, 0xC4CEB9FE, 0x1A85EC53);
+    $hashLow ^= $hashHigh >> 1;
+
     # Save 8 bits for StringImpl to use as flags.
-    $hash &= 0xffffff;
-    
+    my $hash = $hashLow & 0xffffff;
+
     # This avoids ever returning a hash code of 0, since that is used to
     # signal "hash not computed yet". Setting the high bit maintains
     # reasonable fidelity to a hash code of 0 because it is likely to yield
     # exactly 0 when hash lookup masks out the high bits.
     $hash = (0x80000000 >> 8) if ($hash == 0);
-    
+
     return $hash;
 }
 
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "CompiledSelector.h"
+
+#include "CSSSelector.h"
+#include "Element.h"
+#include "HTMLDocument.h"
+#include "HTMLNames.h"
+#include "SelectorChecker.h"
+#include <algorithm>
+
+namespace WebCore {
+
+using namespace HTMLNames;
+
+bool CompiledSelector::appendSimpleSelector(const CSSSelector* selector, Vector<Instruction>& instructions)
+{
+    switch (selector->m_match) {
+    case CSSSelector::Tag: {
+        const QualifiedName& tagQName = selector->tagQName();
+        if (tagQName.localName() != starAtom)
+            instructions.append(Instruction(MatchLocalName, selector, tagQName.localName().impl()));
+        if (tagQName.namespaceURI() != starAtom)
+            instructions.append(Instruction(MatchNamespace, selector, tagQName.namespaceURI().impl()));
+        return true;
+    }
+    case CSSSelector::Id:
+        instructions.append(Instruction(MatchId, selector, selector->value().impl()));
+        return true;
+    case CSSSelector::Class:
+        instructions.append(Instruction(MatchClass, selector));
+        return true;
+    case CSSSelector::Set:
+        // The style attribute is generated lazily, which checkExactAttribute does not trigger.
+        if (selector->attribute() == styleAttr)
+            return false;
+        instructions.append(Instruction(MatchAttribute, selector));
+        return true;
+    case CSSSelector::Exact:
+        if (selector->attribute() == styleAttr || !HTMLDocument::isCaseSensitiveAttribute(selector->attribute()))
+            return false;
+        instructions.append(Instruction(MatchAttribute, selector, selector->value().impl()));
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool CompiledSelector::appendCompoundSelector(const CSSSelector*& selector, Vector<Instruction>& instructions)
+{
+    size_t compoundStart = instructions.size();
+    CSSSelector::Relation relation;
+    do {
+        if (!appendSimpleSelector(selector, instructions))
+            return false;
+        relation = selector->relation();
+        selector = selector->tagHistory();
+    } while (selector && relation == CSSSelector::SubSelector);
+
+    std::stable_sort(instructions.begin() + compoundStart, instructions.end());
+
+    if (!selector) {
+        instructions.append(Instruction(Succeed));
+        return true;
+    }
+    if (relation == CSSSelector::Child) {
+        instructions.append(Instruction(Child));
+        return true;
+    }
+    if (relation == CSSSelector::Descendant) {
+        instructions.append(Instruction(Descendant));
+        return true;
+    }
+    return false;
+}
+
+bool CompiledSelector::compile(const CSSSelector* selector)
+{
+    ASSERT(isEmpty());
+    while (selector) {
+        if (!appendCompoundSelector(selector, m_instructions)) {
+            m_instructions.clear();
+            return false;
+        }
+    }
+    m_instructions.shrinkToFit();
+    return true;
+}
+
+bool CompiledSelector::matches(const Element* element) const
+{
+    ASSERT(!m_instructions.isEmpty());
+
+    // Selectors with only descendant and child combinators never need to backtrack further
+    // than the last descendant combinator: trying an element higher up for any compound to
+    // its left can only leave fewer ancestors to match the rest of the selector.
+    size_t backtrackIndex = 0;
+    const Element* backtrackElement = 0;
+
+    size_t index = 0;
+    while (true) {
+        const Instruction& instruction = m_instructions[index];
+        bool matched = false;
+        switch (instruction.opcode) {
+        case MatchId:
+            matched = element->hasID() && element->idForStyleResolution().impl() == instruction.value;
+            break;
+        case MatchLocalName:
+            matched = element->localName().impl() == instruction.value;
+            break;
+        case MatchNamespace:
+            matched = element->namespaceURI().impl() == instruction.value;
+            break;
+        case MatchClass:
+            matched = element->hasClass() && element->classNames().contains(instruction.selector->value());
+            break;
+        case MatchAttribute:
+            matched = SelectorChecker::checkExactAttribute(element, instruction.selector, instruction.selector->attribute(), instruction.value);
+            break;
+        case Child:
+            element = element->parentElement();
+            if (!element)
+                return false;
+            ++index;
+            continue;
+        case Descendant:
+            element = element->parentElement();
+            if (!element)
+                return false;
+            backtrackIndex = index;
+            backtrackElement = element;
+            ++index;
+            continue;
+        case Succeed:
+            return true;
+        }
+
+        if (matched) {
+            ++index;
+            continue;
+        }
+
+        // The rightmost compound selector failed, or one after it failed and there is
+        // no descendant combinator to retry from.
+        if (!backtrackElement)
+            return false;
+
+        // Retry the compound selectors after the last descendant combinator, starting
+        // from the next ancestor of the element it last moved to.
+        index = backtrackIndex;
+        element = backtrackElement;
+    }
+}
+
+} // namespace WebCore
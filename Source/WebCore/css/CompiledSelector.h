@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CompiledSelector_h
+#define CompiledSelector_h
+
+#include <wtf/Vector.h>
+#include <wtf/text/AtomicStringImpl.h>
+
+namespace WebCore {
+
+class CSSSelector;
+class Element;
+
+// A selector made of tag, id, class and attribute presence or equality checks joined by
+// descendant and child combinators, flattened into a list of instructions that are run
+// right to left. Descendant combinators record a backtracking point, so a failed match
+// further left retries from the next ancestor without recursing.
+class CompiledSelector {
+public:
+    // Returns false and leaves this empty if the selector has parts that have to be
+    // matched by SelectorChecker.
+    bool compile(const CSSSelector*);
+
+    bool isEmpty() const { return m_instructions.isEmpty(); }
+    bool matches(const Element*) const;
+
+private:
+
+    enum Opcode {
+        // The checks of a compound selector are sorted in this order, cheapest first.
+        MatchId,
+        MatchLocalName,
+        MatchNamespace,
+        MatchClass,
+        MatchAttribute,
+        // Move to the parent element.
+        Child,
+        // Move to the parent element and record it as the point to backtrack to.
+        Descendant,
+        Succeed
+    };
+
+    struct Instruction {
+        Instruction(Opcode opcode, const CSSSelector* selector = 0, AtomicStringImpl* value = 0)
+            : opcode(opcode)
+            , selector(selector)
+            , value(value)
+        {
+        }
+
+        bool operator<(const Instruction& other) const { return opcode < other.opcode; }
+
+        Opcode opcode;
+        const CSSSelector* selector;
+        AtomicStringImpl* value;
+    };
+
+    static bool appendSimpleSelector(const CSSSelector*, Vector<Instruction>&);
+    static bool appendCompoundSelector(const CSSSelector*&, Vector<Instruction>&);
+
+    Vector<Instruction> m_instructions;
+};
+
+} // namespace WebCore
+
+#endif // CompiledSelector_h
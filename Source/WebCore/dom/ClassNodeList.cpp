@@ -33,6 +33,7 @@
 #include "Document.h"
 #include "NodeRareData.h"
 #include "StyledElement.h"
+#include "TreeScope.h"
 
 namespace WebCore {
 
@@ -40,6 +41,7 @@ ClassNodeList::ClassNodeList(PassRefPtr<Node> rootNode, const String& classNames
     : LiveNodeList(rootNode, ClassNodeListType, InvalidateOnClassAttrChange)
     , m_classNames(classNames, document()->inQuirksMode())
     , m_originalClassNames(classNames)
+    , m_cachedCandidateIndex(0)
 {
 }
 
@@ -53,4 +55,50 @@ bool ClassNodeList::nodeMatches(Element* testNode) const
     return nodeMatchesInlined(testNode);
 }
 
+const Vector<Element*>* ClassNodeList::indexedCandidates(ContainerNode* root) const
+{
+    if (!m_classNames.size())
+        return 0;
+    TreeScope* scope = root->treeScope();
+    if (scope->rootNode() != root)
+        return 0;
+
+    // Every match carries the first class name, so the elements indexed under it are a superset of the list.
+    if (const Vector<Element*>* candidates = scope->getAllElementsByClassName(m_classNames[0]))
+        return candidates;
+    DEFINE_STATIC_LOCAL(const Vector<Element*>, noCandidates, ());
+    return &noCandidates;
+}
+
+Element* ClassNodeList::firstIndexedElement(const Vector<Element*>& candidates) const
+{
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (nodeMatchesInlined(candidates[i])) {
+            m_cachedCandidateIndex = i;
+            return candidates[i];
+        }
+    }
+    return 0;
+}
+
+size_t ClassNodeList::indexOfIndexedCandidate(const Vector<Element*>& candidates, Element* element) const
+{
+    if (m_cachedCandidateIndex < candidates.size() && candidates[m_cachedCandidateIndex] == element)
+        return m_cachedCandidateIndex;
+    return candidates.find(element);
+}
+
+Element* ClassNodeList::traverseIndexedElementsForwardToOffset(const Vector<Element*>& candidates, size_t currentIndex, unsigned offset, unsigned& currentOffset) const
+{
+    ASSERT(currentOffset < offset);
+    ASSERT(currentIndex < candidates.size());
+    for (size_t i = currentIndex + 1; i < candidates.size(); ++i) {
+        if (nodeMatchesInlined(candidates[i]) && ++currentOffset == offset) {
+            m_cachedCandidateIndex = i;
+            return candidates[i];
+        }
+    }
+    return 0;
+}
+
 } // namespace WebCore
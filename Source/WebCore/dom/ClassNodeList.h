@@ -48,6 +48,13 @@ public:
 
     bool nodeMatchesInlined(Element*) const;
 
+    // Lists rooted at a tree scope root walk the scope's class name index instead of the whole subtree.
+    const Vector<Element*>* indexedCandidates(ContainerNode* root) const;
+    Element* firstIndexedElement(const Vector<Element*>& candidates) const;
+    // Returns notFound if the element is not among the candidates; callers then walk the tree instead.
+    size_t indexOfIndexedCandidate(const Vector<Element*>& candidates, Element*) const;
+    Element* traverseIndexedElementsForwardToOffset(const Vector<Element*>& candidates, size_t currentIndex, unsigned offset, unsigned& currentOffset) const;
+
 private:
     ClassNodeList(PassRefPtr<Node> rootNode, const String& classNames);
 
@@ -55,6 +62,7 @@ private:
 
     SpaceSplitString m_classNames;
     String m_originalClassNames;
+    mutable size_t m_cachedCandidateIndex;
 };
 
 inline bool ClassNodeList::nodeMatchesInlined(Element* testNode) const
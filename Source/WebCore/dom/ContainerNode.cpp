@@ -800,11 +800,20 @@ void ContainerNode::detach(const AttachContext& context)
     Node::detach(context);
 }
 
-void ContainerNode::childrenChanged(bool changedByParser, Node*, Node*, int childCountDelta)
+void ContainerNode::childrenChanged(bool changedByParser, Node* beforeChange, Node* afterChange, int childCountDelta)
 {
     document()->incDOMTreeVersion();
     if (!changedByParser && childCountDelta)
         document()->updateRangesAfterChildrenChanged(this);
+
+    // A single inserted child only adds items, so live lists can account for it instead of starting over.
+    if (childCountDelta == 1) {
+        Node* insertedChild = beforeChange ? beforeChange->nextSibling() : firstChild();
+        if (insertedChild && insertedChild->nextSibling() == afterChange) {
+            invalidateNodeListCachesInAncestorsForInsertion(insertedChild);
+            return;
+        }
+    }
     invalidateNodeListCachesInAncestors();
 }
 
@@ -3699,6 +3699,10 @@ void Document::addListenerTypeIfNeeded(const AtomicString& eventType)
         addListenerType(BEFORELOAD_LISTENER);
     else if (eventType == eventNames().scrollEvent)
         addListenerType(SCROLL_LISTENER);
+    else if (eventType == eventNames().mousemoveEvent)
+        addListenerType(MOUSEMOVE_LISTENER);
+    else if (eventType == eventNames().touchmoveEvent)
+        addListenerType(TOUCHMOVE_LISTENER);
 }
 
 CSSStyleDeclaration* Document::getOverrideStyle(Element*, const String&)
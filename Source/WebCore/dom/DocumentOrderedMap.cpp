@@ -63,6 +63,11 @@ inline bool keyMatchesLowercasedMapName(AtomicStringImpl* key, Element* element)
     return isHTMLMapElement(element) && toHTMLMapElement(element)->getName().lower().impl() == key;
 }
 
+inline bool keyMatchesClassName(AtomicStringImpl* key, Element* element)
+{
+    return element->hasClass() && element->classNames().contains(key);
+}
+
 inline bool keyMatchesLabelForAttribute(AtomicStringImpl* key, Element* element)
 {
     return isHTMLLabelElement(element) && element->getAttribute(forAttr).impl() == key;
@@ -96,7 +101,14 @@ void DocumentOrderedMap::add(AtomicStringImpl* key, Element* element)
     ASSERT(entry.count);
     entry.element = 0;
     entry.count++;
-    entry.orderedList.clear();
+    // Elements are usually added in document order, as the parser or a script appends them.
+    // Keep the list in that case and let any other insertion rebuild it on the next getAll().
+    if (entry.orderedList.isEmpty())
+        return;
+    if (entry.orderedList.last()->compareDocumentPosition(element) & Node::DOCUMENT_POSITION_FOLLOWING)
+        entry.orderedList.append(element);
+    else
+        entry.orderedList.clear();
 }
 
 void DocumentOrderedMap::remove(AtomicStringImpl* key, Element* element)
@@ -120,7 +132,11 @@ void DocumentOrderedMap::remove(AtomicStringImpl* key, Element* element)
         if (entry.element == element)
             entry.element = 0;
         entry.count--;
-        entry.orderedList.clear(); // FIXME: Remove the element instead if there are only few items left.
+        // Removing the last element keeps the list valid. Anything else rebuilds it on the next getAll().
+        if (!entry.orderedList.isEmpty() && entry.orderedList.last() == element)
+            entry.orderedList.removeLast();
+        else
+            entry.orderedList.clear();
     }
 }
 
@@ -187,7 +203,8 @@ Element* DocumentOrderedMap::getElementByDocumentNamedItem(AtomicStringImpl* key
     return get<keyMatchesDocumentNamedItem>(key, scope);
 }
 
-const Vector<Element*>* DocumentOrderedMap::getAllElementsById(AtomicStringImpl* key, const TreeScope* scope) const
+template<bool keyMatches(AtomicStringImpl*, Element*)>
+inline const Vector<Element*>* DocumentOrderedMap::getAll(AtomicStringImpl* key, const TreeScope* scope) const
 {
     ASSERT(key);
     ASSERT(scope);
@@ -206,7 +223,7 @@ const Vector<Element*>* DocumentOrderedMap::getAllElementsById(AtomicStringImpl*
     if (entry.orderedList.isEmpty()) {
         entry.orderedList.reserveCapacity(entry.count);
         for (Element* element = entry.element ? entry.element : ElementTraversal::firstWithin(scope->rootNode()); element; element = ElementTraversal::next(element)) {
-            if (!keyMatchesId(key, element))
+            if (!keyMatches(key, element))
                 continue;
             entry.orderedList.append(element);
         }
@@ -216,4 +233,14 @@ const Vector<Element*>* DocumentOrderedMap::getAllElementsById(AtomicStringImpl*
     return &entry.orderedList;
 }
 
+const Vector<Element*>* DocumentOrderedMap::getAllElementsById(AtomicStringImpl* key, const TreeScope* scope) const
+{
+    return getAll<keyMatchesId>(key, scope);
+}
+
+const Vector<Element*>* DocumentOrderedMap::getAllElementsByClassName(AtomicStringImpl* key, const TreeScope* scope) const
+{
+    return getAll<keyMatchesClassName>(key, scope);
+}
+
 } // namespace WebCore
@@ -61,11 +61,13 @@ public:
     Element* getElementByDocumentNamedItem(AtomicStringImpl*, const TreeScope*) const;
 
     const Vector<Element*>* getAllElementsById(AtomicStringImpl*, const TreeScope*) const;
+    const Vector<Element*>* getAllElementsByClassName(AtomicStringImpl*, const TreeScope*) const;
 
     void checkConsistency() const;
 
 private:
     template<bool keyMatches(AtomicStringImpl*, Element*)> Element* get(AtomicStringImpl*, const TreeScope*) const;
+    template<bool keyMatches(AtomicStringImpl*, Element*)> const Vector<Element*>* getAll(AtomicStringImpl*, const TreeScope*) const;
 
     struct MapEntry {
         MapEntry()
@@ -82,7 +84,12 @@ private:
         Vector<Element*> orderedList;
     };
 
-    typedef HashMap<AtomicStringImpl*, MapEntry> Map;
+    // Lookups by id and name are hot, and many of them miss, so use group probing.
+    struct MapKeyTraits : HashTraits<AtomicStringImpl*> {
+        static const bool useGroupProbing = true;
+    };
+
+    typedef HashMap<AtomicStringImpl*, MapEntry, PtrHash<AtomicStringImpl*>, MapKeyTraits> Map;
 
     mutable Map m_map;
 };
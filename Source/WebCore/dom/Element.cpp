@@ -1142,19 +1142,21 @@ void Element::classAttributeChanged(const AtomicString& newClassString)
     StyleResolver* styleResolver = document()->styleResolverIfExists();
     bool testShouldInvalidateStyle = attached() && styleResolver && styleChangeType() < FullStyleChange;
     bool shouldInvalidateStyle = false;
+    const SpaceSplitString oldClasses = elementData()->classNames();
 
     if (classStringHasClassName(newClassString)) {
         const bool shouldFoldCase = document()->inQuirksMode();
-        const SpaceSplitString oldClasses = elementData()->classNames();
         elementData()->setClass(newClassString, shouldFoldCase);
         const SpaceSplitString& newClasses = elementData()->classNames();
         shouldInvalidateStyle = testShouldInvalidateStyle && checkSelectorForClassChange(oldClasses, newClasses, *styleResolver);
     } else {
-        const SpaceSplitString& oldClasses = elementData()->classNames();
         shouldInvalidateStyle = testShouldInvalidateStyle && checkSelectorForClassChange(oldClasses, *styleResolver);
         elementData()->clearClass();
     }
 
+    if (isInTreeScope())
+        treeScope()->updateElementClassNames(this, oldClasses, elementData()->classNames());
+
     if (hasRareData())
         elementRareData()->clearClassListValueForQuirksMode();
 
@@ -1355,6 +1357,9 @@ Node::InsertionNotificationRequest Element::insertedInto(ContainerNode* insertio
             updateLabel(newScope, nullAtom, fastGetAttribute(forAttr));
     }
 
+    if (newScope && hasClass())
+        newScope->updateElementClassNames(this, SpaceSplitString(), classNames());
+
     return InsertionDone;
 }
 
@@ -1410,6 +1415,9 @@ void Element::removedFrom(ContainerNode* insertionPoint)
             if (oldScope->shouldCacheLabelsByForAttribute())
                 updateLabel(oldScope, fastGetAttribute(forAttr), nullAtom);
         }
+
+        if (oldScope && hasClass())
+            oldScope->updateElementClassNames(this, classNames(), SpaceSplitString());
     }
 
     ContainerNode::removedFrom(insertionPoint);
@@ -3287,6 +3295,7 @@ PassRefPtr<UniqueElementData> UniqueElementData::create()
 
 ShareableElementData::ShareableElementData(const Vector<Attribute>& attributes)
     : ElementData(attributes.size())
+    , m_presentationAttributeStyleTagName(nullQName())
 {
     for (unsigned i = 0; i < m_arraySize; ++i)
         new (NotNull, &m_attributeArray[i]) Attribute(attributes[i]);
@@ -3300,6 +3309,7 @@ ShareableElementData::~ShareableElementData()
 
 ShareableElementData::ShareableElementData(const UniqueElementData& other)
     : ElementData(other, false)
+    , m_presentationAttributeStyleTagName(nullQName())
 {
     ASSERT(!other.m_presentationAttributeStyle);
 
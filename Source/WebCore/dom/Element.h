@@ -72,6 +72,7 @@ public:
     const StylePropertySet* inlineStyle() const { return m_inlineStyle.get(); }
 
     const StylePropertySet* presentationAttributeStyle() const;
+    bool presentationAttributeStyleNeedsRebuild(const QualifiedName& tagName) const;
 
     unsigned length() const;
     bool isEmpty() const { return !length(); }
@@ -137,6 +138,12 @@ public:
     explicit ShareableElementData(const UniqueElementData&);
     ~ShareableElementData();
 
+    // The presentation attribute style only depends on the tag name and the attributes, so the
+    // elements with m_presentationAttributeStyleTagName sharing this data can share it too. The
+    // namespace is part of the key: an HTML and an SVG element can share attributes.
+    mutable RefPtr<StylePropertySet> m_presentationAttributeStyle;
+    mutable QualifiedName m_presentationAttributeStyleTagName;
+
     Attribute m_attributeArray[0];
 };
 
@@ -980,10 +987,18 @@ inline const Attribute* ElementData::attributeBase() const
 inline const StylePropertySet* ElementData::presentationAttributeStyle() const
 {
     if (!m_isUnique)
-        return 0;
+        return static_cast<const ShareableElementData*>(this)->m_presentationAttributeStyle.get();
     return static_cast<const UniqueElementData*>(this)->m_presentationAttributeStyle.get();
 }
 
+inline bool ElementData::presentationAttributeStyleNeedsRebuild(const QualifiedName& tagName) const
+{
+    if (!m_presentationAttributeStyleIsDirty)
+        return false;
+    // The dirty bit of shared data stays set; it means the style has to match the element's tag name.
+    return m_isUnique || static_cast<const ShareableElementData*>(this)->m_presentationAttributeStyleTagName != tagName;
+}
+
 inline const Attribute* ElementData::getAttributeItem(const AtomicString& name, bool shouldIgnoreAttributeCase) const
 {
     unsigned index = getAttributeItemIndex(name, shouldIgnoreAttributeCase);
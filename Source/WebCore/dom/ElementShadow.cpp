@@ -28,6 +28,7 @@
 #include "ElementShadow.h"
 
 #include "ContainerNodeAlgorithms.h"
+#include "EventRetargeter.h"
 #include "InspectorInstrumentation.h"
 
 namespace WebCore {
@@ -41,6 +42,7 @@ ShadowRoot* ElementShadow::addShadowRoot(Element* shadowHost, ShadowRoot::Shadow
     m_shadowRoot->setParentTreeScope(shadowHost->treeScope());
     m_distributor.didShadowBoundaryChange(shadowHost);
     ChildNodeInsertionNotifier(shadowHost).notify(m_shadowRoot.get());
+    EventRetargeter::invalidateCachedEventPath();
 
     // Existence of shadow roots requires the host and its children to do traversal using ComposedShadowTreeWalker.
     shadowHost->setNeedsShadowTreeWalker();
@@ -72,6 +74,7 @@ void ElementShadow::removeShadowRoot()
         oldRoot->setParentOrShadowHostNode(0);
         oldRoot->setParentTreeScope(shadowHost->document());
         ChildNodeRemovalNotifier(shadowHost).notify(oldRoot.get());
+        EventRetargeter::invalidateCachedEventPath();
     }
 
     m_distributor.invalidateDistribution(shadowHost);
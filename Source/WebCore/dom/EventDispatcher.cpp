@@ -27,6 +27,7 @@
 #include "EventDispatcher.h"
 
 #include "ContainerNode.h"
+#include "Document.h"
 #include "ElementShadow.h"
 #include "EventContext.h"
 #include "EventDispatchMediator.h"
@@ -99,6 +100,19 @@ void EventDispatcher::dispatchSimulatedClick(Element* element, Event* underlying
     elementsDispatchingSimulatedClicks.remove(element);
 }
 
+// High frequency events are often not listened for anywhere in the document. For those
+// we consult the document's listener types and skip the walk over the event path.
+static inline bool documentHasListenersForEventType(Document* document, const AtomicString& eventType)
+{
+    if (eventType == eventNames().mousemoveEvent)
+        return document->hasListenerType(Document::MOUSEMOVE_LISTENER);
+    if (eventType == eventNames().touchmoveEvent)
+        return document->hasListenerType(Document::TOUCHMOVE_LISTENER);
+    if (eventType == eventNames().scrollEvent)
+        return document->hasListenerType(Document::SCROLL_LISTENER);
+    return true;
+}
+
 bool EventDispatcher::dispatch()
 {
 #ifndef NDEBUG
@@ -114,10 +128,13 @@ bool EventDispatcher::dispatch()
     InspectorInstrumentationCookie cookie = InspectorInstrumentation::willDispatchEvent(m_node->document(), *m_event, windowEventContext.window(), m_node.get(), m_eventPath);
 
     void* preDispatchEventHandlerResult;
-    if (dispatchEventPreProcess(preDispatchEventHandlerResult) == ContinueDispatching)
-        if (dispatchEventAtCapturing(windowEventContext) == ContinueDispatching)
+    if (dispatchEventPreProcess(preDispatchEventHandlerResult) == ContinueDispatching) {
+        if (!documentHasListenersForEventType(m_node->document(), m_event->type()))
+            dispatchEventAtWindow(windowEventContext);
+        else if (dispatchEventAtCapturing(windowEventContext) == ContinueDispatching)
             if (dispatchEventAtTarget() == ContinueDispatching)
                 dispatchEventAtBubbling(windowEventContext);
+    }
     dispatchEventPostProcess(preDispatchEventHandlerResult);
 
     // Ensure that after event dispatch, the event's target object is the
@@ -185,6 +202,19 @@ inline void EventDispatcher::dispatchEventAtBubbling(WindowEventContext& windowC
     }
 }
 
+inline void EventDispatcher::dispatchEventAtWindow(WindowEventContext& windowContext)
+{
+    // The window may outlive the document it registered its listeners with, so it is
+    // still given the chance to handle the event in both phases.
+    m_event->setEventPhase(Event::CAPTURING_PHASE);
+    if (windowContext.handleLocalEvents(m_event.get()) && m_event->propagationStopped())
+        return;
+    if (m_event->bubbles() && !m_event->cancelBubble()) {
+        m_event->setEventPhase(Event::BUBBLING_PHASE);
+        windowContext.handleLocalEvents(m_event.get());
+    }
+}
+
 inline void EventDispatcher::dispatchEventPostProcess(void* preDispatchEventHandlerResult)
 {
     m_event->setTarget(EventRetargeter::eventTargetRespectingTargetRules(m_node.get()));
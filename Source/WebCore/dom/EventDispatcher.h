@@ -71,6 +71,7 @@ private:
     EventDispatchContinuation dispatchEventAtCapturing(WindowEventContext&);
     EventDispatchContinuation dispatchEventAtTarget();
     void dispatchEventAtBubbling(WindowEventContext&);
+    void dispatchEventAtWindow(WindowEventContext&);
     void dispatchEventPostProcess(void* preDispatchEventHandlerResult);
 
     EventPath m_eventPath;
@@ -21,6 +21,7 @@
 #include "EventRetargeter.h"
 
 #include "ContainerNode.h"
+#include "Document.h"
 #include "EventContext.h"
 #include "EventPathWalker.h"
 #include "FocusEvent.h"
@@ -75,29 +76,99 @@ static inline EventDispatchBehavior determineDispatchBehavior(Event* event, Shad
     return RetargetEvent;
 }
 
-void EventRetargeter::calculateEventPath(Node* node, Event* event, EventPath& eventPath)
+struct EventPathEntry {
+    EventPathEntry(Node* node, EventTarget* currentTarget, EventTarget* target)
+        : node(node)
+        , currentTarget(currentTarget)
+        , target(target)
+    {
+    }
+
+    Node* node;
+    EventTarget* currentTarget;
+    EventTarget* target;
+};
+
+typedef Vector<EventPathEntry, 32> EventPathEntries;
+
+// Remembers the most recently calculated event path so that a stream of events dispatched
+// to the same node, such as mousemove or touchmove, does not walk the composed tree every time.
+// The entries hold raw pointers; they are only used while the document's DOM tree version is
+// unchanged, which guarantees that every node on the path is still in the tree. Changes to the
+// shadow configuration that do not bump the DOM tree version clear the cache explicitly.
+class CachedEventPath {
+    WTF_MAKE_NONCOPYABLE(CachedEventPath);
+public:
+    CachedEventPath()
+        : m_node(0)
+        , m_domTreeVersion(0)
+    {
+    }
+
+    bool isValidFor(Node* node, Event* event) const
+    {
+        return m_node == node && m_eventType == event->type() && m_domTreeVersion == node->document()->domTreeVersion() && !hasFullScreenElement(node);
+    }
+
+    void setKey(Node* node, Event* event)
+    {
+        m_node = node;
+        m_eventType = event->type();
+        m_domTreeVersion = node->document()->domTreeVersion();
+    }
+
+    void clear()
+    {
+        m_node = 0;
+        m_eventType = nullAtom;
+        m_domTreeVersion = 0;
+        m_entries.clear();
+    }
+
+    EventPathEntries& entries() { return m_entries; }
+
+    static bool canCache(Node* node)
+    {
+        // Paths through <use> shadow trees point at SVGElementInstances, which are not tree nodes.
+        return node->inDocument() && !node->isSVGElement() && !hasFullScreenElement(node);
+    }
+
+private:
+    static bool hasFullScreenElement(Node* node)
+    {
+#if ENABLE(FULLSCREEN_API) && ENABLE(VIDEO)
+        // determineDispatchBehavior() depends on the full screen element.
+        return node->document()->webkitCurrentFullScreenElement();
+#else
+        UNUSED_PARAM(node);
+        return false;
+#endif
+    }
+
+    Node* m_node;
+    AtomicString m_eventType;
+    uint64_t m_domTreeVersion;
+    EventPathEntries m_entries;
+};
+
+static CachedEventPath& cachedEventPath()
+{
+    DEFINE_STATIC_LOCAL(CachedEventPath, path, ());
+    return path;
+}
+
+static void calculateEventPathEntries(Node* node, Event* event, EventPathEntries& entries)
 {
     bool inDocument = node->inDocument();
     bool isSVGElement = node->isSVGElement();
-    bool isMouseOrFocusEvent = event->isMouseEvent() || event->isFocusEvent();
-#if ENABLE(TOUCH_EVENTS)
-    bool isTouchEvent = event->isTouchEvent();
-#endif
     Vector<EventTarget*, 32> targetStack;
     for (EventPathWalker walker(node); walker.node(); walker.moveToParent()) {
         Node* node = walker.node();
         if (targetStack.isEmpty())
-            targetStack.append(eventTargetRespectingTargetRules(node));
+            targetStack.append(EventRetargeter::eventTargetRespectingTargetRules(node));
         else if (walker.isVisitingInsertionPointInReprojection())
             targetStack.append(targetStack.last());
-        if (isMouseOrFocusEvent)
-            eventPath.append(adoptPtr(new MouseOrFocusEventContext(node, eventTargetRespectingTargetRules(node), targetStack.last())));
-#if ENABLE(TOUCH_EVENTS)
-        else if (isTouchEvent)
-            eventPath.append(adoptPtr(new TouchEventContext(node, eventTargetRespectingTargetRules(node), targetStack.last())));
-#endif
-        else
-            eventPath.append(adoptPtr(new EventContext(node, eventTargetRespectingTargetRules(node), targetStack.last())));
+        entries.append(EventPathEntry(node, EventRetargeter::eventTargetRespectingTargetRules(node), targetStack.last()));
         if (!inDocument)
             return;
         if (!node->isShadowRoot())
@@ -111,6 +182,40 @@ void EventRetargeter::calculateEventPath(Node* node, Event* event, EventPath& ev
     }
 }
 
+void EventRetargeter::calculateEventPath(Node* node, Event* event, EventPath& eventPath)
+{
+    CachedEventPath& cache = cachedEventPath();
+    if (!cache.isValidFor(node, event)) {
+        cache.clear();
+        calculateEventPathEntries(node, event, cache.entries());
+        if (CachedEventPath::canCache(node))
+            cache.setKey(node, event);
+    }
+
+    const EventPathEntries& entries = cache.entries();
+    bool isMouseOrFocusEvent = event->isMouseEvent() || event->isFocusEvent();
+#if ENABLE(TOUCH_EVENTS)
+    bool isTouchEvent = event->isTouchEvent();
+#endif
+    eventPath.reserveCapacity(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const EventPathEntry& entry = entries[i];
+        if (isMouseOrFocusEvent)
+            eventPath.append(adoptPtr(new MouseOrFocusEventContext(entry.node, entry.currentTarget, entry.target)));
+#if ENABLE(TOUCH_EVENTS)
+        else if (isTouchEvent)
+            eventPath.append(adoptPtr(new TouchEventContext(entry.node, entry.currentTarget, entry.target)));
+#endif
+        else
+            eventPath.append(adoptPtr(new EventContext(entry.node, entry.currentTarget, entry.target)));
+    }
+}
+
+void EventRetargeter::invalidateCachedEventPath()
+{
+    cachedEventPath().clear();
+}
+
 void EventRetargeter::adjustForMouseEvent(Node* node, const MouseEvent& mouseEvent, EventPath& eventPath)
 {
     adjustForRelatedTarget(node, mouseEvent.relatedTarget(), eventPath);
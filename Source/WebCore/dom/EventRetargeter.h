@@ -60,6 +60,10 @@ public:
 #endif
     static EventTarget* eventTargetRespectingTargetRules(Node* referenceNode);
 
+    // Must be called when the composed tree changes without a DOM tree version bump,
+    // e.g. when a shadow root is added or content is redistributed.
+    static void invalidateCachedEventPath();
+
 private:
     typedef Vector<RefPtr<Node> > AdjustedNodes;
     typedef HashMap<TreeScope*, Node*> RelatedNodeMap;
@@ -94,6 +94,7 @@ public:
             invalidateIdNameCacheMaps();
     }
     void invalidateCache() const;
+    void invalidateCacheForInsertion(Node* insertedChild) const;
     void invalidateIdNameCacheMaps() const;
 
     static bool shouldInvalidateTypeOnAttributeChange(NodeListInvalidationType, const QualifiedName&);
@@ -142,6 +143,7 @@ private:
     bool isLastItemCloserThanLastOrCachedItem(unsigned offset) const;
     bool isFirstItemCloserThanCachedItem(unsigned offset) const;
     Node* iterateForPreviousNode(Node* current) const;
+    bool elementMatches(Element*) const;
     Node* itemBefore(Node* previousItem) const;
 
     RefPtr<Node> m_ownerNode;
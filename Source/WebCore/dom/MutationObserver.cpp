@@ -121,12 +121,19 @@ Vector<RefPtr<MutationRecord> > MutationObserver::takeRecords()
 {
     Vector<RefPtr<MutationRecord> > records;
     records.swap(m_records);
+    m_queuedAttributesRecords.clear();
     return records;
 }
 
-void MutationObserver::disconnect()
+void MutationObserver::clearRecords()
 {
     m_records.clear();
+    m_queuedAttributesRecords.clear();
+}
+
+void MutationObserver::disconnect()
+{
+    clearRecords();
     HashSet<MutationObserverRegistration*> registrations(m_registrations);
     for (HashSet<MutationObserverRegistration*>::iterator iter = registrations.begin(); iter != registrations.end(); ++iter)
         MutationObserverRegistration::unregisterAndDelete(*iter);
@@ -158,13 +165,38 @@ static MutationObserverSet& suspendedMutationObservers()
     return suspendedObservers;
 }
 
-void MutationObserver::enqueueMutationRecord(PassRefPtr<MutationRecord> mutation)
+MutationObserver::AttributesRecordKey MutationObserver::attributesRecordKey(MutationRecord* record)
+{
+    ASSERT(record->isAttributesRecord());
+    return std::make_pair(record->target(), std::make_pair(record->attributeName().impl(), record->attributeNamespace().impl()));
+}
+
+void MutationObserver::enqueueMutationRecord(PassRefPtr<MutationRecord> prpMutation)
 {
     ASSERT(isMainThread());
-    m_records.append(mutation);
+    RefPtr<MutationRecord> mutation = prpMutation;
+
+    // Bulk DOM updates tend to append or remove runs of children one call at a time.
+    // Fold each such change into the record that is already waiting for delivery.
+    if (!m_records.isEmpty()) {
+        if (RefPtr<MutationRecord> coalesced = MutationRecord::coalesceChildList(m_records.last().get(), mutation.get())) {
+            m_records.last() = coalesced.release();
+            activeMutationObservers().add(this);
+            return;
+        }
+    }
+
+    if (mutation->isAttributesRecord())
+        m_queuedAttributesRecords.add(attributesRecordKey(mutation.get()));
+    m_records.append(mutation.release());
     activeMutationObservers().add(this);
 }
 
+bool MutationObserver::hasQueuedAttributesRecordLike(MutationRecord* record) const
+{
+    return m_queuedAttributesRecords.contains(attributesRecordKey(record));
+}
+
 void MutationObserver::setHasTransientRegistration()
 {
     ASSERT(isMainThread());
@@ -203,6 +235,7 @@ void MutationObserver::deliver()
 
     Vector<RefPtr<MutationRecord> > records;
     records.swap(m_records);
+    m_queuedAttributesRecords.clear();
 
     m_callback->call(records, this);
 }
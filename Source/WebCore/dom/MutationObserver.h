@@ -83,6 +83,7 @@ public:
     void observationStarted(MutationObserverRegistration*);
     void observationEnded(MutationObserverRegistration*);
     void enqueueMutationRecord(PassRefPtr<MutationRecord>);
+    bool hasQueuedAttributesRecordLike(MutationRecord*) const;
     void setHasTransientRegistration();
     bool canDeliver();
 
@@ -96,8 +97,13 @@ private:
 
     static bool validateOptions(MutationObserverOptions);
 
+    typedef std::pair<Node*, std::pair<AtomicStringImpl*, AtomicStringImpl*> > AttributesRecordKey;
+    static AttributesRecordKey attributesRecordKey(MutationRecord*);
+    void clearRecords();
+
     RefPtr<MutationCallback> m_callback;
     Vector<RefPtr<MutationRecord> > m_records;
+    HashSet<AttributesRecordKey> m_queuedAttributesRecords;
     HashSet<MutationObserverRegistration*> m_registrations;
     unsigned m_priority;
 };
@@ -76,6 +76,9 @@ void MutationObserverInterestGroup::enqueueMutationRecord(PassRefPtr<MutationRec
             observer->enqueueMutationRecord(mutation);
             continue;
         }
+        // Without old values, a second record for the same attribute tells the observer nothing new.
+        if (mutation->isAttributesRecord() && observer->hasQueuedAttributesRecordLike(mutation.get()))
+            continue;
         if (!mutationWithNullOldValue) {
             if (mutation->oldValue().isNull())
                 mutationWithNullOldValue = mutation;
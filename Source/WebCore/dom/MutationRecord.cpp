@@ -43,32 +43,84 @@ namespace WebCore {
 
 namespace {
 
+// The node lists are only created when script asks for them, so records can be coalesced
+// cheaply until then.
 class ChildListRecord : public MutationRecord {
 public:
-    ChildListRecord(PassRefPtr<Node> target, PassRefPtr<NodeList> added, PassRefPtr<NodeList> removed, PassRefPtr<Node> previousSibling, PassRefPtr<Node> nextSibling)
+    ChildListRecord(PassRefPtr<Node> target, Vector<RefPtr<Node> >& added, Vector<RefPtr<Node> >& removed, PassRefPtr<Node> previousSibling, PassRefPtr<Node> nextSibling)
         : m_target(target)
-        , m_addedNodes(added)
-        , m_removedNodes(removed)
         , m_previousSibling(previousSibling)
         , m_nextSibling(nextSibling)
     {
+        m_added.swap(added);
+        m_removed.swap(removed);
     }
 
+    bool canAppend(ChildListRecord*);
+    void append(ChildListRecord*);
+    bool canBeModified() { return hasOneRef() && !m_addedNodes && !m_removedNodes; }
+    PassRefPtr<ChildListRecord> copy();
+
 private:
     virtual const AtomicString& type() OVERRIDE;
     virtual Node* target() OVERRIDE { return m_target.get(); }
-    virtual NodeList* addedNodes() OVERRIDE { return m_addedNodes.get(); }
-    virtual NodeList* removedNodes() OVERRIDE { return m_removedNodes.get(); }
+    virtual NodeList* addedNodes() OVERRIDE { return lazilyInitializeNodeList(m_addedNodes, m_added); }
+    virtual NodeList* removedNodes() OVERRIDE { return lazilyInitializeNodeList(m_removedNodes, m_removed); }
     virtual Node* previousSibling() OVERRIDE { return m_previousSibling.get(); }
     virtual Node* nextSibling() OVERRIDE { return m_nextSibling.get(); }
+    virtual bool isChildListRecord() OVERRIDE { return true; }
+
+    // The list gets a copy of the nodes: this record may still be queued for other observers,
+    // and coalescing a later change into it needs the nodes it holds.
+    static NodeList* lazilyInitializeNodeList(RefPtr<NodeList>& nodeList, const Vector<RefPtr<Node> >& nodes)
+    {
+        if (!nodeList) {
+            Vector<RefPtr<Node> > copiedNodes(nodes);
+            nodeList = StaticNodeList::adopt(copiedNodes);
+        }
+        return nodeList.get();
+    }
 
     RefPtr<Node> m_target;
+    Vector<RefPtr<Node> > m_added;
+    Vector<RefPtr<Node> > m_removed;
     RefPtr<NodeList> m_addedNodes;
     RefPtr<NodeList> m_removedNodes;
     RefPtr<Node> m_previousSibling;
     RefPtr<Node> m_nextSibling;
 };
 
+// Mirrors the rules ChildListMutationAccumulator uses to grow a single record: nodes added
+// right after the nodes already added, or the node that followed the nodes already removed.
+bool ChildListRecord::canAppend(ChildListRecord* next)
+{
+    if (m_target != next->m_target)
+        return false;
+
+    if (next->m_removed.isEmpty()) {
+        Node* lastAdded = m_added.isEmpty() ? m_previousSibling.get() : m_added.last().get();
+        return next->m_previousSibling == lastAdded && next->m_nextSibling == m_nextSibling;
+    }
+
+    return m_added.isEmpty() && next->m_previousSibling == m_previousSibling && next->m_removed.first() == m_nextSibling;
+}
+
+void ChildListRecord::append(ChildListRecord* next)
+{
+    ASSERT(canBeModified());
+    ASSERT(canAppend(next));
+    m_removed.appendVector(next->m_removed);
+    m_added.appendVector(next->m_added);
+    m_nextSibling = next->m_nextSibling;
+}
+
+PassRefPtr<ChildListRecord> ChildListRecord::copy()
+{
+    Vector<RefPtr<Node> > added(m_added);
+    Vector<RefPtr<Node> > removed(m_removed);
+    return adoptRef(new ChildListRecord(m_target, added, removed, m_previousSibling, m_nextSibling));
+}
+
 class RecordWithEmptyNodeLists : public MutationRecord {
 public:
     RecordWithEmptyNodeLists(PassRefPtr<Node> target, const String& oldValue)
@@ -107,6 +159,7 @@ public:
 
 private:
     virtual const AtomicString& type() OVERRIDE;
+    virtual bool isAttributesRecord() OVERRIDE { return true; }
     virtual const AtomicString& attributeName() OVERRIDE { return m_attributeName; }
     virtual const AtomicString& attributeNamespace() OVERRIDE { return m_attributeNamespace; }
 
@@ -141,6 +194,7 @@ private:
     virtual Node* nextSibling() OVERRIDE { return m_record->nextSibling(); }
     virtual const AtomicString& attributeName() OVERRIDE { return m_record->attributeName(); }
     virtual const AtomicString& attributeNamespace() OVERRIDE { return m_record->attributeNamespace(); }
+    virtual bool isAttributesRecord() OVERRIDE { return m_record->isAttributesRecord(); }
 
     virtual String oldValue() OVERRIDE { return String(); }
 
@@ -167,7 +221,7 @@ const AtomicString& CharacterDataRecord::type()
 
 } // namespace
 
-PassRefPtr<MutationRecord> MutationRecord::createChildList(PassRefPtr<Node> target, PassRefPtr<NodeList> added, PassRefPtr<NodeList> removed, PassRefPtr<Node> previousSibling, PassRefPtr<Node> nextSibling)
+PassRefPtr<MutationRecord> MutationRecord::createChildList(PassRefPtr<Node> target, Vector<RefPtr<Node> >& added, Vector<RefPtr<Node> >& removed, PassRefPtr<Node> previousSibling, PassRefPtr<Node> nextSibling)
 {
     return adoptRef(static_cast<MutationRecord*>(new ChildListRecord(target, added, removed, previousSibling, nextSibling)));
 }
@@ -187,6 +241,27 @@ PassRefPtr<MutationRecord> MutationRecord::createWithNullOldValue(PassRefPtr<Mut
     return adoptRef(static_cast<MutationRecord*>(new MutationRecordWithNullOldValue(record)));
 }
 
+PassRefPtr<MutationRecord> MutationRecord::coalesceChildList(MutationRecord* previous, MutationRecord* next)
+{
+    if (!previous->isChildListRecord() || !next->isChildListRecord())
+        return 0;
+
+    ChildListRecord* previousRecord = static_cast<ChildListRecord*>(previous);
+    ChildListRecord* nextRecord = static_cast<ChildListRecord*>(next);
+    if (!previousRecord->canAppend(nextRecord))
+        return 0;
+
+    if (previousRecord->canBeModified()) {
+        previousRecord->append(nextRecord);
+        return previous;
+    }
+
+    // The previous record may also be queued for other observers, so leave it alone.
+    RefPtr<ChildListRecord> record = previousRecord->copy();
+    record->append(nextRecord);
+    return record.release();
+}
+
 MutationRecord::~MutationRecord()
 {
 }
@@ -34,6 +34,7 @@
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefCounted.h>
 #include <wtf/RefPtr.h>
+#include <wtf/Vector.h>
 #include <wtf/text/WTFString.h>
 
 namespace WebCore {
@@ -44,12 +45,18 @@ class QualifiedName;
 
 class MutationRecord : public RefCounted<MutationRecord> {
 public:
-    static PassRefPtr<MutationRecord> createChildList(PassRefPtr<Node> target, PassRefPtr<NodeList> added, PassRefPtr<NodeList> removed, PassRefPtr<Node> previousSibling, PassRefPtr<Node> nextSibling);
+    // Adopts the contents of |added| and |removed|.
+    static PassRefPtr<MutationRecord> createChildList(PassRefPtr<Node> target, Vector<RefPtr<Node> >& added, Vector<RefPtr<Node> >& removed, PassRefPtr<Node> previousSibling, PassRefPtr<Node> nextSibling);
     static PassRefPtr<MutationRecord> createAttributes(PassRefPtr<Node> target, const QualifiedName&, const AtomicString& oldValue);
     static PassRefPtr<MutationRecord> createCharacterData(PassRefPtr<Node> target, const String& oldValue);
 
     static PassRefPtr<MutationRecord> createWithNullOldValue(PassRefPtr<MutationRecord>);
 
+    // If |next| continues the childList change described by |previous| on the same target,
+    // returns a record describing both changes. |previous| is updated in place when nothing
+    // else refers to it. Returns 0 if the records cannot be combined.
+    static PassRefPtr<MutationRecord> coalesceChildList(MutationRecord* previous, MutationRecord* next);
+
     virtual ~MutationRecord();
 
     virtual const AtomicString& type() = 0;
@@ -64,6 +71,9 @@ public:
     virtual const AtomicString& attributeNamespace() { return nullAtom; }
 
     virtual String oldValue() { return String(); }
+
+    virtual bool isChildListRecord() { return false; }
+    virtual bool isAttributesRecord() { return false; }
 };
 
 } // namespace WebCore
@@ -866,6 +866,13 @@ void Document::invalidateNodeListCaches(const QualifiedName* attrName)
         (*it)->invalidateCache(attrName);
 }
 
+void Document::invalidateNodeListCachesForInsertion(Node* insertedChild)
+{
+    HashSet<LiveNodeListBase*>::iterator end = m_listsInvalidatedAtDocument.end();
+    for (HashSet<LiveNodeListBase*>::iterator it = m_listsInvalidatedAtDocument.begin(); it != end; ++it)
+        (*it)->invalidateCacheForInsertion(insertedChild);
+}
+
 void Node::invalidateNodeListCachesInAncestors(const QualifiedName* attrName, Element* attributeOwnerElement)
 {
     if (hasRareData() && (!attrName || isAttributeNode())) {
@@ -891,6 +898,29 @@ void Node::invalidateNodeListCachesInAncestors(const QualifiedName* attrName, El
     }
 }
 
+void Node::invalidateNodeListCachesInAncestorsForInsertion(Node* insertedChild)
+{
+    ASSERT(insertedChild->parentNode() == this);
+
+    if (hasRareData()) {
+        if (NodeListsNodeData* lists = rareData()->nodeLists())
+            lists->clearChildNodeListCache();
+    }
+
+    if (!document()->shouldInvalidateNodeListCaches())
+        return;
+
+    document()->invalidateNodeListCachesForInsertion(insertedChild);
+
+    for (Node* node = this; node; node = node->parentNode()) {
+        if (!node->hasRareData())
+            continue;
+        NodeRareData* data = node->rareData();
+        if (data->nodeLists())
+            data->nodeLists()->invalidateCachesForInsertion(insertedChild);
+    }
+}
+
 NodeListsNodeData* Node::nodeLists()
 {
     return hasRareData() ? rareData()->nodeLists() : 0;
@@ -1945,6 +1975,29 @@ void NodeListsNodeData::invalidateCaches(const QualifiedName* attrName)
         it->value->invalidateCache();
 }
 
+void NodeListsNodeData::invalidateCachesForInsertion(Node* insertedChild)
+{
+    // Lists rooted at the document are updated through Document::invalidateNodeListCachesForInsertion,
+    // and unlike invalidation, adjusting a cache twice for the same insertion is not harmless.
+    NodeListAtomicNameCacheMap::const_iterator atomicNameCacheEnd = m_atomicNameCaches.end();
+    for (NodeListAtomicNameCacheMap::const_iterator it = m_atomicNameCaches.begin(); it != atomicNameCacheEnd; ++it) {
+        if (!it->value->isRootedAtDocument())
+            it->value->invalidateCacheForInsertion(insertedChild);
+    }
+
+    NodeListNameCacheMap::const_iterator nameCacheEnd = m_nameCaches.end();
+    for (NodeListNameCacheMap::const_iterator it = m_nameCaches.begin(); it != nameCacheEnd; ++it) {
+        if (!it->value->isRootedAtDocument())
+            it->value->invalidateCacheForInsertion(insertedChild);
+    }
+
+    TagNodeListCacheNS::iterator tagCacheEnd = m_tagNodeListCacheNS.end();
+    for (TagNodeListCacheNS::iterator it = m_tagNodeListCacheNS.begin(); it != tagCacheEnd; ++it) {
+        if (!it->value->isRootedAtDocument())
+            it->value->invalidateCacheForInsertion(insertedChild);
+    }
+}
+
 void Node::getSubresourceURLs(ListHashSet<KURL>& urls) const
 {
     addSubresourceAttributeURLs(urls);
@@ -548,6 +548,7 @@ public:
 #endif
 
     void invalidateNodeListCachesInAncestors(const QualifiedName* attrName = 0, Element* attributeOwnerElement = 0);
+    void invalidateNodeListCachesInAncestorsForInsertion(Node* insertedChild);
     NodeListsNodeData* nodeLists();
     void clearNodeLists();
 
@@ -178,6 +178,7 @@ public:
     }
 
     void invalidateCaches(const QualifiedName* attrName = 0);
+    void invalidateCachesForInsertion(Node* insertedChild);
     bool isEmpty() const
     {
         return m_atomicNameCaches.isEmpty() && m_nameCaches.isEmpty() && m_tagNodeListCacheNS.isEmpty();
@@ -46,12 +46,17 @@ void SelectorDataList::initialize(const CSSSelectorList& selectorList)
         selectorCount++;
 
     m_selectors.reserveInitialCapacity(selectorCount);
-    for (const CSSSelector* selector = selectorList.first(); selector; selector = CSSSelectorList::next(selector))
+    for (const CSSSelector* selector = selectorList.first(); selector; selector = CSSSelectorList::next(selector)) {
         m_selectors.uncheckedAppend(SelectorData(selector, SelectorCheckerFastPath::canUse(selector)));
+        m_selectors.last().compiledSelector.compile(selector);
+    }
 }
 
 inline bool SelectorDataList::selectorMatches(const SelectorData& selectorData, Element* element, const Node* rootNode) const
 {
+    if (!selectorData.compiledSelector.isEmpty() && !element->isSVGElement())
+        return selectorData.compiledSelector.matches(element);
+
     if (selectorData.isFastCheckable && !element->isSVGElement()) {
         SelectorCheckerFastPath selectorCheckerFastPath(selectorData.selector, element);
         if (!selectorCheckerFastPath.matchesRightmostSelector(SelectorChecker::VisitedMatchDisabled))
@@ -226,6 +231,17 @@ ALWAYS_INLINE void SelectorDataList::executeSingleClassNameSelectorData(const No
     ASSERT(isSingleClassNameSelector(selectorData.selector));
 
     const AtomicString& className = selectorData.selector->value();
+    if (isTreeScopeRoot(rootNode)) {
+        // The scope's class name index already lists exactly the matching elements in document order.
+        const Vector<Element*>* elements = rootNode->treeScope()->getAllElementsByClassName(className);
+        if (!elements)
+            return;
+        size_t count = firstMatchOnly ? std::min<size_t>(elements->size(), 1) : elements->size();
+        matchedElements.reserveCapacity(matchedElements.size() + count);
+        for (size_t i = 0; i < count; ++i)
+            matchedElements.append(elements->at(i));
+        return;
+    }
     for (Element* element = ElementTraversal::firstWithin(rootNode); element; element = ElementTraversal::next(element, rootNode)) {
         if (element->hasClass() && element->classNames().contains(className)) {
             matchedElements.append(element);
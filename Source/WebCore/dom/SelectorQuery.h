@@ -27,6 +27,7 @@
 #define SelectorQuery_h
 
 #include "CSSSelectorList.h"
+#include "CompiledSelector.h"
 #include "NodeList.h"
 #include <wtf/HashMap.h>
 #include <wtf/PassRefPtr.h>
@@ -55,6 +56,7 @@ private:
         SelectorData(const CSSSelector* selector, bool isFastCheckable) : selector(selector), isFastCheckable(isFastCheckable) { }
         const CSSSelector* selector;
         bool isFastCheckable;
+        CompiledSelector compiledSelector;
     };
 
     bool selectorMatches(const SelectorData&, Element*, const Node*) const;
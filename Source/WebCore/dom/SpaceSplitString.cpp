@@ -177,11 +177,16 @@ void SpaceSplitString::set(const AtomicString& inputString, bool shouldFoldCase)
         return;
     }
 
-    String string(inputString.string());
-    if (shouldFoldCase && hasNonASCIIOrUpper(string))
-        string = string.foldCase();
+    if (shouldFoldCase && hasNonASCIIOrUpper(inputString.string())) {
+        m_data = SpaceSplitStringData::create(inputString.string().foldCase());
+        return;
+    }
+
+    // Cloned elements and elements sharing attribute data set the same class string again.
+    if (m_data && m_data->keyString() == inputString)
+        return;
 
-    m_data = SpaceSplitStringData::create(string);
+    m_data = SpaceSplitStringData::create(inputString);
 }
 
 class TokenIsEqualToCStringTokenProcessor {
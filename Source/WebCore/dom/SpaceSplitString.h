@@ -50,6 +50,7 @@ namespace WebCore {
         void remove(unsigned index);
 
         bool isUnique() const { return m_keyString.isNull(); } 
+        const AtomicString& keyString() const { return m_keyString; }
         size_t size() const { return m_vector.size(); }
         const AtomicString& operator[](size_t i) { ASSERT_WITH_SECURITY_IMPLICATION(i < size()); return m_vector[i]; }
 
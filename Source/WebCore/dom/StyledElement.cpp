@@ -351,11 +351,17 @@ void StyledElement::rebuildPresentationAttributeStyle()
         }
     }
 
-    // ShareableElementData doesn't store presentation attribute style, so make sure we have a UniqueElementData.
-    UniqueElementData* elementData = ensureUniqueElementData();
-
-    elementData->m_presentationAttributeStyleIsDirty = false;
-    elementData->m_presentationAttributeStyle = style->isEmpty() ? 0 : style;
+    // ShareableElementData can hold a cacheable style for a single tag name. Otherwise make sure we have a UniqueElementData.
+    const ElementData* currentElementData = elementData();
+    const ShareableElementData* sharedElementData = currentElementData->isUnique() ? 0 : static_cast<const ShareableElementData*>(currentElementData);
+    if (cacheKey.tagName && sharedElementData && (sharedElementData->m_presentationAttributeStyleTagName == nullQName() || sharedElementData->m_presentationAttributeStyleTagName == tagQName())) {
+        sharedElementData->m_presentationAttributeStyleTagName = tagQName();
+        sharedElementData->m_presentationAttributeStyle = style->isEmpty() ? 0 : style;
+    } else {
+        UniqueElementData* elementData = ensureUniqueElementData();
+        elementData->m_presentationAttributeStyleIsDirty = false;
+        elementData->m_presentationAttributeStyle = style->isEmpty() ? 0 : style;
+    }
 
     if (!cacheHash || cacheIterator->value)
         return;
@@ -100,7 +100,7 @@ inline const StylePropertySet* StyledElement::presentationAttributeStyle()
 {
     if (!elementData())
         return 0;
-    if (elementData()->m_presentationAttributeStyleIsDirty)
+    if (elementData()->presentationAttributeStyleNeedsRebuild(tagQName()))
         rebuildPresentationAttributeStyle();
     return elementData()->presentationAttributeStyle();
 }
@@ -305,6 +305,9 @@ void Text::updateTextRenderer(unsigned offsetOfReplacedData, unsigned lengthOfRe
         return;
     RenderText* textRenderer = toRenderText(renderer());
     if (!textRenderer) {
+        // A lazily attached node gets its renderer from the pending style recalc.
+        if (needsStyleRecalc())
+            return;
         reattach();
         return;
     }
@@ -47,6 +47,7 @@
 #include "RenderView.h"
 #include "RuntimeEnabledFeatures.h"
 #include "ShadowRoot.h"
+#include "SpaceSplitString.h"
 #include "TreeScopeAdopter.h"
 #include <wtf/Vector.h>
 #include <wtf/text/AtomicString.h>
@@ -56,7 +57,7 @@ namespace WebCore {
 
 struct SameSizeAsTreeScope {
     virtual ~SameSizeAsTreeScope();
-    void* pointers[9];
+    void* pointers[10];
     int ints[1];
 };
 
@@ -116,6 +117,7 @@ void TreeScope::destroyTreeScopeData()
     m_elementsById.clear();
     m_imageMapsByName.clear();
     m_labelsByForAttribute.clear();
+    m_elementsByClassName.clear();
 }
 
 void TreeScope::clearDocumentScope()
@@ -195,6 +197,48 @@ void TreeScope::removeElementByName(const AtomicString& name, Element* element)
     m_elementsByName->remove(name.impl(), element);
 }
 
+const Vector<Element*>* TreeScope::getAllElementsByClassName(const AtomicString& className)
+{
+    if (className.isEmpty())
+        return 0;
+
+    if (!m_elementsByClassName) {
+        // Populate the map on first access.
+        m_elementsByClassName = adoptPtr(new DocumentOrderedMap);
+        for (Element* element = ElementTraversal::firstWithin(rootNode()); element; element = ElementTraversal::next(element)) {
+            if (element->hasClass())
+                updateElementClassNames(element, SpaceSplitString(), element->classNames());
+        }
+    }
+
+    return m_elementsByClassName->getAllElementsByClassName(className.impl(), this);
+}
+
+static inline bool containsClassNameBefore(const SpaceSplitString& classNames, size_t index)
+{
+    for (size_t i = 0; i < index; ++i) {
+        if (classNames[i] == classNames[index])
+            return true;
+    }
+    return false;
+}
+
+void TreeScope::updateElementClassNames(Element* element, const SpaceSplitString& oldClassNames, const SpaceSplitString& newClassNames)
+{
+    if (!m_elementsByClassName)
+        return;
+
+    // A class attribute may list the same name more than once, but the map must count each element once per name.
+    for (size_t i = 0; i < oldClassNames.size(); ++i) {
+        if (!newClassNames.contains(oldClassNames[i]) && !containsClassNameBefore(oldClassNames, i))
+            m_elementsByClassName->remove(oldClassNames[i].impl(), element);
+    }
+    for (size_t i = 0; i < newClassNames.size(); ++i) {
+        if (!oldClassNames.contains(newClassNames[i]) && !containsClassNameBefore(newClassNames, i))
+            m_elementsByClassName->add(newClassNames[i].impl(), element);
+    }
+}
+
 Node* TreeScope::ancestorInThisScope(Node* node) const
 {
     while (node) {
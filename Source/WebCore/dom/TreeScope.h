@@ -42,6 +42,7 @@ class HTMLMapElement;
 class LayoutPoint;
 class IdTargetObserverRegistry;
 class Node;
+class SpaceSplitString;
 
 // A class which inherits both Node and TreeScope must call clearRareData() in its destructor
 // so that the Node destructor no longer does problematic NodeList cache manipulation in
@@ -68,6 +69,11 @@ public:
     void addElementByName(const AtomicString&, Element*);
     void removeElementByName(const AtomicString&, Element*);
 
+    // The class name index is built on the first lookup and kept up to date by Element from then on.
+    bool shouldCacheElementsByClassName() const { return m_elementsByClassName; }
+    const Vector<Element*>* getAllElementsByClassName(const AtomicString&);
+    void updateElementClassNames(Element*, const SpaceSplitString& oldClassNames, const SpaceSplitString& newClassNames);
+
     Document* documentScope() const { return m_documentScope; }
 
     Node* ancestorInThisScope(Node*) const;
@@ -171,6 +177,7 @@ private:
     OwnPtr<DocumentOrderedMap> m_elementsByName;
     OwnPtr<DocumentOrderedMap> m_imageMapsByName;
     OwnPtr<DocumentOrderedMap> m_labelsByForAttribute;
+    OwnPtr<DocumentOrderedMap> m_elementsByClassName;
 
     OwnPtr<IdTargetObserverRegistry> m_idTargetObserverRegistry;
 
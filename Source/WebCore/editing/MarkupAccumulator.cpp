@@ -46,7 +46,7 @@ namespace WebCore {
 
 using namespace HTMLNames;
 
-void MarkupAccumulator::appendCharactersReplacingEntities(StringBuilder& result, const String& source, unsigned offset, unsigned length, EntityMask entityMask)
+static const EntityDescription* entityMaps(size_t& count)
 {
     DEFINE_STATIC_LOCAL(const String, ampReference, (ASCIILiteral("&amp;")));
     DEFINE_STATIC_LOCAL(const String, ltReference, (ASCIILiteral("&lt;")));
@@ -62,47 +62,70 @@ void MarkupAccumulator::appendCharactersReplacingEntities(StringBuilder& result,
         { noBreakSpace, nbspReference, EntityNbsp },
     };
 
+    count = WTF_ARRAY_LENGTH(entityMaps);
+    return entityMaps;
+}
+
+static const uint8_t* createEntityIndexTable()
+{
+    uint8_t* table = static_cast<uint8_t*>(fastZeroedMalloc(256));
+    size_t count;
+    const EntityDescription* entities = entityMaps(count);
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT(entities[i].entity <= 0xFF);
+        table[entities[i].entity] = i + 1;
+    }
+    return table;
+}
+
+// Maps every Latin-1 character to one plus its index in entityMaps(), or to zero when it never
+// needs a reference, so the scan does a single lookup per character instead of trying each entity.
+// The table is only published once it is filled in.
+static const uint8_t* entityIndexForLatin1Character()
+{
+    static const uint8_t* table = createEntityIndexTable();
+    return table;
+}
+
+template<typename CharacterType>
+static inline void appendCharactersReplacingEntitiesInternal(StringBuilder& result, const CharacterType* text, unsigned length, EntityMask entityMask)
+{
+    size_t entityCount;
+    const EntityDescription* entities = entityMaps(entityCount);
+    const uint8_t* entityIndices = entityIndexForLatin1Character();
+
+    size_t positionAfterLastEntity = 0;
+    for (size_t i = 0; i < length; ++i) {
+        CharacterType character = text[i];
+        if (character > 0xFF || !entityIndices[character])
+            continue;
+        const EntityDescription& entity = entities[entityIndices[character] - 1];
+        if (!(entity.mask & entityMask))
+            continue;
+        result.append(text + positionAfterLastEntity, i - positionAfterLastEntity);
+        result.append(entity.reference);
+        positionAfterLastEntity = i + 1;
+    }
+    result.append(text + positionAfterLastEntity, length - positionAfterLastEntity);
+}
+
+void MarkupAccumulator::appendCharactersReplacingEntities(StringBuilder& result, const String& source, unsigned offset, unsigned length, EntityMask entityMask)
+{
     if (!(offset + length))
         return;
 
     ASSERT(offset + length <= source.length());
 
-    if (source.is8Bit()) {
-        const LChar* text = source.characters8() + offset;
-
-        size_t positionAfterLastEntity = 0;
-        for (size_t i = 0; i < length; ++i) {
-            for (size_t entityIndex = 0; entityIndex < WTF_ARRAY_LENGTH(entityMaps); ++entityIndex) {
-                if (text[i] == entityMaps[entityIndex].entity && entityMaps[entityIndex].mask & entityMask) {
-                    result.append(text + positionAfterLastEntity, i - positionAfterLastEntity);
-                    result.append(entityMaps[entityIndex].reference);
-                    positionAfterLastEntity = i + 1;
-                    break;
-                }
-            }
-        }
-        result.append(text + positionAfterLastEntity, length - positionAfterLastEntity);
-    } else {
-        const UChar* text = source.characters16() + offset;
-
-        size_t positionAfterLastEntity = 0;
-        for (size_t i = 0; i < length; ++i) {
-            for (size_t entityIndex = 0; entityIndex < WTF_ARRAY_LENGTH(entityMaps); ++entityIndex) {
-                if (text[i] == entityMaps[entityIndex].entity && entityMaps[entityIndex].mask & entityMask) {
-                    result.append(text + positionAfterLastEntity, i - positionAfterLastEntity);
-                    result.append(entityMaps[entityIndex].reference);
-                    positionAfterLastEntity = i + 1;
-                    break;
-                }
-            }
-        }
-        result.append(text + positionAfterLastEntity, length - positionAfterLastEntity);
-    }
+    if (source.is8Bit())
+        appendCharactersReplacingEntitiesInternal(result, source.characters8() + offset, length, entityMask);
+    else
+        appendCharactersReplacingEntitiesInternal(result, source.characters16() + offset, length, entityMask);
 }
 
 MarkupAccumulator::MarkupAccumulator(Vector<Node*>* nodes, EAbsoluteURLs resolveUrlsMethod, const Range* range, EFragmentSerialization fragmentSerialization)
     : m_nodes(nodes)
     , m_range(range)
+    , m_markup(StringBuilder::SegmentedBuffer)
     , m_resolveURLsMethod(resolveUrlsMethod)
     , m_fragmentSerialization(fragmentSerialization)
 {
@@ -123,6 +146,18 @@ String MarkupAccumulator::serializeNodes(Node* targetNode, Node* nodeToSkip, ECh
     return m_markup.toString();
 }
 
+void MarkupAccumulator::serializeNodes(Node* targetNode, Node* nodeToSkip, EChildrenOnly childrenOnly, StringBuilder& result)
+{
+    serializeNodesWithNamespaces(targetNode, nodeToSkip, childrenOnly, 0, 0);
+    // Swapping also swaps the buffer modes, so only hand the segments over when
+    // that leaves both builders in the mode they started in.
+    if (result.isEmpty() && result.isSegmented() == m_markup.isSegmented())
+        result.swap(m_markup);
+    else
+        result.append(m_markup);
+    m_markup.clear();
+}
+
 void MarkupAccumulator::serializeNodesWithNamespaces(Node* targetNode, Node* nodeToSkip, EChildrenOnly childrenOnly, const Namespaces* namespaces, Vector<QualifiedName>* tagNamesToSkip)
 {
     if (targetNode == nodeToSkip)
@@ -71,6 +71,9 @@ public:
 
     String serializeNodes(Node* targetNode, Node* nodeToSkip, EChildrenOnly);
     String serializeNodes(Node* targetNode, Node* nodeToSkip, EChildrenOnly, Vector<QualifiedName>* tagNamesToSkip);
+    // Hands over the markup without flattening it when result is an empty segmented builder, for
+    // callers that can consume it a segment at a time. Otherwise the markup is appended to result.
+    void serializeNodes(Node* targetNode, Node* nodeToSkip, EChildrenOnly, StringBuilder& result);
 
     static void appendComment(StringBuilder&, const String&);
 
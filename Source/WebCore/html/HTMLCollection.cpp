@@ -378,8 +378,12 @@ inline Element* LiveNodeListBase::traverseLiveNodeListFirstElement(ContainerNode
     ASSERT(type() != ChildNodeListType);
     if (type() == HTMLTagNodeListType)
         return firstMatchingElement(static_cast<const HTMLTagNodeList*>(this), root);
-    if (type() == ClassNodeListType)
-        return firstMatchingElement(static_cast<const ClassNodeList*>(this), root);
+    if (type() == ClassNodeListType) {
+        const ClassNodeList* classNodeList = static_cast<const ClassNodeList*>(this);
+        if (const Vector<Element*>* candidates = classNodeList->indexedCandidates(root))
+            return classNodeList->firstIndexedElement(*candidates);
+        return firstMatchingElement(classNodeList, root);
+    }
     return firstMatchingElement(static_cast<const LiveNodeList*>(this), root);
 }
 
@@ -390,8 +394,15 @@ inline Element* LiveNodeListBase::traverseLiveNodeListForwardToOffset(unsigned o
     ASSERT(type() != ChildNodeListType);
     if (type() == HTMLTagNodeListType)
         return traverseMatchingElementsForwardToOffset(static_cast<const HTMLTagNodeList*>(this), offset, currentElement, currentOffset, root);
-    if (type() == ClassNodeListType)
-        return traverseMatchingElementsForwardToOffset(static_cast<const ClassNodeList*>(this), offset, currentElement, currentOffset, root);
+    if (type() == ClassNodeListType) {
+        const ClassNodeList* classNodeList = static_cast<const ClassNodeList*>(this);
+        if (const Vector<Element*>* candidates = classNodeList->indexedCandidates(root)) {
+            size_t currentIndex = classNodeList->indexOfIndexedCandidate(*candidates, currentElement);
+            if (currentIndex != notFound)
+                return classNodeList->traverseIndexedElementsForwardToOffset(*candidates, currentIndex, offset, currentOffset);
+        }
+        return traverseMatchingElementsForwardToOffset(classNodeList, offset, currentElement, currentOffset, root);
+    }
     return traverseMatchingElementsForwardToOffset(static_cast<const LiveNodeList*>(this), offset, currentElement, currentOffset, root);
 }
 
@@ -525,6 +536,81 @@ inline Node* LiveNodeListBase::itemBeforeOrAfterCachedItem(unsigned offset, Cont
     return currentItem;
 }
 
+// Whether an element's membership depends only on the element itself, so that inserting
+// a subtree cannot change which of the existing elements are in the list.
+static inline bool isMatchingDecidedByElementAlone(CollectionType type)
+{
+    switch (type) {
+    case DocImages:
+    case DocEmbeds:
+    case DocForms:
+    case DocLinks:
+    case DocAnchors:
+    case DocScripts:
+    case DocAll:
+    case NodeChildren:
+    case ClassNodeListType:
+    case NameNodeListType:
+    case TagNodeListType:
+    case HTMLTagNodeListType:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// FIXME: This should be in LiveNodeList
+inline bool LiveNodeListBase::elementMatches(Element* element) const
+{
+    if (type() == HTMLTagNodeListType)
+        return isMatchingElement(static_cast<const HTMLTagNodeList*>(this), element);
+    if (type() == ClassNodeListType)
+        return isMatchingElement(static_cast<const ClassNodeList*>(this), element);
+    if (isNodeList(type()))
+        return isMatchingElement(static_cast<const LiveNodeList*>(this), element);
+    return isMatchingElement(static_cast<const HTMLCollection*>(this), element);
+}
+
+void LiveNodeListBase::invalidateCacheForInsertion(Node* insertedChild) const
+{
+    if (!isMatchingDecidedByElementAlone(type())) {
+        invalidateCache();
+        return;
+    }
+
+    if (hasIdNameCache()) {
+        invalidateIdNameCacheMaps();
+        m_isNameCacheValid = false;
+    }
+
+    if (!isLengthCacheValid() && !isItemCacheValid())
+        return;
+
+    // isDescendantOf() is true for nodes in the document's shadow trees, which lists rooted at the document never include.
+    Node* root = rootNode();
+    if (insertedChild->treeScope() != root->treeScope() || !insertedChild->isDescendantOf(root))
+        return;
+
+    unsigned insertedItemCount = 0;
+    if (shouldOnlyIncludeDirectChildren()) {
+        if (insertedChild->parentNode() == root && insertedChild->isElementNode() && elementMatches(toElement(insertedChild)))
+            insertedItemCount = 1;
+    } else {
+        for (Node* node = insertedChild; node; node = NodeTraversal::next(node, insertedChild)) {
+            if (node->isElementNode() && elementMatches(toElement(node)))
+                ++insertedItemCount;
+        }
+    }
+    if (!insertedItemCount)
+        return;
+
+    // The new items are contiguous in document order, so the cached item only moves when it comes after them.
+    if (isLengthCacheValid())
+        setLengthCache(cachedLength() + insertedItemCount);
+    if (isItemCacheValid() && (insertedChild->compareDocumentPosition(cachedItem()) & Node::DOCUMENT_POSITION_FOLLOWING))
+        setItemCache(cachedItem(), cachedItemOffset() + insertedItemCount);
+}
+
 Element* HTMLCollection::virtualItemAfter(unsigned&, Element*) const
 {
     ASSERT_NOT_REACHED();
@@ -48,6 +48,7 @@
 #include "ScriptEventListener.h"
 #include "Settings.h"
 #include <limits>
+#include <wtf/MainThread.h>
 
 using namespace std;
 
@@ -90,6 +91,20 @@ HTMLFormElement::~HTMLFormElement()
         m_imageElements[i]->m_form = 0;
 }
 
+HTMLFormElement* HTMLFormElement::findClosestFormAncestor(Element* element)
+{
+    ASSERT(isMainThread());
+    while (element) {
+        if (isHTMLFormElement(element))
+            return toHTMLFormElement(element);
+        ContainerNode* parent = element->parentNode();
+        if (!parent || !parent->isElementNode())
+            return 0;
+        element = toElement(parent);
+    }
+    return 0;
+}
+
 bool HTMLFormElement::formWouldHaveSecureSubmission(const String& url)
 {
     return document()->completeURL(url).protocolIs("https");
@@ -46,6 +46,9 @@ public:
     static PassRefPtr<HTMLFormElement> create(const QualifiedName&, Document*);
     virtual ~HTMLFormElement();
 
+    // The parsers associate the form controls of a fragment with the form that contains the context element.
+    static HTMLFormElement* findClosestFormAncestor(Element*);
+
     PassRefPtr<HTMLCollection> elements();
     void getNamedElements(const AtomicString&, Vector<RefPtr<Node> >&);
 
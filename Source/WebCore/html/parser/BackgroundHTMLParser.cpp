@@ -56,6 +56,17 @@ static const size_t outstandingCheckpointLimit = 10;
 // This was tuned in https://bugs.webkit.org/show_bug.cgi?id=110408.
 static const size_t pendingTokenLimit = 1000;
 
+// The main thread is idle until the first chunk arrives, and the preloads
+// found in <head> are only issued once their chunk is sent, so the first
+// chunks are kept small and the limit doubles with every chunk sent until
+// it reaches pendingTokenLimit.
+static const size_t initialPendingTokenLimit = 64;
+
+// The main thread processes a chunk without yielding, so a chunk is also
+// sent once its tokens cover this much source, which keeps pages made of a
+// few very large text or attribute tokens from producing oversized chunks.
+static const int pendingCharacterLimit = 64 * 1024;
+
 using namespace HTMLNames;
 
 #ifndef NDEBUG
@@ -82,6 +93,8 @@ BackgroundHTMLParser::BackgroundHTMLParser(PassRefPtr<WeakReference<BackgroundHT
     , m_options(config->options)
     , m_parser(config->parser)
     , m_pendingTokens(adoptPtr(new CompactHTMLTokenStream))
+    , m_pendingTokenLimit(initialPendingTokenLimit)
+    , m_charactersConsumedBeforeChunk(0)
     , m_xssAuditor(config->xssAuditor.release())
     , m_preloadScanner(config->preloadScanner.release())
 {
@@ -102,6 +115,9 @@ void BackgroundHTMLParser::resumeFrom(PassOwnPtr<Checkpoint> checkpoint)
     m_treeBuilderSimulator.setState(checkpoint->treeBuilderState);
     m_input.rewindTo(checkpoint->inputCheckpoint, checkpoint->unparsedInput);
     m_preloadScanner->rewindTo(checkpoint->preloadScannerCheckpoint);
+    // The main thread is waiting on us again, so start over with small chunks.
+    m_pendingTokenLimit = initialPendingTokenLimit;
+    m_charactersConsumedBeforeChunk = m_input.current().numberOfCharactersConsumed();
     pumpTokenizer();
 }
 
@@ -171,7 +187,7 @@ void BackgroundHTMLParser::pumpTokenizer()
 
         m_token->clear();
 
-        if (!m_treeBuilderSimulator.simulate(m_pendingTokens->last(), m_tokenizer.get()) || m_pendingTokens->size() >= pendingTokenLimit) {
+        if (!m_treeBuilderSimulator.simulate(m_pendingTokens->last(), m_tokenizer.get()) || isPendingChunkFull()) {
             sendTokensToMainThread();
             // If we're far ahead of the main thread, yield for a bit to avoid consuming too much memory.
             if (m_input.outstandingCheckpointCount() > outstandingCheckpointLimit)
@@ -180,6 +196,13 @@ void BackgroundHTMLParser::pumpTokenizer()
     }
 }
 
+bool BackgroundHTMLParser::isPendingChunkFull()
+{
+    if (m_pendingTokens->size() >= m_pendingTokenLimit)
+        return true;
+    return m_input.current().numberOfCharactersConsumed() - m_charactersConsumedBeforeChunk >= pendingCharacterLimit;
+}
+
 void BackgroundHTMLParser::sendTokensToMainThread()
 {
     if (m_pendingTokens->isEmpty())
@@ -201,6 +224,8 @@ void BackgroundHTMLParser::sendTokensToMainThread()
     callOnMainThread(bind(&HTMLDocumentParser::didReceiveParsedChunkFromBackgroundParser, m_parser, chunk.release()));
 
     m_pendingTokens = adoptPtr(new CompactHTMLTokenStream);
+    m_pendingTokenLimit = std::min(m_pendingTokenLimit * 2, pendingTokenLimit);
+    m_charactersConsumedBeforeChunk = m_input.current().numberOfCharactersConsumed();
 }
 
 }
@@ -84,6 +84,7 @@ private:
 
     void markEndOfFile();
     void pumpTokenizer();
+    bool isPendingChunkFull();
     void sendTokensToMainThread();
 
     WeakPtrFactory<BackgroundHTMLParser> m_weakFactory;
@@ -96,6 +97,8 @@ private:
     WeakPtr<HTMLDocumentParser> m_parser;
 
     OwnPtr<CompactHTMLTokenStream> m_pendingTokens;
+    size_t m_pendingTokenLimit;
+    int m_charactersConsumedBeforeChunk;
     PreloadRequestStream m_pendingPreloads;
     XSSInfoStream m_pendingXSSInfos;
 
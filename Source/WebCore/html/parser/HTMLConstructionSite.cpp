@@ -99,8 +99,11 @@ static inline void executeTask(HTMLConstructionSiteTask& task)
     // JavaScript run from beforeload (or DOM Mutation or event handlers)
     // might have removed the child, in which case we should not attach it.
 
+    // Attaching lazily leaves renderer creation to the next style recalc, which
+    // handles every node the parser inserted since the previous one in a single
+    // pass instead of resolving style and creating a renderer per insertion.
     if (task.child->parentNode() && task.parent->attached() && !task.child->attached())
-        task.child->attach();
+        task.child->lazyAttach();
 
     task.child->beginParsingChildren();
 
@@ -34,6 +34,7 @@
 #include "DocumentLoader.h"
 #include "Element.h"
 #include "Frame.h"
+#include "HTMLFastPathParser.h"
 #include "HTMLIdentifier.h"
 #include "HTMLNames.h"
 #include "HTMLParserScheduler.h"
@@ -957,6 +958,9 @@ void HTMLDocumentParser::executeScriptsWaitingForStylesheets()
 
 void HTMLDocumentParser::parseDocumentFragment(const String& source, DocumentFragment* fragment, Element* contextElement, ParserContentPolicy parserContentPolicy)
 {
+    if (tryFastParsingHTMLFragment(source, fragment, contextElement, parserContentPolicy))
+        return;
+
     RefPtr<HTMLDocumentParser> parser = HTMLDocumentParser::create(fragment, contextElement, parserContentPolicy);
     parser->insert(source); // Use insert() so that the parser will not yield.
     parser->finish();
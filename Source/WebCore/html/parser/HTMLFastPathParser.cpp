@@ -0,0 +1,471 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HTMLFastPathParser.h"
+
+#include "DocumentFragment.h"
+#include "HTMLElementFactory.h"
+#include "HTMLFormElement.h"
+#include "HTMLNames.h"
+#include "HTMLParserIdioms.h"
+#include "HTMLParserOptions.h"
+#include "Text.h"
+#include <wtf/HashMap.h>
+#include <wtf/text/AtomicString.h>
+
+namespace WebCore {
+
+using namespace HTMLNames;
+
+enum FastPathTagFlag {
+    IsVoidElement = 1 << 0,
+    // Start tags that implicitly close an open <p>.
+    ClosesParagraph = 1 << 1,
+    IsParagraph = 1 << 2,
+    IsListItem = 1 << 3,
+    // Special elements other than <address>, <div> and <p>, which end the search for an open <li>.
+    EndsListItemSearch = 1 << 4,
+    IsHeading = 1 << 5,
+    IsAnchor = 1 << 6,
+    IsContextOnly = 1 << 7
+};
+
+struct FastPathTag {
+    FastPathTag()
+        : name(0)
+        , flags(0)
+    {
+    }
+
+    FastPathTag(const QualifiedName& name, unsigned flags)
+        : name(&name)
+        , flags(flags)
+    {
+    }
+
+    const QualifiedName* name;
+    unsigned flags;
+};
+
+typedef HashMap<AtomicStringImpl*, FastPathTag> FastPathTagMap;
+
+static void addTag(FastPathTagMap& map, const QualifiedName& name, unsigned flags)
+{
+    map.add(name.localName().impl(), FastPathTag(name, flags));
+}
+
+// Elements whose start and end tags the tree builder handles by simply pushing and popping them,
+// as long as the nesting checks in FastPathParser::canInsertStartTag() hold.
+static const FastPathTagMap& fastPathTags()
+{
+    DEFINE_STATIC_LOCAL(FastPathTagMap, map, ());
+    if (!map.isEmpty())
+        return map;
+
+    const QualifiedName* phrasingTags[] = { &bTag, &codeTag, &emTag, &iTag, &labelTag, &sTag, &smallTag, &spanTag, &strongTag, &subTag, &supTag, &uTag };
+    for (size_t i = 0; i < WTF_ARRAY_LENGTH(phrasingTags); ++i)
+        addTag(map, *phrasingTags[i], 0);
+
+    const QualifiedName* sectioningTags[] = { &articleTag, &asideTag, &footerTag, &headerTag, &navTag, &olTag, &sectionTag, &ulTag };
+    for (size_t i = 0; i < WTF_ARRAY_LENGTH(sectioningTags); ++i)
+        addTag(map, *sectioningTags[i], ClosesParagraph | EndsListItemSearch);
+
+    const QualifiedName* headingTags[] = { &h1Tag, &h2Tag, &h3Tag, &h4Tag, &h5Tag, &h6Tag };
+    for (size_t i = 0; i < WTF_ARRAY_LENGTH(headingTags); ++i)
+        addTag(map, *headingTags[i], ClosesParagraph | EndsListItemSearch | IsHeading);
+
+    addTag(map, aTag, IsAnchor);
+    addTag(map, divTag, ClosesParagraph);
+    addTag(map, pTag, ClosesParagraph | IsParagraph);
+    addTag(map, liTag, ClosesParagraph | EndsListItemSearch | IsListItem);
+    addTag(map, brTag, IsVoidElement);
+    addTag(map, imgTag, IsVoidElement);
+    addTag(map, wbrTag, IsVoidElement);
+    addTag(map, hrTag, IsVoidElement | ClosesParagraph);
+    addTag(map, bodyTag, IsContextOnly);
+    return map;
+}
+
+template<typename CharacterType>
+class FastPathParser {
+    WTF_MAKE_NONCOPYABLE(FastPathParser);
+public:
+    FastPathParser(const CharacterType* characters, unsigned length, DocumentFragment* fragment, HTMLFormElement* form, ParserContentPolicy parserContentPolicy, unsigned maximumDOMTreeDepth)
+        : m_start(characters)
+        , m_end(characters + length)
+        , m_position(characters)
+        , m_fragment(fragment)
+        , m_form(form)
+        , m_parserContentPolicy(parserContentPolicy)
+        , m_maximumDOMTreeDepth(maximumDOMTreeDepth)
+        , m_isBuilding(false)
+    {
+    }
+
+    // The markup is checked in a first pass that creates no nodes, so giving up never leaves
+    // partial content in the fragment or starts loads for elements the full parser recreates.
+    bool validate()
+    {
+        m_isBuilding = false;
+        return run();
+    }
+
+    void build()
+    {
+        m_isBuilding = true;
+        bool succeeded = run();
+        ASSERT_UNUSED(succeeded, succeeded);
+    }
+
+private:
+    struct OpenElement {
+        OpenElement()
+            : element(0)
+            , localName(0)
+            , flags(0)
+        {
+        }
+
+        OpenElement(Element* element, AtomicStringImpl* localName, unsigned flags)
+            : element(element)
+            , localName(localName)
+            , flags(flags)
+        {
+        }
+
+        Element* element;
+        AtomicStringImpl* localName;
+        unsigned flags;
+    };
+
+    bool run()
+    {
+        m_position = m_start;
+        m_openElements.clear();
+        while (m_position < m_end) {
+            if (*m_position != '<') {
+                if (!parseText())
+                    return false;
+            } else if (m_position + 1 < m_end && m_position[1] == '/') {
+                if (!parseEndTag())
+                    return false;
+            } else if (!parseStartTag())
+                return false;
+        }
+        // Leaving elements open is fine for the tree builder, but it is not the common case.
+        return m_openElements.isEmpty();
+    }
+
+    ContainerNode* currentNode() const
+    {
+        ASSERT(m_isBuilding);
+        if (m_openElements.isEmpty())
+            return m_fragment;
+        return m_openElements.last().element;
+    }
+
+    bool skipWhitespace()
+    {
+        const CharacterType* start = m_position;
+        while (m_position < m_end && isHTMLSpace(*m_position))
+            ++m_position;
+        return m_position != start;
+    }
+
+    AtomicString parseTagName()
+    {
+        const CharacterType* start = m_position;
+        if (m_position == m_end || !isASCIILower(*m_position))
+            return nullAtom;
+        while (m_position < m_end && (isASCIILower(*m_position) || isASCIIDigit(*m_position)))
+            ++m_position;
+        return AtomicString(start, m_position - start);
+    }
+
+    static bool isAttributeNameCharacter(CharacterType character)
+    {
+        return isASCIILower(character) || isASCIIDigit(character) || character == '-' || character == '_';
+    }
+
+    // Character references and the characters the input stream preprocessor rewrites need the full tokenizer.
+    static bool needsTokenizer(CharacterType character)
+    {
+        return character == '&' || character == '\r' || !character;
+    }
+
+    static bool namesAreEqual(const CharacterType* a, const CharacterType* b, unsigned length)
+    {
+        for (unsigned i = 0; i < length; ++i) {
+            if (a[i] != b[i])
+                return false;
+        }
+        return true;
+    }
+
+    bool parseText()
+    {
+        const CharacterType* start = m_position;
+        bool isAllWhitespace = true;
+        for (; m_position < m_end && *m_position != '<'; ++m_position) {
+            if (needsTokenizer(*m_position))
+                return false;
+            if (!isHTMLSpace(*m_position))
+                isAllWhitespace = false;
+        }
+
+        unsigned length = m_position - start;
+        if (length > Text::defaultLengthLimit)
+            return false;
+        if (!m_isBuilding)
+            return true;
+
+        // Like HTMLConstructionSite, share a single string for each whitespace run.
+        String text = isAllWhitespace ? AtomicString(start, length).string() : String(start, length);
+        currentNode()->parserAppendChild(Text::create(m_fragment->document(), text));
+        return true;
+    }
+
+    bool parseAttributes(Vector<Attribute>& attributes, bool& selfClosing)
+    {
+        Vector<std::pair<const CharacterType*, unsigned>, 8> names;
+        bool isSeparated = false;
+        selfClosing = false;
+
+        while (true) {
+            isSeparated |= skipWhitespace();
+            if (m_position == m_end)
+                return false;
+            if (*m_position == '>') {
+                ++m_position;
+                return true;
+            }
+            if (*m_position == '/') {
+                ++m_position;
+                if (m_position == m_end || *m_position != '>')
+                    return false;
+                ++m_position;
+                selfClosing = true;
+                return true;
+            }
+            if (!isSeparated)
+                return false;
+
+            const CharacterType* nameStart = m_position;
+            while (m_position < m_end && isAttributeNameCharacter(*m_position))
+                ++m_position;
+            unsigned nameLength = m_position - nameStart;
+            if (!nameLength)
+                return false;
+
+            // The tokenizer drops repeated attributes; leave that to it.
+            for (size_t i = 0; i < names.size(); ++i) {
+                if (names[i].second == nameLength && namesAreEqual(names[i].first, nameStart, nameLength))
+                    return false;
+            }
+            names.append(std::make_pair(nameStart, nameLength));
+
+            isSeparated = skipWhitespace();
+            const CharacterType* valueStart = m_position;
+            unsigned valueLength = 0;
+            if (m_position < m_end && *m_position == '=') {
+                ++m_position;
+                skipWhitespace();
+                if (m_position == m_end)
+                    return false;
+                CharacterType quote = *m_position;
+                if (quote == '"' || quote == '\'') {
+                    valueStart = ++m_position;
+                    for (; m_position < m_end && *m_position != quote; ++m_position) {
+                        if (needsTokenizer(*m_position))
+                            return false;
+                    }
+                    if (m_position == m_end)
+                        return false;
+                    valueLength = m_position - valueStart;
+                    ++m_position;
+                } else {
+                    valueStart = m_position;
+                    for (; m_position < m_end && !isHTMLSpace(*m_position) && *m_position != '>'; ++m_position) {
+                        CharacterType character = *m_position;
+                        if (needsTokenizer(character) || character == '"' || character == '\'' || character == '<' || character == '=' || character == '`')
+                            return false;
+                    }
+                    valueLength = m_position - valueStart;
+                }
+                isSeparated = false;
+            }
+
+            if (m_isBuilding) {
+                QualifiedName name(nullAtom, AtomicString(nameStart, nameLength), nullAtom);
+                attributes.append(Attribute(name, valueLength ? AtomicString(valueStart, valueLength) : emptyAtom));
+            }
+        }
+    }
+
+    bool hasOpenElementWithFlag(FastPathTagFlag flag) const
+    {
+        for (size_t i = 0; i < m_openElements.size(); ++i) {
+            if (m_openElements[i].flags & flag)
+                return true;
+        }
+        return false;
+    }
+
+    // Rejects start tags for which the tree builder would close or reparent open elements.
+    bool canInsertStartTag(unsigned flags) const
+    {
+        if ((flags & ClosesParagraph) && hasOpenElementWithFlag(IsParagraph))
+            return false;
+        if ((flags & IsHeading) && !m_openElements.isEmpty() && (m_openElements.last().flags & IsHeading))
+            return false;
+        if ((flags & IsAnchor) && hasOpenElementWithFlag(IsAnchor))
+            return false;
+        if (flags & IsListItem) {
+            for (size_t i = m_openElements.size(); i; --i) {
+                unsigned openElementFlags = m_openElements[i - 1].flags;
+                if (openElementFlags & IsListItem)
+                    return false;
+                if (openElementFlags & EndsListItemSearch)
+                    break;
+            }
+        }
+        return true;
+    }
+
+    bool parseStartTag()
+    {
+        ASSERT(*m_position == '<');
+        ++m_position;
+        AtomicString tagName = parseTagName();
+        if (tagName.isNull())
+            return false;
+
+        const FastPathTagMap& tags = fastPathTags();
+        FastPathTagMap::const_iterator it = tags.find(tagName.impl());
+        if (it == tags.end() || (it->value.flags & IsContextOnly))
+            return false;
+        unsigned flags = it->value.flags;
+
+        Vector<Attribute> attributes;
+        bool selfClosing;
+        if (!parseAttributes(attributes, selfClosing))
+            return false;
+        // The tree builder ignores the slash on non-void elements, leaving them open.
+        if (selfClosing && !(flags & IsVoidElement))
+            return false;
+        if (!canInsertStartTag(flags))
+            return false;
+        // The fragment counts as an open element too, hence the + 2.
+        if (m_openElements.size() + 2 > m_maximumDOMTreeDepth)
+            return false;
+
+        RefPtr<Element> element;
+        if (m_isBuilding) {
+            element = HTMLElementFactory::createHTMLElement(*it->value.name, m_fragment->document(), m_form, true);
+            if (!scriptingContentIsAllowed(m_parserContentPolicy))
+                element->stripScriptingAttributes(attributes);
+            element->parserSetAttributes(attributes);
+            currentNode()->parserAppendChild(element);
+            element->beginParsingChildren();
+        }
+
+        if (flags & IsVoidElement) {
+            if (element)
+                element->finishParsingChildren();
+            return true;
+        }
+
+        m_openElements.append(OpenElement(element.get(), tagName.impl(), flags));
+        return true;
+    }
+
+    bool parseEndTag()
+    {
+        ASSERT(m_position[0] == '<' && m_position[1] == '/');
+        m_position += 2;
+        AtomicString tagName = parseTagName();
+        if (tagName.isNull())
+            return false;
+        skipWhitespace();
+        if (m_position == m_end || *m_position != '>')
+            return false;
+        ++m_position;
+
+        // Only well nested end tags are simple pops; anything else runs the adoption agency or generates end tags.
+        if (m_openElements.isEmpty() || m_openElements.last().localName != tagName.impl())
+            return false;
+        if (m_isBuilding)
+            m_openElements.last().element->finishParsingChildren();
+        m_openElements.removeLast();
+        return true;
+    }
+
+    const CharacterType* m_start;
+    const CharacterType* m_end;
+    const CharacterType* m_position;
+    DocumentFragment* m_fragment;
+    HTMLFormElement* m_form;
+    ParserContentPolicy m_parserContentPolicy;
+    unsigned m_maximumDOMTreeDepth;
+    bool m_isBuilding;
+    Vector<OpenElement, 32> m_openElements;
+};
+
+template<typename CharacterType>
+static bool parseFragment(const CharacterType* characters, unsigned length, DocumentFragment* fragment, HTMLFormElement* form, ParserContentPolicy parserContentPolicy, unsigned maximumDOMTreeDepth)
+{
+    FastPathParser<CharacterType> parser(characters, length, fragment, form, parserContentPolicy, maximumDOMTreeDepth);
+    if (!parser.validate())
+        return false;
+    parser.build();
+    return true;
+}
+
+bool tryFastParsingHTMLFragment(const String& source, DocumentFragment* fragment, Element* contextElement, ParserContentPolicy parserContentPolicy)
+{
+    // The context decides the tokenizer state and insertion mode, so only accept contexts
+    // that parse their children as plain body content.
+    if (!contextElement || !contextElement->isHTMLElement())
+        return false;
+    const FastPathTagMap& tags = fastPathTags();
+    FastPathTagMap::const_iterator it = tags.find(contextElement->localName().impl());
+    if (it == tags.end() || (it->value.flags & IsVoidElement))
+        return false;
+
+    HTMLParserOptions options(fragment->document());
+    if (options.usePreHTML5ParserQuirks)
+        return false;
+
+    if (source.isEmpty())
+        return true;
+
+    HTMLFormElement* form = HTMLFormElement::findClosestFormAncestor(contextElement);
+    if (source.is8Bit())
+        return parseFragment(source.characters8(), source.length(), fragment, form, parserContentPolicy, options.maximumDOMTreeDepth);
+    return parseFragment(source.characters16(), source.length(), fragment, form, parserContentPolicy, options.maximumDOMTreeDepth);
+}
+
+} // namespace WebCore
@@ -28,7 +28,7 @@
 
 #if ENABLE(THREADED_HTML_PARSER)
 
-#include <wtf/text/WTFString.h>
+#include <wtf/text/AtomicString.h>
 
 namespace WebCore {
 
@@ -40,45 +40,40 @@ enum CharacterWidth {
     Force16Bit
 };
 
+// Names are shared atomic strings whenever possible, so that the main thread can use them
+// without atomizing them again. Other text is a plain String.
 class HTMLIdentifier {
 public:
-    HTMLIdentifier() : m_index(0) { }
+    HTMLIdentifier() { }
 
     template<size_t inlineCapacity>
     HTMLIdentifier(const Vector<UChar, inlineCapacity>& vector, CharacterWidth width)
-        : m_index(findIndex(vector.data(), vector.size()))
     {
-        if (m_index != invalidIndex)
-            return;
-        if (width == Likely8Bit)
+        if (width == Likely8Bit) {
+            if (AtomicStringImpl* name = findOrAddName(vector.data(), vector.size())) {
+                m_string = name;
+                return;
+            }
             m_string = StringImpl::create8BitIfPossible(vector);
-        else if (width == Force8Bit)
+        } else if (width == Force8Bit)
             m_string = String::make8BitFrom16BitSource(vector);
         else
             m_string = String(vector);
     }
 
-    // asString should only be used on the main thread.
-    const String& asString() const;
-    // asStringImpl() is safe to call from any thread.
-    const StringImpl* asStringImpl() const;
+    // Both are safe to call from any thread.
+    const String& asString() const { return m_string; }
+    const StringImpl* asStringImpl() const { return m_string.impl(); }
 
     static void init();
 
     bool isSafeToSendToAnotherThread() const { return m_string.isSafeToSendToAnotherThread(); }
 
-#ifndef NDEBUG
-    static bool hasIndex(const StringImpl*);
-#endif
-
 private:
-    static const unsigned invalidIndex = -1;
-    static unsigned maxNameLength;
-    static unsigned findIndex(const UChar* characters, unsigned length);
-    static void addNames(QualifiedName** names, unsigned namesCount, unsigned indexOffset);
+    static const unsigned maximumNameLength = 64;
+    static AtomicStringImpl* findOrAddName(const UChar* characters, unsigned length);
+    static void addNames(QualifiedName** names, unsigned namesCount);
 
-    // FIXME: This could be a union.
-    unsigned m_index;
     String m_string;
 };
 
@@ -97,9 +97,9 @@ bool threadSafeMatch(const QualifiedName&, const QualifiedName&);
 bool threadSafeMatch(const HTMLIdentifier&, const QualifiedName&);
 inline bool threadSafeHTMLNamesMatch(const HTMLIdentifier& tagName, const QualifiedName& qName)
 {
-    // When the QualifiedName is known to HTMLIdentifier,
-    // all we have to do is a pointer compare.
-    ASSERT(HTMLIdentifier::hasIndex(qName.localName().impl()));
+    // HTMLIdentifier::init() shares the local names of HTMLNames,
+    // so all we have to do is a pointer compare.
+    ASSERT(qName.localName().impl()->isSharedAtomic());
     return tagName.asStringImpl() == qName.localName().impl();
 }
 #endif
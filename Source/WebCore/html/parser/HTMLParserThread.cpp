@@ -34,6 +34,8 @@
 
 #include "HTMLParserThread.h"
 
+#include <wtf/text/AtomicStringTable.h>
+
 namespace WebCore {
 
 HTMLParserThread::HTMLParserThread()
@@ -51,6 +53,7 @@ bool HTMLParserThread::start()
     MutexLocker lock(m_threadCreationMutex);
     if (m_threadID)
         return true;
+    AtomicStringTable::shareStringsWithOtherThreads();
     m_threadID = createThread(HTMLParserThread::threadStart, this, "WebCore: HTMLParser");
     return m_threadID;
 }
@@ -89,6 +92,8 @@ void HTMLParserThread::runLoop()
         // established before starting the main loop.
         MutexLocker lock(m_threadCreationMutex);
     }
+    // Names the tokenizer atomizes here can then be used by the main thread as they are.
+    AtomicStringTable::useSharedStringsOnCurrentThread();
     while (OwnPtr<Closure> function = m_queue.waitForMessage())
         (*function)();
 
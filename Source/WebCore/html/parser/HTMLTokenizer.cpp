@@ -246,6 +246,8 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
         } else if (cc == kEndOfFileMarker)
             return emitEndOfFile(source);
         else {
+            if (bufferCharacterRun(source))
+                HTML_SWITCH_TO(DataState);
             bufferCharacter(cc);
             HTML_ADVANCE_TO(DataState);
         }
@@ -267,6 +269,8 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
         else if (cc == kEndOfFileMarker)
             return emitEndOfFile(source);
         else {
+            if (bufferCharacterRun(source))
+                HTML_SWITCH_TO(RCDATAState);
             bufferCharacter(cc);
             HTML_ADVANCE_TO(RCDATAState);
         }
@@ -962,6 +966,8 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
             m_token->endAttributeValue(source.numberOfCharactersConsumed());
             HTML_RECONSUME_IN(DataState);
         } else {
+            if (appendRunToAttributeValue(source, '"'))
+                HTML_SWITCH_TO(AttributeValueDoubleQuotedState);
             m_token->appendToAttributeValue(cc);
             HTML_ADVANCE_TO(AttributeValueDoubleQuotedState);
         }
@@ -980,6 +986,8 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
             m_token->endAttributeValue(source.numberOfCharactersConsumed());
             HTML_RECONSUME_IN(DataState);
         } else {
+            if (appendRunToAttributeValue(source, '\''))
+                HTML_SWITCH_TO(AttributeValueSingleQuotedState);
             m_token->appendToAttributeValue(cc);
             HTML_ADVANCE_TO(AttributeValueSingleQuotedState);
         }
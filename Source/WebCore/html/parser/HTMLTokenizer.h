@@ -213,6 +213,36 @@ private:
         m_token->appendToCharacter(character);
     }
 
+    // The data and quoted attribute value states spend most of their time on
+    // runs of characters that need no processing, so they copy a whole run at
+    // once. These return false if the current character does not start a run.
+    inline bool bufferCharacterRun(SegmentedString& source)
+    {
+        unsigned length = source.lengthOfRunBefore('<', '&');
+        if (!length)
+            return false;
+        m_token->ensureIsCharacterToken();
+        if (source.runIs8Bit())
+            m_token->appendToCharacter(source.runCharacters8(), length);
+        else
+            m_token->appendToCharacter(source.runCharacters16(), length);
+        source.advancePastRun(length);
+        return true;
+    }
+
+    inline bool appendRunToAttributeValue(SegmentedString& source, LChar quote)
+    {
+        unsigned length = source.lengthOfRunBefore(quote, '&');
+        if (!length)
+            return false;
+        if (source.runIs8Bit())
+            m_token->appendToAttributeValue(source.runCharacters8(), length);
+        else
+            m_token->appendToAttributeValue(source.runCharacters16(), length);
+        source.advancePastRun(length);
+        return true;
+    }
+
     inline bool emitAndResumeIn(SegmentedString& source, State state)
     {
         saveEndTagNameIfNeeded();
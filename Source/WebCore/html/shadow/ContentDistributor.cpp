@@ -28,6 +28,7 @@
 #include "ContentDistributor.h"
 
 #include "ElementShadow.h"
+#include "EventRetargeter.h"
 #include "HTMLContentElement.h"
 #include "NodeTraversal.h"
 #include "ShadowRoot.h"
@@ -79,6 +80,7 @@ void ContentDistributor::distribute(Element* host)
     ASSERT(!host->containingShadowRoot() || host->containingShadowRoot()->owner()->distributor().isValid());
 
     m_validity = Valid;
+    EventRetargeter::invalidateCachedEventPath();
 
     if (ShadowRoot* root = host->shadowRoot()) {
         const Vector<RefPtr<InsertionPoint> >& insertionPoints = ensureInsertionPointList(root);
@@ -107,6 +109,7 @@ bool ContentDistributor::invalidate(Element* host)
 
     m_validity = Invalidating;
     m_nodeToInsertionPoint.clear();
+    EventRetargeter::invalidateCachedEventPath();
     return needsReattach;
 }
 
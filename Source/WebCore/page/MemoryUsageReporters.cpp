@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "MemoryUsageReporters.h"
+
+#include "FontCache.h"
+#include "GlyphPage.h"
+#include "GlyphPageTreeNode.h"
+#include "JSDOMWindowBase.h"
+#include "MemoryCache.h"
+#include "Page.h"
+#include "RenderArena.h"
+#include "SimpleFontData.h"
+#include <runtime/JSLock.h>
+#include <runtime/MemoryStatistics.h>
+#include <wtf/FastMalloc.h>
+#include <wtf/MainThread.h>
+#include <wtf/MemoryUsageRegistry.h>
+
+namespace WebCore {
+
+// Each byte is reported once: the memory cache reports resources without their decoded data,
+// which is reported on its own, and fastMalloc only reports the memory on its free lists.
+
+static void reportJavaScriptMemoryUsage(MemoryUsageReport& report)
+{
+    ASSERT(isMainThread());
+    JSC::VM* vm = JSDOMWindowBase::commonVM();
+    JSC::JSLockHolder lock(vm);
+    report.add("JavaScript.Heap", vm->heap.size());
+
+    JSC::GlobalMemoryStatistics statistics = JSC::globalMemoryStatistics();
+    report.add("JavaScript.Stack", statistics.stackBytes);
+    report.add("JavaScript.JIT", statistics.JITBytes);
+}
+
+static void addMemoryCacheStatistic(MemoryUsageReport& report, const char* category, const MemoryCache::TypeStatistic& statistic)
+{
+    report.add(category, statistic.size - statistic.decodedSize);
+}
+
+static void reportMemoryCacheUsage(MemoryUsageReport& report)
+{
+    ASSERT(isMainThread());
+    MemoryCache::Statistics statistics = memoryCache()->getStatistics();
+    addMemoryCacheStatistic(report, "WebCore.MemoryCache.Images", statistics.images);
+    addMemoryCacheStatistic(report, "WebCore.MemoryCache.StyleSheets", statistics.cssStyleSheets);
+    addMemoryCacheStatistic(report, "WebCore.MemoryCache.Scripts", statistics.scripts);
+    addMemoryCacheStatistic(report, "WebCore.MemoryCache.XSLStyleSheets", statistics.xslStyleSheets);
+    addMemoryCacheStatistic(report, "WebCore.MemoryCache.Fonts", statistics.fonts);
+
+    report.add("WebCore.DecodedImages", statistics.images.decodedSize);
+    report.add("WebCore.MemoryCache.DecodedData", statistics.cssStyleSheets.decodedSize + statistics.scripts.decodedSize
+        + statistics.xslStyleSheets.decodedSize + statistics.fonts.decodedSize);
+}
+
+static void reportFontMemoryUsage(MemoryUsageReport& report)
+{
+    ASSERT(isMainThread());
+    // Font data and glyph pages do not track their sizes, so these are lower bounds from the object counts.
+    report.add("WebCore.Fonts.FontData", fontCache()->fontDataCount() * sizeof(SimpleFontData));
+    report.add("WebCore.Fonts.GlyphPages", GlyphPageTreeNode::treeGlyphPageCount() * sizeof(GlyphPage));
+}
+
+static void reportRenderingMemoryUsage(MemoryUsageReport& report)
+{
+    ASSERT(isMainThread());
+    report.add("WebCore.RenderArena", RenderArena::totalAllocatedBytesInAllRenderArenas());
+#if USE(ACCELERATED_COMPOSITING)
+    report.add("WebCore.BackingStores", static_cast<size_t>(Page::backingStoreMemoryEstimateForAllPages()));
+#endif
+}
+
+static void reportFastMallocMemoryUsage(MemoryUsageReport& report)
+{
+    report.add("FastMalloc.FreeList", WTF::fastMallocStatistics().freeListBytes);
+}
+
+void registerMemoryUsageReporters()
+{
+    MemoryUsageRegistry& registry = MemoryUsageRegistry::shared();
+    registry.addReporter(reportJavaScriptMemoryUsage);
+    registry.addReporter(reportMemoryCacheUsage);
+    registry.addReporter(reportFontMemoryUsage);
+    registry.addReporter(reportRenderingMemoryUsage);
+    registry.addReporter(reportFastMallocMemoryUsage);
+}
+
+} // namespace WebCore
@@ -54,6 +54,7 @@
 #include "InspectorInstrumentation.h"
 #include "Logging.h"
 #include "MediaCanStartListener.h"
+#include "MemoryUsageReporters.h"
 #include "Navigator.h"
 #include "NetworkStateNotifier.h"
 #include "PageActivityAssertionToken.h"
@@ -195,6 +196,7 @@ Page::Page(PageClients& pageClients)
         allPages = new HashSet<Page*>;
         
         networkStateNotifier().addNetworkStateChangeListener(networkStateChanged);
+        registerMemoryUsageReporters();
     }
 
     ASSERT(!allPages->contains(this));
@@ -482,6 +484,24 @@ void Page::updateStyleForAllPagesAfterGlobalChangeInEnvironment()
         }
 }
 
+#if USE(ACCELERATED_COMPOSITING)
+double Page::backingStoreMemoryEstimateForAllPages()
+{
+    if (!allPages)
+        return 0;
+    double estimate = 0;
+    HashSet<Page*>::iterator end = allPages->end();
+    for (HashSet<Page*>::iterator it = allPages->begin(); it != end; ++it) {
+        for (Frame* frame = (*it)->mainFrame(); frame; frame = frame->tree()->traverseNext()) {
+            RenderView* view = frame->contentRenderer();
+            if (view && view->usesCompositing())
+                estimate += view->compositor()->backingStoreMemoryEstimate();
+        }
+    }
+    return estimate;
+}
+#endif
+
 void Page::setNeedsRecalcStyleInAllFrames()
 {
     for (Frame* frame = mainFrame(); frame; frame = frame->tree()->traverseNext())
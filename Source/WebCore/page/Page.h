@@ -117,6 +117,9 @@ class Page : public Supplementable<Page> {
 
 public:
     static void updateStyleForAllPagesAfterGlobalChangeInEnvironment();
+#if USE(ACCELERATED_COMPOSITING)
+    static double backingStoreMemoryEstimateForAllPages();
+#endif
 
     // It is up to the platform to ensure that non-null clients are provided where required.
     struct PageClients {
@@ -216,9 +216,11 @@ void PageSerializer::serializeFrame(Frame* frame)
         // FIXME: iframes used as images trigger this. We should deal with them correctly.
         return;
     }
-    String text = accumulator.serializeNodes(document->documentElement(), 0, IncludeNode);
-    CString frameHTML = textEncoding.encode(text.characters(), text.length(), EntitiesForUnencodables);
-    m_resources->append(Resource(url, document->suggestedMIMEType(), SharedBuffer::create(frameHTML.data(), frameHTML.length())));
+    StringBuilder text(StringBuilder::SegmentedBuffer);
+    accumulator.serializeNodes(document->documentElement(), 0, IncludeNode, text);
+    RefPtr<SharedBuffer> frameHTML = SharedBuffer::create();
+    textEncoding.encode(text, EntitiesForUnencodables, *frameHTML);
+    m_resources->append(Resource(url, document->suggestedMIMEType(), frameHTML.release()));
     m_resourceURLs.add(url);
 
     for (Vector<Node*>::iterator iter = nodes.begin(); iter != nodes.end(); ++iter) {
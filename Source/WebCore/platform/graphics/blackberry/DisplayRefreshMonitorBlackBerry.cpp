@@ -86,7 +86,7 @@ void DisplayRefreshMonitor::displayLinkFired()
 
     m_monotonicAnimationStartTime = monotonicallyIncreasingTime();
 
-    callOnMainThread(handleDisplayRefreshedNotificationOnMainThread, this);
+    callOnMainThread(handleDisplayRefreshedNotificationOnMainThread, this, MainThreadInputPriority);
     m_mutex.unlock();
 }
 
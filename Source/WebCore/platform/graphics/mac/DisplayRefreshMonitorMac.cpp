@@ -97,7 +97,7 @@ void DisplayRefreshMonitor::displayLinkFired(double nowSeconds, double outputTim
     // FIXME: Should this be using webKitMonotonicNow?
     m_monotonicAnimationStartTime = webKitMonotonicNow + timeUntilOutput;
 
-    callOnMainThread(handleDisplayRefreshedNotificationOnMainThread, this);
+    callOnMainThread(handleDisplayRefreshedNotificationOnMainThread, this, MainThreadInputPriority);
 }
 
 }
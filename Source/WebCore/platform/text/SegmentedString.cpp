@@ -20,6 +20,8 @@
 #include "config.h"
 #include "SegmentedString.h"
 
+#include <wtf/text/StringSIMD.h>
+
 namespace WebCore {
 
 SegmentedString::SegmentedString(const SegmentedString& other)
@@ -353,6 +355,32 @@ void SegmentedString::updateSlowCaseFunctionPointers()
     m_advanceAndUpdateLineNumberFunc = &SegmentedString::advanceAndUpdateLineNumberSlowCase;
 }
 
+template<typename CharacterType>
+static inline unsigned lengthOfRun(const CharacterType* characters, unsigned length, LChar delimiter1, LChar delimiter2)
+{
+    const LChar delimiters[] = { '\n', '\r', '\0', delimiter1, delimiter2 };
+    bool found;
+    unsigned i = WTF::findFirstOfInBlocks(characters, length, delimiters, WTF_ARRAY_LENGTH(delimiters), 0, found);
+    if (found)
+        return i;
+    for (; i < length; ++i) {
+        CharacterType character = characters[i];
+        if (character == '\n' || character == '\r' || !character || character == delimiter1 || character == delimiter2)
+            break;
+    }
+    return i;
+}
+
+unsigned SegmentedString::lengthOfRunBefore(LChar delimiter1, LChar delimiter2) const
+{
+    if (m_pushedChar1 || m_currentString.m_length < 2)
+        return 0;
+    unsigned length = m_currentString.m_length - 1;
+    if (m_currentString.is8Bit())
+        return lengthOfRun(m_currentString.m_data.string8Ptr, length, delimiter1, delimiter2);
+    return lengthOfRun(m_currentString.m_data.string16Ptr, length, delimiter1, delimiter2);
+}
+
 OrdinalNumber SegmentedString::currentLine() const
 {
     return OrdinalNumber::fromZeroBasedInt(m_currentLine);
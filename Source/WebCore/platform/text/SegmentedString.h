@@ -58,7 +58,7 @@ public:
 
     void clear() { m_length = 0; m_data.string16Ptr = 0; m_is8Bit = false;}
     
-    bool is8Bit() { return m_is8Bit; }
+    bool is8Bit() const { return m_is8Bit; }
     
     bool excludeLineNumbers() const { return !m_doNotExcludeLineNumbers; }
     bool doNotExcludeLineNumbers() const { return m_doNotExcludeLineNumbers; }
@@ -290,6 +290,30 @@ public:
     // have space for at least |count| characters.
     void advance(unsigned count, UChar* consumedCharacters);
 
+    // Bulk access for tokenizer states that consume long runs of ordinary characters.
+    // Returns how many characters, starting with the current one, precede the first
+    // '\n', '\r', '\0', |delimiter1| or |delimiter2| in the current substring. The last
+    // character of a substring is never part of a run, so advancing past a run never
+    // changes the line number or moves to the next substring.
+    unsigned lengthOfRunBefore(LChar delimiter1, LChar delimiter2) const;
+    bool runIs8Bit() const { return m_currentString.is8Bit(); }
+    const LChar* runCharacters8() const { return m_currentString.m_data.string8Ptr; }
+    const UChar* runCharacters16() const { return m_currentString.m_data.string16Ptr; }
+
+    void advancePastRun(unsigned length)
+    {
+        ASSERT(!m_pushedChar1);
+        ASSERT(length < static_cast<unsigned>(m_currentString.m_length));
+        m_currentString.m_length -= length;
+        if (m_currentString.is8Bit())
+            m_currentString.m_data.string8Ptr += length;
+        else
+            m_currentString.m_data.string16Ptr += length;
+        m_currentChar = m_currentString.getCurrentChar();
+        if (m_currentString.m_length == 1)
+            updateSlowCaseFunctionPointers();
+    }
+
     bool escaped() const { return m_pushedChar1; }
 
     int numberOfCharactersConsumed() const
@@ -28,14 +28,17 @@
 #include "config.h"
 #include "TextEncoding.h"
 
+#include "SharedBuffer.h"
 #include "TextCodec.h"
 #include "TextEncodingRegistry.h"
 #include <wtf/OwnPtr.h>
 #include <wtf/StdLibExtras.h>
 #include <wtf/text/CString.h>
+#include <wtf/text/StringBuilder.h>
 #include <wtf/text/WTFString.h>
 
 #if USE(ICU_UNICODE)
+#include <unicode/uchar.h>
 #include <unicode/unorm.h>
 #endif
 
@@ -108,6 +111,46 @@ CString TextEncoding::encode(const UChar* characters, size_t length, Unencodable
 #endif
 }
 
+// Normalization can combine characters across a segment boundary, so a run of segments may only
+// be encoded on its own if the next segment starts with a character that never composes with
+// what precedes it.
+static bool startsNormalizationBoundary(const String& segment)
+{
+    if (segment.is8Bit())
+        return segment.characters8()[0] < 0x80;
+#if USE(ICU_UNICODE)
+    UChar32 character;
+    unsigned i = 0;
+    U16_NEXT(segment.characters16(), i, segment.length(), character);
+    return !u_getCombiningClass(character) && u_getIntPropertyValue(character, UCHAR_NFC_QUICK_CHECK) == UNORM_YES;
+#else
+    return true;
+#endif
+}
+
+void TextEncoding::encode(const StringBuilder& builder, UnencodableHandling handling, SharedBuffer& output) const
+{
+    unsigned segmentCount = builder.segmentCount();
+    if (segmentCount == 1) {
+        String string = builder.segmentAt(0);
+        CString encoded = encode(string.characters(), string.length(), handling);
+        output.append(encoded.data(), encoded.length());
+        return;
+    }
+
+    StringBuilder run;
+    for (unsigned i = 0; i < segmentCount; ++i) {
+        String segment = builder.segmentAt(i);
+        run.append(segment);
+        if (i + 1 < segmentCount && !startsNormalizationBoundary(builder.segmentAt(i + 1)))
+            continue;
+        String runString = run.toString();
+        CString encoded = encode(runString.characters(), runString.length(), handling);
+        output.append(encoded.data(), encoded.length());
+        run.clear();
+    }
+}
+
 const char* TextEncoding::domName() const
 {
     if (noExtendedTextEncodingNameUsed())
@@ -32,6 +32,8 @@
 
 namespace WebCore {
 
+    class SharedBuffer;
+
     class TextEncoding {
     public:
         TextEncoding() : m_name(0) { }
@@ -71,6 +73,8 @@ namespace WebCore {
         }
         String decode(const char*, size_t length, bool stopOnError, bool& sawError) const;
         CString encode(const UChar*, size_t length, UnencodableHandling) const;
+        // Encodes the builder a run of segments at a time, so a segmented builder is never flattened.
+        void encode(const StringBuilder&, UnencodableHandling, SharedBuffer&) const;
 
         UChar backslashAsCurrencySymbol() const;
 
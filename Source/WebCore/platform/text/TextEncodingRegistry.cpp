@@ -87,7 +87,8 @@ struct TextEncodingNameHash {
     // http://burtleburtle.net/bob/hash/doobs.html
     static unsigned hash(const char* s)
     {
-        unsigned h = WTF::stringHashingStartValue;
+        // Arbitrary start value to avoid mapping all 0's to all 0's.
+        unsigned h = 0x9E3779B9U;
         for (;;) {
             char c = *s++;
             if (!c) {
@@ -41,6 +41,7 @@
 #include <string.h>
 #include <wtf/Assertions.h>
 #include <wtf/CryptographicallyRandomNumber.h>
+#include <wtf/MainThread.h>
 
 #define ROUNDUP(x, y) ((((x)+((y)-1))/(y))*(y))
 
@@ -68,6 +69,8 @@ static const size_t debugHeaderSize = ARENA_ALIGN(sizeof(RenderArenaDebugHeader)
 
 #endif
 
+static size_t allocatedBytesInAllRenderArenas;
+
 RenderArena::RenderArena(unsigned arenaSize)
     : m_totalSize(0)
     , m_totalAllocated(0)
@@ -97,9 +100,16 @@ RenderArena::RenderArena(unsigned arenaSize)
 
 RenderArena::~RenderArena()
 {
+    allocatedBytesInAllRenderArenas -= m_totalAllocated;
     FinishArenaPool(&m_pool);
 }
 
+size_t RenderArena::totalAllocatedBytesInAllRenderArenas()
+{
+    ASSERT(isMainThread());
+    return allocatedBytesInAllRenderArenas;
+}
+
 void* RenderArena::allocate(size_t size)
 {
     ASSERT(size <= gMaxRecycledSize - 32);
@@ -134,6 +144,7 @@ void* RenderArena::allocate(size_t size)
         unsigned bytesAllocated = 0;
         ARENA_ALLOCATE(result, &m_pool, size, &bytesAllocated);
         m_totalAllocated += bytesAllocated;
+        allocatedBytesInAllRenderArenas += bytesAllocated;
     }
 
     return result;
@@ -57,6 +57,9 @@ public:
     size_t totalRenderArenaSize() const { return m_totalSize; }
     size_t totalRenderArenaAllocatedBytes() const { return m_totalAllocated; }
 
+    // The arena memory held by all render arenas, for memory usage reports.
+    static size_t totalAllocatedBytesInAllRenderArenas();
+
 private:
     RenderArena(unsigned arenaSize = 8192);
     
@@ -1729,6 +1729,20 @@ bool RenderLayerCompositor::has3DContent() const
     return layerHas3DContent(rootRenderLayer());
 }
 
+static double backingStoreMemoryEstimateForLayerTree(const RenderLayer* layer)
+{
+    double estimate = layer->backing() ? layer->backing()->backingStoreMemoryEstimate() : 0;
+    for (RenderLayer* child = layer->firstChild(); child; child = child->nextSibling())
+        estimate += backingStoreMemoryEstimateForLayerTree(child);
+    return estimate;
+}
+
+double RenderLayerCompositor::backingStoreMemoryEstimate() const
+{
+    RenderLayer* rootLayer = rootRenderLayer();
+    return rootLayer ? backingStoreMemoryEstimateForLayerTree(rootLayer) : 0;
+}
+
 bool RenderLayerCompositor::allowsIndependentlyCompositedFrames(const FrameView* view)
 {
 #if PLATFORM(MAC)
@@ -217,6 +217,9 @@ public:
     // Walk the tree looking for layers with 3d transforms. Useful in case you need
     // to know if there is non-affine content, e.g. for drawing into an image.
     bool has3DContent() const;
+
+    // The sum of the backing store estimates of the composited layers in this frame.
+    double backingStoreMemoryEstimate() const;
     
     // Most platforms connect compositing layer trees between iframes and their parent document.
     // Some (currently just Mac) allow iframes to do their own compositing.
@@ -713,7 +713,9 @@ Object.defineProperty(String.prototype, "hash",
 {
     get: function()
     {
-        // Matches the wtf/StringHasher.h (SuperFastHash) algorithm.
+        // This is the SuperFastHash algorithm that wtf/StringHasher.h used to implement.
+        // It no longer matches the native hash, but it is kept so that the settings
+        // keyed by it stay valid.
 
         // Arbitrary start value to avoid mapping all 0's to all 0's.
         const stringHashingStartValue = 0x9e3779b9;
@@ -327,6 +327,12 @@ void QWebSettingsPrivate::apply()
         value = attributes.value(QWebSettings::WebSecurityEnabled,
                                       global->attributes.value(QWebSettings::WebSecurityEnabled));
         settings->setWebSecurityEnabled(value);
+
+#if ENABLE(THREADED_HTML_PARSER)
+        value = attributes.value(QWebSettings::ThreadedHTMLParserEnabled,
+                                      global->attributes.value(QWebSettings::ThreadedHTMLParserEnabled));
+        settings->setThreadedHTMLParser(value);
+#endif
     } else {
         QList<QWebSettingsPrivate*> settings = *::allSettings();
         for (int i = 0; i < settings.count(); ++i)
@@ -542,6 +548,9 @@ QWebSettings* QWebSettings::globalSettings()
         or not. This is enabled by default.
     \value Accelerated2dCanvasEnabled Specifies whether the HTML5 2D canvas should be a OpenGL framebuffer.
         This makes many painting operations faster, but slows down pixel access. This is disabled by default.
+    \value ThreadedHTMLParserEnabled Specifies whether HTML documents are tokenized on a background thread,
+        which keeps the main thread responsive while large pages are parsed. This is enabled by default.
+        (This value was introduced in 5.5.)
 */
 
 /*!
@@ -600,6 +609,7 @@ QWebSettings::QWebSettings()
     d->attributes.insert(QWebSettings::RepaintCounter, false);
     d->attributes.insert(QWebSettings::DebugBorder, false);
     d->attributes.insert(QWebSettings::Accelerated2dCanvasEnabled, true);
+    d->attributes.insert(QWebSettings::ThreadedHTMLParserEnabled, true);
     d->offlineStorageDefaultQuota = 5 * 1024 * 1024;
     d->defaultTextEncoding = QLatin1String("iso-8859-1");
     d->thirdPartyCookiePolicy = AlwaysAllowThirdPartyCookies;
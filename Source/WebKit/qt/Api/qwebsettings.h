@@ -90,7 +90,8 @@ public:
         RepaintCounter,
         DebugBorder,
         WebSecurityEnabled,
-        Accelerated2dCanvasEnabled
+        Accelerated2dCanvasEnabled,
+        ThreadedHTMLParserEnabled
     };
     enum WebGraphic {
         MissingImageGraphic,
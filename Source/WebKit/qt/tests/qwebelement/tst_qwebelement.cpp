@@ -72,6 +72,25 @@ private Q_SLOTS:
     void hasSetFocus();
     void render();
     void addElementToHead();
+    void parserInsertedNodesAreRendered();
+    void findAllDescendantBacktracking();
+    void findAllAttributeOperators();
+    void findAllQuirksModeCaseFolding();
+    void classNameIndexKeepsDocumentOrder();
+    void innerHTMLMatchesTreeBuilder_data();
+    void innerHTMLMatchesTreeBuilder();
+    void innerHTMLAssociatesFormOwner();
+    void liveListsAfterInsertion();
+    void mutationRecordsCoalescedForTwoObservers();
+    void presentationAttributeStyleOfClones();
+    void presentationAttributeStyleOfSharedAttributes();
+    void highFrequencyEventDispatch_data();
+    void highFrequencyEventDispatch();
+    void eventListenerAddedAfterFirstDispatch_data();
+    void eventListenerAddedAfterFirstDispatch();
+    void cachedEventPathAfterReparenting();
+    void cachedEventPathAfterShadowTreeChange();
+    void scrollEventsReachLateListeners();
 
 private:
     QWebView* m_view;
@@ -1076,5 +1095,540 @@ void tst_QWebElement::addElementToHead()
     QCOMPARE(head.toInnerXml(), append);
 }
 
+void tst_QWebElement::parserInsertedNodesAreRendered()
+{
+    // The text written by each script is merged with the text that follows it in the markup,
+    // once before and once after layout has created a renderer for the written text.
+    m_mainFrame->setHtml("<html><body>"
+        "<p id='paragraph'>paragraph</p>"
+        "<script>var heightWhileParsing = document.getElementById('paragraph').offsetHeight;</script>"
+        "<span id='appendedBeforeLayout'><script>document.write('abc');</script>def</span><br>"
+        "<span id='appendedAfterLayout'><script>document.write('abc'); document.body.offsetWidth;</script>def</span><br>"
+        "<span id='parsedWhole'>abcdef</span>"
+        "<div id='hidden' style='display: none'>hidden</div>"
+        "</body></html>");
+
+    QVERIFY(m_mainFrame->evaluateJavaScript("heightWhileParsing").toInt() > 0);
+
+    QWebElement whole = m_mainFrame->findFirstElement("#parsedWhole");
+    int wholeWidth = whole.evaluateJavaScript("this.offsetWidth").toInt();
+    QVERIFY(wholeWidth > 0);
+    QWebElement beforeLayout = m_mainFrame->findFirstElement("#appendedBeforeLayout");
+    QCOMPARE(beforeLayout.toPlainText(), QString("abcdef"));
+    QCOMPARE(beforeLayout.evaluateJavaScript("this.offsetWidth").toInt(), wholeWidth);
+    QWebElement afterLayout = m_mainFrame->findFirstElement("#appendedAfterLayout");
+    QCOMPARE(afterLayout.toPlainText(), QString("abcdef"));
+    QCOMPARE(afterLayout.evaluateJavaScript("this.offsetWidth").toInt(), wholeWidth);
+
+    QWebElement hidden = m_mainFrame->findFirstElement("#hidden");
+    QCOMPARE(hidden.evaluateJavaScript("this.offsetHeight").toInt(), 0);
+    hidden.setStyleProperty("display", "block");
+    QVERIFY(hidden.evaluateJavaScript("this.offsetHeight").toInt() > 0);
+}
+
+static QString idsOf(const QWebElementCollection& collection)
+{
+    QStringList ids;
+    foreach(QWebElement element, collection)
+        ids.append(element.attribute("id"));
+    return ids.join(" ");
+}
+
+void tst_QWebElement::findAllDescendantBacktracking()
+{
+    m_mainFrame->setHtml("<!DOCTYPE html><html><body>"
+        "<div class='a' id='outer'><div id='middle'><p class='b'><span id='s1'></span></p>"
+        "<div class='b'><section><span id='s2'></span></section></div></div></div>"
+        "<div class='b' id='lone'><span id='s3'></span></div>"
+        "</body></html>");
+    QWebElement document = m_mainFrame->documentElement();
+
+    // The nearest .b ancestor of #s2 has no .a parent, so .a has to be found further up.
+    QCOMPARE(idsOf(document.findAll(".a .b span")), QString("s1 s2"));
+    // #s1's parent is the .b, whose parent #middle is not .a; the whole child chain has to be retried.
+    QCOMPARE(idsOf(document.findAll(".a > .b span")), QString());
+    QCOMPARE(idsOf(document.findAll("#middle > .b span")), QString("s1 s2"));
+    QCOMPARE(idsOf(document.findAll(".a > div > .b > span")), QString("s1"));
+    QCOMPARE(idsOf(document.findAll("div .b > span")), QString("s1"));
+    QCOMPARE(idsOf(document.findAll("body > div > div span")), QString("s1 s2"));
+    QCOMPARE(idsOf(document.findAll("body > .b span")), QString("s3"));
+    QCOMPARE(document.findFirst(".a div span").attribute("id"), QString("s1"));
+    QCOMPARE(document.findFirst("section span").attribute("id"), QString("s2"));
+    QVERIFY(document.findFirst("p div span").isNull());
+}
+
+void tst_QWebElement::findAllAttributeOperators()
+{
+    m_mainFrame->setHtml("<!DOCTYPE html><html><body>"
+        "<input id='i1' type='TEXT' name='first' lang='en-US' title='one two'>"
+        "<input id='i2' type='text' name='First' lang='en' title='two'>"
+        "<input id='i3' name='' lang='fr'>"
+        "</body></html>");
+    QWebElement document = m_mainFrame->documentElement();
+
+    QCOMPARE(idsOf(document.findAll("[name]")), QString("i1 i2 i3"));
+    QCOMPARE(idsOf(document.findAll("input[name='first']")), QString("i1"));
+    QCOMPARE(idsOf(document.findAll("[name='']")), QString("i3"));
+    // The values of some HTML attributes, like type, are compared case-insensitively.
+    QCOMPARE(idsOf(document.findAll("[type='text']")), QString("i1 i2"));
+    QCOMPARE(idsOf(document.findAll("[lang|='en']")), QString("i1 i2"));
+    QCOMPARE(idsOf(document.findAll("[title~='two']")), QString("i1 i2"));
+    QCOMPARE(idsOf(document.findAll("[title^='one']")), QString("i1"));
+    QCOMPARE(idsOf(document.findAll("[name$='st']")), QString("i1 i2"));
+    QCOMPARE(idsOf(document.findAll("[name*='irs']")), QString("i1 i2"));
+    QCOMPARE(idsOf(document.findAll("body > [name='First'][lang]")), QString("i2"));
+}
+
+void tst_QWebElement::findAllQuirksModeCaseFolding()
+{
+    static const char* markup = "<html><body><div id='Container' class='Box'><p id='para' class='Item'></p></div></body></html>";
+
+    // Without a doctype the document is in quirks mode, where ids and classes match case-insensitively.
+    m_mainFrame->setHtml(markup);
+    QWebElement document = m_mainFrame->documentElement();
+    QCOMPARE(idsOf(document.findAll("#container p")), QString("para"));
+    QCOMPARE(idsOf(document.findAll(".box > .item")), QString("para"));
+    QCOMPARE(idsOf(document.findAll("DIV.BOX P#PARA")), QString("para"));
+
+    m_mainFrame->setHtml(QString("<!DOCTYPE html>") + markup);
+    document = m_mainFrame->documentElement();
+    QCOMPARE(idsOf(document.findAll("#container p")), QString());
+    QCOMPARE(idsOf(document.findAll(".box > .item")), QString());
+    QCOMPARE(idsOf(document.findAll("#Container > .Item")), QString("para"));
+    QCOMPARE(idsOf(document.findAll("DIV.Box P#para")), QString("para"));
+}
+
+void tst_QWebElement::classNameIndexKeepsDocumentOrder()
+{
+    m_mainFrame->setHtml("<!DOCTYPE html><html><body><div id='container'><p id='a' class='x'></p><p id='b' class='x'></p></div></body></html>");
+    QWebElement document = m_mainFrame->documentElement();
+    QCOMPARE(idsOf(document.findAll(".x")), QString("a b"));
+
+    // Appending keeps the indexed list, inserting in the middle rebuilds it.
+    m_mainFrame->evaluateJavaScript("var container = document.getElementById('container');"
+        "var c = document.createElement('p'); c.id = 'c'; c.className = 'x'; container.appendChild(c);");
+    QCOMPARE(idsOf(document.findAll(".x")), QString("a b c"));
+    m_mainFrame->evaluateJavaScript("var d = document.createElement('p'); d.id = 'd'; d.className = 'x';"
+        "container.insertBefore(d, document.getElementById('b'));");
+    QCOMPARE(idsOf(document.findAll(".x")), QString("a d b c"));
+
+    // Removing the last element keeps the list, removing any other rebuilds it.
+    m_mainFrame->evaluateJavaScript("container.removeChild(c);");
+    QCOMPARE(idsOf(document.findAll(".x")), QString("a d b"));
+    m_mainFrame->evaluateJavaScript("container.removeChild(d);");
+    QCOMPARE(idsOf(document.findAll(".x")), QString("a b"));
+    m_mainFrame->evaluateJavaScript("document.getElementById('a').className = 'y';");
+    QCOMPARE(idsOf(document.findAll(".x")), QString("b"));
+    m_mainFrame->evaluateJavaScript("document.getElementById('a').className = 'x';");
+    QCOMPARE(idsOf(document.findAll(".x")), QString("a b"));
+    QCOMPARE(m_mainFrame->evaluateJavaScript("document.getElementsByClassName('x').length").toInt(), 2);
+}
+
+static const char* fragmentParsingTestPage =
+    "<!DOCTYPE html><html><body><form id='form'>"
+    // The fast path handles <div> contexts. <blockquote> is outside its tag set, so the tree builder parses it.
+    "<div id='fast'></div><blockquote id='treeBuilder'></blockquote>"
+    "</form><script>"
+    "function dump(node) {"
+    "    if (node.nodeType != Node.ELEMENT_NODE)"
+    "        return node.nodeType + ':' + JSON.stringify(node.nodeValue);"
+    "    var result = node.namespaceURI + ':' + node.localName;"
+    "    for (var i = 0; i < node.attributes.length; ++i)"
+    "        result += ' ' + node.attributes[i].name + '=' + JSON.stringify(node.attributes[i].value);"
+    "    return result + '[' + dumpChildren(node) + ']';"
+    "}"
+    "function dumpChildren(node) {"
+    "    var result = [];"
+    "    for (var child = node.firstChild; child; child = child.nextSibling)"
+    "        result.push(dump(child));"
+    "    return result.join(',');"
+    "}"
+    "</script></body></html>";
+
+static QString toJavaScriptStringLiteral(QString string)
+{
+    string.replace('\\', "\\\\").replace('\'', "\\'").replace('\n', "\\n").replace('\r', "\\r");
+    return QString("'%1'").arg(string);
+}
+
+void tst_QWebElement::innerHTMLMatchesTreeBuilder_data()
+{
+    QTest::addColumn<QString>("markup");
+
+    QTest::newRow("empty") << QString();
+    QTest::newRow("text") << QString("plain text");
+    QTest::newRow("text with references") << QString("a &lt; b &amp;&amp; c &gt; d");
+    QTest::newRow("whitespace") << QString(" \ttab\nnewline  ");
+    QTest::newRow("non-ASCII text") << QString::fromUtf8("caf\xc3\xa9 \xe2\x98\x83");
+    QTest::newRow("phrasing") << QString("<p>para <b>bold <i>both</i></b> <a href='x'>link</a> <code>c</code></p>");
+    QTest::newRow("lists") << QString("<ul><li>one</li><li>two <span>three</span></li></ul><ol><li>four</li></ol>");
+    QTest::newRow("sections") << QString("<section><article><header><h1>title</h1></header><p>body</p><footer>f</footer></article></section>");
+    QTest::newRow("void elements") << QString("a<br>b<wbr>c<hr><img src='data:,' alt='i'>d");
+    QTest::newRow("self-closing void") << QString("a<br/>b<img src='data:,'/>");
+    QTest::newRow("deep nesting") << QString("<div><div><div><span><b><i><u>x</u></i></b></span></div></div></div>");
+    QTest::newRow("attributes") << QString("<span class='a b' id=\"c\" title=unquoted data-x='1' hidden>t</span>");
+    QTest::newRow("empty attribute values") << QString("<div title='' lang=\"\"></div>");
+    QTest::newRow("attribute reference") << QString("<span title='a &amp; b'>x</span>");
+    QTest::newRow("uppercase attribute") << QString("<span TITLE='upper'>x</span>");
+    QTest::newRow("duplicate attribute") << QString("<span title='1' title='2'>x</span>");
+    QTest::newRow("event handler attribute") << QString("<span onclick='void 0'>x</span>");
+    QTest::newRow("implied paragraph end") << QString("<p>one<p>two<div>three</div>");
+    QTest::newRow("implied list item end") << QString("<ul><li>a<li>b</ul>");
+    QTest::newRow("nested headings") << QString("<h1><h2>x</h2></h1>");
+    QTest::newRow("nested anchors") << QString("<a href='1'>a<a href='2'>b</a></a>");
+    QTest::newRow("misnested formatting") << QString("<b><i>misnested</b> after</i>");
+    QTest::newRow("self-closing non-void") << QString("<span/>after");
+    QTest::newRow("unclosed element") << QString("<div>unclosed <span>too");
+    QTest::newRow("stray end tag") << QString("</span>stray</div>");
+    QTest::newRow("uppercase tags") << QString("<DIV>upper</Div>");
+    QTest::newRow("carriage return") << QString("a\rb\r\nc");
+    QTest::newRow("comment") << QString("<!-- comment -->x");
+    QTest::newRow("table") << QString("<table><tr><td>cell</td></tr></table>");
+    QTest::newRow("script") << QString("<script>var x;</script>");
+    QTest::newRow("form controls") << QString("<label>name <input name='n'></label><select><option>o</option></select>");
+    QTest::newRow("svg") << QString("<svg><circle r='1'/></svg>");
+}
+
+void tst_QWebElement::innerHTMLMatchesTreeBuilder()
+{
+    QFETCH(QString, markup);
+
+    m_mainFrame->setHtml(fragmentParsingTestPage);
+    QString literal = toJavaScriptStringLiteral(markup);
+    m_mainFrame->evaluateJavaScript("document.getElementById('fast').innerHTML = " + literal + ";"
+        "document.getElementById('treeBuilder').innerHTML = " + literal + ";");
+
+    QString fastDump = m_mainFrame->evaluateJavaScript("dumpChildren(document.getElementById('fast'))").toString();
+    QString treeBuilderDump = m_mainFrame->evaluateJavaScript("dumpChildren(document.getElementById('treeBuilder'))").toString();
+    QCOMPARE(fastDump, treeBuilderDump);
+    QCOMPARE(fastDump.isEmpty(), markup.isEmpty());
+}
+
+void tst_QWebElement::innerHTMLAssociatesFormOwner()
+{
+    m_mainFrame->setHtml(fragmentParsingTestPage);
+    m_mainFrame->evaluateJavaScript("document.getElementById('fast').innerHTML = \"<span><img name='picture' src='data:,'></span>\";");
+    QVERIFY(m_mainFrame->evaluateJavaScript("document.getElementById('form').picture === document.querySelector('#fast img')").toBool());
+}
+
+void tst_QWebElement::liveListsAfterInsertion()
+{
+    m_mainFrame->setHtml("<!DOCTYPE html><html><body><div id='container'><p id='p1'></p><p id='p2'></p></div></body></html>");
+    m_mainFrame->evaluateJavaScript("var container = document.getElementById('container');"
+        "var paragraphs = container.getElementsByTagName('p');"
+        "var children = container.children;"
+        "var divs = document.getElementsByTagName('div');"
+        "function ids(list) { var result = []; for (var i = 0; i < list.length; ++i) result.push(list[i].id); return result.join(' '); }"
+        "function create(tagName, id) { var element = document.createElement(tagName); element.id = id; return element; }");
+    QCOMPARE(m_mainFrame->evaluateJavaScript("ids(paragraphs)").toString(), QString("p1 p2"));
+    QCOMPARE(m_mainFrame->evaluateJavaScript("ids(children)").toString(), QString("p1 p2"));
+
+    // Appending with the length and the last item cached.
+    m_mainFrame->evaluateJavaScript("paragraphs[1]; children[1]; container.appendChild(create('p', 'p3'));");
+    QCOMPARE(m_mainFrame->evaluateJavaScript("paragraphs.length").toInt(), 3);
+    QCOMPARE(m_mainFrame->evaluateJavaScript("paragraphs[2].id").toString(), QString("p3"));
+    QCOMPARE(m_mainFrame->evaluateJavaScript("children.length").toInt(), 3);
+    QCOMPARE(m_mainFrame->evaluateJavaScript("children[2].id").toString(), QString("p3"));
+
+    // Inserting before the cached item shifts it.
+    m_mainFrame->evaluateJavaScript("paragraphs[1]; children[1]; container.insertBefore(create('p', 'p0'), document.getElementById('p1'));");
+    QCOMPARE(m_mainFrame->evaluateJavaScript("paragraphs[1].id").toString(), QString("p1"));
+    QCOMPARE(m_mainFrame->evaluateJavaScript("children[1].id").toString(), QString("p1"));
+    QCOMPARE(m_mainFrame->evaluateJavaScript("ids(paragraphs)").toString(), QString("p0 p1 p2 p3"));
+
+    // A subtree counts all its matches for descendant lists, but only its root for children.
+    m_mainFrame->evaluateJavaScript("paragraphs[3]; children[3]; var section = create('section', 's');"
+        "section.appendChild(create('p', 'nested1')); section.appendChild(create('p', 'nested2'));"
+        "container.insertBefore(section, document.getElementById('p2'));");
+    QCOMPARE(m_mainFrame->evaluateJavaScript("paragraphs.length").toInt(), 6);
+    QCOMPARE(m_mainFrame->evaluateJavaScript("paragraphs[3].id").toString(), QString("nested2"));
+    QCOMPARE(m_mainFrame->evaluateJavaScript("ids(paragraphs)").toString(), QString("p0 p1 nested1 nested2 p2 p3"));
+    QCOMPARE(m_mainFrame->evaluateJavaScript("children.length").toInt(), 5);
+    QCOMPARE(m_mainFrame->evaluateJavaScript("ids(children)").toString(), QString("p0 p1 s p2 p3"));
+
+    // Text and elements that do not match leave the lists alone.
+    m_mainFrame->evaluateJavaScript("paragraphs.length; children.length;"
+        "container.appendChild(document.createTextNode('text')); container.firstChild.appendChild(create('span', 'span'));");
+    QCOMPARE(m_mainFrame->evaluateJavaScript("paragraphs.length").toInt(), 6);
+    QCOMPARE(m_mainFrame->evaluateJavaScript("children.length").toInt(), 5);
+
+    // The shadow tree of a range input is built from divs, which a list rooted at the document must not count.
+    int divCount = m_mainFrame->evaluateJavaScript("divs.length").toInt();
+    m_mainFrame->evaluateJavaScript("var input = document.createElement('input'); container.appendChild(input); divs.length; divs[0]; input.type = 'range';");
+    QCOMPARE(m_mainFrame->evaluateJavaScript("divs.length").toInt(), divCount);
+    QCOMPARE(m_mainFrame->evaluateJavaScript("divs[0].id").toString(), QString("container"));
+    QCOMPARE(m_mainFrame->evaluateJavaScript("document.getElementsByTagName('div').length").toInt(), divCount);
+}
+
+void tst_QWebElement::mutationRecordsCoalescedForTwoObservers()
+{
+    m_mainFrame->setHtml("<!DOCTYPE html><html><body><div id='container'></div></body></html>");
+    // Both observers get the record for the first append. The first observer reads its node
+    // list and appends again before the second observer's records are delivered, so the second
+    // append is coalesced into a record that has already handed out its node list.
+    m_mainFrame->evaluateJavaScript("var container = document.getElementById('container');"
+        "var firstLog = [], secondLog = [];"
+        "function ids(nodes) { var result = []; for (var i = 0; i < nodes.length; ++i) result.push(nodes[i].id); return result.join(' '); }"
+        "function logRecords(log, records) { for (var i = 0; i < records.length; ++i) log.push(ids(records[i].addedNodes)); }"
+        "function create(id) { var element = document.createElement('span'); element.id = id; return element; }"
+        "var shouldAppendFromCallback = true;"
+        "var first = new WebKitMutationObserver(function(records) {"
+        "    logRecords(firstLog, records);"
+        "    if (shouldAppendFromCallback) {"
+        "        shouldAppendFromCallback = false;"
+        "        container.appendChild(create('b'));"
+        "    }"
+        "});"
+        "var second = new WebKitMutationObserver(function(records) { logRecords(secondLog, records); });"
+        "first.observe(container, { childList: true });"
+        "second.observe(container, { childList: true });"
+        "container.appendChild(create('a'));");
+
+    QCOMPARE(m_mainFrame->evaluateJavaScript("firstLog.join('|')").toString(), QString("a|b"));
+    QCOMPARE(m_mainFrame->evaluateJavaScript("secondLog.join('|')").toString(), QString("a b"));
+
+    // Appends made one call at a time are still reported as a single record.
+    m_mainFrame->evaluateJavaScript("firstLog = []; secondLog = [];"
+        "container.appendChild(create('c')); container.appendChild(create('d')); container.appendChild(create('e'));");
+    QCOMPARE(m_mainFrame->evaluateJavaScript("firstLog.join('|')").toString(), QString("c d e"));
+    QCOMPARE(m_mainFrame->evaluateJavaScript("secondLog.join('|')").toString(), QString("c d e"));
+}
+
+void tst_QWebElement::presentationAttributeStyleOfClones()
+{
+    m_mainFrame->setHtml("<!DOCTYPE html><html><body><div id='container'><img width='10' height='20'></div></body></html>");
+    // Clones share the original's attribute data, and with it the presentation attribute style.
+    m_mainFrame->evaluateJavaScript("var container = document.getElementById('container');"
+        "var original = container.firstChild;"
+        "var clones = [];"
+        "for (var i = 0; i < 3; ++i)"
+        "    clones.push(container.appendChild(original.cloneNode(false)));"
+        "function widths() {"
+        "    var result = [getComputedStyle(original).width];"
+        "    for (var i = 0; i < clones.length; ++i)"
+        "        result.push(getComputedStyle(clones[i]).width);"
+        "    return result.join(' ');"
+        "}");
+    QCOMPARE(m_mainFrame->evaluateJavaScript("widths()").toString(), QString("10px 10px 10px 10px"));
+    QCOMPARE(m_mainFrame->evaluateJavaScript("getComputedStyle(clones[2]).height").toString(), QString("20px"));
+
+    m_mainFrame->evaluateJavaScript("clones[1].setAttribute('width', '30');");
+    QCOMPARE(m_mainFrame->evaluateJavaScript("widths()").toString(), QString("10px 10px 30px 10px"));
+    m_mainFrame->evaluateJavaScript("original.removeAttribute('width');");
+    QCOMPARE(m_mainFrame->evaluateJavaScript("getComputedStyle(clones[0]).width").toString(), QString("10px"));
+    QCOMPARE(m_mainFrame->evaluateJavaScript("getComputedStyle(clones[2]).width").toString(), QString("10px"));
+}
+
+void tst_QWebElement::presentationAttributeStyleOfSharedAttributes()
+{
+    // The parser shares attribute data between elements with the same attributes, whatever their tag
+    // names, but the presentation attribute style depends on the tag name and namespace too.
+    m_mainFrame->setHtml("<!DOCTYPE html><html><body>"
+        "<img align='right'><div align='right'></div><img align='right'>"
+        "<p hidden></p><svg><a hidden><text>svg</text></a></svg><p hidden></p>"
+        "</body></html>");
+    m_mainFrame->evaluateJavaScript("function computed(selector, index, property) {"
+        "    return getComputedStyle(document.querySelectorAll(selector)[index]).getPropertyValue(property);"
+        "}");
+
+    QCOMPARE(m_mainFrame->evaluateJavaScript("computed('img', 0, 'float')").toString(), QString("right"));
+    QCOMPARE(m_mainFrame->evaluateJavaScript("computed('div', 0, 'float')").toString(), QString("none"));
+    QCOMPARE(m_mainFrame->evaluateJavaScript("computed('div', 0, 'text-align')").toString(), QString("-webkit-right"));
+    QCOMPARE(m_mainFrame->evaluateJavaScript("computed('img', 1, 'float')").toString(), QString("right"));
+
+    QCOMPARE(m_mainFrame->evaluateJavaScript("computed('p', 0, 'display')").toString(), QString("none"));
+    QCOMPARE(m_mainFrame->evaluateJavaScript("computed('svg a', 0, 'display')").toString(), QString("inline"));
+    QCOMPARE(m_mainFrame->evaluateJavaScript("computed('p', 1, 'display')").toString(), QString("none"));
+}
+
+// Logs each listener call as "name:phase:target", and dispatches synthetic events, whose type
+// is all that EventDispatcher looks at to decide whether the document listens for them.
+static const char eventLogScript[] =
+    "var log = [];"
+    "var lastEvent = null;"
+    "function record(name) {"
+    "    return function(event) { log.push(name + ':' + event.eventPhase + ':' + (event.target.id || event.target.nodeName)); };"
+    "}"
+    "function fire(target, type) {"
+    "    lastEvent = document.createEvent('Event');"
+    "    lastEvent.initEvent(type, true, true);"
+    "    return target.dispatchEvent(lastEvent);"
+    "}"
+    "function takeLog() { var result = log.join(' '); log = []; return result; }";
+
+static const char eventTargetHtml[] = "<!DOCTYPE html><html><body><div id='container'><span id='target'>target</span></div></body></html>";
+
+void tst_QWebElement::highFrequencyEventDispatch_data()
+{
+    QTest::addColumn<QString>("eventType");
+    QTest::newRow("mousemove") << "mousemove";
+    QTest::newRow("touchmove") << "touchmove";
+    QTest::newRow("scroll") << "scroll";
+}
+
+void tst_QWebElement::highFrequencyEventDispatch()
+{
+    QFETCH(QString, eventType);
+    const QString fireAtTarget = QString::fromLatin1("fire(document.getElementById('target'), '%1')").arg(eventType);
+
+    // Nothing listens for the type, so the walk over the event path is skipped, but the
+    // event still ends up targeted at the node it was dispatched to.
+    m_mainFrame->setHtml(eventTargetHtml);
+    m_mainFrame->evaluateJavaScript(eventLogScript);
+    QVERIFY(m_mainFrame->evaluateJavaScript(fireAtTarget).toBool());
+    QCOMPARE(m_mainFrame->evaluateJavaScript("lastEvent.target.id").toString(), QString("target"));
+    QCOMPARE(m_mainFrame->evaluateJavaScript("lastEvent.eventPhase").toInt(), 0);
+
+    // Window listeners run in both phases, and can cancel the event or keep it from bubbling.
+    m_mainFrame->setHtml(eventTargetHtml);
+    m_mainFrame->evaluateJavaScript(eventLogScript);
+    m_mainFrame->evaluateJavaScript(QString::fromLatin1("window.addEventListener('%1', record('capture'), true);"
+        "window.addEventListener('%1', record('bubble'), false);").arg(eventType));
+    QVERIFY(m_mainFrame->evaluateJavaScript(fireAtTarget).toBool());
+    QCOMPARE(m_mainFrame->evaluateJavaScript("takeLog()").toString(), QString("capture:1:target bubble:3:target"));
+    m_mainFrame->evaluateJavaScript(QString::fromLatin1("window.addEventListener('%1', function(event) { event.preventDefault(); }, false);").arg(eventType));
+    QVERIFY(!m_mainFrame->evaluateJavaScript(fireAtTarget).toBool());
+    QCOMPARE(m_mainFrame->evaluateJavaScript("takeLog()").toString(), QString("capture:1:target bubble:3:target"));
+    m_mainFrame->evaluateJavaScript(QString::fromLatin1("window.addEventListener('%1', function(event) { event.stopPropagation(); }, true);").arg(eventType));
+    QVERIFY(m_mainFrame->evaluateJavaScript(fireAtTarget).toBool());
+    QCOMPARE(m_mainFrame->evaluateJavaScript("takeLog()").toString(), QString("capture:1:target"));
+
+    // An on* attribute handler is a listener on its element.
+    m_mainFrame->setHtml(QString::fromLatin1("<!DOCTYPE html><html><body>"
+        "<div id='container' on%1=\"log.push('attribute:' + event.eventPhase + ':' + event.target.id)\"><span id='target'>target</span></div>"
+        "</body></html>").arg(eventType));
+    m_mainFrame->evaluateJavaScript(eventLogScript);
+    QVERIFY(m_mainFrame->evaluateJavaScript(fireAtTarget).toBool());
+    QCOMPARE(m_mainFrame->evaluateJavaScript("takeLog()").toString(), QString("attribute:3:target"));
+    QVERIFY(m_mainFrame->evaluateJavaScript(QString::fromLatin1("fire(document.getElementById('container'), '%1')").arg(eventType)).toBool());
+    QCOMPARE(m_mainFrame->evaluateJavaScript("takeLog()").toString(), QString("attribute:2:container"));
+}
+
+void tst_QWebElement::eventListenerAddedAfterFirstDispatch_data()
+{
+    highFrequencyEventDispatch_data();
+}
+
+void tst_QWebElement::eventListenerAddedAfterFirstDispatch()
+{
+    QFETCH(QString, eventType);
+    const QString fireAtTarget = QString::fromLatin1("fire(document.getElementById('target'), '%1')").arg(eventType);
+
+    m_mainFrame->setHtml(eventTargetHtml);
+    m_mainFrame->evaluateJavaScript(eventLogScript);
+    QVERIFY(m_mainFrame->evaluateJavaScript(fireAtTarget).toBool());
+    QCOMPARE(m_mainFrame->evaluateJavaScript("takeLog()").toString(), QString());
+
+    // The next dispatch to the same node reuses its event path, and sees the new listeners.
+    m_mainFrame->evaluateJavaScript(QString::fromLatin1("document.addEventListener('%1', record('document'), true);"
+        "document.getElementById('target').addEventListener('%1', record('target'), false);"
+        "document.getElementById('container').addEventListener('%1', record('container'), false);").arg(eventType));
+    for (int i = 0; i < 2; ++i) {
+        QVERIFY(m_mainFrame->evaluateJavaScript(fireAtTarget).toBool());
+        QCOMPARE(m_mainFrame->evaluateJavaScript("takeLog()").toString(), QString("document:1:target target:2:target container:3:target"));
+    }
+
+    // So does an attribute handler set from script after the first dispatch.
+    m_mainFrame->setHtml(eventTargetHtml);
+    m_mainFrame->evaluateJavaScript(eventLogScript);
+    QVERIFY(m_mainFrame->evaluateJavaScript(fireAtTarget).toBool());
+    m_mainFrame->evaluateJavaScript(QString::fromLatin1("document.getElementById('container').on%1 = record('property');").arg(eventType));
+    QVERIFY(m_mainFrame->evaluateJavaScript(fireAtTarget).toBool());
+    QCOMPARE(m_mainFrame->evaluateJavaScript("takeLog()").toString(), QString("property:3:target"));
+}
+
+void tst_QWebElement::cachedEventPathAfterReparenting()
+{
+    m_mainFrame->setHtml("<!DOCTYPE html><html><body><div id='first'><span id='target'>target</span></div><div id='second'></div></body></html>");
+    m_mainFrame->evaluateJavaScript(eventLogScript);
+    m_mainFrame->evaluateJavaScript("var target = document.getElementById('target');"
+        "var first = document.getElementById('first');"
+        "var second = document.getElementById('second');"
+        "first.addEventListener('mousemove', record('first'), false);"
+        "second.addEventListener('mousemove', record('second'), false);");
+
+    m_mainFrame->evaluateJavaScript("fire(target, 'mousemove'); fire(target, 'mousemove');");
+    QCOMPARE(m_mainFrame->evaluateJavaScript("takeLog()").toString(), QString("first:3:target first:3:target"));
+
+    m_mainFrame->evaluateJavaScript("second.appendChild(target); fire(target, 'mousemove');");
+    QCOMPARE(m_mainFrame->evaluateJavaScript("takeLog()").toString(), QString("second:3:target"));
+
+    // Out of the document, the event only reaches the node itself.
+    m_mainFrame->evaluateJavaScript("second.removeChild(target);"
+        "target.addEventListener('mousemove', record('target'), false);"
+        "fire(target, 'mousemove');");
+    QCOMPARE(m_mainFrame->evaluateJavaScript("takeLog()").toString(), QString("target:2:target"));
+
+    m_mainFrame->evaluateJavaScript("first.appendChild(target); fire(target, 'mousemove');");
+    QCOMPARE(m_mainFrame->evaluateJavaScript("takeLog()").toString(), QString("target:2:target first:3:target"));
+
+    // Moving an ancestor changes the path as well.
+    m_mainFrame->evaluateJavaScript("second.appendChild(first); fire(target, 'mousemove');");
+    QCOMPARE(m_mainFrame->evaluateJavaScript("takeLog()").toString(), QString("target:2:target first:3:target second:3:target"));
+}
+
+static void moveMouse(QWebPage* page, const QPoint& position)
+{
+    QMouseEvent event(QEvent::MouseMove, position, Qt::NoButton, Qt::NoButton, Qt::NoModifier);
+    page->event(&event);
+}
+
+void tst_QWebElement::cachedEventPathAfterShadowTreeChange()
+{
+    m_page->setViewportSize(QSize(800, 600));
+    m_mainFrame->setHtml("<!DOCTYPE html><html><body>"
+        "<input id='input' style='width: 200px; height: 40px'>"
+        "<details id='details' open><summary id='summary'>summary</summary><p id='content'>content</p></details>"
+        "</body></html>");
+    m_mainFrame->evaluateJavaScript(eventLogScript);
+    m_mainFrame->evaluateJavaScript("document.getElementById('input').addEventListener('mousemove', record('input'), false);"
+        "document.getElementById('details').addEventListener('mousemove', record('details'), false);"
+        "document.addEventListener('mousemove', record('document'), false);");
+
+    // The mouse is over nodes in the input's user agent shadow tree, which changing the type
+    // replaces. Listeners outside it always see the input as the target.
+    QWebElement input = m_mainFrame->findFirstElement("#input");
+    const char* const types[] = { "text", "range", "text" };
+    for (unsigned i = 0; i < sizeof(types) / sizeof(types[0]); ++i) {
+        input.setAttribute("type", types[i]);
+        QRect geometry = input.geometry();
+        QVERIFY(geometry.width() > 10);
+        moveMouse(m_page, geometry.center() - QPoint(geometry.width() / 4, 0));
+        moveMouse(m_page, geometry.center() + QPoint(geometry.width() / 4, 0));
+        QCOMPARE(m_mainFrame->evaluateJavaScript("takeLog()").toString(), QString("input:2:input document:3:input input:2:input document:3:input"));
+    }
+
+    // The details element distributes its children to insertion points in its shadow tree.
+    // A new first summary moves the old one from the summary insertion point to the other.
+    m_mainFrame->evaluateJavaScript("var summary = document.getElementById('summary'); fire(summary, 'mousemove'); fire(summary, 'mousemove');");
+    QCOMPARE(m_mainFrame->evaluateJavaScript("takeLog()").toString(), QString("details:3:summary document:3:summary details:3:summary document:3:summary"));
+    m_mainFrame->evaluateJavaScript("var details = document.getElementById('details');"
+        "var newSummary = document.createElement('summary');"
+        "details.insertBefore(newSummary, details.firstChild);"
+        "fire(summary, 'mousemove');");
+    QCOMPARE(m_mainFrame->evaluateJavaScript("takeLog()").toString(), QString("details:3:summary document:3:summary"));
+    m_mainFrame->evaluateJavaScript("details.removeChild(newSummary); details.removeAttribute('open'); fire(summary, 'mousemove');");
+    QCOMPARE(m_mainFrame->evaluateJavaScript("takeLog()").toString(), QString("details:3:summary document:3:summary"));
+}
+
+void tst_QWebElement::scrollEventsReachLateListeners()
+{
+    m_page->setViewportSize(QSize(400, 300));
+    m_mainFrame->setHtml("<!DOCTYPE html><html>"
+        "<body onscroll=\"log.push('window:' + event.eventPhase + ':' + event.target.nodeName)\"><div style='height: 5000px'></div></body>"
+        "</html>");
+    m_mainFrame->evaluateJavaScript(eventLogScript);
+    QVERIFY(m_mainFrame->evaluateJavaScript("document.body.offsetHeight").toInt() > 300);
+
+    // The body's onscroll attribute is a window listener, and scroll events fired at the
+    // document bubble to the window.
+    m_mainFrame->setScrollPosition(QPoint(0, 100));
+    QTRY_COMPARE(m_mainFrame->evaluateJavaScript("log.join(' ')").toString(), QString("window:3:#document"));
+
+    m_mainFrame->evaluateJavaScript("log = []; document.addEventListener('scroll', record('document'), false);");
+    m_mainFrame->setScrollPosition(QPoint(0, 200));
+    QTRY_COMPARE(m_mainFrame->evaluateJavaScript("log.join(' ')").toString(), QString("document:2:#document window:3:#document"));
+}
+
 QTEST_MAIN(tst_QWebElement)
 #include "tst_qwebelement.moc"
@@ -195,6 +195,7 @@ private Q_SLOTS:
     void openWindowDefaultSize();
     void cssMediaTypeGlobalSetting();
     void cssMediaTypePageSetting();
+    void threadedHTMLParser();
 
 #ifdef Q_OS_MAC
     void macCopyUnicodeToClipboard();
@@ -3520,5 +3521,60 @@ void tst_QWebPage::cssMediaTypePageSetting()
     QVERIFY(m_view->page()->settings()->cssMediaType() == "screen"); 
 }
 
+static QString largeDocument()
+{
+    QString html = QLatin1String("<!DOCTYPE html><html><head><title>Large document</title></head><body><table id='rows'>");
+
+    // Enough small tokens to fill the background parser's chunks up to their largest size.
+    for (int i = 0; i < 3000; ++i)
+        html += QString::fromLatin1("<tr class='row%1'><td>%2</td><td><a href='#%2'>link &amp; %2</a></td></tr>").arg(i % 7).arg(i);
+    html += QLatin1String("</table>");
+
+    // Single tokens that are larger than a chunk's character limit.
+    html += QLatin1String("<pre id='text'>") + QString(100000, QLatin1Char('x')) + QLatin1String("</pre>");
+    html += QLatin1String("<div id='attribute' title='") + QString(70000, QLatin1Char('y')) + QLatin1String("'>attribute</div>");
+
+    // The textarea turns the markup the background parser has already tokenized into text,
+    // so the main thread has to roll it back.
+    html += QLatin1String("<script>document.write('<textarea id=written>');</script><p>inside the textarea</p></textarea>");
+
+    for (int i = 0; i < 2000; ++i)
+        html += QString::fromLatin1("<ul><li id='item%1'>item <b>%1</b><li>second<br>line</ul>").arg(i);
+    html += QLatin1String("</body></html>");
+    return html;
+}
+
+void tst_QWebPage::threadedHTMLParser()
+{
+    const QString html = largeDocument();
+    // Documents loaded from about:blank are always parsed on the main thread.
+    const QUrl baseUrl(QLatin1String("http://www.example.com/"));
+    QSignalSpy loadSpy(m_view, SIGNAL(loadFinished(bool)));
+    QWebFrame* frame = m_page->mainFrame();
+
+    QVERIFY(m_page->settings()->testAttribute(QWebSettings::ThreadedHTMLParserEnabled));
+    m_view->setHtml(html, baseUrl);
+    QTRY_COMPARE(loadSpy.count(), 1);
+    QVERIFY(loadSpy.at(0).first().toBool());
+    const QString threadedDOM = frame->documentElement().toOuterXml();
+
+    m_page->settings()->setAttribute(QWebSettings::ThreadedHTMLParserEnabled, false);
+    m_view->setHtml(html, baseUrl);
+    QTRY_COMPARE(loadSpy.count(), 2);
+    QVERIFY(loadSpy.at(1).first().toBool());
+    const QString mainThreadDOM = frame->documentElement().toOuterXml();
+
+    QCOMPARE(threadedDOM.length(), mainThreadDOM.length());
+    QVERIFY(threadedDOM == mainThreadDOM);
+
+    QCOMPARE(frame->findAllElements("tr").count(), 3000);
+    QCOMPARE(frame->findAllElements("li").count(), 4000);
+    QCOMPARE(frame->findFirstElement("#text").toPlainText().length(), 100000);
+    QCOMPARE(frame->findFirstElement("#attribute").attribute("title").length(), 70000);
+    QCOMPARE(frame->findFirstElement("#written").evaluateJavaScript("this.value").toString(), QString::fromLatin1("<p>inside the textarea</p>"));
+
+    m_page->settings()->resetAttribute(QWebSettings::ThreadedHTMLParserEnabled);
+}
+
 QTEST_MAIN(tst_QWebPage)
 #include "tst_qwebpage.moc"
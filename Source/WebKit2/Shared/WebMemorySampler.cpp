@@ -30,6 +30,7 @@
 
 #include <stdio.h>
 #include <unistd.h>
+#include <wtf/MemoryUsageRegistry.h>
 #include <wtf/text/CString.h>
 #include <wtf/text/StringBuilder.h>
 
@@ -154,6 +155,16 @@ void WebMemorySampler::writeHeaders()
     writeToFile(m_sampleLogFile, utf8String.data(), utf8String.length());
 }
 
+void WebMemorySampler::appendMemoryUsageReport(WebMemoryStatistics& stats) const
+{
+    MemoryUsageReport report;
+    MemoryUsageRegistry::shared().collect(report);
+    for (size_t i = 0; i < report.entries().size(); ++i) {
+        stats.keys.append(String(report.entries()[i].category));
+        stats.values.append(report.entries()[i].bytes);
+    }
+}
+
 void WebMemorySampler::sampleTimerFired(Timer<WebMemorySampler>*)
 {
     sendMemoryPressureEvent();
@@ -93,6 +93,7 @@ private:
     SystemMallocStats sampleSystemMalloc() const;
     size_t sampleProcessCommittedBytes() const;
     WebMemoryStatistics sampleWebKit() const;
+    void appendMemoryUsageReport(WebMemoryStatistics&) const;
     String processName() const;
     
     WebCore::PlatformFileHandle m_sampleLogFile;
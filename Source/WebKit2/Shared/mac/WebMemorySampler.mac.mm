@@ -173,6 +173,8 @@ WebMemoryStatistics WebMemorySampler::sampleWebKit() const
     webKitMemoryStats.values.append(globalMemoryStats.JITBytes);
     webKitMemoryStats.keys.append(String("Resident Size"));
     webKitMemoryStats.values.append(residentSize);
+
+    appendMemoryUsageReport(webKitMemoryStats);
     
     return webKitMemoryStats;
 }
@@ -70,6 +70,7 @@
 #include <WebCore/Language.h>
 #include <WebCore/MemoryCache.h>
 #include <WebCore/MemoryPressureHandler.h>
+#include <WebCore/MemoryUsageReporters.h>
 #include <WebCore/Page.h>
 #include <WebCore/PageCache.h>
 #include <WebCore/PageGroup.h>
@@ -1106,6 +1107,9 @@ void WebProcess::setEnhancedAccessibility(bool flag)
 void WebProcess::startMemorySampler(const SandboxExtension::Handle& sampleLogFileHandle, const String& sampleLogFilePath, const double interval)
 {
 #if ENABLE(MEMORY_SAMPLER)    
+    // The sample headers name the registry's categories, so the reporters must be registered first.
+    // Only the WebProcess registers them; the UIProcess has no WebCore pages or caches to report.
+    registerMemoryUsageReporters();
     WebMemorySampler::shared()->start(sampleLogFileHandle, sampleLogFilePath, interval);
 #endif
 }
@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <parser/SourceCode.h>
+#include <runtime/Completion.h>
+#include <runtime/JSGlobalObject.h>
+#include <runtime/JSLock.h>
+#include <runtime/Operations.h>
+#include <runtime/VM.h>
+#include <stdlib.h>
+#include <time.h>
+#include <wtf/DateMath.h>
+#include <wtf/text/WTFString.h>
+
+using namespace JSC;
+
+namespace TestWebKitAPI {
+
+class DateTest {
+public:
+    DateTest()
+        : m_vm(VM::create(LargeHeap))
+        , m_locker(m_vm.get())
+    {
+        m_globalObject = JSGlobalObject::create(*m_vm, JSGlobalObject::createStructure(*m_vm, jsNull()));
+        gcProtect(m_globalObject);
+    }
+
+    ~DateTest()
+    {
+        gcUnprotect(m_globalObject);
+        // Leave the last reference to the locker, so the VM is destroyed before its lock is released.
+        m_vm.clear();
+    }
+
+    JSValue evaluate(const String& script)
+    {
+        JSValue exception;
+        JSValue result = JSC::evaluate(m_globalObject->globalExec(), makeSource(script), JSValue(), &exception);
+        EXPECT_FALSE(exception);
+        return result;
+    }
+
+    double evaluateNumber(const String& script)
+    {
+        JSValue result = evaluate(script);
+        EXPECT_TRUE(result.isNumber());
+        return result.isNumber() ? result.asNumber() : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    String evaluateString(const String& script)
+    {
+        return evaluate(script).toWTFString(m_globalObject->globalExec());
+    }
+
+private:
+    RefPtr<VM> m_vm;
+    JSLockHolder m_locker;
+    JSGlobalObject* m_globalObject;
+};
+
+static double utc(int year, int month, int day, int hours = 0)
+{
+    return WTF::dateToDaysFrom1970(year, month, day) * msPerDay + hours * msPerHour;
+}
+
+// Date.parse() tries the fast ISO parser first; whatever it accepts must come out the same
+// as it would from the general ES5 parser, and whatever it rejects must still be parsed.
+static void expectSameAsGeneralParser(DateTest& test, const char* dateString)
+{
+    double expected = WTF::parseES5DateFromNullTerminatedCharacters(dateString);
+    if (std::isnan(expected))
+        expected = WTF::parseDateFromNullTerminatedCharacters(dateString);
+
+    double parsed = test.evaluateNumber(String::format("Date.parse('%s')", dateString));
+    if (std::isnan(expected))
+        EXPECT_TRUE(std::isnan(parsed)) << dateString;
+    else
+        EXPECT_EQ(expected, parsed) << dateString;
+}
+
+TEST(JSC, DateParseMatchesGeneralES5Parser)
+{
+    DateTest test;
+
+    const char* const dateStrings[] = {
+        "2013-03-04",
+        "2013-03-04T05:06",
+        "2013-03-04T05:06Z",
+        "2013-03-04T05:06:07",
+        "2013-03-04T05:06:07Z",
+        "2013-03-04T05:06:07.089",
+        "2013-03-04T05:06:07.089Z",
+        "2013-03-04T05:06:07.999Z",
+        "1969-12-31T23:59:59.999Z",
+        "0000-01-01T00:00:00.000Z",
+        "9999-12-31T23:59:59.999Z",
+        // Left to the general parser.
+        "2013-03-04T05:06:07.0891Z",
+        "2013-03-04T05:06:07.1Z",
+        "2013-03-04T24:00:00Z",
+        "2013-03-04T24:00Z",
+        "2013-03-04T05:06:07+01:00",
+        "+002013-03-04T05:06:07.089Z",
+        "-000001-01-01T00:00:00.000Z",
+    };
+    for (size_t i = 0; i < WTF_ARRAY_LENGTH(dateStrings); ++i)
+        expectSameAsGeneralParser(test, dateStrings[i]);
+
+    // 24:00 is the end of the day, and only valid with nothing after it.
+    EXPECT_EQ(test.evaluateNumber("Date.parse('2013-03-05T00:00:00Z')"), test.evaluateNumber("Date.parse('2013-03-04T24:00:00Z')"));
+    EXPECT_TRUE(std::isnan(test.evaluateNumber("Date.parse('2013-03-04T24:00:01Z')")));
+
+    // Fractions other than three digits are still scaled by their length.
+    EXPECT_NEAR(89.1, test.evaluateNumber("Date.parse('1970-01-01T00:00:00.0891Z')"), 1e-9);
+    EXPECT_EQ(500, test.evaluateNumber("Date.parse('1970-01-01T00:00:00.5Z')"));
+}
+
+TEST(JSC, DateParseFebruary29)
+{
+    DateTest test;
+
+    const char* const dateStrings[] = {
+        "2012-02-29",
+        "2012-02-29T12:00:00.000Z",
+        "2000-02-29",
+        "2013-02-29",
+        "2013-02-29T12:00:00.000Z",
+        "1900-02-29",
+        "2012-02-30",
+    };
+    for (size_t i = 0; i < WTF_ARRAY_LENGTH(dateStrings); ++i)
+        expectSameAsGeneralParser(test, dateStrings[i]);
+
+    EXPECT_EQ(utc(2012, 1, 29), test.evaluateNumber("Date.parse('2012-02-29')"));
+    EXPECT_EQ(utc(2000, 1, 29), test.evaluateNumber("Date.parse('2000-02-29')"));
+    EXPECT_TRUE(std::isnan(WTF::parseES5DateFromNullTerminatedCharacters("2013-02-29")));
+    EXPECT_TRUE(std::isnan(WTF::parseES5DateFromNullTerminatedCharacters("1900-02-29")));
+}
+
+TEST(JSC, DateParseInvalidMonthsAndDays)
+{
+    DateTest test;
+
+    const char* const dateStrings[] = {
+        "2013-00-10",
+        "2013-13-01",
+        "2013-01-00",
+        "2013-01-32",
+        "2013-04-31",
+        "2013-06-31",
+        "2013-09-31",
+        "2013-11-31",
+        "2013-12-32T00:00:00.000Z",
+        "2013-1-01",
+        "2013-01-1",
+        "2013-0a-01",
+    };
+    for (size_t i = 0; i < WTF_ARRAY_LENGTH(dateStrings); ++i) {
+        EXPECT_TRUE(std::isnan(WTF::parseES5DateFromNullTerminatedCharacters(dateStrings[i]))) << dateStrings[i];
+        expectSameAsGeneralParser(test, dateStrings[i]);
+    }
+}
+
+TEST(JSC, DateToISOStringExtendedYears)
+{
+    DateTest test;
+
+    EXPECT_STREQ("-000001-01-01T00:00:00.000Z", test.evaluateString("new Date(Date.UTC(-1, 0, 1)).toISOString()").utf8().data());
+    EXPECT_STREQ("-000001-12-31T23:59:59.999Z", test.evaluateString("new Date(Date.UTC(-1, 11, 31, 23, 59, 59, 999)).toISOString()").utf8().data());
+    EXPECT_STREQ("-271821-04-20T00:00:00.000Z", test.evaluateString("new Date(-8.64e15).toISOString()").utf8().data());
+    EXPECT_STREQ("0000-01-01T00:00:00.000Z", test.evaluateString("var d = new Date(0); d.setUTCFullYear(0); d.toISOString()").utf8().data());
+    EXPECT_STREQ("9999-12-31T23:59:59.999Z", test.evaluateString("new Date(Date.UTC(9999, 11, 31, 23, 59, 59, 999)).toISOString()").utf8().data());
+    EXPECT_STREQ("+010000-01-01T00:00:00.000Z", test.evaluateString("new Date(Date.UTC(10000, 0, 1)).toISOString()").utf8().data());
+    EXPECT_STREQ("+275760-09-13T00:00:00.000Z", test.evaluateString("new Date(8.64e15).toISOString()").utf8().data());
+
+    // The extended forms are left to the general parser, and read back to the same time.
+    EXPECT_TRUE(test.evaluate("var d = new Date(Date.UTC(-1, 5, 6, 7, 8, 9, 10)); Date.parse(d.toISOString()) === d.getTime()").isTrue());
+    EXPECT_TRUE(test.evaluate("var d = new Date(Date.UTC(12345, 5, 6, 7, 8, 9, 10)); Date.parse(d.toISOString()) === d.getTime()").isTrue());
+    EXPECT_TRUE(test.evaluate("try { new Date(NaN).toISOString(); false; } catch (e) { e instanceof RangeError; }").isTrue());
+}
+
+static double localTimeOffsetInMinutes(double ms)
+{
+    return WTF::calculateLocalTimeOffset(ms).offset / msPerMinute;
+}
+
+// US Pacific time switched to daylight saving time at 2013-03-10T10:00:00Z (02:00 local
+// became 03:00), and back at 2013-11-03T09:00:00Z (02:00 local became 01:00).
+TEST(JSC, DateLocalTimeOffsetAcrossDSTTransitions)
+{
+    const char* oldTimeZone = getenv("TZ");
+    String savedTimeZone = oldTimeZone ? String(oldTimeZone) : String();
+    setenv("TZ", "America/Los_Angeles", 1);
+    tzset();
+
+    {
+        DateTest test;
+
+        const double springForward = utc(2013, 2, 10, 10);
+        const double fallBack = utc(2013, 10, 3, 9);
+        const double transitions[] = { springForward, fallBack };
+
+        // Without time zone data both offsets are zero, and only the comparisons with the
+        // uncached offsets below mean anything.
+        bool haveTimeZoneData = localTimeOffsetInMinutes(springForward - 1) != localTimeOffsetInMinutes(springForward);
+
+        // The table computes the year's transitions on its first lookup in that year.
+        test.evaluate("new Date(2013, 0, 1).getTimezoneOffset()");
+
+        for (size_t i = 0; i < WTF_ARRAY_LENGTH(transitions); ++i) {
+            const double offsets[] = { -2 * msPerHour, -msPerMinute, -1, 0, 1, msPerMinute, 2 * msPerHour };
+            for (size_t j = 0; j < WTF_ARRAY_LENGTH(offsets); ++j) {
+                double ms = transitions[i] + offsets[j];
+                EXPECT_EQ(-localTimeOffsetInMinutes(ms), test.evaluateNumber(String::format("new Date(%.0f).getTimezoneOffset()", ms))) << ms;
+            }
+        }
+
+        // Times outside the years the table covers are computed directly.
+        const double uncachedTimes[] = { utc(1969, 6, 1), utc(2040, 6, 1) };
+        for (size_t i = 0; i < WTF_ARRAY_LENGTH(uncachedTimes); ++i)
+            EXPECT_EQ(-localTimeOffsetInMinutes(uncachedTimes[i]), test.evaluateNumber(String::format("new Date(%.0f).getTimezoneOffset()", uncachedTimes[i])));
+
+        if (haveTimeZoneData) {
+            EXPECT_EQ(480, test.evaluateNumber(String::format("new Date(%.0f).getTimezoneOffset()", springForward - 1)));
+            EXPECT_EQ(420, test.evaluateNumber(String::format("new Date(%.0f).getTimezoneOffset()", springForward)));
+            EXPECT_EQ(1, test.evaluateNumber(String::format("new Date(%.0f).getHours()", springForward - 1)));
+            EXPECT_EQ(3, test.evaluateNumber(String::format("new Date(%.0f).getHours()", springForward)));
+            EXPECT_EQ(1, test.evaluateNumber(String::format("new Date(%.0f).getHours()", fallBack - 1)));
+            EXPECT_EQ(1, test.evaluateNumber(String::format("new Date(%.0f).getHours()", fallBack)));
+
+            // Local times are converted with the offset in effect when UTC reads the same, so
+            // local 03:00 on the day of the change still gets standard time.
+            EXPECT_EQ(utc(2013, 2, 10, 9) + 59 * msPerMinute, test.evaluateNumber("new Date(2013, 2, 10, 1, 59).getTime()"));
+            EXPECT_EQ(utc(2013, 2, 10, 11), test.evaluateNumber("new Date(2013, 2, 10, 3, 0).getTime()"));
+        }
+    }
+
+    if (savedTimeZone.isNull())
+        unsetenv("TZ");
+    else
+        setenv("TZ", savedTimeZone.utf8().data(), 1);
+    tzset();
+}
+
+} // namespace TestWebKitAPI
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <heap/HeapSnapshot.h>
+#include <parser/SourceCode.h>
+#include <runtime/Completion.h>
+#include <runtime/JSGlobalObject.h>
+#include <runtime/JSLock.h>
+#include <runtime/Operations.h>
+#include <runtime/VM.h>
+#include <wtf/StringPrintStream.h>
+
+using namespace JSC;
+
+namespace TestWebKitAPI {
+
+static PassRefPtr<HeapSnapshot> takeSnapshotAfterRunning(VM& vm, const char* script)
+{
+    JSGlobalObject* globalObject = JSGlobalObject::create(vm, JSGlobalObject::createStructure(vm, jsNull()));
+    gcProtect(globalObject);
+    evaluate(globalObject->globalExec(), makeSource(script));
+    RefPtr<HeapSnapshot> snapshot = HeapSnapshot::take(vm);
+    gcUnprotect(globalObject);
+    return snapshot.release();
+}
+
+TEST(JSC, HeapSnapshotRetainedSizes)
+{
+    // The locker holds the only reference, so the VM is destroyed before its lock is released.
+    VM* vm = VM::create(LargeHeap).leakRef();
+    JSLockHolder locker(vm);
+    vm->deref();
+    RefPtr<HeapSnapshot> snapshot = takeSnapshotAfterRunning(*vm, "var retained = []; for (var i = 0; i < 1000; ++i) retained.push({ index: i });");
+
+    ASSERT_GT(snapshot->nodeCount(), 1000u);
+    EXPECT_STREQ("<root>", snapshot->className(HeapSnapshot::rootNodeIndex));
+    EXPECT_EQ(HeapSnapshot::rootNodeIndex, snapshot->dominator(HeapSnapshot::rootNodeIndex));
+
+    size_t largestArrayRetainedSize = 0;
+    for (unsigned i = 0; i < snapshot->nodeCount(); ++i) {
+        // A node retains at least itself, and its dominator retains at least what it does.
+        EXPECT_GE(snapshot->retainedSize(i), snapshot->selfSize(i));
+        EXPECT_GE(snapshot->retainedSize(snapshot->dominator(i)), snapshot->retainedSize(i));
+        if (!strcmp(snapshot->className(i), "Array"))
+            largestArrayRetainedSize = std::max(largestArrayRetainedSize, snapshot->retainedSize(i));
+    }
+
+    // The only path to the thousand objects goes through the array.
+    EXPECT_GE(largestArrayRetainedSize, 1000 * sizeof(JSObject));
+}
+
+TEST(JSC, HeapSnapshotInspectorFormat)
+{
+    // The locker holds the only reference, so the VM is destroyed before its lock is released.
+    VM* vm = VM::create(LargeHeap).leakRef();
+    JSLockHolder locker(vm);
+    vm->deref();
+    RefPtr<HeapSnapshot> snapshot = takeSnapshotAfterRunning(*vm, "var object = { child: {} };");
+
+    StringPrintStream out;
+    snapshot->writeJSON(out);
+    String json = out.toString();
+
+    // The inspector's HeapSnapshotLoader reads the header first, then the
+    // nodes, edges and strings arrays, in that order.
+    EXPECT_TRUE(json.startsWith("{\"snapshot\":{\"meta\":{\"node_fields\":[\"type\",\"name\",\"id\",\"self_size\",\"edge_count\"]"));
+    size_t nodeCountPosition = json.find(String::format("\"node_count\":%u,\"edge_count\":%u}", static_cast<unsigned>(snapshot->nodeCount()), static_cast<unsigned>(snapshot->edgeCount())));
+    size_t nodesPosition = json.find("\"nodes\":[");
+    size_t edgesPosition = json.find("\"edges\":[");
+    size_t stringsPosition = json.find("\"strings\":[\"<root>\"");
+    ASSERT_NE(notFound, nodeCountPosition);
+    ASSERT_NE(notFound, nodesPosition);
+    ASSERT_NE(notFound, edgesPosition);
+    ASSERT_NE(notFound, stringsPosition);
+    EXPECT_LT(nodeCountPosition, nodesPosition);
+    EXPECT_LT(nodesPosition, edgesPosition);
+    EXPECT_LT(edgesPosition, stringsPosition);
+}
+
+} // namespace TestWebKitAPI
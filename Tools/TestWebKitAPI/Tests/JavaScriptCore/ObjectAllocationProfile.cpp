@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <parser/SourceCode.h>
+#include <runtime/Completion.h>
+#include <runtime/JSGlobalObject.h>
+#include <runtime/JSLock.h>
+#include <runtime/Operations.h>
+#include <runtime/VM.h>
+#include <wtf/text/StringBuilder.h>
+
+using namespace JSC;
+
+namespace TestWebKitAPI {
+
+static const unsigned smallPropertyCount = 10;
+static const unsigned largePropertyCount = 30;
+static const unsigned objectsPerPhase = 20000;
+
+// Model() only assigns two properties itself, so its allocation profile starts out with room
+// for about two. The helpers it calls add ten more, and once the first phase has had time to
+// be optimized, twenty more on a path the optimized code has never taken.
+static String spillingConstructorScript()
+{
+    StringBuilder builder;
+    builder.appendLiteral("function initialize(o, n) {\n");
+    for (unsigned i = 0; i < smallPropertyCount; ++i)
+        builder.append(String::format("    o.p%u = n + %u;\n", i, i));
+    builder.appendLiteral("}\nfunction addMore(o, n) {\n");
+    for (unsigned i = smallPropertyCount; i < largePropertyCount; ++i)
+        builder.append(String::format("    o.p%u = n + %u;\n", i, i));
+    builder.appendLiteral(
+        "}\n"
+        "function Model(n, large) {\n"
+        "    this.first = n;\n"
+        "    initialize(this, n);\n"
+        "    if (large)\n"
+        "        addMore(this, n);\n"
+        "    this.last = n;\n"
+        "}\n"
+        "var objects = [];\n"
+        "function build(first, count, large) {\n"
+        "    for (var i = first; i < first + count; ++i)\n"
+        "        objects.push(new Model(i, large));\n"
+        "}\n");
+    builder.append(String::format(
+        "build(0, %u, false);\n"
+        "build(%u, %u, true);\n"
+        "function check(o, n, count) {\n"
+        "    if (o.first !== n || o.last !== n)\n"
+        "        return false;\n"
+        "    for (var i = 0; i < count; ++i) {\n"
+        "        if (o['p' + i] !== n + i)\n"
+        "            return false;\n"
+        "    }\n"
+        "    return !(('p' + count) in o);\n"
+        "}\n"
+        "var mismatches = 0;\n"
+        "for (var i = 0; i < objects.length; ++i) {\n"
+        "    if (!check(objects[i], i, i < %u ? %u : %u))\n"
+        "        ++mismatches;\n"
+        "}\n",
+        objectsPerPhase, objectsPerPhase, objectsPerPhase, objectsPerPhase, smallPropertyCount, largePropertyCount));
+    return builder.toString();
+}
+
+static Structure* structureOfObject(ExecState* exec, JSValue objects, unsigned index)
+{
+    JSValue object = objects.get(exec, index);
+    EXPECT_TRUE(object.isObject());
+    return asObject(object)->structure();
+}
+
+TEST(JSC, ObjectAllocationProfileGrowsInlineStorageForSpilledProperties)
+{
+    // The locker holds the only reference, so the VM is destroyed before its lock is released.
+    VM* vm = VM::create(LargeHeap).leakRef();
+    JSLockHolder locker(vm);
+    vm->deref();
+    JSGlobalObject* globalObject = JSGlobalObject::create(*vm, JSGlobalObject::createStructure(*vm, jsNull()));
+    gcProtect(globalObject);
+    ExecState* exec = globalObject->globalExec();
+
+    JSValue exception;
+    evaluate(exec, makeSource(spillingConstructorScript()), JSValue(), &exception);
+    EXPECT_FALSE(exception);
+
+    // Every object keeps its values across the profile being reset, whether it was built
+    // by optimized code or after an exit from it.
+    EXPECT_EQ(0, globalObject->get(exec, Identifier(exec, "mismatches")).asNumber());
+
+    JSValue objects = globalObject->get(exec, Identifier(exec, "objects"));
+    ASSERT_EQ(2 * objectsPerPhase, objects.get(exec, exec->propertyNames().length).toUInt32(exec));
+
+    // The first object of each phase spills; the ones after it are allocated with enough
+    // inline storage for all of their properties.
+    const unsigned firstPropertyCountOfPhase[] = { smallPropertyCount + 2, largePropertyCount + 2 };
+    for (unsigned phase = 0; phase < 2; ++phase) {
+        unsigned first = phase * objectsPerPhase;
+        EXPECT_GT(structureOfObject(exec, objects, first)->outOfLineCapacity(), 0u);
+
+        const unsigned laterObjects[] = { first + 1, first + objectsPerPhase / 2, first + objectsPerPhase - 1 };
+        for (unsigned i = 0; i < WTF_ARRAY_LENGTH(laterObjects); ++i) {
+            Structure* structure = structureOfObject(exec, objects, laterObjects[i]);
+            EXPECT_EQ(0u, structure->outOfLineCapacity()) << laterObjects[i];
+            EXPECT_GE(structure->inlineCapacity(), firstPropertyCountOfPhase[phase]) << laterObjects[i];
+        }
+    }
+
+    gcUnprotect(globalObject);
+}
+
+} // namespace TestWebKitAPI
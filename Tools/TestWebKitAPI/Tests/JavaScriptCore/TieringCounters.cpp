@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <parser/SourceCode.h>
+#include <profiler/ProfilerDatabase.h>
+#include <runtime/Completion.h>
+#include <runtime/JSGlobalObject.h>
+#include <runtime/JSLock.h>
+#include <runtime/Operations.h>
+#include <runtime/Options.h>
+#include <runtime/VM.h>
+
+using namespace JSC;
+
+namespace TestWebKitAPI {
+
+#if ENABLE(DFG_JIT)
+
+// hot() is compiled by the DFG for objects shaped { x }. Objects shaped { y, x } then make
+// its property access exit until the DFG code is jettisoned and recompiled.
+static const char* const tieringScript =
+    "function hot(o) { return o.x + 1; }\n"
+    "var result = 0;\n"
+    "for (var i = 0; i < 100000; ++i)\n"
+    "    result += hot({ x: i });\n"
+    "for (var i = 0; i < 100000; ++i)\n"
+    "    result += hot(i % 2 ? { x: i } : { y: 1, x: i });\n";
+
+static JSValue findFunctionCounters(ExecState* exec, JSValue tiering, const char* name)
+{
+    unsigned length = tiering.get(exec, exec->propertyNames().length).toUInt32(exec);
+    for (unsigned i = 0; i < length; ++i) {
+        JSValue entry = tiering.get(exec, i);
+        if (entry.get(exec, exec->propertyNames().inferredName).toWTFString(exec) == name)
+            return entry;
+    }
+    return JSValue();
+}
+
+TEST(JSC, TieringCountersRecordOptimizationAndJettison)
+{
+    // The locker holds the only reference, so the VM is destroyed before its lock is released.
+    VM* vm = VM::create(LargeHeap).leakRef();
+    JSLockHolder locker(vm);
+    vm->deref();
+    if (!vm->canUseJIT() || !Options::useDFGJIT())
+        return;
+
+    // Keep hot() out of the loops' own optimized code, so that it is compiled and exits on its own.
+    unsigned maximumInliningDepth = Options::maximumInliningDepth();
+    Options::maximumInliningDepth() = 1;
+
+    JSGlobalObject* globalObject = JSGlobalObject::create(*vm, JSGlobalObject::createStructure(*vm, jsNull()));
+    gcProtect(globalObject);
+    ExecState* exec = globalObject->globalExec();
+    JSValue exception;
+    evaluate(exec, makeSource(tieringScript), JSValue(), &exception);
+    EXPECT_FALSE(exception);
+
+    Profiler::Database database(*vm);
+    JSValue counters = findFunctionCounters(exec, database.tieringCountersToJS(exec), "hot");
+    ASSERT_TRUE(counters.isObject());
+    EXPECT_FALSE(counters.get(exec, exec->propertyNames().hash).toWTFString(exec).isEmpty());
+
+    // Tiers are listed as LLInt, Baseline, DFG.
+    JSValue tiers = counters.get(exec, exec->propertyNames().tiers);
+    ASSERT_EQ(3u, tiers.get(exec, exec->propertyNames().length).toUInt32(exec));
+    const char* const tierNames[] = { "LLInt", "Baseline", "DFG" };
+    for (unsigned i = 0; i < 3; ++i) {
+        JSValue tier = tiers.get(exec, i);
+        EXPECT_TRUE(tier.get(exec, exec->propertyNames().tier).toWTFString(exec) == tierNames[i]);
+        EXPECT_TRUE(tier.get(exec, exec->propertyNames().installedTime).isNumber());
+        EXPECT_GE(tier.get(exec, exec->propertyNames().installedTime).asNumber(), 0);
+    }
+    EXPECT_GE(tiers.get(exec, 1).get(exec, exec->propertyNames().compilations).asNumber(), 1);
+    double numberOfDFGCompilations = tiers.get(exec, 2).get(exec, exec->propertyNames().compilations).asNumber();
+    EXPECT_GE(numberOfDFGCompilations, 1);
+    EXPECT_GT(tiers.get(exec, 2).get(exec, exec->propertyNames().installedTime).asNumber(), 0);
+
+    // Only DFG code can be jettisoned.
+    double numberOfJettisons = counters.get(exec, exec->propertyNames().jettisons).asNumber();
+    EXPECT_GE(numberOfJettisons, 1);
+    EXPECT_LE(numberOfJettisons, numberOfDFGCompilations);
+
+    JSValue exits = counters.get(exec, exec->propertyNames().osrExits);
+    unsigned numberOfExitKinds = exits.get(exec, exec->propertyNames().length).toUInt32(exec);
+    ASSERT_GE(numberOfExitKinds, 1u);
+    double numberOfExits = 0;
+    for (unsigned i = 0; i < numberOfExitKinds; ++i) {
+        JSValue exit = exits.get(exec, i);
+        EXPECT_FALSE(exit.get(exec, exec->propertyNames().exitKind).toWTFString(exec).isEmpty());
+        EXPECT_GE(exit.get(exec, exec->propertyNames().count).asNumber(), 1);
+        numberOfExits += exit.get(exec, exec->propertyNames().count).asNumber();
+    }
+    // Reoptimization waits for this many exits.
+    EXPECT_GE(numberOfExits, Options::osrExitCountForReoptimization());
+
+    // The same counters are in the database's JSON, which does not need the profiler enabled.
+    String json = database.toJSON();
+    EXPECT_NE(notFound, json.find("\"tiering\":["));
+    EXPECT_NE(notFound, json.find("\"inferredName\":\"hot\""));
+    EXPECT_NE(notFound, json.find("\"installedTime\":"));
+    EXPECT_NE(notFound, json.find("\"compilations\":"));
+    EXPECT_NE(notFound, json.find("\"jettisons\":"));
+    EXPECT_NE(notFound, json.find("\"osrExits\":[{\"exitKind\":"));
+
+    gcUnprotect(globalObject);
+    Options::maximumInliningDepth() = maximumInliningDepth;
+}
+
+#endif // ENABLE(DFG_JIT)
+
+} // namespace TestWebKitAPI
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <API/JSContextRefPrivate.h>
+#include <JavaScriptCore/JavaScript.h>
+
+namespace TestWebKitAPI {
+
+// These run on every port, so they exercise whichever Watchdog timer the port
+// builds (WatchdogMac or WatchdogGeneric). The scripts spin for a fixed amount
+// of wall clock time, which is also CPU time since they never block.
+
+static void spin(JSGlobalContextRef context, int milliseconds, JSValueRef* exception)
+{
+    char source[128];
+    snprintf(source, sizeof(source), "var end = Date.now() + %d; while (Date.now() < end) { }", milliseconds);
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSEvaluateScript(context, script, 0, 0, 1, exception);
+    JSStringRelease(script);
+}
+
+static int yieldCallbackCount;
+
+static void countYields(JSContextRef, void*)
+{
+    yieldCallbackCount++;
+}
+
+TEST(JSC, WatchdogYieldInterval)
+{
+    JSContextGroupRef group = JSContextGroupCreate();
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, 0);
+
+    yieldCallbackCount = 0;
+    JSContextGroupSetExecutionYieldInterval(group, .050, countYields, 0);
+    JSValueRef exception = 0;
+    spin(context, 300, &exception);
+    JSContextGroupClearExecutionYieldInterval(group);
+
+    EXPECT_FALSE(exception);
+    EXPECT_GE(yieldCallbackCount, 3);
+
+    JSGlobalContextRelease(context);
+    JSContextGroupRelease(group);
+}
+
+static bool budgetCallbackWasCalled;
+
+static bool terminateWhenOutOfBudget(JSContextRef, void*)
+{
+    budgetCallbackWasCalled = true;
+    return true;
+}
+
+TEST(JSC, WatchdogBudgetIsSharedBetweenEvaluations)
+{
+    JSContextGroupRef group = JSContextGroupCreate();
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, 0);
+
+    budgetCallbackWasCalled = false;
+    JSContextGroupSetExecutionBudget(group, .200, terminateWhenOutOfBudget, 0);
+    double executionTimeBefore = JSContextGroupGetExecutionTime(group);
+    JSValueRef firstException = 0;
+    JSValueRef secondException = 0;
+    spin(context, 150, &firstException);
+    spin(context, 150, &secondException);
+    double executionTime = JSContextGroupGetExecutionTime(group) - executionTimeBefore;
+    JSContextGroupClearExecutionBudget(group);
+
+    EXPECT_FALSE(firstException);
+    EXPECT_TRUE(secondException);
+    EXPECT_TRUE(budgetCallbackWasCalled);
+    EXPECT_GE(executionTime, .200);
+    EXPECT_LT(executionTime, .300);
+
+    JSGlobalContextRelease(context);
+    JSContextGroupRelease(group);
+}
+
+TEST(JSC, WatchdogDoesNotAccountWhenDisabled)
+{
+    JSContextGroupRef group = JSContextGroupCreate();
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, 0);
+
+    JSValueRef exception = 0;
+    spin(context, 50, &exception);
+
+    EXPECT_FALSE(exception);
+    EXPECT_EQ(0, JSContextGroupGetExecutionTime(group));
+
+    JSGlobalContextRelease(context);
+    JSContextGroupRelease(group);
+}
+
+} // namespace TestWebKitAPI
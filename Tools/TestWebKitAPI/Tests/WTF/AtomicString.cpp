@@ -25,7 +25,10 @@
 
 #include "config.h"
 
+#include <wtf/MainThread.h>
+#include <wtf/Threading.h>
 #include <wtf/text/AtomicString.h>
+#include <wtf/text/AtomicStringTable.h>
 
 namespace TestWebKitAPI {
 
@@ -56,4 +59,120 @@ TEST(WTF, AtomicStringCreationFromLiteralUniqueness)
     ASSERT_EQ(string1.impl(), string3.impl());
 }
 
+TEST(WTF, AtomicStringSharedFromMainThread)
+{
+    // Strings atomized before this keep their identity when they move to the main table.
+    AtomicString atomizedEarlier("atomizedBeforeMainThreadWasKnown");
+    WTF::initializeMainThread();
+    ASSERT_EQ(atomizedEarlier.impl(), AtomicString("atomizedBeforeMainThreadWasKnown").impl());
+
+    AtomicString string("sharedFromMainThread");
+    ASSERT_FALSE(string.impl()->isSharedAtomic());
+    ASSERT_FALSE(string.string().isSafeToSendToAnotherThread());
+
+    AtomicStringImpl* shared = AtomicString::addShared(string.characters8(), string.length());
+    ASSERT_EQ(string.impl(), shared);
+    ASSERT_TRUE(shared->isSharedAtomic());
+    ASSERT_TRUE(string.string().isSafeToSendToAnotherThread());
+
+    const UChar characters[] = { 's', 'h', 'a', 'r', 'e', 'd', 'U', 'C', 'h', 'a', 'r' };
+    shared = AtomicString::addShared(characters, WTF_ARRAY_LENGTH(characters));
+    ASSERT_TRUE(shared->isSharedAtomic());
+    ASSERT_TRUE(shared->is8Bit());
+    ASSERT_EQ(shared, AtomicString("sharedUChar").impl());
+}
+
+struct SharedStringThreadResults {
+    AtomicStringImpl* sharedFromThread;
+    AtomicStringImpl* mainThreadOnly;
+    AtomicStringImpl* sharedFromMainThread;
+    bool mainThreadOnlyIsShared;
+    bool mainThreadOnlyCanBeShared;
+};
+
+static void atomizeOnThread(void* context)
+{
+    SharedStringThreadResults* results = static_cast<SharedStringThreadResults*>(context);
+    AtomicStringTable::useSharedStringsOnCurrentThread();
+
+    AtomicString sharedFromThread("sharedFromThread");
+    results->sharedFromThread = sharedFromThread.impl();
+
+    AtomicString mainThreadOnly("mainThreadOnly");
+    results->mainThreadOnly = mainThreadOnly.impl();
+
+    AtomicString sharedFromMainThread("sharedFromMainThreadBeforeThread");
+    results->sharedFromMainThread = sharedFromMainThread.impl();
+
+    // The thread atomized this string on its own, and it keeps that identity here.
+    results->mainThreadOnlyIsShared = mainThreadOnly.impl()->isSharedAtomic();
+    results->mainThreadOnlyCanBeShared = AtomicString::addShared(mainThreadOnly.characters8(), mainThreadOnly.length());
+}
+
+TEST(WTF, AtomicStringSharedAcrossThreads)
+{
+    WTF::initializeMainThread();
+    AtomicString mainThreadOnly("mainThreadOnly");
+    AtomicString sharedFromMainThread("sharedFromMainThreadBeforeThread");
+    AtomicString::addShared(sharedFromMainThread.characters8(), sharedFromMainThread.length());
+
+    SharedStringThreadResults results;
+    AtomicStringTable::shareStringsWithOtherThreads();
+    ThreadIdentifier thread = createThread(atomizeOnThread, &results, "AtomicStringSharedAcrossThreads");
+    waitForThreadCompletion(thread);
+
+    // Strings the thread atomized first are shared, and are the main thread's atomic strings.
+    ASSERT_TRUE(results.sharedFromThread->isSharedAtomic());
+    ASSERT_EQ(results.sharedFromThread, AtomicString("sharedFromThread").impl());
+    ASSERT_EQ(results.sharedFromMainThread, sharedFromMainThread.impl());
+
+    // The main thread's strings that are not shared are never handed to other threads.
+    ASSERT_NE(results.mainThreadOnly, mainThreadOnly.impl());
+    ASSERT_FALSE(mainThreadOnly.impl()->isSharedAtomic());
+
+    ASSERT_FALSE(results.mainThreadOnlyIsShared);
+    ASSERT_FALSE(results.mainThreadOnlyCanBeShared);
+}
+
+static const unsigned concurrentStringCount = 256;
+
+static String concurrentStringName(unsigned i)
+{
+    return String::format("concurrentlyAtomized%u", i);
+}
+
+static void atomizeConcurrentlyOnThread(void* context)
+{
+    AtomicStringImpl** results = static_cast<AtomicStringImpl**>(context);
+    AtomicStringTable::useSharedStringsOnCurrentThread();
+    // Walk the names backwards so that the two threads meet halfway and race on the same stripes.
+    for (unsigned i = concurrentStringCount; i--;) {
+        AtomicString string(concurrentStringName(i));
+        results[i] = string.impl();
+    }
+}
+
+TEST(WTF, AtomicStringConcurrentAdditions)
+{
+    WTF::initializeMainThread();
+    AtomicStringTable::shareStringsWithOtherThreads();
+
+    AtomicStringImpl* threadResults[concurrentStringCount];
+    ThreadIdentifier thread = createThread(atomizeConcurrentlyOnThread, threadResults, "AtomicStringConcurrentAdditions");
+    Vector<AtomicStringImpl*> mainThreadResults;
+    for (unsigned i = 0; i < concurrentStringCount; ++i) {
+        String name = concurrentStringName(i);
+        mainThreadResults.append(AtomicString::addShared(name.characters8(), name.length()));
+    }
+    waitForThreadCompletion(thread);
+
+    // Whichever thread added a string first, both ended up with the same shared string.
+    for (unsigned i = 0; i < concurrentStringCount; ++i) {
+        ASSERT_TRUE(mainThreadResults[i]);
+        ASSERT_TRUE(mainThreadResults[i]->isSharedAtomic());
+        ASSERT_EQ(mainThreadResults[i], threadResults[i]);
+        ASSERT_EQ(mainThreadResults[i], AtomicString(concurrentStringName(i)).impl());
+    }
+}
+
 } // namespace TestWebKitAPI
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <wtf/BumpArena.h>
+#include <wtf/HashMap.h>
+#include <wtf/HashSet.h>
+#include <wtf/Vector.h>
+
+namespace TestWebKitAPI {
+
+static bool isInArena(const void* p, const void* first, size_t chunkSize)
+{
+    const char* address = static_cast<const char*>(p);
+    const char* begin = static_cast<const char*>(first);
+    return address >= begin && address < begin + chunkSize;
+}
+
+TEST(WTF_BumpArena, AllocateIsAlignedAndContiguous)
+{
+    BumpArena arena;
+    char* first = static_cast<char*>(arena.allocate(1));
+    char* second = static_cast<char*>(arena.allocate(24));
+    char* third = static_cast<char*>(arena.allocate(8));
+
+    EXPECT_FALSE(reinterpret_cast<uintptr_t>(first) % BumpArena::alignment);
+    EXPECT_EQ(first + BumpArena::alignment, second);
+    EXPECT_EQ(second + BumpArena::roundUpToAlignment(24), third);
+}
+
+TEST(WTF_BumpArena, DeallocateRewindsLastAllocation)
+{
+    BumpArena arena;
+    void* first = arena.allocate(16);
+    void* second = arena.allocate(64);
+
+    // Only the latest allocation can be given back.
+    arena.deallocate(first);
+    EXPECT_EQ(static_cast<char*>(second) + 64, arena.allocate(16));
+
+    arena.deallocate(second);
+    void* last = arena.allocate(32);
+    arena.deallocate(last);
+    EXPECT_EQ(last, arena.allocate(32));
+}
+
+TEST(WTF_BumpArena, ReallocateExtendsInPlace)
+{
+    BumpArena arena;
+    arena.allocate(16);
+    char* p = static_cast<char*>(arena.allocate(16));
+    memset(p, 'a', 16);
+
+    EXPECT_EQ(p, arena.reallocate(p, 16, 256));
+    EXPECT_EQ(p + 256, arena.allocate(16));
+
+    char* moved = static_cast<char*>(arena.reallocate(p, 256, 512));
+    EXPECT_NE(p, moved);
+    for (int i = 0; i < 16; ++i)
+        EXPECT_EQ('a', moved[i]);
+}
+
+TEST(WTF_BumpArena, LargeAllocationsAndReset)
+{
+    BumpArena arena(1024);
+    char* small = static_cast<char*>(arena.allocate(16));
+    char* large = static_cast<char*>(arena.allocate(4096));
+    memset(large, 0, 4096);
+
+    // The chunk of a small allocation keeps serving small allocations.
+    EXPECT_EQ(small + 16, arena.allocate(16));
+
+    for (int i = 0; i < 1000; ++i)
+        arena.allocate(48);
+
+    arena.reset();
+    void* afterReset = arena.allocate(16);
+    EXPECT_TRUE(afterReset);
+    arena.reset();
+    EXPECT_EQ(afterReset, arena.allocate(16));
+}
+
+typedef Vector<int, 0, WTF::CrashOnOverflow, BumpArenaAllocator> ArenaIntVector;
+
+TEST(WTF_BumpArena, VectorUsesArena)
+{
+    BumpArena arena;
+    char* chunkStart = static_cast<char*>(arena.allocate(16));
+
+    ArenaIntVector vector((BumpArenaAllocator(arena)));
+    EXPECT_EQ(&arena, vector.allocator().arena());
+    for (int i = 0; i < 500; ++i)
+        vector.append(i);
+
+    EXPECT_EQ(500u, vector.size());
+    EXPECT_TRUE(isInArena(vector.data(), chunkStart, arena.chunkSize()));
+    for (int i = 0; i < 500; ++i)
+        EXPECT_EQ(i, vector[i]);
+
+    ArenaIntVector copy(vector);
+    EXPECT_EQ(&arena, copy.allocator().arena());
+    EXPECT_TRUE(copy == vector);
+
+    ArenaIntVector other;
+    other.swap(copy);
+    EXPECT_EQ(&arena, other.allocator().arena());
+    EXPECT_FALSE(copy.allocator().arena());
+    EXPECT_EQ(500u, other.size());
+}
+
+TEST(WTF_BumpArena, VectorReleaseBufferCopiesToFastMalloc)
+{
+    BumpArena arena;
+    ArenaIntVector vector((BumpArenaAllocator(arena)));
+    vector.append(1);
+    vector.append(2);
+
+    int* buffer = vector.releaseBuffer();
+    EXPECT_TRUE(vector.isEmpty());
+    EXPECT_EQ(1, buffer[0]);
+    EXPECT_EQ(2, buffer[1]);
+    fastFree(buffer);
+}
+
+TEST(WTF_BumpArena, VectorInlineCapacity)
+{
+    typedef Vector<double, VectorInlineCapacityForBytes<double, 64>::value> ScratchVector;
+    EXPECT_EQ(8u, ScratchVector().capacity());
+
+    ScratchVector vector;
+    EXPECT_TRUE(vector.usesInlineBuffer());
+    vector.fill(1, 8);
+    EXPECT_TRUE(vector.usesInlineBuffer());
+    vector.append(2);
+    EXPECT_FALSE(vector.usesInlineBuffer());
+
+    EXPECT_FALSE(Vector<int>().usesInlineBuffer());
+}
+
+struct ArenaIntHashTraits : HashTraits<int> {
+    typedef BumpArenaAllocator Allocator;
+};
+
+struct GroupProbingArenaIntHashTraits : ArenaIntHashTraits {
+    static const bool useGroupProbing = true;
+};
+
+template<typename Map> static void testArenaHashMap()
+{
+    BumpArena arena;
+    Map map((BumpArenaAllocator(arena)));
+    for (int i = 1; i <= 1000; ++i)
+        map.add(i, i * 3);
+    for (int i = 1; i <= 1000; i += 2)
+        map.remove(i);
+
+    EXPECT_EQ(500, map.size());
+    for (int i = 1; i <= 1000; ++i)
+        EXPECT_EQ(i % 2 ? 0 : i * 3, map.get(i));
+
+    Map copy(map);
+    EXPECT_EQ(500, copy.size());
+    EXPECT_EQ(6, copy.get(2));
+
+    Map other;
+    other.swap(copy);
+    EXPECT_EQ(500, other.size());
+    EXPECT_TRUE(copy.isEmpty());
+}
+
+TEST(WTF_BumpArena, HashMapUsesArena)
+{
+    testArenaHashMap<HashMap<int, int, DefaultHash<int>::Hash, ArenaIntHashTraits> >();
+}
+
+TEST(WTF_BumpArena, GroupProbingHashMapUsesArena)
+{
+    testArenaHashMap<HashMap<int, int, DefaultHash<int>::Hash, GroupProbingArenaIntHashTraits> >();
+}
+
+TEST(WTF_BumpArena, HashSetUsesArena)
+{
+    BumpArena arena;
+    HashSet<int, DefaultHash<int>::Hash, ArenaIntHashTraits> set((BumpArenaAllocator(arena)));
+    for (int i = 1; i <= 100; ++i)
+        set.add(i);
+    EXPECT_EQ(100, set.size());
+    EXPECT_TRUE(set.contains(50));
+    EXPECT_FALSE(set.contains(101));
+}
+
+} // namespace TestWebKitAPI
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <wtf/FastMalloc.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+namespace TestWebKitAPI {
+
+// Freed objects stay in the thread caches until there are too many of them, then go back to
+// their spans, and spans with no objects in use go back to the page heap.
+static const size_t numberOfObjects = 2000;
+
+// Returns the statistics of the smallest size class that holds objects of the given size,
+// or false when FastMalloc is not in use.
+static bool sizeClassStatistics(size_t size, WTF::FastMallocSizeClassStatistics& result)
+{
+    size_t count = WTF::fastMallocSizeClassStatistics(0, 0);
+    if (!count)
+        return false;
+
+    Vector<WTF::FastMallocSizeClassStatistics> statistics(count);
+    EXPECT_EQ(count, WTF::fastMallocSizeClassStatistics(statistics.data(), count));
+    for (size_t i = 0; i < count; ++i) {
+        if (statistics[i].objectSize >= size) {
+            result = statistics[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+static void allocateObjects(Vector<void*>& objects, size_t size)
+{
+    objects.reserveCapacity(numberOfObjects);
+    for (size_t i = 0; i < numberOfObjects; ++i)
+        objects.append(fastMalloc(size));
+}
+
+static void freeObjects(Vector<void*>& objects)
+{
+    for (size_t i = 0; i < objects.size(); ++i)
+        fastFree(objects[i]);
+    objects.clear();
+}
+
+TEST(WTF, FastMallocSizeClassStatisticsCountLiveAndFreeBytes)
+{
+    const size_t requestedSize = 1000;
+    WTF::FastMallocSizeClassStatistics initial;
+    if (!sizeClassStatistics(requestedSize, initial))
+        return;
+    EXPECT_GE(initial.objectSize, requestedSize);
+
+    Vector<void*> objects;
+    allocateObjects(objects, initial.objectSize);
+
+    WTF::FastMallocSizeClassStatistics afterAllocating;
+    ASSERT_TRUE(sizeClassStatistics(requestedSize, afterAllocating));
+    EXPECT_EQ(initial.objectSize, afterAllocating.objectSize);
+    EXPECT_GE(afterAllocating.liveBytes, initial.liveBytes + numberOfObjects * initial.objectSize);
+
+    freeObjects(objects);
+
+    WTF::FastMallocSizeClassStatistics afterFreeing;
+    ASSERT_TRUE(sizeClassStatistics(requestedSize, afterFreeing));
+    EXPECT_LE(afterFreeing.liveBytes + numberOfObjects * initial.objectSize, afterAllocating.liveBytes);
+    EXPECT_GT(afterFreeing.freeBytes, 0u);
+
+    WTF::releaseFastMallocFreeMemory();
+
+    WTF::FastMallocSizeClassStatistics afterReleasing;
+    ASSERT_TRUE(sizeClassStatistics(requestedSize, afterReleasing));
+    EXPECT_LT(afterReleasing.freeBytes, afterFreeing.freeBytes);
+    EXPECT_EQ(afterFreeing.liveBytes, afterReleasing.liveBytes);
+}
+
+// The other thread frees its objects into its own cache, then waits while the main thread
+// releases free memory, and finally misses in another size class, which is when it acts on
+// the release.
+static const size_t otherThreadObjectSize = 1500;
+static const size_t otherThreadMissObjectSize = 6000;
+
+static int otherThreadStep;
+
+static Mutex& otherThreadLock()
+{
+    DEFINE_STATIC_LOCAL(Mutex, lock, ());
+    return lock;
+}
+
+static ThreadCondition& otherThreadCondition()
+{
+    DEFINE_STATIC_LOCAL(ThreadCondition, condition, ());
+    return condition;
+}
+
+static void advanceOtherThreadStep(int step)
+{
+    MutexLocker locker(otherThreadLock());
+    otherThreadStep = step;
+    otherThreadCondition().broadcast();
+}
+
+static void waitForOtherThreadStep(int step)
+{
+    MutexLocker locker(otherThreadLock());
+    while (otherThreadStep < step)
+        otherThreadCondition().wait(otherThreadLock());
+}
+
+static void allocateAndFreeOnOtherThread(void*)
+{
+    Vector<void*> objects;
+    allocateObjects(objects, otherThreadObjectSize);
+    freeObjects(objects);
+    advanceOtherThreadStep(1);
+
+    waitForOtherThreadStep(2);
+    fastFree(fastMalloc(otherThreadMissObjectSize));
+    advanceOtherThreadStep(3);
+
+    waitForOtherThreadStep(4);
+}
+
+TEST(WTF, FastMallocReleaseEmptiesOtherThreadCaches)
+{
+    WTF::initializeThreading();
+
+    WTF::FastMallocSizeClassStatistics initial;
+    if (!sizeClassStatistics(otherThreadObjectSize, initial))
+        return;
+
+    otherThreadStep = 0;
+    ThreadIdentifier thread = createThread(allocateAndFreeOnOtherThread, 0, "FastMallocReleaseEmptiesOtherThreadCaches");
+    waitForOtherThreadStep(1);
+
+    WTF::FastMallocSizeClassStatistics afterFreeing;
+    ASSERT_TRUE(sizeClassStatistics(otherThreadObjectSize, afterFreeing));
+    EXPECT_GT(afterFreeing.freeBytes, 0u);
+
+    // Only this thread's cache and the objects the other thread already gave back are freed now.
+    WTF::releaseFastMallocFreeMemory();
+    WTF::FastMallocSizeClassStatistics afterReleasing;
+    ASSERT_TRUE(sizeClassStatistics(otherThreadObjectSize, afterReleasing));
+    EXPECT_LT(afterReleasing.freeBytes, afterFreeing.freeBytes);
+
+    advanceOtherThreadStep(2);
+    waitForOtherThreadStep(3);
+
+    // The other thread is still alive, so only the release could have emptied its cache.
+    WTF::FastMallocSizeClassStatistics afterOtherThreadMissed;
+    ASSERT_TRUE(sizeClassStatistics(otherThreadObjectSize, afterOtherThreadMissed));
+    EXPECT_LT(afterOtherThreadMissed.freeBytes, afterReleasing.freeBytes);
+
+    advanceOtherThreadStep(4);
+    waitForThreadCompletion(thread);
+}
+
+} // namespace TestWebKitAPI
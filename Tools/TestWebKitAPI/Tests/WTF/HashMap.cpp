@@ -81,4 +81,86 @@ TEST(WTF, DoubleHashCollisions)
     ASSERT_EQ(map.get(negativeZeroKey), 3);
 }
 
+struct GroupProbingIntHashTraits : HashTraits<int> {
+    static const bool useGroupProbing = true;
+};
+
+typedef HashMap<int, int, DefaultHash<int>::Hash, GroupProbingIntHashTraits> GroupProbingIntHashMap;
+
+TEST(WTF, GroupProbingHashMapAddFindRemove)
+{
+    GroupProbingIntHashMap map;
+    ASSERT_TRUE(map.begin() == map.end());
+
+    for (int i = 1; i <= 1000; ++i)
+        ASSERT_TRUE(map.add(i, i * 2).isNewEntry);
+    ASSERT_EQ(map.size(), 1000);
+    ASSERT_FALSE(map.add(500, 0).isNewEntry);
+
+    for (int i = 1; i <= 1000; ++i)
+        ASSERT_EQ(map.get(i), i * 2);
+    ASSERT_FALSE(map.contains(1001));
+
+    for (int i = 1; i <= 1000; i += 2)
+        map.remove(i);
+    ASSERT_EQ(map.size(), 500);
+    for (int i = 1; i <= 1000; ++i)
+        ASSERT_EQ(map.contains(i), !(i % 2));
+
+    int sum = 0;
+    int count = 0;
+    for (GroupProbingIntHashMap::iterator it = map.begin(); it != map.end(); ++it) {
+        ASSERT_EQ(it->value, it->key * 2);
+        sum += it->key;
+        ++count;
+    }
+    ASSERT_EQ(count, 500);
+    ASSERT_EQ(sum, 250500);
+
+    map.clear();
+    ASSERT_TRUE(map.isEmpty());
+    ASSERT_FALSE(map.contains(2));
+}
+
+TEST(WTF, GroupProbingHashMapReusesDeletedBuckets)
+{
+    // Repeatedly adding and removing keys must not grow the table without bound.
+    GroupProbingIntHashMap map;
+    for (int i = 1; i <= 8; ++i)
+        map.add(i, i);
+    int capacity = map.capacity();
+
+    for (int i = 9; i < 10000; ++i) {
+        map.add(i, i);
+        map.remove(i - 8);
+    }
+    ASSERT_EQ(map.size(), 8);
+    ASSERT_EQ(map.capacity(), capacity);
+    for (int i = 10000 - 8; i < 10000; ++i)
+        ASSERT_EQ(map.get(i), i);
+}
+
+TEST(WTF, GroupProbingHashMapCopyAndSwap)
+{
+    GroupProbingIntHashMap map;
+    for (int i = 1; i <= 100; ++i)
+        map.add(i, -i);
+
+    GroupProbingIntHashMap copy(map);
+    ASSERT_EQ(copy.size(), 100);
+    for (int i = 1; i <= 100; ++i)
+        ASSERT_EQ(copy.get(i), -i);
+
+    GroupProbingIntHashMap other;
+    other.add(1000, 1);
+    other.swap(copy);
+    ASSERT_EQ(other.size(), 100);
+    ASSERT_EQ(copy.size(), 1);
+    ASSERT_EQ(copy.get(1000), 1);
+
+    GroupProbingIntHashMap::const_iterator begin = other.begin();
+    ASSERT_TRUE(begin == other.begin());
+    ASSERT_TRUE(begin != other.end());
+}
+
 } // namespace TestWebKitAPI
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <wtf/MainThread.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+namespace TestWebKitAPI {
+
+static Vector<int>& dispatchLog()
+{
+    DEFINE_STATIC_LOCAL(Vector<int>, log, ());
+    return log;
+}
+
+static void appendToDispatchLog(void* context)
+{
+    dispatchLog().append(static_cast<int>(reinterpret_cast<intptr_t>(context)));
+}
+
+static void* logEntry(int value)
+{
+    return reinterpret_cast<void*>(static_cast<intptr_t>(value));
+}
+
+// These tests run the dispatch themselves instead of spinning the platform run loop.
+static void dispatchPendingFunctions()
+{
+    WTF::dispatchFunctionsFromMainThread();
+}
+
+TEST(WTF, MainThreadOrderWithinAndAcrossPriorities)
+{
+    WTF::initializeMainThread();
+    dispatchPendingFunctions();
+    dispatchLog().clear();
+
+    // Values are priority * 10 + posting order.
+    for (int i = 0; i < 3; ++i) {
+        callOnMainThread(appendToDispatchLog, logEntry(20 + i), MainThreadBackgroundPriority);
+        callOnMainThread(appendToDispatchLog, logEntry(10 + i), MainThreadNormalPriority);
+        callOnMainThread(appendToDispatchLog, logEntry(i), MainThreadInputPriority);
+    }
+    dispatchPendingFunctions();
+
+    const int expected[] = { 0, 1, 2, 10, 11, 12, 20, 21, 22 };
+    ASSERT_EQ(WTF_ARRAY_LENGTH(expected), dispatchLog().size());
+    for (size_t i = 0; i < WTF_ARRAY_LENGTH(expected); ++i)
+        EXPECT_EQ(expected[i], dispatchLog()[i]);
+}
+
+static void postInputFunction(void*)
+{
+    dispatchLog().append(1);
+    callOnMainThread(appendToDispatchLog, logEntry(0), MainThreadInputPriority);
+}
+
+TEST(WTF, MainThreadInputPostedDuringDispatchRunsNext)
+{
+    WTF::initializeMainThread();
+    dispatchPendingFunctions();
+    dispatchLog().clear();
+
+    callOnMainThread(postInputFunction, 0, MainThreadNormalPriority);
+    callOnMainThread(appendToDispatchLog, logEntry(2), MainThreadNormalPriority);
+    dispatchPendingFunctions();
+
+    ASSERT_EQ(3u, dispatchLog().size());
+    EXPECT_EQ(1, dispatchLog()[0]);
+    EXPECT_EQ(0, dispatchLog()[1]);
+    EXPECT_EQ(2, dispatchLog()[2]);
+}
+
+TEST(WTF, MainThreadCancelAcrossPriorities)
+{
+    WTF::initializeMainThread();
+    dispatchPendingFunctions();
+    dispatchLog().clear();
+
+    callOnMainThread(appendToDispatchLog, logEntry(1), MainThreadInputPriority);
+    callOnMainThread(appendToDispatchLog, logEntry(2), MainThreadNormalPriority);
+    callOnMainThread(appendToDispatchLog, logEntry(1), MainThreadNormalPriority);
+    callOnMainThread(appendToDispatchLog, logEntry(1), MainThreadBackgroundPriority);
+    callOnMainThread(appendToDispatchLog, logEntry(3), MainThreadBackgroundPriority);
+    cancelCallOnMainThread(appendToDispatchLog, logEntry(1));
+    dispatchPendingFunctions();
+
+    ASSERT_EQ(2u, dispatchLog().size());
+    EXPECT_EQ(2, dispatchLog()[0]);
+    EXPECT_EQ(3, dispatchLog()[1]);
+}
+
+static const int functionsPostedFromThread = 1000;
+
+static void postFunctionsFromThread(void*)
+{
+    for (int i = 0; i < functionsPostedFromThread; ++i)
+        callOnMainThread(appendToDispatchLog, logEntry(i), MainThreadNormalPriority);
+}
+
+TEST(WTF, MainThreadBatchSchedulesOneDispatch)
+{
+    WTF::initializeMainThread();
+    dispatchPendingFunctions();
+    dispatchLog().clear();
+
+    MainThreadDispatchStatistics before = mainThreadDispatchStatistics();
+
+    // Enough posts for the recycled nodes to be reused within the batch of the next round.
+    for (int round = 0; round < 2; ++round) {
+        ThreadIdentifier thread = createThread(postFunctionsFromThread, 0, "MainThreadBatchSchedulesOneDispatch");
+        waitForThreadCompletion(thread);
+        dispatchPendingFunctions();
+    }
+
+    MainThreadDispatchStatistics after = mainThreadDispatchStatistics();
+    EXPECT_EQ(2u, after.scheduledDispatches - before.scheduledDispatches);
+    EXPECT_EQ(2u, after.dispatches - before.dispatches);
+    EXPECT_EQ(2u * functionsPostedFromThread, after.postedFunctions[MainThreadNormalPriority] - before.postedFunctions[MainThreadNormalPriority]);
+
+    ASSERT_EQ(2u * functionsPostedFromThread, dispatchLog().size());
+    for (int i = 0; i < 2 * functionsPostedFromThread; ++i)
+        EXPECT_EQ(i % functionsPostedFromThread, dispatchLog()[i]);
+}
+
+} // namespace TestWebKitAPI
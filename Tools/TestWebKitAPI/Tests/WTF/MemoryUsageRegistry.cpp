@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <wtf/MemoryUsageRegistry.h>
+
+namespace TestWebKitAPI {
+
+static size_t imageBytes;
+
+static void reportCache(MemoryUsageReport& report)
+{
+    report.add("Test.Cache.Images", imageBytes);
+    report.add("Test.Cache.Scripts", 200);
+}
+
+static void reportFonts(MemoryUsageReport& report)
+{
+    report.add("Test.Fonts", 30);
+}
+
+TEST(WTF_MemoryUsageRegistry, CollectSumsCategories)
+{
+    MemoryUsageRegistry& registry = MemoryUsageRegistry::shared();
+    imageBytes = 1000;
+    registry.addReporter(reportCache);
+    registry.addReporter(reportFonts);
+    registry.addReporter(reportFonts);
+
+    MemoryUsageReport report;
+    registry.collect(report);
+    EXPECT_GT(report.timestamp(), 0);
+    EXPECT_EQ(3u, report.entries().size());
+    EXPECT_EQ(1230u, report.totalBytes());
+    EXPECT_EQ(1200u, report.bytes("Test.Cache"));
+    EXPECT_EQ(1000u, report.bytes("Test.Cache.Images"));
+    EXPECT_EQ(0u, report.bytes("Test.Cache.Image"));
+    EXPECT_EQ(1230u, report.bytes("Test"));
+
+    registry.removeReporter(reportFonts);
+    registry.collect(report);
+    EXPECT_EQ(2u, report.entries().size());
+    EXPECT_EQ(0u, report.bytes("Test.Fonts"));
+
+    registry.removeReporter(reportCache);
+    registry.collect(report);
+    EXPECT_EQ(0u, report.bytes("Test"));
+}
+
+TEST(WTF_MemoryUsageRegistry, Budgets)
+{
+    MemoryUsageRegistry& registry = MemoryUsageRegistry::shared();
+    registry.addReporter(reportCache);
+    registry.setBudget("Test.Cache", 2000);
+    registry.setBudget("Test.Cache.Scripts", 100);
+
+    imageBytes = 1000;
+    MemoryUsageReport report;
+    registry.collect(report);
+    ASSERT_EQ(1u, report.categoriesOverBudget().size());
+    EXPECT_STREQ("Test.Cache.Scripts", report.categoriesOverBudget()[0]);
+
+    imageBytes = 5000;
+    registry.setBudget("Test.Cache.Scripts", 500);
+    registry.collect(report);
+    ASSERT_EQ(1u, report.categoriesOverBudget().size());
+    EXPECT_STREQ("Test.Cache", report.categoriesOverBudget()[0]);
+
+    registry.clearBudget("Test.Cache");
+    registry.clearBudget("Test.Cache.Scripts");
+    registry.collect(report);
+    EXPECT_TRUE(report.categoriesOverBudget().isEmpty());
+
+    registry.removeReporter(reportCache);
+}
+
+} // namespace TestWebKitAPI
@@ -332,4 +332,96 @@ TEST(StringBuilderTest, ToAtomicStringOnEmpty)
     }
 }
 
+static void appendTestContent(StringBuilder& builder, unsigned rounds)
+{
+    LChar latin1[300];
+    UChar wide[300];
+    for (unsigned i = 0; i < 300; ++i) {
+        latin1[i] = 'a' + i % 26;
+        wide[i] = 0x400 + i;
+    }
+
+    for (unsigned round = 0; round < rounds; ++round) {
+        builder.append(latin1, 1 + round % 300);
+        builder.append('<');
+        builder.append(static_cast<UChar32>(0x1F600 + round % 16));
+        if (!(round % 7))
+            builder.append(wide, 1 + round % 300);
+        if (!(round % 11))
+            builder.append(String(latin1, 250));
+        builder.appendNumber(round);
+    }
+}
+
+TEST(StringBuilderTest, SegmentedMatchesSingleBuffer)
+{
+    StringBuilder singleBuffer;
+    StringBuilder segmented(StringBuilder::SegmentedBuffer);
+    appendTestContent(singleBuffer, 2000);
+    appendTestContent(segmented, 2000);
+
+    ASSERT_TRUE(segmented.isSegmented());
+    ASSERT_EQ(singleBuffer.length(), segmented.length());
+    ASSERT_GT(segmented.segmentCount(), 2U);
+
+    unsigned maximumSegmentLength = StringBuilder::maximumSegmentLength;
+    unsigned length = 0;
+    for (unsigned i = 0; i < segmented.segmentCount(); ++i) {
+        String segment = segmented.segmentAt(i);
+        ASSERT_LE(segment.length(), maximumSegmentLength);
+        ASSERT_FALSE(U16_IS_LEAD(segment[segment.length() - 1]));
+        length += segment.length();
+    }
+    ASSERT_EQ(segmented.length(), length);
+
+    String expected = singleBuffer.toString();
+    ASSERT_EQ(expected, segmented.toString());
+    ASSERT_EQ(1U, segmented.segmentCount());
+
+    // Appending after flattening continues in new segments.
+    segmented.append(expected);
+    ASSERT_EQ(String(expected + expected), segmented.toString());
+}
+
+TEST(StringBuilderTest, SegmentedKeepsWidthPerSegment)
+{
+    unsigned maximumSegmentLength = StringBuilder::maximumSegmentLength;
+    Vector<LChar> characters(maximumSegmentLength);
+    for (unsigned i = 0; i < characters.size(); ++i)
+        characters[i] = 'a' + i % 26;
+
+    StringBuilder builder(StringBuilder::SegmentedBuffer);
+    builder.append(characters.data(), characters.size());
+    builder.append(static_cast<UChar>(0x3042));
+    builder.append(characters.data(), 10);
+    ASSERT_EQ(2U, builder.segmentCount());
+    ASSERT_TRUE(builder.segmentAt(0).is8Bit());
+    ASSERT_FALSE(builder.segmentAt(1).is8Bit());
+    ASSERT_FALSE(builder.is8Bit());
+
+    // Latin-1 16-bit characters do not upconvert a segmented builder.
+    StringBuilder latin1Builder(StringBuilder::SegmentedBuffer);
+    const UChar latin1Characters[] = { 'a', 0xE9, 'b' };
+    latin1Builder.append(latin1Characters, 3);
+    ASSERT_TRUE(latin1Builder.is8Bit());
+
+    String result = builder.toString();
+    ASSERT_EQ(maximumSegmentLength + 11, result.length());
+    ASSERT_EQ(0x3042, result[maximumSegmentLength]);
+    ASSERT_EQ('a', result[maximumSegmentLength + 1]);
+}
+
+TEST(StringBuilderTest, AppendSegmentedBuilder)
+{
+    StringBuilder segmented(StringBuilder::SegmentedBuffer);
+    appendTestContent(segmented, 1000);
+    StringBuilder copy(StringBuilder::SegmentedBuffer);
+    appendTestContent(copy, 1000);
+
+    StringBuilder builder;
+    builder.appendLiteral("prefix");
+    builder.append(segmented);
+    ASSERT_EQ(String("prefix" + copy.toString()), builder.toString());
+}
+
 } // namespace
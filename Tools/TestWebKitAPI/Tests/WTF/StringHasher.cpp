@@ -32,24 +32,24 @@ namespace TestWebKitAPI {
 static const LChar nullLChars[2] = { 0, 0 };
 static const UChar nullUChars[2] = { 0, 0 };
 
-static const unsigned emptyStringHash = 0x4EC889EU;
-static const unsigned singleNullCharacterHash = 0x3D3ABF44U;
+static const unsigned emptyStringHash = 0xA4AB2EEAU;
+static const unsigned singleNullCharacterHash = 0xCA5F068U;
 
 static const LChar testALChars[6] = { 0x41, 0x95, 0xFF, 0x50, 0x01, 0 };
 static const UChar testAUChars[6] = { 0x41, 0x95, 0xFF, 0x50, 0x01, 0 };
 static const UChar testBUChars[6] = { 0x41, 0x95, 0xFFFF, 0x1080, 0x01, 0 };
 
-static const unsigned testAHash1 = 0xEA32B004;
-static const unsigned testAHash2 = 0x93F0F71E;
-static const unsigned testAHash3 = 0xCB609EB1;
-static const unsigned testAHash4 = 0x7984A706;
-static const unsigned testAHash5 = 0x0427561F;
+static const unsigned testAHash1 = 0xB303E11A;
+static const unsigned testAHash2 = 0x80BABD2D;
+static const unsigned testAHash3 = 0xAEBA4078;
+static const unsigned testAHash4 = 0x481B3D55;
+static const unsigned testAHash5 = 0xB1963E36;
 
-static const unsigned testBHash1 = 0xEA32B004;
-static const unsigned testBHash2 = 0x93F0F71E;
-static const unsigned testBHash3 = 0x59EB1B2C;
-static const unsigned testBHash4 = 0xA7BCCC0A;
-static const unsigned testBHash5 = 0x79201649;
+static const unsigned testBHash1 = 0xB303E11A;
+static const unsigned testBHash2 = 0x80BABD2D;
+static const unsigned testBHash3 = 0x3F5ED32E;
+static const unsigned testBHash4 = 0x5609DB24;
+static const unsigned testBHash5 = 0x64FAB09A;
 
 TEST(WTF, StringHasher)
 {
@@ -441,4 +441,32 @@ TEST(WTF, StringHasher_hashMemory)
     ASSERT_EQ(testBHash5 & 0xFFFFFF, StringHasher::hashMemory<10>(testBUChars));
 }
 
+TEST(WTF, StringHasher_wordBoundaries)
+{
+    // The hasher consumes whole words of four characters. Hashing must not depend on
+    // how the characters are split across calls, or on whether they are 8-bit or 16-bit.
+    LChar lchars[20];
+    UChar uchars[20];
+    for (unsigned i = 0; i < 20; ++i) {
+        lchars[i] = 0xA0 + i * 3;
+        uchars[i] = lchars[i];
+    }
+
+    for (unsigned length = 0; length <= 20; ++length) {
+        unsigned expectedHash = StringHasher::computeHash(uchars, length);
+        ASSERT_EQ(expectedHash, StringHasher::computeHash(lchars, length));
+
+        for (unsigned split = 0; split <= length; ++split) {
+            StringHasher hasher;
+            hasher.addCharacters(lchars, split);
+            hasher.addCharacters(uchars + split, length - split);
+            ASSERT_EQ(expectedHash, hasher.hash());
+        }
+    }
+
+    // Trailing null characters change the hash.
+    ASSERT_NE(StringHasher::computeHash(nullUChars, 1), StringHasher::computeHash(nullUChars, 2));
+    ASSERT_NE(StringHasher::computeHash(testAUChars, 3), StringHasher::computeHash(testAUChars, 4));
+}
+
 } // namespace TestWebKitAPI
@@ -26,6 +26,7 @@
 #include "config.h"
 
 #include <wtf/text/StringImpl.h>
+#include <wtf/text/StringSIMD.h>
 #include <wtf/text/WTFString.h>
 
 namespace TestWebKitAPI {
@@ -113,4 +114,180 @@ TEST(WTF, StringImplReplaceWithLiteral)
     ASSERT_TRUE(equal(testStringImpl.get(), "r555sum555"));
 }
 
+// The string primitives process whole blocks of characters at a time, so these tests cover
+// every length and position around a few block sizes, for both 8-bit and 16-bit strings.
+static const unsigned maximumTestLength = 70;
+
+static String makeTestString(unsigned length, bool is16Bit)
+{
+    Vector<UChar> characters;
+    for (unsigned i = 0; i < length; ++i)
+        characters.append('a' + i % 26);
+    if (is16Bit)
+        return String::adopt(characters);
+    return String::make8BitFrom16BitSource(characters.data(), characters.size());
+}
+
+static String replaceCharacter(const String& string, unsigned index, UChar character)
+{
+    Vector<UChar> characters;
+    for (unsigned i = 0; i < string.length(); ++i)
+        characters.append(i == index ? character : string[i]);
+    if (string.is8Bit() && character <= 0xFF)
+        return String::make8BitFrom16BitSource(characters.data(), characters.size());
+    return String::adopt(characters);
+}
+
+TEST(WTF, StringImplFindCharacterAtEveryPosition)
+{
+    for (int is16Bit = 0; is16Bit < 2; ++is16Bit) {
+        for (unsigned length = 1; length < maximumTestLength; ++length) {
+            for (unsigned position = 0; position < length; ++position) {
+                String string = replaceCharacter(makeTestString(length, is16Bit), position, '#');
+                ASSERT_EQ(position, string.find('#'));
+                ASSERT_EQ(position, string.find('#', position));
+                ASSERT_EQ(notFound, string.find('#', position + 1));
+                ASSERT_EQ(notFound, string.find('$'));
+            }
+        }
+    }
+}
+
+TEST(WTF, StringImplFindSubstringAtEveryPosition)
+{
+    for (int is16Bit = 0; is16Bit < 2; ++is16Bit) {
+        for (unsigned length = 2; length < maximumTestLength; ++length) {
+            String string = makeTestString(length, is16Bit);
+            for (unsigned matchLength = 2; matchLength <= length && matchLength < 20; ++matchLength) {
+                for (unsigned position = 0; position + matchLength <= length; ++position) {
+                    String match = string.substring(position, matchLength);
+                    size_t expected = position % 26;
+                    ASSERT_EQ(expected, string.impl()->find(match.impl()));
+                    ASSERT_EQ(position, string.impl()->find(match.impl(), position));
+
+                    // Only the first and last characters of the match agree with the string.
+                    String nearMatch = replaceCharacter(match, matchLength / 2, '#');
+                    if (matchLength > 2)
+                        ASSERT_EQ(notFound, string.impl()->find(nearMatch.impl()));
+                }
+            }
+        }
+    }
+
+    String string16 = replaceCharacter(makeTestString(40, false), 33, 0x3042);
+    ASSERT_FALSE(string16.is8Bit());
+    ASSERT_EQ(32u, string16.impl()->find(string16.substring(32, 3).impl()));
+}
+
+TEST(WTF, StringImplEqualAtEveryPosition)
+{
+    for (int is16Bit = 0; is16Bit < 2; ++is16Bit) {
+        for (unsigned length = 1; length < maximumTestLength; ++length) {
+            String string = makeTestString(length, is16Bit);
+            String copy = makeTestString(length, is16Bit);
+            String otherWidthCopy = makeTestString(length, !is16Bit);
+            ASSERT_TRUE(equal(string.impl(), copy.impl()));
+            ASSERT_TRUE(equal(string.impl(), otherWidthCopy.impl()));
+            for (unsigned position = 0; position < length; ++position) {
+                String different = replaceCharacter(copy, position, '#');
+                ASSERT_FALSE(equal(string.impl(), different.impl()));
+                ASSERT_FALSE(equal(otherWidthCopy.impl(), different.impl()));
+            }
+        }
+    }
+}
+
+TEST(WTF, StringImplEqualIgnoringCaseAtEveryPosition)
+{
+    for (int is16Bit = 0; is16Bit < 2; ++is16Bit) {
+        for (unsigned length = 1; length < maximumTestLength; ++length) {
+            String string = makeTestString(length, is16Bit);
+            String upper = string.upper();
+            ASSERT_TRUE(equalIgnoringCaseNonNull(string.impl(), upper.impl()));
+            ASSERT_TRUE(equalIgnoringCaseNonNull(upper.impl(), makeTestString(length, false).impl()));
+            for (unsigned position = 0; position < length; ++position) {
+                ASSERT_FALSE(equalIgnoringCaseNonNull(string.impl(), replaceCharacter(upper, position, '#').impl()));
+
+                // Non-ASCII characters are folded by the scalar code.
+                String withLatin1 = replaceCharacter(string, position, 0xE9);
+                ASSERT_TRUE(equalIgnoringCaseNonNull(withLatin1.impl(), replaceCharacter(upper, position, 0xC9).impl()));
+                ASSERT_FALSE(equalIgnoringCaseNonNull(withLatin1.impl(), upper.impl()));
+            }
+        }
+    }
+}
+
+TEST(WTF, StringImplLowerAndUpperAtEveryPosition)
+{
+    for (int is16Bit = 0; is16Bit < 2; ++is16Bit) {
+        for (unsigned length = 1; length < maximumTestLength; ++length) {
+            String lower = makeTestString(length, is16Bit);
+            String upper = lower.upper();
+            ASSERT_EQ(is16Bit, !upper.is8Bit());
+            for (unsigned i = 0; i < length; ++i)
+                ASSERT_EQ(toASCIIUpper(lower[i]), upper[i]);
+            ASSERT_TRUE(lower == upper.lower());
+            ASSERT_EQ(lower.impl(), lower.impl()->lower().get());
+
+            for (unsigned position = 0; position < length; ++position) {
+                ASSERT_TRUE(replaceCharacter(lower, position, '#') == replaceCharacter(upper, position, '#').lower());
+                ASSERT_TRUE(replaceCharacter(lower, position, 0xE9) == replaceCharacter(upper, position, 0xC9).lower());
+                ASSERT_TRUE(replaceCharacter(upper, position, 0xC9) == replaceCharacter(lower, position, 0xE9).upper());
+            }
+        }
+    }
+}
+
+TEST(WTF, StringImplUpconvertAtEveryLength)
+{
+    for (unsigned length = 1; length < maximumTestLength; ++length) {
+        String string = makeTestString(length, false);
+        ASSERT_TRUE(string.is8Bit());
+        const UChar* characters = string.characters();
+        for (unsigned i = 0; i < length; ++i)
+            ASSERT_EQ(string.characters8()[i], characters[i]);
+    }
+}
+
+template<typename CharacterType>
+static unsigned findFirstOf(const CharacterType* characters, unsigned length, const LChar* matchCharacters, unsigned matchCount)
+{
+    bool found;
+    unsigned i = WTF::findFirstOfInBlocks(characters, length, matchCharacters, matchCount, 0, found);
+    if (found)
+        return i;
+    for (; i < length; ++i) {
+        for (unsigned j = 0; j < matchCount; ++j) {
+            if (characters[i] == matchCharacters[j])
+                return i;
+        }
+    }
+    return length;
+}
+
+TEST(WTF, StringSIMDFindFirstOfAtEveryPosition)
+{
+    const LChar matchCharacters[] = { '<', '&', '\n', '\r', '\0' };
+    const unsigned matchCount = WTF_ARRAY_LENGTH(matchCharacters);
+    for (int is16Bit = 0; is16Bit < 2; ++is16Bit) {
+        for (unsigned length = 1; length < maximumTestLength; ++length) {
+            String string = makeTestString(length, is16Bit);
+            if (is16Bit)
+                ASSERT_EQ(length, findFirstOf(string.characters16(), length, matchCharacters, matchCount));
+            else
+                ASSERT_EQ(length, findFirstOf(string.characters8(), length, matchCharacters, matchCount));
+
+            for (unsigned position = 0; position < length; ++position) {
+                for (unsigned j = 0; j < matchCount; ++j) {
+                    String withMatch = replaceCharacter(string, position, matchCharacters[j]);
+                    if (is16Bit)
+                        ASSERT_EQ(position, findFirstOf(withMatch.characters16(), length, matchCharacters, matchCount));
+                    else
+                        ASSERT_EQ(position, findFirstOf(withMatch.characters8(), length, matchCharacters, matchCount));
+                }
+            }
+        }
+    }
+}
+
 } // namespace TestWebKitAPI
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/text/StringBuilder.h>
+#include <wtf/text/WTFString.h>
+
+// Microbenchmarks for the string primitives of StringImpl. They are disabled so that they do not
+// slow down regular runs; use --gtest_also_run_disabled_tests --gtest_filter=WTF.DISABLED_StringImplBenchmark*
+// to run them.
+
+namespace TestWebKitAPI {
+
+static const unsigned benchmarkIterations = 200000;
+
+static String makeBenchmarkString(unsigned length, bool is16Bit)
+{
+    StringBuilder builder;
+    for (unsigned i = 0; i < length; ++i)
+        builder.append(static_cast<LChar>('a' + (i * 7) % 26));
+    String string = builder.toString();
+    if (!is16Bit)
+        return string;
+    return String(string.characters(), string.length());
+}
+
+static void reportBenchmark(const char* name, bool is16Bit, unsigned length, double startTime, unsigned checksum)
+{
+    double nanosecondsPerIteration = (monotonicallyIncreasingTime() - startTime) * 1e9 / benchmarkIterations;
+    printf("%-24s %s length %5u: %8.1f ns (checksum %u)\n", name, is16Bit ? "16-bit" : " 8-bit", length, nanosecondsPerIteration, checksum);
+}
+
+static const unsigned benchmarkLengths[] = { 8, 32, 256, 4096 };
+
+TEST(WTF, DISABLED_StringImplBenchmarkFindCharacter)
+{
+    for (int is16Bit = 0; is16Bit < 2; ++is16Bit) {
+        for (size_t i = 0; i < WTF_ARRAY_LENGTH(benchmarkLengths); ++i) {
+            String string = makeBenchmarkString(benchmarkLengths[i], is16Bit);
+            unsigned checksum = 0;
+            double startTime = monotonicallyIncreasingTime();
+            for (unsigned iteration = 0; iteration < benchmarkIterations; ++iteration)
+                checksum += string.find('#') == notFound;
+            reportBenchmark("find(character)", is16Bit, string.length(), startTime, checksum);
+        }
+    }
+}
+
+TEST(WTF, DISABLED_StringImplBenchmarkFindSubstring)
+{
+    for (int is16Bit = 0; is16Bit < 2; ++is16Bit) {
+        for (size_t i = 0; i < WTF_ARRAY_LENGTH(benchmarkLengths); ++i) {
+            String string = makeBenchmarkString(benchmarkLengths[i], is16Bit);
+            String match = makeBenchmarkString(6, is16Bit);
+            string.append("#");
+            match.append("#");
+            unsigned checksum = 0;
+            double startTime = monotonicallyIncreasingTime();
+            for (unsigned iteration = 0; iteration < benchmarkIterations; ++iteration)
+                checksum += string.find(match);
+            reportBenchmark("find(string)", is16Bit, string.length(), startTime, checksum);
+        }
+    }
+}
+
+TEST(WTF, DISABLED_StringImplBenchmarkEqual)
+{
+    for (int is16Bit = 0; is16Bit < 2; ++is16Bit) {
+        for (size_t i = 0; i < WTF_ARRAY_LENGTH(benchmarkLengths); ++i) {
+            String string = makeBenchmarkString(benchmarkLengths[i], is16Bit);
+            String copy = makeBenchmarkString(benchmarkLengths[i], is16Bit);
+            String otherWidthCopy = makeBenchmarkString(benchmarkLengths[i], !is16Bit);
+            unsigned checksum = 0;
+            double startTime = monotonicallyIncreasingTime();
+            for (unsigned iteration = 0; iteration < benchmarkIterations; ++iteration)
+                checksum += equal(string.impl(), copy.impl());
+            reportBenchmark("equal", is16Bit, string.length(), startTime, checksum);
+
+            startTime = monotonicallyIncreasingTime();
+            for (unsigned iteration = 0; iteration < benchmarkIterations; ++iteration)
+                checksum += equal(string.impl(), otherWidthCopy.impl());
+            reportBenchmark("equal(mixed width)", is16Bit, string.length(), startTime, checksum);
+        }
+    }
+}
+
+TEST(WTF, DISABLED_StringImplBenchmarkEqualIgnoringCase)
+{
+    for (int is16Bit = 0; is16Bit < 2; ++is16Bit) {
+        for (size_t i = 0; i < WTF_ARRAY_LENGTH(benchmarkLengths); ++i) {
+            String string = makeBenchmarkString(benchmarkLengths[i], is16Bit);
+            String upper = makeBenchmarkString(benchmarkLengths[i], false).upper();
+            unsigned checksum = 0;
+            double startTime = monotonicallyIncreasingTime();
+            for (unsigned iteration = 0; iteration < benchmarkIterations; ++iteration)
+                checksum += equalIgnoringCaseNonNull(string.impl(), upper.impl());
+            reportBenchmark("equalIgnoringCase", is16Bit, string.length(), startTime, checksum);
+        }
+    }
+}
+
+TEST(WTF, DISABLED_StringImplBenchmarkLowerAndUpper)
+{
+    for (int is16Bit = 0; is16Bit < 2; ++is16Bit) {
+        for (size_t i = 0; i < WTF_ARRAY_LENGTH(benchmarkLengths); ++i) {
+            String string = makeBenchmarkString(benchmarkLengths[i], is16Bit);
+            String upper = string.upper();
+            unsigned checksum = 0;
+            double startTime = monotonicallyIncreasingTime();
+            for (unsigned iteration = 0; iteration < benchmarkIterations; ++iteration)
+                checksum += string.impl()->lower()->length();
+            reportBenchmark("lower (no-op)", is16Bit, string.length(), startTime, checksum);
+
+            startTime = monotonicallyIncreasingTime();
+            for (unsigned iteration = 0; iteration < benchmarkIterations; ++iteration)
+                checksum += upper.impl()->lower()->length();
+            reportBenchmark("lower", is16Bit, string.length(), startTime, checksum);
+
+            startTime = monotonicallyIncreasingTime();
+            for (unsigned iteration = 0; iteration < benchmarkIterations; ++iteration)
+                checksum += string.impl()->upper()->length();
+            reportBenchmark("upper", is16Bit, string.length(), startTime, checksum);
+        }
+    }
+}
+
+TEST(WTF, DISABLED_StringImplBenchmarkUpconvert)
+{
+    for (size_t i = 0; i < WTF_ARRAY_LENGTH(benchmarkLengths); ++i) {
+        String string = makeBenchmarkString(benchmarkLengths[i], false);
+        unsigned checksum = 0;
+        double startTime = monotonicallyIncreasingTime();
+        for (unsigned iteration = 0; iteration < benchmarkIterations; ++iteration) {
+            String copy = StringImpl::create(string.characters8(), string.length());
+            checksum += copy.characters()[0];
+        }
+        reportBenchmark("upconvert", false, string.length(), startTime, checksum);
+    }
+}
+
+} // namespace TestWebKitAPI
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2013 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include <wtf/Atomics.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/ThreadPool.h>
+
+namespace TestWebKitAPI {
+
+static volatile int taskCounter;
+
+static void incrementTaskCounter(int times)
+{
+    for (int i = 0; i < times; ++i)
+        atomicIncrement(&taskCounter);
+}
+
+static void dispatchNestedTasks(int depth)
+{
+    atomicIncrement(&taskCounter);
+    if (!depth)
+        return;
+
+    RefPtr<TaskGroup> group = TaskGroup::create();
+    for (int i = 0; i < 3; ++i)
+        group->dispatch(bind(dispatchNestedTasks, depth - 1));
+    group->wait();
+}
+
+static ThreadIdentifier waitingThread;
+static volatile int unrelatedTasksRunWhileWaiting;
+
+static void recordUnrelatedTask()
+{
+    if (currentThread() == waitingThread)
+        atomicIncrement(&unrelatedTasksRunWhileWaiting);
+}
+
+TEST(WTF, ThreadPoolHasWorkers)
+{
+    WTF::initializeThreading();
+    EXPECT_GE(ThreadPool::shared().numberOfWorkers(), 1u);
+}
+
+// Idle workers exit after a second, so this gives them plenty of time.
+static bool waitForRunningWorkersToExit()
+{
+    double deadline = currentTime() + 5;
+    while (ThreadPool::shared().numberOfRunningWorkers()) {
+        if (currentTime() > deadline)
+            return false;
+        yield();
+    }
+    return true;
+}
+
+TEST(WTF, ThreadPoolStartsWorkersOnDemandAndStopsIdleOnes)
+{
+    WTF::initializeThreading();
+    ASSERT_TRUE(waitForRunningWorkersToExit());
+
+    taskCounter = 0;
+    RefPtr<TaskGroup> group = TaskGroup::create();
+    for (int i = 0; i < 50; ++i)
+        group->dispatch(bind(incrementTaskCounter, 100));
+    EXPECT_GE(ThreadPool::shared().numberOfRunningWorkers(), 1u);
+    EXPECT_LE(ThreadPool::shared().numberOfRunningWorkers(), ThreadPool::shared().numberOfWorkers());
+    group->wait();
+    EXPECT_EQ(50 * 100, taskCounter);
+
+    EXPECT_TRUE(waitForRunningWorkersToExit());
+
+    // Stopped workers are started again for the next batch.
+    group = TaskGroup::create();
+    for (int i = 0; i < 50; ++i)
+        group->dispatch(bind(incrementTaskCounter, 100));
+    group->wait();
+    EXPECT_EQ(2 * 50 * 100, taskCounter);
+}
+
+TEST(WTF, ThreadPoolTaskGroupWait)
+{
+    WTF::initializeThreading();
+    taskCounter = 0;
+    for (int round = 0; round < 20; ++round) {
+        RefPtr<TaskGroup> group = TaskGroup::create(ThreadPool::HighPriority);
+        for (int i = 0; i < 50; ++i)
+            group->dispatch(bind(incrementTaskCounter, 100));
+        group->wait();
+        EXPECT_EQ((round + 1) * 50 * 100, taskCounter);
+    }
+}
+
+TEST(WTF, ThreadPoolNestedTaskGroups)
+{
+    // Every task waits on a group of its own, which only finishes because
+    // waiting threads run pending tasks.
+    WTF::initializeThreading();
+    taskCounter = 0;
+    RefPtr<TaskGroup> group = TaskGroup::create();
+    group->dispatch(bind(dispatchNestedTasks, 6));
+    group->wait();
+    EXPECT_EQ(1093, taskCounter);
+}
+
+TEST(WTF, ThreadPoolCancelledTaskGroup)
+{
+    WTF::initializeThreading();
+    taskCounter = 0;
+    RefPtr<TaskGroup> group = TaskGroup::create(ThreadPool::BackgroundPriority);
+    group->cancel();
+    for (int i = 0; i < 100; ++i)
+        group->dispatch(bind(incrementTaskCounter, 1));
+    group->wait();
+    EXPECT_TRUE(group->isCancelled());
+    EXPECT_EQ(0, taskCounter);
+}
+
+TEST(WTF, ThreadPoolTaskGroupWaitOnlyRunsItsOwnTasks)
+{
+    WTF::initializeThreading();
+    waitingThread = currentThread();
+    unrelatedTasksRunWhileWaiting = 0;
+    taskCounter = 0;
+    for (int i = 0; i < 200; ++i)
+        ThreadPool::shared().dispatch(bind(recordUnrelatedTask), ThreadPool::HighPriority);
+    RefPtr<TaskGroup> group = TaskGroup::create(ThreadPool::BackgroundPriority);
+    for (int i = 0; i < 50; ++i)
+        group->dispatch(bind(incrementTaskCounter, 100));
+    group->wait();
+    EXPECT_EQ(50 * 100, taskCounter);
+    EXPECT_EQ(0, unrelatedTasksRunWhileWaiting);
+}
+
+} // namespace TestWebKitAPI
@@ -3,24 +3,30 @@ TARGET = tst_wtf
 
 SOURCES += \
     AtomicString.cpp \
+    BumpArena.cpp \
     CheckedArithmeticOperations.cpp \
     CString.cpp \
+    FastMalloc.cpp \
     Functional.cpp \
     HashMap.cpp \
     HashSet.cpp \
     IntegerToStringConversion.cpp \
     ListHashSet.cpp \
+    MainThread.cpp \
     MD5.cpp \
     MathExtras.cpp \
     MediaTime.cpp \
+    MemoryUsageRegistry.cpp \
     RedBlackTree.cpp \
     SHA1.cpp \
     SaturatedArithmeticOperations.cpp \
     StringBuilder.cpp \
     StringHasher.cpp \
     StringImpl.cpp \
+    StringImplBenchmark.cpp \
     StringOperators.cpp \
     TemporaryChange.cpp \
+    ThreadPool.cpp \
     Vector.cpp \
     VectorBasic.cpp \
     VectorReverse.cpp \
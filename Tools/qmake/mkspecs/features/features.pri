@@ -110,7 +110,7 @@ FEATURE_DEFAULTS = \
     ENABLE_SVG_FONTS=1 \
     ENABLE_TEMPLATE_ELEMENT=0 \
     ENABLE_TEXT_AUTOSIZING=0 \
-    ENABLE_THREADED_HTML_PARSER=0 \
+    ENABLE_THREADED_HTML_PARSER=1 \
     ENABLE_TOUCH_ADJUSTMENT=1 \
     ENABLE_TOUCH_EVENTS=1 \
     ENABLE_TOUCH_ICON_LOADING=0 \